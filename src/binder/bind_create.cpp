@@ -68,6 +68,10 @@ auto Binder::BindColumnDefinition(duckdb_libpgquery::PGColumnDef *cdef) -> Colum
     return {colname, TypeId::INTEGER};
   }
 
+  if (name == "numeric" || name == "float8") {
+    return {colname, TypeId::DECIMAL};
+  }
+
   if (name == "varchar") {
     auto exprs = BindExpressionList(cdef->typeName->typmods);
     if (exprs.size() != 1) {
@@ -112,7 +116,34 @@ auto Binder::BindCreate(duckdb_libpgquery::PGCreateStmt *pg_stmt) -> std::unique
     throw bustub::Exception("should have at least 1 column");
   }
 
-  return std::make_unique<CreateStatement>(std::move(table), std::move(columns));
+  // `WITH (format = pax)` stores the table column by column.
+  std::string format = "row";
+  if (pg_stmt->options != nullptr) {
+    for (auto c = pg_stmt->options->head; c != nullptr; c = lnext(c)) {
+      auto def_elem = reinterpret_cast<duckdb_libpgquery::PGDefElem *>(c->data.ptr_value);
+      if (def_elem->defname == nullptr || std::string(def_elem->defname) != "format" || def_elem->arg == nullptr) {
+        throw NotImplementedException("only the format option is supported for tables");
+      }
+      switch (def_elem->arg->type) {
+        case duckdb_libpgquery::T_PGTypeName: {
+          auto type_name = reinterpret_cast<duckdb_libpgquery::PGTypeName *>(def_elem->arg);
+          format = reinterpret_cast<duckdb_libpgquery::PGValue *>(type_name->names->tail->data.ptr_value)->val.str;
+          break;
+        }
+        case duckdb_libpgquery::T_PGString:
+          format = reinterpret_cast<duckdb_libpgquery::PGValue *>(def_elem->arg)->val.str;
+          break;
+        default:
+          throw NotImplementedException("table format should be a name");
+      }
+      format = StringUtil::Lower(format);
+      if (format != "row" && format != "pax") {
+        throw NotImplementedException(fmt::format("table format {} is not supported", format));
+      }
+    }
+  }
+
+  return std::make_unique<CreateStatement>(std::move(table), std::move(columns), std::move(format));
 }
 
 auto Binder::BindIndex(duckdb_libpgquery::PGIndexStmt *stmt) -> std::unique_ptr<IndexStatement> {
@@ -129,7 +160,16 @@ auto Binder::BindIndex(duckdb_libpgquery::PGIndexStmt *stmt) -> std::unique_ptr<
     }
   }
 
-  return std::make_unique<IndexStatement>(stmt->idxname, std::move(table), std::move(cols));
+  // The parser fills in "art" when USING is omitted, which we treat as the default B+ tree.
+  std::string index_type = stmt->accessMethod == nullptr ? "btree" : StringUtil::Lower(stmt->accessMethod);
+  if (index_type == "art") {
+    index_type = "btree";
+  }
+  if (index_type != "btree" && index_type != "hash") {
+    throw NotImplementedException(fmt::format("index access method {} is not supported", index_type));
+  }
+
+  return std::make_unique<IndexStatement>(stmt->idxname, std::move(table), std::move(cols), std::move(index_type));
 }
 
 }  // namespace bustub
@@ -36,7 +36,14 @@ BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, DiskManag
   //     "exception line in `buffer_pool_manager_instance.cpp`.");
 }
 
+std::atomic<size_t> BufferPoolManagerInstance::leaked_pinned_pages{0};
+
 BufferPoolManagerInstance::~BufferPoolManagerInstance() {
+  for (size_t i = 0; i < pool_size_; i++) {
+    if (pages_[i].GetPinCount() > 0) {
+      leaked_pinned_pages++;
+    }
+  }
   delete[] pages_;
   delete page_table_;
   delete replacer_;
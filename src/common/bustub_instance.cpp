@@ -38,7 +38,10 @@
 namespace bustub {
 
 auto BustubInstance::MakeExecutorContext(Transaction *txn) -> std::unique_ptr<ExecutorContext> {
-  return std::make_unique<ExecutorContext>(txn, catalog_, buffer_pool_manager_, txn_manager_, lock_manager_);
+  auto exec_ctx = std::make_unique<ExecutorContext>(txn, catalog_, buffer_pool_manager_, txn_manager_, lock_manager_);
+  exec_ctx->SetMemoryBudget(GetMemoryBudget());
+  exec_ctx->SetSortThreads(GetSortThreads());
+  return exec_ctx;
 }
 
 BustubInstance::BustubInstance(const std::string &db_file_name) {
@@ -174,7 +177,15 @@ see the execution plan of your query.
 
 auto BustubInstance::ExecuteSql(const std::string &sql, ResultWriter &writer) -> bool {
   auto txn = txn_manager_->Begin();
-  auto result = ExecuteSqlTxn(sql, writer, txn);
+  bool result;
+  try {
+    result = ExecuteSqlTxn(sql, writer, txn);
+  } catch (...) {
+    // A statement that fails, e.g. a SET with a bad value, leaves nothing behind.
+    txn_manager_->Abort(txn);
+    delete txn;
+    throw;
+  }
   txn_manager_->Commit(txn);
   delete txn;
   return result;
@@ -212,7 +223,8 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
         const auto &create_stmt = dynamic_cast<const CreateStatement &>(*statement);
 
         std::unique_lock<std::shared_mutex> l(catalog_lock_);
-        auto info = catalog_->CreateTable(txn, create_stmt.table_, Schema(create_stmt.columns_));
+        auto info = catalog_->CreateTable(txn, create_stmt.table_, Schema(create_stmt.columns_), true,
+                                          create_stmt.format_ == "pax" ? TableFormat::Pax : TableFormat::Row);
         l.unlock();
 
         if (info == nullptr) {
@@ -240,7 +252,8 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
         std::unique_lock<std::shared_mutex> l(catalog_lock_);
         auto info = catalog_->CreateIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>(
             txn, index_stmt.index_name_, index_stmt.table_->table_, index_stmt.table_->schema_, key_schema, col_ids,
-            INTEGER_SIZE, IntegerHashFunctionType{});
+            INTEGER_SIZE, IntegerHashFunctionType{},
+            index_stmt.index_type_ == "hash" ? IndexType::HashTableIndex : IndexType::BPlusTreeIndex);
         l.unlock();
 
         if (info == nullptr) {
@@ -257,6 +270,9 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
       }
       case StatementType::VARIABLE_SET_STATEMENT: {
         const auto &set_stmt = dynamic_cast<const VariableSetStatement &>(*statement);
+        if (IsCountSessionVariable(set_stmt.variable_)) {
+          ParseCountSessionVariable(set_stmt.variable_, set_stmt.value_);
+        }
         session_variables_[set_stmt.variable_] = set_stmt.value_;
         continue;
       }
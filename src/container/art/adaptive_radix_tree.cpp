@@ -0,0 +1,1024 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// adaptive_radix_tree.cpp
+//
+// Identification: src/container/art/adaptive_radix_tree.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "container/art/adaptive_radix_tree.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <thread>  // NOLINT
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "common/rid.h"
+
+namespace bustub {
+
+template <typename ValueType>
+AdaptiveRadixTree<ValueType>::AdaptiveRadixTree() : root_(new Node256()) {
+  for (auto &slot : epoch_slots_) {
+    slot.store(ART_IDLE_EPOCH);
+  }
+}
+
+template <typename ValueType>
+AdaptiveRadixTree<ValueType>::~AdaptiveRadixTree() {
+  FreeSubtree(root_);
+  for (auto [epoch, node] : garbage_) {
+    if (IsLeaf(node)) {
+      FreeLeaf(AsLeaf(node));
+    } else {
+      FreeNode(node);
+    }
+  }
+}
+
+/*****************************************************************************
+ * PUBLIC API
+ *****************************************************************************/
+template <typename ValueType>
+auto AdaptiveRadixTree<ValueType>::Insert(const std::vector<uint8_t> &key, const ValueType &value) -> bool {
+  EpochGuard epoch_guard(this);
+  while (true) {
+    bool need_restart = false;
+    auto inserted = InsertAttempt(key.data(), key.size(), value, &need_restart);
+    if (!need_restart) {
+      return inserted;
+    }
+  }
+}
+
+template <typename ValueType>
+auto AdaptiveRadixTree<ValueType>::Remove(const std::vector<uint8_t> &key) -> bool {
+  EpochGuard epoch_guard(this);
+  while (true) {
+    bool need_restart = false;
+    auto removed = RemoveAttempt(key.data(), key.size(), &need_restart);
+    if (!need_restart) {
+      return removed;
+    }
+  }
+}
+
+template <typename ValueType>
+auto AdaptiveRadixTree<ValueType>::GetValue(const std::vector<uint8_t> &key, ValueType *value) -> bool {
+  EpochGuard epoch_guard(this);
+  while (true) {
+    bool need_restart = false;
+    auto found = GetValueAttempt(key.data(), key.size(), value, &need_restart);
+    if (!need_restart) {
+      return found;
+    }
+  }
+}
+
+template <typename ValueType>
+void AdaptiveRadixTree<ValueType>::Scan(const std::vector<uint8_t> &low, size_t limit,
+                                        std::vector<ValueType> *result) {
+  EpochGuard epoch_guard(this);
+  while (true) {
+    result->clear();
+    if (limit == 0) {
+      return;
+    }
+    bool need_restart = false;
+    ScanNode(root_, 0, low, true, limit, result, &need_restart);
+    if (!need_restart) {
+      return;
+    }
+  }
+}
+
+template <typename ValueType>
+auto AdaptiveRadixTree<ValueType>::GetNumRetired() -> size_t {
+  std::scoped_lock lock(garbage_latch_);
+  return garbage_.size();
+}
+
+/*****************************************************************************
+ * EPOCH-BASED RECLAMATION
+ *****************************************************************************/
+template <typename ValueType>
+AdaptiveRadixTree<ValueType>::EpochGuard::EpochGuard(AdaptiveRadixTree *tree)
+    : tree_(tree), slot_(std::hash<std::thread::id>()(std::this_thread::get_id()) % ART_EPOCH_SLOTS) {
+  uint64_t epoch = tree_->global_epoch_.load();
+  for (uint64_t idle = ART_IDLE_EPOCH; !tree_->epoch_slots_[slot_].compare_exchange_weak(idle, epoch);
+       idle = ART_IDLE_EPOCH) {
+    slot_ = (slot_ + 1) % ART_EPOCH_SLOTS;
+    if (slot_ == 0) {
+      std::this_thread::yield();
+    }
+  }
+  // The announcement only protects us if the epoch did not move before it became visible; otherwise a reclaimer may
+  // already have scanned the slots and we announce again.
+  for (uint64_t current = tree_->global_epoch_.load(); current != epoch; current = tree_->global_epoch_.load()) {
+    epoch = current;
+    tree_->epoch_slots_[slot_].store(epoch);
+  }
+}
+
+template <typename ValueType>
+void AdaptiveRadixTree<ValueType>::Retire(Node *node) {
+  std::vector<Node *> reclaimed;
+  {
+    std::scoped_lock lock(garbage_latch_);
+    garbage_.emplace_back(global_epoch_.load(), node);
+    if (garbage_.size() >= ART_RECLAIM_THRESHOLD) {
+      Reclaim(&reclaimed);
+    }
+  }
+  for (auto *garbage : reclaimed) {
+    if (IsLeaf(garbage)) {
+      FreeLeaf(AsLeaf(garbage));
+    } else {
+      FreeNode(garbage);
+    }
+  }
+}
+
+template <typename ValueType>
+void AdaptiveRadixTree<ValueType>::Reclaim(std::vector<Node *> *reclaimed) {
+  // Memory retired in epoch e was unlinked before e ended, so operations that announce a later epoch cannot reach it.
+  // Advancing the epoch first makes everything retired so far older than any operation that starts from now on.
+  uint64_t safe_epoch = global_epoch_.fetch_add(1) + 1;
+  for (auto &slot : epoch_slots_) {
+    safe_epoch = std::min(safe_epoch, slot.load());
+  }
+  auto end =
+      std::find_if(garbage_.begin(), garbage_.end(), [&](const auto &entry) { return entry.first >= safe_epoch; });
+  for (auto it = garbage_.begin(); it != end; ++it) {
+    reclaimed->push_back(it->second);
+  }
+  garbage_.erase(garbage_.begin(), end);
+}
+
+/*****************************************************************************
+ * VERSIONS
+ *****************************************************************************/
+template <typename ValueType>
+auto AdaptiveRadixTree<ValueType>::ReadLockOrRestart(Node *node, bool *need_restart) -> uint64_t {
+  uint64_t version = node->version_.load();
+  while ((version & 0b10) == 0b10) {
+    std::this_thread::yield();
+    version = node->version_.load();
+  }
+  if ((version & 0b1) == 0b1) {
+    *need_restart = true;
+  }
+  return version;
+}
+
+template <typename ValueType>
+void AdaptiveRadixTree<ValueType>::CheckOrRestart(Node *node, uint64_t version, bool *need_restart) {
+  if (node->version_.load() != version) {
+    *need_restart = true;
+  }
+}
+
+template <typename ValueType>
+void AdaptiveRadixTree<ValueType>::UpgradeToWriteLockOrRestart(Node *node, uint64_t version, bool *need_restart) {
+  if (!node->version_.compare_exchange_strong(version, version + 0b10)) {
+    *need_restart = true;
+  }
+}
+
+template <typename ValueType>
+void AdaptiveRadixTree<ValueType>::WriteUnlock(Node *node) {
+  node->version_.fetch_add(0b10);
+}
+
+template <typename ValueType>
+void AdaptiveRadixTree<ValueType>::WriteUnlockObsolete(Node *node) {
+  node->version_.fetch_add(0b11);
+}
+
+/*****************************************************************************
+ * NODE OPERATIONS
+ *****************************************************************************/
+template <typename ValueType>
+auto AdaptiveRadixTree<ValueType>::MakeLeaf(const uint8_t *key, uint32_t key_len, const ValueType &value) -> Leaf * {
+  auto *leaf = reinterpret_cast<Leaf *>(new uint8_t[sizeof(Leaf) + key_len]);
+  leaf->value_ = value;
+  leaf->key_len_ = key_len;
+  memcpy(leaf->key_, key, key_len);
+  return leaf;
+}
+
+template <typename ValueType>
+auto AdaptiveRadixTree<ValueType>::LeafMatches(const Leaf *leaf, const uint8_t *key, uint32_t key_len) -> bool {
+  return leaf->key_len_ == key_len && memcmp(leaf->key_, key, key_len) == 0;
+}
+
+template <typename ValueType>
+auto AdaptiveRadixTree<ValueType>::FindChild(Node *node, uint8_t byte) -> Node * {
+  // Readers may race with writers, so counts are clamped to the node capacity and validated by the caller.
+  switch (node->type_) {
+    case NodeType::NODE4: {
+      auto *n = static_cast<Node4 *>(node);
+      int count = std::min<int>(n->num_children_, 4);
+      for (int i = 0; i < count; i++) {
+        if (n->keys_[i] == byte) {
+          return n->children_[i];
+        }
+      }
+      return nullptr;
+    }
+    case NodeType::NODE16: {
+      auto *n = static_cast<Node16 *>(node);
+      int count = std::min<int>(n->num_children_, 16);
+#ifdef __SSE2__
+      __m128i cmp = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(byte)),
+                                   _mm_loadu_si128(reinterpret_cast<const __m128i *>(n->keys_)));
+      unsigned bitfield = static_cast<unsigned>(_mm_movemask_epi8(cmp)) & ((1U << count) - 1);
+      return bitfield != 0 ? n->children_[__builtin_ctz(bitfield)] : nullptr;
+#else
+      for (int i = 0; i < count; i++) {
+        if (n->keys_[i] == byte) {
+          return n->children_[i];
+        }
+      }
+      return nullptr;
+#endif
+    }
+    case NodeType::NODE48: {
+      auto *n = static_cast<Node48 *>(node);
+      uint8_t slot = n->child_index_[byte];
+      return slot < ART_EMPTY_SLOT ? n->children_[slot] : nullptr;
+    }
+    case NodeType::NODE256:
+      return static_cast<Node256 *>(node)->children_[byte];
+  }
+  return nullptr;
+}
+
+template <typename ValueType>
+void AdaptiveRadixTree<ValueType>::AddChild(Node *node, uint8_t byte, Node *child) {
+  switch (node->type_) {
+    case NodeType::NODE4:
+    case NodeType::NODE16: {
+      uint8_t *keys;
+      Node **children;
+      if (node->type_ == NodeType::NODE4) {
+        keys = static_cast<Node4 *>(node)->keys_;
+        children = static_cast<Node4 *>(node)->children_;
+      } else {
+        keys = static_cast<Node16 *>(node)->keys_;
+        children = static_cast<Node16 *>(node)->children_;
+      }
+      int pos = 0;
+      while (pos < node->num_children_ && keys[pos] < byte) {
+        pos++;
+      }
+      memmove(keys + pos + 1, keys + pos, node->num_children_ - pos);
+      memmove(children + pos + 1, children + pos, (node->num_children_ - pos) * sizeof(Node *));
+      keys[pos] = byte;
+      children[pos] = child;
+      break;
+    }
+    case NodeType::NODE48: {
+      auto *n = static_cast<Node48 *>(node);
+      uint8_t slot = 0;
+      while (n->children_[slot] != nullptr) {
+        slot++;
+      }
+      n->children_[slot] = child;
+      n->child_index_[byte] = slot;
+      break;
+    }
+    case NodeType::NODE256:
+      static_cast<Node256 *>(node)->children_[byte] = child;
+      break;
+  }
+  node->num_children_++;
+}
+
+template <typename ValueType>
+void AdaptiveRadixTree<ValueType>::ChangeChild(Node *node, uint8_t byte, Node *child) {
+  switch (node->type_) {
+    case NodeType::NODE4: {
+      auto *n = static_cast<Node4 *>(node);
+      for (int i = 0; i < n->num_children_; i++) {
+        if (n->keys_[i] == byte) {
+          n->children_[i] = child;
+          return;
+        }
+      }
+      break;
+    }
+    case NodeType::NODE16: {
+      auto *n = static_cast<Node16 *>(node);
+      for (int i = 0; i < n->num_children_; i++) {
+        if (n->keys_[i] == byte) {
+          n->children_[i] = child;
+          return;
+        }
+      }
+      break;
+    }
+    case NodeType::NODE48: {
+      auto *n = static_cast<Node48 *>(node);
+      n->children_[n->child_index_[byte]] = child;
+      return;
+    }
+    case NodeType::NODE256:
+      static_cast<Node256 *>(node)->children_[byte] = child;
+      return;
+  }
+  UNREACHABLE("the child to replace is not in the node");
+}
+
+template <typename ValueType>
+void AdaptiveRadixTree<ValueType>::RemoveChild(Node *node, uint8_t byte) {
+  switch (node->type_) {
+    case NodeType::NODE4:
+    case NodeType::NODE16: {
+      uint8_t *keys;
+      Node **children;
+      if (node->type_ == NodeType::NODE4) {
+        keys = static_cast<Node4 *>(node)->keys_;
+        children = static_cast<Node4 *>(node)->children_;
+      } else {
+        keys = static_cast<Node16 *>(node)->keys_;
+        children = static_cast<Node16 *>(node)->children_;
+      }
+      int pos = 0;
+      while (keys[pos] != byte) {
+        pos++;
+      }
+      memmove(keys + pos, keys + pos + 1, node->num_children_ - pos - 1);
+      memmove(children + pos, children + pos + 1, (node->num_children_ - pos - 1) * sizeof(Node *));
+      break;
+    }
+    case NodeType::NODE48: {
+      auto *n = static_cast<Node48 *>(node);
+      n->children_[n->child_index_[byte]] = nullptr;
+      n->child_index_[byte] = ART_EMPTY_SLOT;
+      break;
+    }
+    case NodeType::NODE256:
+      static_cast<Node256 *>(node)->children_[byte] = nullptr;
+      break;
+  }
+  node->num_children_--;
+}
+
+template <typename ValueType>
+auto AdaptiveRadixTree<ValueType>::IsFull(const Node *node) -> bool {
+  switch (node->type_) {
+    case NodeType::NODE4:
+      return node->num_children_ == 4;
+    case NodeType::NODE16:
+      return node->num_children_ == 16;
+    case NodeType::NODE48:
+      return node->num_children_ == 48;
+    case NodeType::NODE256:
+      return false;
+  }
+  return false;
+}
+
+template <typename ValueType>
+auto AdaptiveRadixTree<ValueType>::IsUnderfullAfterRemove(const Node *node) -> bool {
+  // Shrink thresholds sit below the grow thresholds so that a node does not flip between layouts.
+  switch (node->type_) {
+    case NodeType::NODE4:
+      return false;
+    case NodeType::NODE16:
+      return node->num_children_ <= 4;
+    case NodeType::NODE48:
+      return node->num_children_ <= 13;
+    case NodeType::NODE256:
+      return node->num_children_ <= 38;
+  }
+  return false;
+}
+
+template <typename ValueType>
+auto AdaptiveRadixTree<ValueType>::Grow(Node *node) -> Node * {
+  Node *bigger;
+  switch (node->type_) {
+    case NodeType::NODE4:
+      bigger = new Node16();
+      break;
+    case NodeType::NODE16:
+      bigger = new Node48();
+      break;
+    default:
+      bigger = new Node256();
+      break;
+  }
+  CopyPrefix(node, bigger);
+  uint8_t bytes[256];
+  Node *children[256];
+  int count = CollectChildren(node, 0, bytes, children);
+  for (int i = 0; i < count; i++) {
+    AddChild(bigger, bytes[i], children[i]);
+  }
+  return bigger;
+}
+
+template <typename ValueType>
+auto AdaptiveRadixTree<ValueType>::Shrink(Node *node) -> Node * {
+  Node *smaller;
+  switch (node->type_) {
+    case NodeType::NODE16:
+      smaller = new Node4();
+      break;
+    case NodeType::NODE48:
+      smaller = new Node16();
+      break;
+    default:
+      smaller = new Node48();
+      break;
+  }
+  CopyPrefix(node, smaller);
+  uint8_t bytes[256];
+  Node *children[256];
+  int count = CollectChildren(node, 0, bytes, children);
+  for (int i = 0; i < count; i++) {
+    AddChild(smaller, bytes[i], children[i]);
+  }
+  return smaller;
+}
+
+template <typename ValueType>
+auto AdaptiveRadixTree<ValueType>::CollectChildren(Node *node, uint8_t from, uint8_t *bytes, Node **children) -> int {
+  int count = 0;
+  switch (node->type_) {
+    case NodeType::NODE4:
+    case NodeType::NODE16: {
+      uint8_t *keys;
+      Node **slots;
+      int num_children;
+      if (node->type_ == NodeType::NODE4) {
+        keys = static_cast<Node4 *>(node)->keys_;
+        slots = static_cast<Node4 *>(node)->children_;
+        num_children = std::min<int>(node->num_children_, 4);
+      } else {
+        keys = static_cast<Node16 *>(node)->keys_;
+        slots = static_cast<Node16 *>(node)->children_;
+        num_children = std::min<int>(node->num_children_, 16);
+      }
+      for (int i = 0; i < num_children; i++) {
+        if (keys[i] >= from) {
+          bytes[count] = keys[i];
+          children[count++] = slots[i];
+        }
+      }
+      break;
+    }
+    case NodeType::NODE48: {
+      auto *n = static_cast<Node48 *>(node);
+      for (int byte = from; byte < 256; byte++) {
+        uint8_t slot = n->child_index_[byte];
+        if (slot < ART_EMPTY_SLOT && n->children_[slot] != nullptr) {
+          bytes[count] = static_cast<uint8_t>(byte);
+          children[count++] = n->children_[slot];
+        }
+      }
+      break;
+    }
+    case NodeType::NODE256: {
+      auto *n = static_cast<Node256 *>(node);
+      for (int byte = from; byte < 256; byte++) {
+        if (n->children_[byte] != nullptr) {
+          bytes[count] = static_cast<uint8_t>(byte);
+          children[count++] = n->children_[byte];
+        }
+      }
+      break;
+    }
+  }
+  return count;
+}
+
+template <typename ValueType>
+void AdaptiveRadixTree<ValueType>::CopyPrefix(Node *from, Node *to) {
+  to->prefix_len_ = from->prefix_len_;
+  memcpy(to->prefix_, from->prefix_, ART_MAX_PREFIX_LEN);
+}
+
+template <typename ValueType>
+void AdaptiveRadixTree<ValueType>::SetPrefix(Node *node, const uint8_t *prefix, uint32_t len) {
+  node->prefix_len_ = len;
+  memcpy(node->prefix_, prefix, std::min(len, ART_MAX_PREFIX_LEN));
+}
+
+template <typename ValueType>
+auto AdaptiveRadixTree<ValueType>::AnyLeaf(Node *node) -> Leaf * {
+  while (!IsLeaf(node)) {
+    Node *next = nullptr;
+    switch (node->type_) {
+      case NodeType::NODE4:
+        next = static_cast<Node4 *>(node)->children_[0];
+        break;
+      case NodeType::NODE16:
+        next = static_cast<Node16 *>(node)->children_[0];
+        break;
+      case NodeType::NODE48: {
+        auto *n = static_cast<Node48 *>(node);
+        for (int slot = 0; slot < 48 && next == nullptr; slot++) {
+          next = n->children_[slot];
+        }
+        break;
+      }
+      case NodeType::NODE256: {
+        auto *n = static_cast<Node256 *>(node);
+        for (int byte = 0; byte < 256 && next == nullptr; byte++) {
+          next = n->children_[byte];
+        }
+        break;
+      }
+    }
+    if (next == nullptr) {
+      return nullptr;
+    }
+    node = next;
+  }
+  return AsLeaf(node);
+}
+
+template <typename ValueType>
+auto AdaptiveRadixTree<ValueType>::PrefixMismatch(Node *node, const uint8_t *key, uint32_t key_len, uint32_t depth,
+                                                  bool *need_restart) -> uint32_t {
+  uint32_t prefix_len = node->prefix_len_;
+  uint32_t stored = std::min(prefix_len, ART_MAX_PREFIX_LEN);
+  for (uint32_t i = 0; i < stored; i++) {
+    if (depth + i >= key_len || node->prefix_[i] != key[depth + i]) {
+      return i;
+    }
+  }
+  if (prefix_len > ART_MAX_PREFIX_LEN) {
+    // Every leaf below the node shares its prefix, so any of them holds the bytes that are not stored.
+    Leaf *leaf = AnyLeaf(node);
+    if (leaf == nullptr || leaf->key_len_ < depth + prefix_len) {
+      *need_restart = true;
+      return 0;
+    }
+    for (uint32_t i = ART_MAX_PREFIX_LEN; i < prefix_len; i++) {
+      if (depth + i >= key_len || leaf->key_[depth + i] != key[depth + i]) {
+        return i;
+      }
+    }
+  }
+  return prefix_len;
+}
+
+template <typename ValueType>
+auto AdaptiveRadixTree<ValueType>::LoadFullPrefix(Node *node, uint32_t depth) -> std::vector<uint8_t> {
+  if (node->prefix_len_ <= ART_MAX_PREFIX_LEN) {
+    return {node->prefix_, node->prefix_ + node->prefix_len_};
+  }
+  // The node is locked but its descendants are not; retry until a writer below has finished moving children.
+  Leaf *leaf = AnyLeaf(node);
+  while (leaf == nullptr) {
+    std::this_thread::yield();
+    leaf = AnyLeaf(node);
+  }
+  return {leaf->key_ + depth, leaf->key_ + depth + node->prefix_len_};
+}
+
+template <typename ValueType>
+void AdaptiveRadixTree<ValueType>::FreeNode(Node *node) {
+  switch (node->type_) {
+    case NodeType::NODE4:
+      delete static_cast<Node4 *>(node);
+      break;
+    case NodeType::NODE16:
+      delete static_cast<Node16 *>(node);
+      break;
+    case NodeType::NODE48:
+      delete static_cast<Node48 *>(node);
+      break;
+    case NodeType::NODE256:
+      delete static_cast<Node256 *>(node);
+      break;
+  }
+}
+
+template <typename ValueType>
+void AdaptiveRadixTree<ValueType>::FreeLeaf(Leaf *leaf) {
+  delete[] reinterpret_cast<uint8_t *>(leaf);
+}
+
+template <typename ValueType>
+void AdaptiveRadixTree<ValueType>::FreeSubtree(Node *node) {
+  if (IsLeaf(node)) {
+    FreeLeaf(AsLeaf(node));
+    return;
+  }
+  uint8_t bytes[256];
+  Node *children[256];
+  int count = CollectChildren(node, 0, bytes, children);
+  for (int i = 0; i < count; i++) {
+    FreeSubtree(children[i]);
+  }
+  FreeNode(node);
+}
+
+/*****************************************************************************
+ * OPTIMISTIC ATTEMPTS
+ *****************************************************************************/
+template <typename ValueType>
+auto AdaptiveRadixTree<ValueType>::InsertAttempt(const uint8_t *key, uint32_t key_len, const ValueType &value,
+                                                 bool *need_restart) -> bool {
+  Node *parent = nullptr;
+  uint64_t parent_version = 0;
+  uint8_t parent_key = 0;
+  Node *node = root_;
+  uint64_t version = ReadLockOrRestart(node, need_restart);
+  if (*need_restart) {
+    return false;
+  }
+  uint32_t depth = 0;
+
+  while (true) {
+    uint32_t prefix_len = node->prefix_len_;
+    if (prefix_len > 0) {
+      uint32_t matched = PrefixMismatch(node, key, key_len, depth, need_restart);
+      if (*need_restart) {
+        return false;
+      }
+      if (matched < prefix_len) {
+        // The key leaves the compressed path inside the prefix: put a Node4 with the common part above node.
+        // The root has no prefix, so node has a parent here.
+        UpgradeToWriteLockOrRestart(parent, parent_version, need_restart);
+        if (*need_restart) {
+          return false;
+        }
+        UpgradeToWriteLockOrRestart(node, version, need_restart);
+        if (*need_restart) {
+          WriteUnlock(parent);
+          return false;
+        }
+        if (depth + matched >= key_len) {
+          // The key is a prefix of keys already in the tree.
+          WriteUnlock(node);
+          WriteUnlock(parent);
+          return false;
+        }
+        auto full_prefix = LoadFullPrefix(node, depth);
+        auto *new_node = new Node4();
+        SetPrefix(new_node, key + depth, matched);
+        AddChild(new_node, full_prefix[matched], node);
+        AddChild(new_node, key[depth + matched], LeafToNode(MakeLeaf(key, key_len, value)));
+        SetPrefix(node, full_prefix.data() + matched + 1, prefix_len - matched - 1);
+        ChangeChild(parent, parent_key, new_node);
+        WriteUnlock(node);
+        WriteUnlock(parent);
+        return true;
+      }
+      depth += prefix_len;
+    }
+
+    if (depth >= key_len) {
+      CheckOrRestart(node, version, need_restart);
+      return false;
+    }
+    uint8_t node_key = key[depth];
+    Node *next = FindChild(node, node_key);
+    CheckOrRestart(node, version, need_restart);
+    if (*need_restart) {
+      return false;
+    }
+
+    if (next == nullptr) {
+      if (IsFull(node)) {
+        // Replace node with a larger copy; the root is a Node256 and never full, so node has a parent.
+        UpgradeToWriteLockOrRestart(parent, parent_version, need_restart);
+        if (*need_restart) {
+          return false;
+        }
+        UpgradeToWriteLockOrRestart(node, version, need_restart);
+        if (*need_restart) {
+          WriteUnlock(parent);
+          return false;
+        }
+        Node *bigger = Grow(node);
+        AddChild(bigger, node_key, LeafToNode(MakeLeaf(key, key_len, value)));
+        ChangeChild(parent, parent_key, bigger);
+        WriteUnlockObsolete(node);
+        Retire(node);
+        WriteUnlock(parent);
+        return true;
+      }
+      UpgradeToWriteLockOrRestart(node, version, need_restart);
+      if (*need_restart) {
+        return false;
+      }
+      AddChild(node, node_key, LeafToNode(MakeLeaf(key, key_len, value)));
+      WriteUnlock(node);
+      return true;
+    }
+
+    if (IsLeaf(next)) {
+      Leaf *leaf = AsLeaf(next);
+      if (LeafMatches(leaf, key, key_len)) {
+        return false;
+      }
+      UpgradeToWriteLockOrRestart(node, version, need_restart);
+      if (*need_restart) {
+        return false;
+      }
+      // Both keys agree up to depth; a Node4 holding their common bytes after that replaces the leaf.
+      uint32_t max_common = std::min(leaf->key_len_, key_len) - depth - 1;
+      uint32_t common = 0;
+      while (common < max_common && leaf->key_[depth + 1 + common] == key[depth + 1 + common]) {
+        common++;
+      }
+      if (common == max_common) {
+        // One key is a prefix of the other.
+        WriteUnlock(node);
+        return false;
+      }
+      auto *new_node = new Node4();
+      SetPrefix(new_node, key + depth + 1, common);
+      AddChild(new_node, leaf->key_[depth + 1 + common], next);
+      AddChild(new_node, key[depth + 1 + common], LeafToNode(MakeLeaf(key, key_len, value)));
+      ChangeChild(node, node_key, new_node);
+      WriteUnlock(node);
+      return true;
+    }
+
+    parent = node;
+    parent_version = version;
+    parent_key = node_key;
+    node = next;
+    version = ReadLockOrRestart(node, need_restart);
+    if (*need_restart) {
+      return false;
+    }
+    CheckOrRestart(parent, parent_version, need_restart);
+    if (*need_restart) {
+      return false;
+    }
+    depth++;
+  }
+}
+
+template <typename ValueType>
+auto AdaptiveRadixTree<ValueType>::RemoveAttempt(const uint8_t *key, uint32_t key_len, bool *need_restart) -> bool {
+  Node *parent = nullptr;
+  uint64_t parent_version = 0;
+  uint8_t parent_key = 0;
+  Node *node = root_;
+  uint64_t version = ReadLockOrRestart(node, need_restart);
+  if (*need_restart) {
+    return false;
+  }
+  uint32_t depth = 0;
+
+  while (true) {
+    uint32_t node_depth = depth;
+    uint32_t prefix_len = node->prefix_len_;
+    // Bytes beyond the stored prefix are checked against the leaf at the end.
+    uint32_t stored = std::min(prefix_len, ART_MAX_PREFIX_LEN);
+    for (uint32_t i = 0; i < stored; i++) {
+      if (depth + i >= key_len || node->prefix_[i] != key[depth + i]) {
+        CheckOrRestart(node, version, need_restart);
+        return false;
+      }
+    }
+    depth += prefix_len;
+
+    if (depth >= key_len) {
+      CheckOrRestart(node, version, need_restart);
+      return false;
+    }
+    uint8_t node_key = key[depth];
+    Node *next = FindChild(node, node_key);
+    CheckOrRestart(node, version, need_restart);
+    if (*need_restart || next == nullptr) {
+      return false;
+    }
+
+    if (!IsLeaf(next)) {
+      parent = node;
+      parent_version = version;
+      parent_key = node_key;
+      node = next;
+      version = ReadLockOrRestart(node, need_restart);
+      if (*need_restart) {
+        return false;
+      }
+      CheckOrRestart(parent, parent_version, need_restart);
+      if (*need_restart) {
+        return false;
+      }
+      depth++;
+      continue;
+    }
+
+    Leaf *leaf = AsLeaf(next);
+    if (!LeafMatches(leaf, key, key_len)) {
+      return false;
+    }
+
+    if (parent != nullptr && node->type_ == NodeType::NODE4 && node->num_children_ == 2) {
+      // Only one child would be left: splice it into the parent, extending its prefix by node's path.
+      UpgradeToWriteLockOrRestart(parent, parent_version, need_restart);
+      if (*need_restart) {
+        return false;
+      }
+      UpgradeToWriteLockOrRestart(node, version, need_restart);
+      if (*need_restart) {
+        WriteUnlock(parent);
+        return false;
+      }
+      auto *node4 = static_cast<Node4 *>(node);
+      int other = node4->keys_[0] == node_key ? 1 : 0;
+      uint8_t other_key = node4->keys_[other];
+      Node *other_child = node4->children_[other];
+      if (!IsLeaf(other_child)) {
+        uint64_t child_version = ReadLockOrRestart(other_child, need_restart);
+        if (!*need_restart) {
+          UpgradeToWriteLockOrRestart(other_child, child_version, need_restart);
+        }
+        if (*need_restart) {
+          WriteUnlock(node);
+          WriteUnlock(parent);
+          return false;
+        }
+        // node's prefix is part of the key that was just matched in full.
+        std::vector<uint8_t> prefix(key + node_depth, key + node_depth + prefix_len);
+        prefix.push_back(other_key);
+        prefix.insert(prefix.end(), other_child->prefix_,
+                      other_child->prefix_ + std::min(other_child->prefix_len_, ART_MAX_PREFIX_LEN));
+        uint32_t new_prefix_len = prefix_len + 1 + other_child->prefix_len_;
+        other_child->prefix_len_ = new_prefix_len;
+        memcpy(other_child->prefix_, prefix.data(), std::min(new_prefix_len, ART_MAX_PREFIX_LEN));
+      }
+      ChangeChild(parent, parent_key, other_child);
+      if (!IsLeaf(other_child)) {
+        WriteUnlock(other_child);
+      }
+      WriteUnlockObsolete(node);
+      Retire(node);
+      WriteUnlock(parent);
+    } else if (parent != nullptr && IsUnderfullAfterRemove(node)) {
+      UpgradeToWriteLockOrRestart(parent, parent_version, need_restart);
+      if (*need_restart) {
+        return false;
+      }
+      UpgradeToWriteLockOrRestart(node, version, need_restart);
+      if (*need_restart) {
+        WriteUnlock(parent);
+        return false;
+      }
+      RemoveChild(node, node_key);
+      Node *smaller = Shrink(node);
+      ChangeChild(parent, parent_key, smaller);
+      WriteUnlockObsolete(node);
+      Retire(node);
+      WriteUnlock(parent);
+    } else {
+      UpgradeToWriteLockOrRestart(node, version, need_restart);
+      if (*need_restart) {
+        return false;
+      }
+      RemoveChild(node, node_key);
+      WriteUnlock(node);
+    }
+    Retire(next);
+    return true;
+  }
+}
+
+template <typename ValueType>
+auto AdaptiveRadixTree<ValueType>::GetValueAttempt(const uint8_t *key, uint32_t key_len, ValueType *value,
+                                                   bool *need_restart) -> bool {
+  Node *node = root_;
+  uint64_t version = ReadLockOrRestart(node, need_restart);
+  if (*need_restart) {
+    return false;
+  }
+  uint32_t depth = 0;
+
+  while (true) {
+    uint32_t prefix_len = node->prefix_len_;
+    // Bytes beyond the stored prefix are checked against the leaf at the end.
+    uint32_t stored = std::min(prefix_len, ART_MAX_PREFIX_LEN);
+    for (uint32_t i = 0; i < stored; i++) {
+      if (depth + i >= key_len || node->prefix_[i] != key[depth + i]) {
+        CheckOrRestart(node, version, need_restart);
+        return false;
+      }
+    }
+    depth += prefix_len;
+
+    if (depth >= key_len) {
+      CheckOrRestart(node, version, need_restart);
+      return false;
+    }
+    Node *next = FindChild(node, key[depth]);
+    CheckOrRestart(node, version, need_restart);
+    if (*need_restart || next == nullptr) {
+      return false;
+    }
+
+    if (IsLeaf(next)) {
+      // Leaves never change once published.
+      Leaf *leaf = AsLeaf(next);
+      if (!LeafMatches(leaf, key, key_len)) {
+        return false;
+      }
+      *value = leaf->value_;
+      return true;
+    }
+
+    uint64_t next_version = ReadLockOrRestart(next, need_restart);
+    if (*need_restart) {
+      return false;
+    }
+    CheckOrRestart(node, version, need_restart);
+    if (*need_restart) {
+      return false;
+    }
+    node = next;
+    version = next_version;
+    depth++;
+  }
+}
+
+template <typename ValueType>
+void AdaptiveRadixTree<ValueType>::ScanNode(Node *node, uint32_t depth, const std::vector<uint8_t> &low, bool bounded,
+                                            size_t limit, std::vector<ValueType> *result, bool *need_restart) {
+  // bounded means the path to node equals low so far, so subtrees before low still have to be skipped.
+  uint64_t version = ReadLockOrRestart(node, need_restart);
+  if (*need_restart) {
+    return;
+  }
+  uint32_t prefix_len = node->prefix_len_;
+  if (bounded && prefix_len > 0) {
+    const uint8_t *prefix = node->prefix_;
+    if (prefix_len > ART_MAX_PREFIX_LEN) {
+      Leaf *leaf = AnyLeaf(node);
+      if (leaf == nullptr || leaf->key_len_ < depth + prefix_len) {
+        *need_restart = true;
+        return;
+      }
+      prefix = leaf->key_ + depth;
+    }
+    for (uint32_t i = 0; i < prefix_len; i++) {
+      if (depth + i >= low.size()) {
+        bounded = false;
+        break;
+      }
+      if (prefix[i] != low[depth + i]) {
+        if (prefix[i] < low[depth + i]) {
+          // Everything below node sorts before low.
+          CheckOrRestart(node, version, need_restart);
+          return;
+        }
+        bounded = false;
+        break;
+      }
+    }
+  }
+  depth += prefix_len;
+
+  // Children before the next byte of low cannot hold keys in range.
+  uint8_t from = bounded && depth < low.size() ? low[depth] : 0;
+  uint8_t bytes[256];
+  Node *children[256];
+  int count = CollectChildren(node, from, bytes, children);
+  CheckOrRestart(node, version, need_restart);
+  if (*need_restart) {
+    return;
+  }
+
+  for (int i = 0; i < count; i++) {
+    Node *child = children[i];
+    bool child_bounded = bounded && depth < low.size() && bytes[i] == low[depth];
+    if (IsLeaf(child)) {
+      Leaf *leaf = AsLeaf(child);
+      if (!child_bounded ||
+          !std::lexicographical_compare(leaf->key_, leaf->key_ + leaf->key_len_, low.begin(), low.end())) {
+        result->push_back(leaf->value_);
+      }
+    } else {
+      ScanNode(child, depth + 1, low, child_bounded, limit, result, need_restart);
+      if (*need_restart) {
+        return;
+      }
+    }
+    if (result->size() >= limit) {
+      return;
+    }
+  }
+}
+
+template class AdaptiveRadixTree<RID>;
+
+}  // namespace bustub
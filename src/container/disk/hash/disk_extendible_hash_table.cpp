@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <utility>
@@ -24,9 +25,19 @@ namespace bustub {
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 HASH_TABLE_TYPE::DiskExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
-                                         const KeyComparator &comparator, HashFunction<KeyType> hash_fn)
+                                         const KeyComparator &comparator, HashFunction<KeyType> hash_fn,
+                                         uint32_t header_max_depth)
     : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
-  //  implement me!
+  if (header_max_depth > DIRECTORY_HEADER_MAX_DEPTH) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "hash table header depth is too large");
+  }
+  // Directories and their buckets are created when the first key hashes to them.
+  Page *page = buffer_pool_manager_->NewPage(&header_page_id_);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate the hash table header page");
+  }
+  reinterpret_cast<HashTableDirectoryHeaderPage *>(page->GetData())->Init(header_page_id_, header_max_depth);
+  buffer_pool_manager_->UnpinPage(header_page_id_, true);
 }
 
 /*****************************************************************************
@@ -46,22 +57,70 @@ auto HASH_TABLE_TYPE::Hash(KeyType key) -> uint32_t {
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 inline auto HASH_TABLE_TYPE::KeyToDirectoryIndex(KeyType key, HashTableDirectoryPage *dir_page) -> uint32_t {
-  return 0;
+  return Hash(key) & dir_page->GetGlobalDepthMask();
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 inline auto HASH_TABLE_TYPE::KeyToPageId(KeyType key, HashTableDirectoryPage *dir_page) -> page_id_t {
-  return 0;
+  return dir_page->GetBucketPageId(KeyToDirectoryIndex(key, dir_page));
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_TYPE::FetchDirectoryPage() -> HashTableDirectoryPage * {
-  return nullptr;
+auto HASH_TABLE_TYPE::FetchPageOrThrow(page_id_t page_id) -> Page * {
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot fetch a hash table page, the buffer pool is full");
+  }
+  return page;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_TYPE::FetchBucketPage(page_id_t bucket_page_id) -> HASH_TABLE_BUCKET_TYPE * {
-  return nullptr;
+auto HASH_TABLE_TYPE::FetchChildOrThrow(page_id_t page_id, Page *parent) -> Page * {
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr) {
+    parent->RUnlatch();
+    buffer_pool_manager_->UnpinPage(parent->GetPageId(), false);
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot fetch a hash table page, the buffer pool is full");
+  }
+  return page;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::KeyToDirectoryPageId(KeyType key, bool create) -> page_id_t {
+  Page *page = FetchPageOrThrow(header_page_id_);
+  auto *header = reinterpret_cast<HashTableDirectoryHeaderPage *>(page->GetData());
+  uint32_t directory_idx = header->HashToDirectoryIndex(Hash(key));
+  page->RLatch();
+  page_id_t directory_page_id = header->GetDirectoryPageId(directory_idx);
+  page->RUnlatch();
+  if (directory_page_id != INVALID_PAGE_ID || !create) {
+    buffer_pool_manager_->UnpinPage(header_page_id_, false);
+    return directory_page_id;
+  }
+
+  page->WLatch();
+  directory_page_id = header->GetDirectoryPageId(directory_idx);
+  bool created = false;
+  if (directory_page_id == INVALID_PAGE_ID) {
+    // A new directory starts with a single bucket of local depth 0 behind a global depth of 0.
+    Page *dir_page = buffer_pool_manager_->NewPage(&directory_page_id);
+    page_id_t bucket_page_id;
+    if (dir_page == nullptr || buffer_pool_manager_->NewPage(&bucket_page_id) == nullptr) {
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(header_page_id_, false);
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate a hash table directory");
+    }
+    AsDirectory(dir_page)->SetPageId(directory_page_id);
+    AsDirectory(dir_page)->SetBucketPageId(0, bucket_page_id);
+    AsDirectory(dir_page)->SetLocalDepth(0, 0);
+    buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+    buffer_pool_manager_->UnpinPage(directory_page_id, true);
+    header->SetDirectoryPageId(directory_idx, directory_page_id);
+    created = true;
+  }
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(header_page_id_, created);
+  return directory_page_id;
 }
 
 /*****************************************************************************
@@ -69,7 +128,21 @@ auto HASH_TABLE_TYPE::FetchBucketPage(page_id_t bucket_page_id) -> HASH_TABLE_BU
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool {
-  return false;
+  page_id_t directory_page_id = KeyToDirectoryPageId(key, false);
+  if (directory_page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  Page *dir_page = FetchPageOrThrow(directory_page_id);
+  dir_page->RLatch();
+  page_id_t bucket_page_id = KeyToPageId(key, AsDirectory(dir_page));
+  Page *page = FetchChildOrThrow(bucket_page_id, dir_page);
+  page->RLatch();
+  bool found = AsBucket(page)->GetValue(key, comparator_, result);
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+  dir_page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(directory_page_id, false);
+  return found;
 }
 
 /*****************************************************************************
@@ -77,12 +150,100 @@ auto HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  page_id_t directory_page_id = KeyToDirectoryPageId(key, true);
+  Page *dir_page = FetchPageOrThrow(directory_page_id);
+  dir_page->RLatch();
+  page_id_t bucket_page_id = KeyToPageId(key, AsDirectory(dir_page));
+  Page *page = FetchChildOrThrow(bucket_page_id, dir_page);
+  page->WLatch();
+  auto *bucket = AsBucket(page);
+  bool full = bucket->IsFull();
+  bool inserted = !full && bucket->Insert(key, value, comparator_);
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, inserted);
+  dir_page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(directory_page_id, false);
+
+  if (full) {
+    return SplitInsert(transaction, directory_page_id, key, value);
+  }
+  return inserted;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-auto HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+auto HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, page_id_t directory_page_id, const KeyType &key,
+                                  const ValueType &value) -> bool {
+  // Holding the directory exclusively keeps every other thread out of its buckets, so they need no latches here.
+  Page *page = FetchPageOrThrow(directory_page_id);
+  page->WLatch();
+  HashTableDirectoryPage *dir_page = AsDirectory(page);
+  bool dir_dirty = false;
+  bool inserted = false;
+
+  while (true) {
+    uint32_t bucket_idx = KeyToDirectoryIndex(key, dir_page);
+    page_id_t bucket_page_id = dir_page->GetBucketPageId(bucket_idx);
+    Page *bucket_page = buffer_pool_manager_->FetchPage(bucket_page_id);
+    if (bucket_page == nullptr) {
+      // Like a split image that cannot be allocated, the insert fails.
+      break;
+    }
+    HASH_TABLE_BUCKET_TYPE *bucket = AsBucket(bucket_page);
+    if (!bucket->IsFull()) {
+      // Another split made room, or this one did.
+      inserted = bucket->Insert(key, value, comparator_);
+      buffer_pool_manager_->UnpinPage(bucket_page_id, inserted);
+      break;
+    }
+
+    std::vector<ValueType> existing;
+    bucket->GetValue(key, comparator_, &existing);
+    uint32_t local_depth = dir_page->GetLocalDepth(bucket_idx);
+    if (std::find(existing.begin(), existing.end(), value) != existing.end() ||
+        (local_depth == dir_page->GetGlobalDepth() && dir_page->Size() * 2 > DIRECTORY_ARRAY_SIZE)) {
+      // Either a duplicate pair, or the directory cannot grow any further.
+      buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+      break;
+    }
+
+    page_id_t image_page_id;
+    Page *image_page = buffer_pool_manager_->NewPage(&image_page_id);
+    if (image_page == nullptr) {
+      buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+      break;
+    }
+    auto *image = AsBucket(image_page);
+    if (local_depth == dir_page->GetGlobalDepth()) {
+      dir_page->IncrGlobalDepth();
+    }
+
+    // Every directory slot that pointed to the full bucket gains a bit of local depth; those with that bit set move
+    // to the split image.
+    uint32_t high_bit = 1U << local_depth;
+    uint32_t old_mask = high_bit - 1;
+    for (uint32_t idx = 0; idx < dir_page->Size(); idx++) {
+      if ((idx & old_mask) == (bucket_idx & old_mask)) {
+        dir_page->SetLocalDepth(idx, local_depth + 1);
+        if ((idx & high_bit) != 0) {
+          dir_page->SetBucketPageId(idx, image_page_id);
+        }
+      }
+    }
+    dir_dirty = true;
+
+    for (uint32_t slot = 0; slot < BUCKET_ARRAY_SIZE; slot++) {
+      if (bucket->IsReadable(slot) && (Hash(bucket->KeyAt(slot)) & high_bit) != 0) {
+        image->Insert(bucket->KeyAt(slot), bucket->ValueAt(slot), comparator_);
+        bucket->RemoveAt(slot);
+      }
+    }
+    buffer_pool_manager_->UnpinPage(image_page_id, true);
+    buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+  }
+
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(directory_page_id, dir_dirty);
+  return inserted;
 }
 
 /*****************************************************************************
@@ -90,38 +251,138 @@ auto HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key,
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  page_id_t directory_page_id = KeyToDirectoryPageId(key, false);
+  if (directory_page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  Page *dir_page = FetchPageOrThrow(directory_page_id);
+  dir_page->RLatch();
+  page_id_t bucket_page_id = KeyToPageId(key, AsDirectory(dir_page));
+  Page *page = FetchChildOrThrow(bucket_page_id, dir_page);
+  page->WLatch();
+  auto *bucket = AsBucket(page);
+  bool removed = bucket->Remove(key, value, comparator_);
+  bool empty = bucket->IsEmpty();
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, removed);
+  dir_page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(directory_page_id, false);
+
+  if (removed && empty) {
+    Merge(transaction, directory_page_id, key);
+  }
+  return removed;
 }
 
 /*****************************************************************************
  * MERGE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_TYPE::Merge(Transaction *transaction, const KeyType &key, const ValueType &value) {}
+void HASH_TABLE_TYPE::Merge(Transaction *transaction, page_id_t directory_page_id, const KeyType &key) {
+  // Merging is only housekeeping; without a free frame, the empty bucket is left in place.
+  Page *page = buffer_pool_manager_->FetchPage(directory_page_id);
+  if (page == nullptr) {
+    return;
+  }
+  page->WLatch();
+  HashTableDirectoryPage *dir_page = AsDirectory(page);
+  uint32_t bucket_idx = KeyToDirectoryIndex(key, dir_page);
+  bool dir_dirty = false;
+
+  // Merging may leave an empty bucket next to an empty split image one level up, so keep folding until neither half
+  // of a pair is empty.
+  while (true) {
+    uint32_t local_depth = dir_page->GetLocalDepth(bucket_idx);
+    uint32_t image_idx = dir_page->GetSplitImageIndex(bucket_idx);
+    if (local_depth == 0 || dir_page->GetLocalDepth(image_idx) != local_depth) {
+      break;
+    }
+    page_id_t bucket_page_id = dir_page->GetBucketPageId(bucket_idx);
+    page_id_t image_page_id = dir_page->GetBucketPageId(image_idx);
+    Page *bucket_page = buffer_pool_manager_->FetchPage(bucket_page_id);
+    if (bucket_page == nullptr) {
+      break;
+    }
+    bool bucket_empty = AsBucket(bucket_page)->IsEmpty();
+    buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+    Page *image_page = buffer_pool_manager_->FetchPage(image_page_id);
+    if (image_page == nullptr) {
+      break;
+    }
+    bool image_empty = AsBucket(image_page)->IsEmpty();
+    buffer_pool_manager_->UnpinPage(image_page_id, false);
+    if (!bucket_empty && !image_empty) {
+      break;
+    }
+
+    // Fold the empty half into the other one.
+    page_id_t empty_page_id = bucket_empty ? bucket_page_id : image_page_id;
+    page_id_t kept_page_id = bucket_empty ? image_page_id : bucket_page_id;
+    for (uint32_t idx = 0; idx < dir_page->Size(); idx++) {
+      page_id_t page_id = dir_page->GetBucketPageId(idx);
+      if (page_id == bucket_page_id || page_id == image_page_id) {
+        dir_page->SetBucketPageId(idx, kept_page_id);
+        dir_page->SetLocalDepth(idx, local_depth - 1);
+      }
+    }
+    buffer_pool_manager_->DeletePage(empty_page_id);
+    dir_dirty = true;
+  }
+
+  while (dir_page->CanShrink()) {
+    dir_page->DecrGlobalDepth();
+    dir_dirty = true;
+  }
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(directory_page_id, dir_dirty);
+}
 
 /*****************************************************************************
- * GETGLOBALDEPTH - DO NOT TOUCH
+ * GETGLOBALDEPTH
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::GetGlobalDepth() -> uint32_t {
-  table_latch_.RLock();
-  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
-  uint32_t global_depth = dir_page->GetGlobalDepth();
-  assert(buffer_pool_manager_->UnpinPage(directory_page_id_, false, nullptr));
-  table_latch_.RUnlock();
+  Page *page = FetchPageOrThrow(header_page_id_);
+  auto *header = reinterpret_cast<HashTableDirectoryHeaderPage *>(page->GetData());
+  uint32_t global_depth = 0;
+  page->RLatch();
+  for (uint32_t directory_idx = 0; directory_idx < header->Size(); directory_idx++) {
+    page_id_t directory_page_id = header->GetDirectoryPageId(directory_idx);
+    if (directory_page_id == INVALID_PAGE_ID) {
+      continue;
+    }
+    Page *dir_page = FetchChildOrThrow(directory_page_id, page);
+    dir_page->RLatch();
+    global_depth = std::max(global_depth, AsDirectory(dir_page)->GetGlobalDepth());
+    dir_page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(directory_page_id, false);
+  }
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
   return global_depth;
 }
 
 /*****************************************************************************
- * VERIFY INTEGRITY - DO NOT TOUCH
+ * VERIFY INTEGRITY
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 void HASH_TABLE_TYPE::VerifyIntegrity() {
-  table_latch_.RLock();
-  HashTableDirectoryPage *dir_page = FetchDirectoryPage();
-  dir_page->VerifyIntegrity();
-  assert(buffer_pool_manager_->UnpinPage(directory_page_id_, false, nullptr));
-  table_latch_.RUnlock();
+  Page *page = FetchPageOrThrow(header_page_id_);
+  auto *header = reinterpret_cast<HashTableDirectoryHeaderPage *>(page->GetData());
+  page->RLatch();
+  for (uint32_t directory_idx = 0; directory_idx < header->Size(); directory_idx++) {
+    page_id_t directory_page_id = header->GetDirectoryPageId(directory_idx);
+    if (directory_page_id == INVALID_PAGE_ID) {
+      continue;
+    }
+    Page *dir_page = FetchChildOrThrow(directory_page_id, page);
+    dir_page->RLatch();
+    AsDirectory(dir_page)->VerifyIntegrity();
+    dir_page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(directory_page_id, false);
+  }
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
 }
 
 /*****************************************************************************
@@ -4,14 +4,17 @@
 //
 // linear_probe_hash_table.cpp
 //
-// Identification: src/container/hash/linear_probe_hash_table.cpp
+// Identification: src/container/disk/hash/linear_probe_hash_table.cpp
 //
 // Copyright (c) 2015-2019, Carnegie Mellon University Database Group
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iostream>
 #include <string>
+#include <thread>  // NOLINT
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -26,21 +29,239 @@ template <typename KeyType, typename ValueType, typename KeyComparator>
 HASH_TABLE_TYPE::LinearProbeHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
                                       const KeyComparator &comparator, size_t num_buckets,
                                       HashFunction<KeyType> hash_fn)
-    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {}
+    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {
+  header_page_id_ = CreateTable(num_buckets);
+  if (header_page_id_ == INVALID_PAGE_ID) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "too many buckets for a linear probe hash table");
+  }
+}
+
+/*****************************************************************************
+ * HELPERS
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::Hash(const KeyType &key) -> size_t {
+  return static_cast<size_t>(hash_fn_.GetHash(key));
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::FetchPageOrThrow(page_id_t page_id) -> BasicPageGuard {
+  auto guard = buffer_pool_manager_->FetchPageBasic(page_id);
+  if (!guard.IsValid()) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot fetch a hash table page, the buffer pool is full");
+  }
+  return guard;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::CreateTable(size_t num_slots) -> page_id_t {
+  size_t num_blocks = std::max<size_t>(1, (num_slots + BLOCK_ARRAY_SIZE - 1) / BLOCK_ARRAY_SIZE);
+  if (num_blocks > HEADER_BLOCK_ARRAY_SIZE) {
+    return INVALID_PAGE_ID;
+  }
+  page_id_t header_page_id;
+  Page *page = buffer_pool_manager_->NewPage(&header_page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate the hash table header page");
+  }
+  auto *header_page = reinterpret_cast<HashTableHeaderPage *>(page->GetData());
+  header_page->SetPageId(header_page_id);
+  header_page->SetSize(num_blocks * BLOCK_ARRAY_SIZE);
+  for (size_t i = 0; i < num_blocks; i++) {
+    page_id_t block_page_id;
+    if (buffer_pool_manager_->NewPage(&block_page_id) == nullptr) {
+      buffer_pool_manager_->UnpinPage(header_page_id, true);
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate a hash table block page");
+    }
+    header_page->AddBlockPageId(block_page_id);
+    buffer_pool_manager_->UnpinPage(block_page_id, true);
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id, true);
+  return header_page_id;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::DeleteTable(page_id_t header_page_id, const std::vector<page_id_t> &block_page_ids) {
+  for (auto block_page_id : block_page_ids) {
+    buffer_pool_manager_->DeletePage(block_page_id);
+  }
+  buffer_pool_manager_->DeletePage(header_page_id);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename Visitor>
+void HASH_TABLE_TYPE::Probe(HashTableHeaderPage *header_page, const KeyType &key, bool is_dirty, Visitor &&visit) {
+  size_t size = header_page->GetSize();
+  size_t slot = Hash(key) % size;
+  BasicPageGuard block_guard;
+  HASH_TABLE_BLOCK_TYPE *block = nullptr;
+  for (size_t i = 0; i < size; i++) {
+    // The size is a multiple of the block size, so wrapping around also starts a new block.
+    if (block == nullptr || slot % BLOCK_ARRAY_SIZE == 0) {
+      block_guard.Drop();
+      block_guard = FetchPageOrThrow(header_page->GetBlockPageId(slot / BLOCK_ARRAY_SIZE));
+      if (is_dirty) {
+        block_guard.SetDirty();
+      }
+      block = block_guard.As<HASH_TABLE_BLOCK_TYPE>();
+    }
+    if (!visit(block, slot % BLOCK_ARRAY_SIZE)) {
+      break;
+    }
+    slot = slot + 1 == size ? 0 : slot + 1;
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::LatchHomeBlock(HashTableHeaderPage *header_page, const KeyType &key) -> WritePageGuard {
+  size_t slot = Hash(key) % header_page->GetSize();
+  return FetchPageOrThrow(header_page->GetBlockPageId(slot / BLOCK_ARRAY_SIZE)).UpgradeWrite();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::ScanTable(HashTableHeaderPage *header_page, const KeyType &key, std::vector<ValueType> *result)
+    -> bool {
+  bool found = false;
+  Probe(header_page, key, false, [&](HASH_TABLE_BLOCK_TYPE *block, slot_offset_t offset) {
+    if (!block->IsOccupied(offset)) {
+      return false;
+    }
+    if (block->IsReadable(offset) && comparator_(key, block->KeyAt(offset)) == 0) {
+      result->push_back(block->ValueAt(offset));
+      found = true;
+    }
+    return true;
+  });
+  return found;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::ContainsPair(HashTableHeaderPage *header_page, const KeyType &key, const ValueType &value)
+    -> bool {
+  bool found = false;
+  Probe(header_page, key, false, [&](HASH_TABLE_BLOCK_TYPE *block, slot_offset_t offset) {
+    if (!block->IsOccupied(offset)) {
+      return false;
+    }
+    found = block->IsReadable(offset) && comparator_(key, block->KeyAt(offset)) == 0 && block->ValueAt(offset) == value;
+    return !found;
+  });
+  return found;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::RemovePair(HashTableHeaderPage *header_page, const KeyType &key, const ValueType &value)
+    -> bool {
+  bool removed = false;
+  Probe(header_page, key, true, [&](HASH_TABLE_BLOCK_TYPE *block, slot_offset_t offset) {
+    if (!block->IsOccupied(offset)) {
+      return false;
+    }
+    if (block->IsReadable(offset) && comparator_(key, block->KeyAt(offset)) == 0 && block->ValueAt(offset) == value) {
+      block->Remove(offset);
+      removed = true;
+    }
+    return !removed;
+  });
+  return removed;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::InsertPair(HashTableHeaderPage *header_page, const KeyType &key, const ValueType &value)
+    -> bool {
+  bool inserted = false;
+  // Block::Insert fails on occupied slots, including those claimed by a concurrent insert of another key.
+  Probe(header_page, key, true, [&](HASH_TABLE_BLOCK_TYPE *block, slot_offset_t offset) {
+    inserted = block->Insert(offset, key, value);
+    return !inserted;
+  });
+  if (inserted) {
+    num_occupied_++;
+  }
+  return inserted;
+}
 
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool {
-  return false;
+  table_latch_.RLock();
+  size_t begin = result->size();
+  size_t old_end = begin;
+  try {
+    if (old_header_page_id_ != INVALID_PAGE_ID) {
+      // Migration inserts a pair into the new table before removing it from the old one, so checking the old table
+      // first never misses a pair; it may see it twice.
+      BasicPageGuard old_header_guard = FetchPageOrThrow(old_header_page_id_);
+      ScanTable(old_header_guard.As<HashTableHeaderPage>(), key, result);
+    }
+    old_end = result->size();
+    BasicPageGuard header_guard = FetchPageOrThrow(header_page_id_);
+    ScanTable(header_guard.As<HashTableHeaderPage>(), key, result);
+  } catch (const Exception &) {
+    result->resize(begin);
+    table_latch_.RUnlock();
+    throw;
+  }
+  table_latch_.RUnlock();
+
+  if (old_end != begin) {
+    size_t end = old_end;
+    for (size_t i = old_end; i < result->size(); i++) {
+      if (std::find(result->begin() + begin, result->begin() + old_end, (*result)[i]) == result->begin() + old_end) {
+        (*result)[end++] = (*result)[i];
+      }
+    }
+    result->resize(end);
+  }
+  return result->size() != begin;
 }
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  MigrateStep();
+  bool can_grow = true;
+  while (true) {
+    table_latch_.RLock();
+    page_id_t header_page_id = header_page_id_;
+    size_t size;
+    bool grow;
+    bool duplicate = false;
+    bool inserted = false;
+    try {
+      BasicPageGuard header_guard = FetchPageOrThrow(header_page_id);
+      auto *header_page = header_guard.As<HashTableHeaderPage>();
+      size = header_page->GetSize();
+      grow = can_grow && (num_occupied_.load() + 1) * 2 > size;
+      if (!grow) {
+        auto home_guard = LatchHomeBlock(header_page, key);
+        duplicate = ContainsPair(header_page, key, value);
+        if (!duplicate && old_header_page_id_ != INVALID_PAGE_ID) {
+          BasicPageGuard old_header_guard = FetchPageOrThrow(old_header_page_id_);
+          duplicate = ContainsPair(old_header_guard.As<HashTableHeaderPage>(), key, value);
+        }
+        inserted = !duplicate && InsertPair(header_page, key, value);
+      }
+    } catch (const Exception &) {
+      table_latch_.RUnlock();
+      throw;
+    }
+    table_latch_.RUnlock();
+
+    if (grow) {
+      can_grow = Rebuild(header_page_id, RebuildSize(size));
+      continue;
+    }
+    if (duplicate || inserted || !can_grow) {
+      return inserted;
+    }
+    // Every slot is taken, which takes concurrent inserts racing past the load factor check.
+    can_grow = Rebuild(header_page_id, size * 2);
+  }
 }
 
 /*****************************************************************************
@@ -48,21 +269,195 @@ auto HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
-  return false;
+  MigrateStep();
+  table_latch_.RLock();
+  bool removed;
+  try {
+    BasicPageGuard header_guard = FetchPageOrThrow(header_page_id_);
+    auto *header_page = header_guard.As<HashTableHeaderPage>();
+    auto home_guard = LatchHomeBlock(header_page, key);
+    removed = RemovePair(header_page, key, value);
+    if (removed) {
+      num_tombstones_++;
+    }
+    if (!removed && old_header_page_id_ != INVALID_PAGE_ID) {
+      BasicPageGuard old_header_guard = FetchPageOrThrow(old_header_page_id_);
+      removed = RemovePair(old_header_guard.As<HashTableHeaderPage>(), key, value);
+    }
+  } catch (const Exception &) {
+    table_latch_.RUnlock();
+    throw;
+  }
+  table_latch_.RUnlock();
+  return removed;
 }
 
 /*****************************************************************************
  * RESIZE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_TYPE::Resize(size_t initial_size) {}
+void HASH_TABLE_TYPE::Resize(size_t initial_size) {
+  table_latch_.RLock();
+  page_id_t header_page_id = header_page_id_;
+  size_t size;
+  try {
+    BasicPageGuard header_guard = FetchPageOrThrow(header_page_id);
+    size = header_guard.As<HashTableHeaderPage>()->GetSize();
+  } catch (const Exception &) {
+    table_latch_.RUnlock();
+    throw;
+  }
+  table_latch_.RUnlock();
+  Rebuild(header_page_id, std::max(initial_size, size) * 2);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::RebuildSize(size_t size) const -> size_t {
+  // Rebuilding at the same size leaves the live pairs at most a quarter of the slots, so under insert/remove churn the
+  // table is rebuilt every size / 4 inserts or more, and only grows with the number of live pairs.
+  return num_tombstones_.load() * 2 > num_occupied_.load() ? size : size * 2;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::Rebuild(page_id_t expected_header_page_id, size_t num_slots) -> bool {
+  std::lock_guard<std::mutex> guard(resize_latch_);
+  while (true) {
+    table_latch_.RLock();
+    bool replaced = header_page_id_ != expected_header_page_id;
+    table_latch_.RUnlock();
+    if (replaced) {
+      return true;
+    }
+    if (!IsResizing()) {
+      break;
+    }
+    // Only two tables exist at a time, so the previous resize has to finish first.
+    if (!MigrateStep()) {
+      std::this_thread::yield();
+    }
+  }
+
+  // The new table is allocated without blocking anyone; the exclusive latch is only held to switch tables.
+  page_id_t new_header_page_id = CreateTable(num_slots);
+  if (new_header_page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  table_latch_.WLock();
+  old_header_page_id_ = header_page_id_;
+  header_page_id_ = new_header_page_id;
+  num_occupied_ = 0;
+  num_tombstones_ = 0;
+  migrate_cursor_ = 0;
+  migrated_slots_ = 0;
+  table_latch_.WUnlock();
+  return true;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::NextMigrateRange(size_t old_size) -> std::pair<size_t, size_t> {
+  {
+    std::lock_guard<std::mutex> guard(unfinished_ranges_latch_);
+    if (!unfinished_ranges_.empty()) {
+      auto range = unfinished_ranges_.back();
+      unfinished_ranges_.pop_back();
+      return range;
+    }
+  }
+  size_t begin = std::min(migrate_cursor_.fetch_add(MIGRATE_SLOTS_PER_OPERATION), old_size);
+  return {begin, std::min(begin + MIGRATE_SLOTS_PER_OPERATION, old_size)};
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::MigrateStep() -> bool {
+  table_latch_.RLock();
+  page_id_t old_header_page_id = old_header_page_id_;
+  if (old_header_page_id == INVALID_PAGE_ID) {
+    table_latch_.RUnlock();
+    return false;
+  }
+  size_t begin = 0;
+  size_t end = 0;
+  size_t slot = 0;
+  std::vector<page_id_t> old_block_page_ids;
+  try {
+    BasicPageGuard old_header_guard = FetchPageOrThrow(old_header_page_id);
+    auto *old_header_page = old_header_guard.As<HashTableHeaderPage>();
+    std::tie(begin, end) = NextMigrateRange(old_header_page->GetSize());
+    slot = begin;
+    if (begin < end) {
+      BasicPageGuard header_guard = FetchPageOrThrow(header_page_id_);
+      auto *header_page = header_guard.As<HashTableHeaderPage>();
+      while (slot < end) {
+        BasicPageGuard block_guard = FetchPageOrThrow(old_header_page->GetBlockPageId(slot / BLOCK_ARRAY_SIZE));
+        block_guard.SetDirty();
+        auto *block = block_guard.As<HASH_TABLE_BLOCK_TYPE>();
+        do {
+          slot_offset_t offset = slot % BLOCK_ARRAY_SIZE;
+          if (block->IsReadable(offset)) {
+            KeyType key = block->KeyAt(offset);
+            auto home_guard = LatchHomeBlock(header_page, key);
+            // A concurrent Remove of the pair may have taken the home block latch first.
+            if (block->IsReadable(offset)) {
+              // The old table was replaced at half load, by one at least as large, so there is room.
+              BUSTUB_ENSURE(InsertPair(header_page, key, block->ValueAt(offset)), "new hash table is full");
+              block->Remove(offset);
+            }
+          }
+          slot++;
+        } while (slot < end && slot % BLOCK_ARRAY_SIZE != 0);
+      }
+      if (migrated_slots_.fetch_add(end - begin) + (end - begin) == old_header_page->GetSize()) {
+        for (size_t i = 0; i < old_header_page->NumBlocks(); i++) {
+          old_block_page_ids.push_back(old_header_page->GetBlockPageId(i));
+        }
+      }
+    }
+  } catch (const Exception &) {
+    // The slots from the one that failed on are handed out again; migrating a slot twice does nothing the second time.
+    if (slot < end) {
+      std::lock_guard<std::mutex> guard(unfinished_ranges_latch_);
+      unfinished_ranges_.emplace_back(slot, end);
+    }
+    migrated_slots_ += slot - begin;
+    table_latch_.RUnlock();
+    throw;
+  }
+  table_latch_.RUnlock();
+
+  if (!old_block_page_ids.empty()) {
+    table_latch_.WLock();
+    old_header_page_id_ = INVALID_PAGE_ID;
+    table_latch_.WUnlock();
+    // Every operation that could still read the old table held the table latch, so none is left.
+    DeleteTable(old_header_page_id, old_block_page_ids);
+  }
+  return begin < end;
+}
 
 /*****************************************************************************
  * GETSIZE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_TYPE::GetSize() -> size_t {
-  return 0;
+  table_latch_.RLock();
+  size_t size;
+  try {
+    BasicPageGuard header_guard = FetchPageOrThrow(header_page_id_);
+    size = header_guard.As<HashTableHeaderPage>()->GetSize();
+  } catch (const Exception &) {
+    table_latch_.RUnlock();
+    throw;
+  }
+  table_latch_.RUnlock();
+  return size;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_TYPE::IsResizing() -> bool {
+  table_latch_.RLock();
+  bool resizing = old_header_page_id_ != INVALID_PAGE_ID;
+  table_latch_.RUnlock();
+  return resizing;
 }
 
 template class LinearProbeHashTable<int, int, IntComparator>;
@@ -0,0 +1,318 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// robin_hood_hash_table.cpp
+//
+// Identification: src/container/disk/hash/robin_hood_hash_table.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "common/rid.h"
+#include "container/disk/hash/robin_hood_hash_table.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+ROBIN_HOOD_HASH_TABLE_TYPE::RobinHoodHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
+                                               const KeyComparator &comparator, size_t num_buckets,
+                                               HashFunction<KeyType> hash_fn, double max_load_factor)
+    : buffer_pool_manager_(buffer_pool_manager),
+      comparator_(comparator),
+      max_load_factor_(max_load_factor),
+      hash_fn_(std::move(hash_fn)) {
+  if (max_load_factor <= 0 || max_load_factor >= 1) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "load factor of a robin hood hash table must be between 0 and 1");
+  }
+  header_page_id_ = CreateTable(num_buckets);
+  if (header_page_id_ == INVALID_PAGE_ID) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "too many buckets for a robin hood hash table");
+  }
+}
+
+/*****************************************************************************
+ * HELPERS
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto ROBIN_HOOD_HASH_TABLE_TYPE::Hash(const KeyType &key) -> size_t {
+  return static_cast<size_t>(hash_fn_.GetHash(key));
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto ROBIN_HOOD_HASH_TABLE_TYPE::GetHeaderPage(page_id_t header_page_id) -> HashTableHeaderPage * {
+  return reinterpret_cast<HashTableHeaderPage *>(buffer_pool_manager_->FetchPage(header_page_id)->GetData());
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto ROBIN_HOOD_HASH_TABLE_TYPE::CreateTable(size_t num_slots) -> page_id_t {
+  size_t num_blocks = std::max<size_t>(1, (num_slots + ROBIN_HOOD_BLOCK_ARRAY_SIZE - 1) / ROBIN_HOOD_BLOCK_ARRAY_SIZE);
+  if (num_blocks > HEADER_BLOCK_ARRAY_SIZE) {
+    return INVALID_PAGE_ID;
+  }
+  page_id_t header_page_id;
+  Page *page = buffer_pool_manager_->NewPage(&header_page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate the hash table header page");
+  }
+  auto *header_page = reinterpret_cast<HashTableHeaderPage *>(page->GetData());
+  header_page->SetPageId(header_page_id);
+  header_page->SetSize(num_blocks * ROBIN_HOOD_BLOCK_ARRAY_SIZE);
+  for (size_t i = 0; i < num_blocks; i++) {
+    page_id_t block_page_id;
+    if (buffer_pool_manager_->NewPage(&block_page_id) == nullptr) {
+      buffer_pool_manager_->UnpinPage(header_page_id, true);
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot allocate a hash table block page");
+    }
+    header_page->AddBlockPageId(block_page_id);
+    buffer_pool_manager_->UnpinPage(block_page_id, true);
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id, true);
+  return header_page_id;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void ROBIN_HOOD_HASH_TABLE_TYPE::DeleteTable(page_id_t header_page_id) {
+  auto *header_page = GetHeaderPage(header_page_id);
+  for (size_t i = 0; i < header_page->NumBlocks(); i++) {
+    buffer_pool_manager_->DeletePage(header_page->GetBlockPageId(i));
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id, false);
+  buffer_pool_manager_->DeletePage(header_page_id);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto ROBIN_HOOD_HASH_TABLE_TYPE::FindPair(HashTableHeaderPage *header_page, const KeyType &key,
+                                          const ValueType &value, size_t *slot) -> bool {
+  size_t size = header_page->GetSize();
+  BlockCursor cursor(buffer_pool_manager_, header_page, false);
+  size_t probe = Hash(key) % size;
+  for (uint32_t distance = 0; distance <= ROBIN_HOOD_MAX_PROBE_DISTANCE; distance++) {
+    auto *block = cursor.Block(probe);
+    slot_offset_t offset = Offset(probe);
+    // A pair closer to its home slot than the probe means the key would have taken its place.
+    if (!block->IsOccupied(offset) || block->ProbeDistanceAt(offset) < distance) {
+      return false;
+    }
+    if (comparator_(key, block->KeyAt(offset)) == 0 && block->ValueAt(offset) == value) {
+      *slot = probe;
+      return true;
+    }
+    probe = probe + 1 == size ? 0 : probe + 1;
+  }
+  return false;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto ROBIN_HOOD_HASH_TABLE_TYPE::InsertPair(HashTableHeaderPage *header_page, const MappingType &pair) -> bool {
+  size_t size = header_page->GetSize();
+  BlockCursor cursor(buffer_pool_manager_, header_page, true);
+  auto next = [size](size_t slot) { return slot + 1 == size ? 0 : slot + 1; };
+
+  // The pair goes to the first slot that is empty or holds a pair closer to its home slot.
+  size_t slot = Hash(pair.first) % size;
+  uint32_t distance = 0;
+  while (true) {
+    auto *block = cursor.Block(slot);
+    if (!block->IsOccupied(Offset(slot)) || block->ProbeDistanceAt(Offset(slot)) < distance) {
+      break;
+    }
+    slot = next(slot);
+    if (++distance > ROBIN_HOOD_MAX_PROBE_DISTANCE) {
+      return false;
+    }
+  }
+
+  // The rest of the cluster moves back by one slot. The load factor keeps an empty slot around to end it.
+  std::vector<std::pair<MappingType, uint32_t>> shifted;
+  for (size_t probe = slot; cursor.Block(probe)->IsOccupied(Offset(probe)); probe = next(probe)) {
+    auto *block = cursor.Block(probe);
+    uint32_t shifted_distance = block->ProbeDistanceAt(Offset(probe)) + 1;
+    if (shifted_distance > ROBIN_HOOD_MAX_PROBE_DISTANCE) {
+      return false;
+    }
+    shifted.emplace_back(block->PairAt(Offset(probe)), shifted_distance);
+  }
+  cursor.Block(slot)->SetPair(Offset(slot), pair, distance);
+  for (auto &[moved, moved_distance] : shifted) {
+    slot = next(slot);
+    cursor.Block(slot)->SetPair(Offset(slot), moved, moved_distance);
+  }
+  return true;
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto ROBIN_HOOD_HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key,
+                                          std::vector<ValueType> *result) -> bool {
+  table_latch_.RLock();
+  auto *header_page = GetHeaderPage(header_page_id_);
+  size_t size = header_page->GetSize();
+  bool found = false;
+  {
+    BlockCursor cursor(buffer_pool_manager_, header_page, false);
+    size_t probe = Hash(key) % size;
+    for (uint32_t distance = 0; distance <= ROBIN_HOOD_MAX_PROBE_DISTANCE; distance++) {
+      auto *block = cursor.Block(probe);
+      slot_offset_t offset = Offset(probe);
+      if (!block->IsOccupied(offset) || block->ProbeDistanceAt(offset) < distance) {
+        break;
+      }
+      if (comparator_(key, block->KeyAt(offset)) == 0) {
+        result->push_back(block->ValueAt(offset));
+        found = true;
+      }
+      probe = probe + 1 == size ? 0 : probe + 1;
+    }
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  table_latch_.RUnlock();
+  return found;
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto ROBIN_HOOD_HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
+  table_latch_.WLock();
+  bool inserted = false;
+  while (true) {
+    page_id_t header_page_id = header_page_id_;
+    auto *header_page = GetHeaderPage(header_page_id);
+    size_t size = header_page->GetSize();
+    size_t slot;
+    if (FindPair(header_page, key, value, &slot)) {
+      buffer_pool_manager_->UnpinPage(header_page_id, false);
+      break;
+    }
+    inserted = static_cast<double>(num_entries_ + 1) <= max_load_factor_ * static_cast<double>(size) &&
+               InsertPair(header_page, MappingType(key, value));
+    buffer_pool_manager_->UnpinPage(header_page_id, false);
+    if (inserted) {
+      num_entries_++;
+      break;
+    }
+    if (!Grow(size * 2)) {
+      break;
+    }
+  }
+  table_latch_.WUnlock();
+  return inserted;
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto ROBIN_HOOD_HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool {
+  table_latch_.WLock();
+  auto *header_page = GetHeaderPage(header_page_id_);
+  size_t size = header_page->GetSize();
+  size_t hole;
+  bool removed = FindPair(header_page, key, value, &hole);
+  if (removed) {
+    // Backward-shift deletion: pull the following pairs of the cluster one slot closer to their home slots.
+    BlockCursor cursor(buffer_pool_manager_, header_page, true);
+    while (true) {
+      size_t next = hole + 1 == size ? 0 : hole + 1;
+      auto *block = cursor.Block(next);
+      if (!block->IsOccupied(Offset(next)) || block->ProbeDistanceAt(Offset(next)) == 0) {
+        break;
+      }
+      MappingType moved = block->PairAt(Offset(next));
+      uint32_t moved_distance = block->ProbeDistanceAt(Offset(next)) - 1;
+      cursor.Block(hole)->SetPair(Offset(hole), moved, moved_distance);
+      hole = next;
+    }
+    cursor.Block(hole)->Clear(Offset(hole));
+    num_entries_--;
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  table_latch_.WUnlock();
+  return removed;
+}
+
+/*****************************************************************************
+ * RESIZE
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto ROBIN_HOOD_HASH_TABLE_TYPE::Grow(size_t num_slots) -> bool {
+  page_id_t new_header_page_id = CreateTable(num_slots);
+  if (new_header_page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  auto *old_header_page = GetHeaderPage(header_page_id_);
+  auto *new_header_page = GetHeaderPage(new_header_page_id);
+  bool fits = true;
+  BlockCursor cursor(buffer_pool_manager_, old_header_page, false);
+  for (size_t slot = 0; fits && slot < old_header_page->GetSize(); slot++) {
+    auto *block = cursor.Block(slot);
+    if (block->IsOccupied(Offset(slot))) {
+      fits = InsertPair(new_header_page, block->PairAt(Offset(slot)));
+    }
+  }
+  buffer_pool_manager_->UnpinPage(new_header_page_id, false);
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  if (!fits) {
+    // Probe distances can only exceed the bound in a table this small for a badly skewed hash; try a larger one.
+    DeleteTable(new_header_page_id);
+    return Grow(num_slots * 2);
+  }
+  DeleteTable(header_page_id_);
+  header_page_id_ = new_header_page_id;
+  return true;
+}
+
+/*****************************************************************************
+ * GETSIZE
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto ROBIN_HOOD_HASH_TABLE_TYPE::GetSize() -> size_t {
+  table_latch_.RLock();
+  size_t size = GetHeaderPage(header_page_id_)->GetSize();
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  table_latch_.RUnlock();
+  return size;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void ROBIN_HOOD_HASH_TABLE_TYPE::GetProbeDistances(double *average, uint32_t *max) {
+  table_latch_.RLock();
+  auto *header_page = GetHeaderPage(header_page_id_);
+  uint64_t total = 0;
+  *max = 0;
+  {
+    BlockCursor cursor(buffer_pool_manager_, header_page, false);
+    for (size_t slot = 0; slot < header_page->GetSize(); slot++) {
+      auto *block = cursor.Block(slot);
+      if (block->IsOccupied(Offset(slot))) {
+        total += block->ProbeDistanceAt(Offset(slot));
+        *max = std::max(*max, block->ProbeDistanceAt(Offset(slot)));
+      }
+    }
+  }
+  *average = num_entries_ == 0 ? 0 : static_cast<double>(total) / static_cast<double>(num_entries_);
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  table_latch_.RUnlock();
+}
+
+template class RobinHoodHashTable<int, int, IntComparator>;
+
+template class RobinHoodHashTable<GenericKey<4>, RID, GenericComparator<4>>;
+template class RobinHoodHashTable<GenericKey<8>, RID, GenericComparator<8>>;
+template class RobinHoodHashTable<GenericKey<16>, RID, GenericComparator<16>>;
+template class RobinHoodHashTable<GenericKey<32>, RID, GenericComparator<32>>;
+template class RobinHoodHashTable<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
@@ -14,114 +14,137 @@
 #include <cstdlib>
 #include <functional>
 #include <list>
+#include <string>
 #include <utility>
 
 #include "container/hash/extendible_hash_table.h"
 #include "storage/page/page.h"
-#define de(x) std::cout << "\033[32m" << #x << ":" << (x) << "\033[0m\n"
+
 namespace bustub {
 
 template <typename K, typename V>
 ExtendibleHashTable<K, V>::ExtendibleHashTable(size_t bucket_size)
-    : global_depth_(0), bucket_size_(bucket_size), num_buckets_(1) {
-  dir_.push_back(std::shared_ptr<Bucket>(new Bucket(bucket_size)));
+    : global_depth_(0), bucket_size_(bucket_size), num_buckets_(1), dir_(1) {
+  buckets_.emplace_back(std::make_unique<Bucket>(bucket_size));
+  dir_[0].store(buckets_.back().get());
 }
 
 template <typename K, typename V>
-auto ExtendibleHashTable<K, V>::IndexOf(const K &key) -> size_t {
+auto ExtendibleHashTable<K, V>::IndexOf(const K &key) const -> size_t {
   int mask = (1 << global_depth_) - 1;
   return std::hash<K>()(key) & mask;
 }
 
 template <typename K, typename V>
 auto ExtendibleHashTable<K, V>::GetGlobalDepth() const -> int {
-  std::scoped_lock<std::mutex> lock(latch_);
-  return GetGlobalDepthInternal();
-}
-
-template <typename K, typename V>
-auto ExtendibleHashTable<K, V>::GetGlobalDepthInternal() const -> int {
+  std::shared_lock<std::shared_mutex> lock(dir_latch_);
   return global_depth_;
 }
 
 template <typename K, typename V>
 auto ExtendibleHashTable<K, V>::GetLocalDepth(int dir_index) const -> int {
-  std::scoped_lock<std::mutex> lock(latch_);
-  return GetLocalDepthInternal(dir_index);
-}
-
-template <typename K, typename V>
-auto ExtendibleHashTable<K, V>::GetLocalDepthInternal(int dir_index) const -> int {
-  return dir_[dir_index]->GetDepth();
+  std::shared_lock<std::shared_mutex> lock(dir_latch_);
+  Bucket *bucket = dir_[dir_index].load(std::memory_order_acquire);
+  std::shared_lock<std::shared_mutex> bucket_lock(bucket->latch_);
+  return bucket->GetDepth();
 }
 
 template <typename K, typename V>
 auto ExtendibleHashTable<K, V>::GetNumBuckets() const -> int {
-  std::scoped_lock<std::mutex> lock(latch_);
-  return GetNumBucketsInternal();
+  return num_buckets_.load();
 }
 
 template <typename K, typename V>
-auto ExtendibleHashTable<K, V>::GetNumBucketsInternal() const -> int {
-  return num_buckets_;
+template <typename Lock>
+auto ExtendibleHashTable<K, V>::LatchBucket(const K &key, Lock *lock) const -> Bucket * {
+  size_t index = IndexOf(key);
+  while (true) {
+    Bucket *bucket = dir_[index].load(std::memory_order_acquire);
+    *lock = Lock(bucket->latch_);
+    // A split may have moved the key to the new image while we waited for the latch.
+    if (dir_[index].load(std::memory_order_acquire) == bucket) {
+      return bucket;
+    }
+    lock->unlock();
+  }
 }
 
 template <typename K, typename V>
 auto ExtendibleHashTable<K, V>::Find(const K &key, V &value) -> bool {
-  std::scoped_lock<std::mutex> lock(latch_);
-  size_t index = IndexOf(key);
-  std::shared_ptr<Bucket> bucket_dir = dir_[index];
-  if (bucket_dir == nullptr) {
-    return false;
-  }
-  return bucket_dir->Find(key, value);
+  std::shared_lock<std::shared_mutex> dir_lock(dir_latch_);
+  std::shared_lock<std::shared_mutex> bucket_lock;
+  return LatchBucket(key, &bucket_lock)->Find(key, value);
 }
 
 template <typename K, typename V>
 auto ExtendibleHashTable<K, V>::Remove(const K &key) -> bool {
-  std::scoped_lock<std::mutex> lock(latch_);
-  size_t index = IndexOf(key);
-  std::shared_ptr<Bucket> bucket_dir = dir_[index];
-  if (bucket_dir == nullptr) {
-    return false;
-  }
-  return bucket_dir->Remove(key);
+  std::shared_lock<std::shared_mutex> dir_lock(dir_latch_);
+  std::unique_lock<std::shared_mutex> bucket_lock;
+  return LatchBucket(key, &bucket_lock)->Remove(key);
 }
 
 template <typename K, typename V>
 void ExtendibleHashTable<K, V>::Insert(const K &key, const V &value) {
-  std::scoped_lock<std::mutex> lock(latch_);
-  size_t index = IndexOf(key);
-  std::shared_ptr<Bucket> bucket_dir = dir_[index];
-  while (!bucket_dir->Insert(key, value)) {
-    if (global_depth_ == bucket_dir->GetDepth()) {
-      size_t len = dir_.size();
-      for (size_t i = 0; i < len; i++) {
-        dir_.push_back(dir_[i]);
+  while (true) {
+    {
+      std::shared_lock<std::shared_mutex> dir_lock(dir_latch_);
+      std::unique_lock<std::shared_mutex> bucket_lock;
+      Bucket *bucket = LatchBucket(key, &bucket_lock);
+      if (bucket->Insert(key, value)) {
+        return;
       }
-      global_depth_++;
-    }
-    auto bucket0 = std::shared_ptr<Bucket>(new Bucket(bucket_size_, bucket_dir->GetDepth() + 1));
-    auto bucket1 = std::shared_ptr<Bucket>(new Bucket(bucket_size_, bucket_dir->GetDepth() + 1));
-    num_buckets_++;
-    int mask = 1 << bucket_dir->GetDepth();
-    for (auto &[fi, se] : bucket_dir->GetItems()) {
-      if (std::hash<K>()(fi) & mask) {
-        bucket1->Insert(fi, se);
-      } else {
-        bucket0->Insert(fi, se);
+      if (bucket->GetDepth() < global_depth_) {
+        SplitBucket(bucket, IndexOf(key));
+        continue;
       }
     }
-    size_t len = dir_.size();
-    for (size_t i = index & (mask - 1); i < len; i += mask) {
-      if ((i & mask) != 0U) {
-        dir_[i] = bucket1;
-      } else {
-        dir_[i] = bucket0;
-      }
+    // The bucket is as deep as the directory; only growing the directory needs it exclusively.
+    std::unique_lock<std::shared_mutex> dir_lock(dir_latch_);
+    Bucket *bucket = dir_[IndexOf(key)].load(std::memory_order_relaxed);
+    if (bucket->IsFull() && bucket->GetDepth() == global_depth_) {
+      GrowDirectory();
     }
-    index = IndexOf(key);
-    bucket_dir = dir_[index];
+  }
+}
+
+template <typename K, typename V>
+void ExtendibleHashTable<K, V>::GrowDirectory() {
+  std::vector<std::atomic<Bucket *>> dir(dir_.size() * 2);
+  for (size_t i = 0; i < dir.size(); i++) {
+    dir[i].store(dir_[i % dir_.size()].load(std::memory_order_relaxed), std::memory_order_relaxed);
+  }
+  dir_.swap(dir);
+  global_depth_++;
+}
+
+template <typename K, typename V>
+void ExtendibleHashTable<K, V>::SplitBucket(Bucket *bucket, size_t index) {
+  int depth = bucket->GetDepth();
+  size_t high_bit = 1 << depth;
+  auto image = std::make_unique<Bucket>(bucket_size_, depth + 1);
+
+  // The bucket keeps the keys without the new bit; the image is not visible yet, so it needs no latch.
+  auto &items = bucket->GetItems();
+  for (size_t i = 0; i < items.size();) {
+    if ((std::hash<K>()(items[i].first) & high_bit) != 0) {
+      image->GetItems().push_back(std::move(items[i]));
+      items[i] = std::move(items.back());
+      items.pop_back();
+    } else {
+      i++;
+    }
+  }
+  bucket->IncrementDepth();
+
+  Bucket *image_ptr = image.get();
+  {
+    std::scoped_lock<std::mutex> lock(buckets_latch_);
+    buckets_.push_back(std::move(image));
+  }
+  num_buckets_++;
+  // Only the slots of this bucket change, and no other split touches them.
+  for (size_t i = (index & (high_bit - 1)) | high_bit; i < dir_.size(); i += high_bit << 1) {
+    dir_[i].store(image_ptr, std::memory_order_release);
   }
 }
 
@@ -129,13 +152,15 @@ void ExtendibleHashTable<K, V>::Insert(const K &key, const V &value) {
 // Bucket
 //===--------------------------------------------------------------------===//
 template <typename K, typename V>
-ExtendibleHashTable<K, V>::Bucket::Bucket(size_t array_size, int depth) : size_(array_size), depth_(depth) {}
+ExtendibleHashTable<K, V>::Bucket::Bucket(size_t array_size, int depth) : size_(array_size), depth_(depth) {
+  items_.reserve(array_size);
+}
 
 template <typename K, typename V>
-auto ExtendibleHashTable<K, V>::Bucket::Find(const K &key, V &value) -> bool {
-  for (auto it = list_.begin(); it != list_.end(); it++) {
-    if (it->first == key) {
-      value = it->second;
+auto ExtendibleHashTable<K, V>::Bucket::Find(const K &key, V &value) const -> bool {
+  for (const auto &item : items_) {
+    if (item.first == key) {
+      value = item.second;
       return true;
     }
   }
@@ -144,9 +169,11 @@ auto ExtendibleHashTable<K, V>::Bucket::Find(const K &key, V &value) -> bool {
 
 template <typename K, typename V>
 auto ExtendibleHashTable<K, V>::Bucket::Remove(const K &key) -> bool {
-  for (auto it = list_.begin(); it != list_.end(); it++) {
-    if (it->first == key) {
-      list_.erase(it);
+  for (auto &item : items_) {
+    if (item.first == key) {
+      // Order within a bucket does not matter, so the last item fills the hole.
+      item = std::move(items_.back());
+      items_.pop_back();
       return true;
     }
   }
@@ -155,16 +182,16 @@ auto ExtendibleHashTable<K, V>::Bucket::Remove(const K &key) -> bool {
 
 template <typename K, typename V>
 auto ExtendibleHashTable<K, V>::Bucket::Insert(const K &key, const V &value) -> bool {
-  if (IsFull()) {
-    return false;
-  }
-  for (auto it = list_.begin(); it != list_.end(); it++) {
-    if (it->first == key) {
-      it->second = value;
+  for (auto &item : items_) {
+    if (item.first == key) {
+      item.second = value;
       return true;
     }
   }
-  list_.emplace_back(key, value);
+  if (IsFull()) {
+    return false;
+  }
+  items_.emplace_back(key, value);
   return true;
 }
 
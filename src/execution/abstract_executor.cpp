@@ -0,0 +1,43 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// abstract_executor.cpp
+//
+// Identification: src/execution/abstract_executor.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/abstract_executor.h"
+
+namespace bustub {
+
+auto AbstractExecutor::NextBatch(TupleBatch *batch) -> bool {
+  const auto &schema = GetOutputSchema();
+  batch->Reset(schema.GetColumnCount());
+  Tuple tuple;
+  RID rid;
+  while (!batch->IsFull() && Next(&tuple, &rid)) {
+    batch->AppendTuple(tuple, schema, rid);
+  }
+  return batch->NumSelected() > 0;
+}
+
+auto AbstractExecutor::NextFromBatch(Tuple *tuple, RID *rid) -> bool {
+  while (reader_cursor_ == reader_batch_.NumSelected()) {
+    if (!NextBatch(&reader_batch_)) {
+      reader_batch_.Reset(0);
+      reader_cursor_ = 0;
+      return false;
+    }
+    reader_cursor_ = 0;
+  }
+  auto row = reader_batch_.GetSelection()[reader_cursor_++];
+  *tuple = reader_batch_.ToTuple(row, GetOutputSchema());
+  *rid = reader_batch_.GetRid(row);
+  return true;
+}
+
+}  // namespace bustub
@@ -1,70 +1,112 @@
-//===----------------------------------------------------------------------===//
-//
-//                         BusTub
-//
-// aggregation_executor.cpp
-//
-// Identification: src/execution/aggregation_executor.cpp
-//
-// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
-//
-//===----------------------------------------------------------------------===//
-#include <memory>
-#include <vector>
-
-#include "execution/executors/aggregation_executor.h"
-
-namespace bustub {
-
-AggregationExecutor::AggregationExecutor(ExecutorContext *exec_ctx, const AggregationPlanNode *plan,
-                                         std::unique_ptr<AbstractExecutor> &&child)
-    : AbstractExecutor(exec_ctx),
-      plan_(plan),
-      child_(std::move(child)),
-      aht_(plan_->aggregates_, plan_->agg_types_),
-      aht_iterator_(aht_.Begin()) {}
-
-void AggregationExecutor::Init() {
-  child_->Init();
-  Tuple tuple{};
-  RID rid{};
-  while (child_->Next(&tuple, &rid)) {
-    // std::cout<<"**"<<'\n';
-    aht_.InsertCombine(MakeAggregateKey(&tuple), MakeAggregateValue(&tuple));
-  }
-  aht_iterator_ = aht_.Begin();
-}
-
-auto AggregationExecutor::Next(Tuple *tuple, RID *rid) -> bool {
-  // std::cout<<"agg\n";
-  if (aht_iterator_ == aht_.End()) {
-    if (!plan_->GetGroupBys().empty()) {
-      return false;
-    }
-    if (aht_.Empty() && !is_agg_) {
-      AggregateValue values = aht_.GenerateInitialAggregateValue();
-      *tuple = Tuple(values.aggregates_, &plan_->OutputSchema());
-      *rid = tuple->GetRid();
-      is_agg_ = true;
-      return true;
-    }
-    return false;
-  }
-  auto key = aht_iterator_.Key();
-  auto value = aht_iterator_.Val();
-  std::vector<Value> values;
-  for (const auto &it : key.group_bys_) {
-    values.push_back(it);
-  }
-  for (const auto &it : value.aggregates_) {
-    values.push_back(it);
-  }
-  *tuple = Tuple(values, &plan_->OutputSchema());
-  *rid = tuple->GetRid();
-  ++aht_iterator_;
-  return true;
-}
-
-auto AggregationExecutor::GetChildExecutor() const -> const AbstractExecutor * { return child_.get(); }
-
-}  // namespace bustub
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregation_executor.cpp
+//
+// Identification: src/execution/aggregation_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#include <memory>
+#include <vector>
+
+#include "execution/executors/aggregation_executor.h"
+
+namespace bustub {
+
+AggregationExecutor::AggregationExecutor(ExecutorContext *exec_ctx, const AggregationPlanNode *plan,
+                                         std::unique_ptr<AbstractExecutor> &&child)
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      child_(std::move(child)),
+      aht_(plan_->aggregates_, plan_->agg_types_),
+      aht_iterator_(aht_.Begin()) {}
+
+void AggregationExecutor::Init() {
+  child_->Init();
+  TupleBatch batch;
+  while (child_->NextBatch(&batch)) {
+    InsertBatch(batch);
+  }
+  aht_iterator_ = aht_.Begin();
+}
+
+void AggregationExecutor::InsertBatch(const TupleBatch &batch) {
+  const auto &group_bys = plan_->GetGroupBys();
+  const auto &aggregates = plan_->GetAggregates();
+  key_columns_.resize(group_bys.size());
+  value_columns_.resize(aggregates.size());
+  for (size_t i = 0; i < group_bys.size(); i++) {
+    group_bys[i]->EvaluateBatch(batch, &key_columns_[i]);
+  }
+  for (size_t i = 0; i < aggregates.size(); i++) {
+    aggregates[i]->EvaluateBatch(batch, &value_columns_[i]);
+  }
+  AggregateKey key;
+  AggregateValue value;
+  for (auto row : batch.GetSelection()) {
+    key.group_bys_.clear();
+    for (auto &column : key_columns_) {
+      key.group_bys_.push_back(std::move(column[row]));
+    }
+    value.aggregates_.clear();
+    for (auto &column : value_columns_) {
+      value.aggregates_.push_back(std::move(column[row]));
+    }
+    aht_.InsertCombine(key, value);
+  }
+}
+
+auto AggregationExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  // std::cout<<"agg\n";
+  if (aht_iterator_ == aht_.End()) {
+    if (!plan_->GetGroupBys().empty()) {
+      return false;
+    }
+    if (aht_.Empty() && !is_agg_) {
+      AggregateValue values = aht_.GenerateInitialAggregateValue();
+      *tuple = Tuple(values.aggregates_, &plan_->OutputSchema());
+      *rid = tuple->GetRid();
+      is_agg_ = true;
+      return true;
+    }
+    return false;
+  }
+  auto key = aht_iterator_.Key();
+  auto value = aht_iterator_.Val();
+  std::vector<Value> values;
+  for (const auto &it : key.group_bys_) {
+    values.push_back(it);
+  }
+  for (const auto &it : value.aggregates_) {
+    values.push_back(it);
+  }
+  *tuple = Tuple(values, &plan_->OutputSchema());
+  *rid = tuple->GetRid();
+  ++aht_iterator_;
+  return true;
+}
+
+auto AggregationExecutor::NextBatch(TupleBatch *batch) -> bool {
+  batch->Reset(GetOutputSchema().GetColumnCount());
+  if (aht_iterator_ == aht_.End()) {
+    if (plan_->GetGroupBys().empty() && aht_.Empty() && !is_agg_) {
+      batch->AppendRow(std::move(aht_.GenerateInitialAggregateValue().aggregates_));
+      is_agg_ = true;
+      return true;
+    }
+    return false;
+  }
+  for (; aht_iterator_ != aht_.End() && !batch->IsFull(); ++aht_iterator_) {
+    std::vector<Value> values(aht_iterator_.Key().group_bys_);
+    values.insert(values.end(), aht_iterator_.Val().aggregates_.begin(), aht_iterator_.Val().aggregates_.end());
+    batch->AppendRow(std::move(values));
+  }
+  return true;
+}
+
+auto AggregationExecutor::GetChildExecutor() const -> const AbstractExecutor * { return child_.get(); }
+
+}  // namespace bustub
@@ -31,4 +31,24 @@ auto FilterExecutor::Next(Tuple *tuple, RID *rid) -> bool {
   }
 }
 
+auto FilterExecutor::NextBatch(TupleBatch *batch) -> bool {
+  const auto &filter_expr = plan_->GetPredicate();
+  while (child_executor_->NextBatch(batch)) {
+    filter_expr->EvaluateBatch(*batch, &predicate_values_);
+    auto &selection = batch->GetSelectionMut();
+    size_t selected = 0;
+    for (auto row : selection) {
+      const auto &value = predicate_values_[row];
+      if (!value.IsNull() && value.GetAs<bool>()) {
+        selection[selected++] = row;
+      }
+    }
+    selection.resize(selected);
+    if (selected > 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
 }  // namespace bustub
@@ -12,81 +12,310 @@
 
 #include "execution/executors/hash_join_executor.h"
 
+#include <algorithm>
+
+#include "execution/expressions/column_value_expression.h"
+
 // Note for 2022 Fall: You don't need to implement HashJoinExecutor to pass all tests. You ONLY need to implement it
 // if you want to get faster in leaderboard tests.
 
 namespace bustub {
 
+namespace {
+
+auto MakeSpillSchema(const Schema &left_schema) -> Schema {
+  auto columns = left_schema.GetColumns();
+  columns.emplace_back("__matched", TypeId::BOOLEAN);
+  return Schema(columns);
+}
+
+/** Read up to a batch of tuples of the given schema from a temp file. */
+auto ReadBatch(TmpTupleFile::Reader *reader, const Schema &schema, TupleBatch *batch) -> bool {
+  batch->Reset(schema.GetColumnCount());
+  Tuple tuple;
+  while (!batch->IsFull() && reader->Next(&tuple)) {
+    batch->AppendTuple(tuple, schema, RID{});
+  }
+  return batch->GetSize() > 0;
+}
+
+/**
+ * @return the type two join keys of the given types are compared as: INVALID (as they are) if the types are the same
+ * or not both numeric, otherwise DECIMAL if either one is, BIGINT if not
+ */
+auto CommonKeyType(TypeId left, TypeId right) -> TypeId {
+  auto is_numeric = [](TypeId type) {
+    return type == TypeId::TINYINT || type == TypeId::SMALLINT || type == TypeId::INTEGER || type == TypeId::BIGINT ||
+           type == TypeId::DECIMAL;
+  };
+  if (left == right || !is_numeric(left) || !is_numeric(right)) {
+    return TypeId::INVALID;
+  }
+  return left == TypeId::DECIMAL || right == TypeId::DECIMAL ? TypeId::DECIMAL : TypeId::BIGINT;
+}
+
+}  // namespace
+
 HashJoinExecutor::HashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan,
                                    std::unique_ptr<AbstractExecutor> &&left_child,
                                    std::unique_ptr<AbstractExecutor> &&right_child)
     : AbstractExecutor(exec_ctx),
       plan_{plan},
       left_executor_{std::move(left_child)},
-      right_executor_(std::move(right_child)) {
+      right_executor_(std::move(right_child)),
+      left_spill_schema_(MakeSpillSchema(plan->GetLeftPlan()->OutputSchema())),
+      hash_table_(plan->RightJoinKeyExpressions().size(), plan->GetRightPlan()->OutputSchema().GetColumnCount()) {
   if (!(plan->GetJoinType() == JoinType::LEFT || plan->GetJoinType() == JoinType::INNER)) {
     // Note for 2022 Fall: You ONLY need to implement left join and inner join.
     throw bustub::NotImplementedException(fmt::format("join type {} not supported", plan->GetJoinType()));
   }
+  for (size_t i = 0; i < plan->LeftJoinKeyExpressions().size(); i++) {
+    key_types_.push_back(CommonKeyType(plan->LeftJoinKeyExpressions()[i]->GetReturnType(),
+                                       plan->RightJoinKeyExpressions()[i]->GetReturnType()));
+  }
+  if (plan->GetJoinType() == JoinType::INNER) {
+    // The filter hashes and ranges the right keys, and checks the left values as they are; keys of different types,
+    // such as an integer and a decimal, hash apart and do not share a range, so they get no filter.
+    std::vector<uint32_t> column_idxs;
+    for (size_t i = 0; i < plan->LeftJoinKeyExpressions().size(); i++) {
+      const auto &key_expr = plan->LeftJoinKeyExpressions()[i];
+      const auto *column = dynamic_cast<const ColumnValueExpression *>(key_expr.get());
+      if (column == nullptr || key_expr->GetReturnType() != plan->RightJoinKeyExpressions()[i]->GetReturnType()) {
+        return;
+      }
+      column_idxs.push_back(column->GetColIdx());
+    }
+    runtime_filter_ = std::make_shared<RuntimeFilter>();
+    if (!left_executor_->PushRuntimeFilter(runtime_filter_, column_idxs)) {
+      runtime_filter_ = nullptr;
+    }
+  }
 }
 
 void HashJoinExecutor::Init() {
-  left_executor_->Init();
+  // The runtime filter has to be complete before the left side reads any row, and a join below may even read its
+  // right side in Init.
   right_executor_->Init();
+  ResetBatchReader();
+  pending_partitions_.clear();
+  probe_partition_ = SpillPartition{};
+  probe_reader_.reset();
+  left_done_ = false;
+  Build(nullptr, 0);
+  left_executor_->Init();
+}
 
-  Tuple right_tuple{};
-  RID right_rid{};
-  while (right_executor_->Next(&right_tuple, &right_rid)) {
-    auto join_key = plan_->RightJoinKeyExpression().Evaluate(&right_tuple, plan_->GetRightPlan()->OutputSchema());
-    hash_join_table_[HashUtil::HashValue(&join_key)].push_back(right_tuple);
-  }
-  Tuple left_tuple{};
-  RID left_rid{};
-  while (left_executor_->Next(&left_tuple, &left_rid)) {
-    auto join_key = plan_->LeftJoinKeyExpression().Evaluate(&left_tuple, plan_->GetLeftPlan()->OutputSchema());
-    if (hash_join_table_.count(HashUtil::HashValue(&join_key)) > 0) {
-      auto right_tuples = hash_join_table_[HashUtil::HashValue(&join_key)];
-      for (const auto &right_tuple : right_tuples) {
-        auto right_join_key =
-            plan_->RightJoinKeyExpression().Evaluate(&right_tuple, plan_->GetRightPlan()->OutputSchema());
-        if (right_join_key.CompareEquals(join_key) == CmpBool::CmpTrue) {
-          std::vector<Value> values;
-          for (uint32_t i = 0; i < plan_->GetLeftPlan()->OutputSchema().GetColumnCount(); i++) {
-            values.push_back(left_tuple.GetValue(&plan_->GetLeftPlan()->OutputSchema(), i));
-          }
-          for (uint32_t i = 0; i < plan_->GetRightPlan()->OutputSchema().GetColumnCount(); i++) {
-            values.push_back(right_tuple.GetValue(&plan_->GetRightPlan()->OutputSchema(), i));
+auto HashJoinExecutor::PushRuntimeFilter(const std::shared_ptr<const RuntimeFilter> &filter,
+                                         const std::vector<uint32_t> &column_idxs) -> bool {
+  const auto left_column_count = plan_->GetLeftPlan()->OutputSchema().GetColumnCount();
+  if (std::all_of(column_idxs.begin(), column_idxs.end(), [&](uint32_t idx) { return idx < left_column_count; })) {
+    return left_executor_->PushRuntimeFilter(filter, column_idxs);
+  }
+  if (plan_->GetJoinType() == JoinType::INNER &&
+      std::all_of(column_idxs.begin(), column_idxs.end(), [&](uint32_t idx) { return idx >= left_column_count; })) {
+    std::vector<uint32_t> right_column_idxs;
+    for (auto column_idx : column_idxs) {
+      right_column_idxs.push_back(column_idx - left_column_count);
+    }
+    return right_executor_->PushRuntimeFilter(filter, right_column_idxs);
+  }
+  return false;
+}
+
+void HashJoinExecutor::Build(TmpTupleFile *right_file, uint32_t level) {
+  const auto &right_schema = plan_->GetRightPlan()->OutputSchema();
+  const auto memory_budget = exec_ctx_->GetMemoryBudget();
+  hash_table_.Clear();
+  partitions_.clear();
+  level_ = level;
+  // The runtime filter covers all right rows, so it is only built by the first pass. The key range is tracked while
+  // the rows come in; the Bloom filter is made from the hash table if nothing was spilled.
+  auto *runtime_filter = level == 0 ? runtime_filter_.get() : nullptr;
+  const bool track_range = runtime_filter != nullptr && plan_->RightJoinKeyExpressions().size() == 1 &&
+                           RuntimeFilter::SupportsRange(plan_->LeftJoinKeyExpressions()[0]->GetReturnType()) &&
+                           RuntimeFilter::SupportsRange(plan_->RightJoinKeyExpressions()[0]->GetReturnType());
+  if (runtime_filter != nullptr) {
+    runtime_filter->Reset();
+    if (track_range) {
+      runtime_filter->EnableRange();
+    }
+  }
+
+  // The join keys of a whole right batch are evaluated at once and stored with the rows.
+  TupleBatch batch;
+  std::vector<std::vector<Value>> key_columns;
+  std::unique_ptr<TmpTupleFile::Reader> reader;
+  if (right_file != nullptr) {
+    reader = std::make_unique<TmpTupleFile::Reader>(right_file);
+  }
+  while (right_file != nullptr ? ReadBatch(reader.get(), right_schema, &batch) : right_executor_->NextBatch(&batch)) {
+    EvaluateKeys(plan_->RightJoinKeyExpressions(), batch, &key_columns);
+    for (auto row : batch.GetSelection()) {
+      if (track_range && !key_columns[0][row].IsNull()) {
+        runtime_filter->AddToRange(key_columns[0][row]);
+      }
+      if (partitions_.empty()) {
+        hash_table_.Insert(key_columns, batch, row);
+        if (memory_budget > 0 && level_ < MAX_SPILL_LEVEL && hash_table_.GetMemoryUsage() > memory_budget) {
+          auto *bpm = exec_ctx_->GetBufferPoolManager();
+          for (size_t i = 0; i < (1U << SPILL_FANOUT_BITS); i++) {
+            partitions_.push_back(
+                {std::make_unique<TmpTupleFile>(bpm), std::make_unique<TmpTupleFile>(bpm), level_});
           }
-          Tuple tuple1 = Tuple(values, &GetOutputSchema());
-          output_tuples_.push_back(tuple1);
         }
+      } else if (!JoinHashTable::HasNull(key_columns, row)) {
+        partitions_[GetPartition(key_columns, row)].right_->Append(batch.ToTuple(row, right_schema));
       }
-    } else if (plan_->GetJoinType() == JoinType::LEFT) {
-      std::vector<Value> values;
-      for (uint32_t i = 0; i < plan_->GetLeftPlan()->OutputSchema().GetColumnCount(); i++) {
-        values.push_back(left_tuple.GetValue(&plan_->GetLeftPlan()->OutputSchema(), i));
-      }
-      for (uint32_t i = 0; i < plan_->GetRightPlan()->OutputSchema().GetColumnCount(); i++) {
-        values.push_back(
-            ValueFactory::GetNullValueByType(plan_->GetRightPlan()->OutputSchema().GetColumn(i).GetType()));
+    }
+  }
+  for (auto &partition : partitions_) {
+    partition.right_->Finish();
+  }
+  if (runtime_filter != nullptr && partitions_.empty()) {
+    runtime_filter->EnableBloom(hash_table_.GetKeyCount());
+    hash_table_.ForEachKeyHash([runtime_filter](hash_t hash) { runtime_filter->AddHash(hash); });
+  }
+
+  left_batch_.Reset(0);
+  left_cursor_ = 0;
+  probing_ = false;
+}
+
+auto HashJoinExecutor::NextProbeBatch() -> bool {
+  if (probe_reader_ != nullptr) {
+    return ReadBatch(probe_reader_.get(), left_spill_schema_, &left_batch_);
+  }
+  return left_executor_->NextBatch(&left_batch_);
+}
+
+auto HashJoinExecutor::NextPass() -> bool {
+  // A partition needs a pass of its own only if both of its sides have rows; a left row is not even spilled if the
+  // right side of its partition is empty.
+  for (auto &partition : partitions_) {
+    partition.left_->Finish();
+    if (partition.left_->GetTupleCount() > 0 && partition.right_->GetTupleCount() > 0) {
+      pending_partitions_.push_back(std::move(partition));
+    }
+  }
+  partitions_.clear();
+  probe_reader_.reset();
+  if (pending_partitions_.empty()) {
+    probe_partition_ = SpillPartition{};
+    return false;
+  }
+  probe_partition_ = std::move(pending_partitions_.back());
+  pending_partitions_.pop_back();
+  Build(probe_partition_.right_.get(), probe_partition_.level_ + 1);
+  probe_partition_.right_.reset();
+  probe_reader_ = std::make_unique<TmpTupleFile::Reader>(probe_partition_.left_.get());
+  return true;
+}
+
+void HashJoinExecutor::EvaluateKeys(const std::vector<AbstractExpressionRef> &key_exprs, const TupleBatch &batch,
+                                    std::vector<std::vector<Value>> *key_columns) const {
+  key_columns->resize(key_exprs.size());
+  for (size_t i = 0; i < key_exprs.size(); i++) {
+    auto &column = (*key_columns)[i];
+    key_exprs[i]->EvaluateBatch(batch, &column);
+    if (key_types_[i] != TypeId::INVALID && key_exprs[i]->GetReturnType() != key_types_[i]) {
+      for (auto row : batch.GetSelection()) {
+        column[row] = column[row].CastAs(key_types_[i]);
       }
-      Tuple tuple1 = Tuple(values, &GetOutputSchema());
-      output_tuples_.push_back(tuple1);
     }
   }
+}
 
-  output_tuples_iter_ = output_tuples_.cbegin();
+auto HashJoinExecutor::NextLeftRow() -> bool {
+  if (left_done_) {
+    return false;
+  }
+  if (probing_) {
+    left_cursor_++;
+  }
+  while (left_cursor_ == left_batch_.NumSelected()) {
+    if (!NextProbeBatch()) {
+      if (!NextPass()) {
+        left_done_ = true;
+        probing_ = false;
+        return false;
+      }
+      continue;
+    }
+    EvaluateKeys(plan_->LeftJoinKeyExpressions(), left_batch_, &left_key_columns_);
+    left_cursor_ = 0;
+  }
+  auto row = left_batch_.GetSelection()[left_cursor_];
+  match_ = hash_table_.Find(left_key_columns_, row);
+  // A spilled row carries whether it matched in the pass that spilled it.
+  matched_ = probe_reader_ != nullptr &&
+             left_batch_.GetValue(row, left_spill_schema_.GetColumnCount() - 1).GetAs<bool>();
+  probing_ = true;
+  return true;
 }
 
-auto HashJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool {
-  // std::cout<<"hash_join\n";
-  if (output_tuples_iter_ == output_tuples_.cend()) {
+auto HashJoinExecutor::SpillLeftRow(uint32_t row) -> bool {
+  if (partitions_.empty() || JoinHashTable::HasNull(left_key_columns_, row)) {
     return false;
   }
-  *tuple = *output_tuples_iter_;
-  *rid = tuple->GetRid();
-  ++output_tuples_iter_;
+  auto &partition = partitions_[GetPartition(left_key_columns_, row)];
+  if (partition.right_->GetTupleCount() == 0) {
+    return false;
+  }
+  const auto left_column_count = left_spill_schema_.GetColumnCount() - 1;
+  std::vector<Value> values;
+  values.reserve(left_column_count + 1);
+  for (uint32_t i = 0; i < left_column_count; i++) {
+    values.push_back(left_batch_.GetValue(row, i));
+  }
+  values.push_back(ValueFactory::GetBooleanValue(matched_));
+  partition.left_->Append(Tuple(values, &left_spill_schema_));
   return true;
 }
 
+auto HashJoinExecutor::NextBatch(TupleBatch *batch) -> bool {
+  const auto &right_schema = plan_->GetRightPlan()->OutputSchema();
+  const auto left_column_count = left_spill_schema_.GetColumnCount() - 1;
+  const auto column_count = GetOutputSchema().GetColumnCount();
+  batch->Reset(column_count);
+
+  auto left_values = [&](uint32_t row) {
+    std::vector<Value> values;
+    values.reserve(column_count);
+    for (uint32_t i = 0; i < left_column_count; i++) {
+      values.push_back(left_batch_.GetValue(row, i));
+    }
+    return values;
+  };
+
+  while (!batch->IsFull()) {
+    // Finished rows are only moved past here, so that a full batch never loses the rest of a row's matches.
+    if ((!probing_ || match_ == JoinHashTable::NO_ROW) && !NextLeftRow()) {
+      break;
+    }
+    auto row = left_batch_.GetSelection()[left_cursor_];
+    // Every row of the chain has the join key of the left row.
+    for (; match_ != JoinHashTable::NO_ROW && !batch->IsFull(); match_ = hash_table_.NextMatch(match_)) {
+      matched_ = true;
+      auto values = left_values(row);
+      for (uint32_t i = 0; i < right_schema.GetColumnCount(); i++) {
+        values.push_back(hash_table_.GetValue(match_, i));
+      }
+      batch->AppendRow(std::move(values));
+    }
+    if (match_ != JoinHashTable::NO_ROW) {
+      break;
+    }
+    if (!SpillLeftRow(row) && !matched_ && plan_->GetJoinType() == JoinType::LEFT) {
+      auto values = left_values(row);
+      for (uint32_t i = 0; i < right_schema.GetColumnCount(); i++) {
+        values.push_back(ValueFactory::GetNullValueByType(right_schema.GetColumn(i).GetType()));
+      }
+      batch->AppendRow(std::move(values));
+    }
+  }
+  return batch->GetSize() > 0;
+}
+
+auto HashJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool { return NextFromBatch(tuple, rid); }
+
 }  // namespace bustub
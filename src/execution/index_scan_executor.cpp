@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 #include "execution/executors/index_scan_executor.h"
+#include "common/exception.h"
 
 namespace bustub {
 IndexScanExecutor::IndexScanExecutor(ExecutorContext *exec_ctx, const IndexScanPlanNode *plan)
@@ -17,12 +18,37 @@ IndexScanExecutor::IndexScanExecutor(ExecutorContext *exec_ctx, const IndexScanP
       plan_(plan),
       index_info_{this->exec_ctx_->GetCatalog()->GetIndex(plan_->index_oid_)},
       table_info_{this->exec_ctx_->GetCatalog()->GetTable(index_info_->table_name_)},
-      tree_{dynamic_cast<BPlusTreeIndexForOneIntegerColumn *>(index_info_->index_.get())},
-      iter_{tree_->GetBeginIterator()} {}
+      tree_{plan_->pred_key_ == nullptr ? dynamic_cast<BPlusTreeIndexForOneIntegerColumn *>(index_info_->index_.get())
+                                        : nullptr},
+      iter_{tree_ != nullptr ? tree_->GetBeginIterator()
+                             : BPlusTreeIndexIteratorForOneIntegerColumn()} {
+  if (plan_->pred_key_ == nullptr && tree_ == nullptr) {
+    throw NotImplementedException("only B+ tree indexes can be scanned in key order");
+  }
+}
 
-void IndexScanExecutor::Init() {}
+void IndexScanExecutor::Init() {
+  if (plan_->pred_key_ == nullptr) {
+    return;
+  }
+  // Point lookups work on any index type.
+  const auto &key_schema = index_info_->key_schema_;
+  Tuple key({plan_->pred_key_->val_.CastAs(key_schema.GetColumn(0).GetType())}, &key_schema);
+  rids_.clear();
+  cursor_ = 0;
+  index_info_->index_->ScanKey(key, &rids_, exec_ctx_->GetTransaction());
+}
 
 auto IndexScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  if (plan_->pred_key_ != nullptr) {
+    while (cursor_ < rids_.size()) {
+      *rid = rids_[cursor_++];
+      if (table_info_->table_->GetTuple(*rid, tuple, exec_ctx_->GetTransaction())) {
+        return true;
+      }
+    }
+    return false;
+  }
   if (iter_ == tree_->GetEndIterator()) {
     return false;
   }
@@ -1,75 +1,120 @@
-//===----------------------------------------------------------------------===//
-//
-//                         BusTub
-//
-// insert_executor.cpp
-//
-// Identification: src/execution/insert_executor.cpp
-//
-// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
-//
-//===----------------------------------------------------------------------===//
-
-#include <memory>
-
-#include "execution/executors/insert_executor.h"
-
-namespace bustub {
-
-InsertExecutor::InsertExecutor(ExecutorContext *exec_ctx, const InsertPlanNode *plan,
-                               std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {
-  table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->table_oid_);
-}
-
-void InsertExecutor::Init() {
-  child_executor_->Init();
-  try {
-    bool get_lock = exec_ctx_->GetLockManager()->LockTable(
-        exec_ctx_->GetTransaction(), LockManager::LockMode::INTENTION_EXCLUSIVE, table_info_->oid_);
-    if (!get_lock) {
-      throw ExecutionException("Insert Executor Get Table Lock Failed");
-    }
-  } catch (TransactionAbortException &e) {
-    throw ExecutionException("Insert Executor Get Table Lock Failed");
-  }
-}
-
-auto InsertExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool {
-  if (is_insert_) {
-    return false;
-  }
-  is_insert_ = true;
-
-  auto table = exec_ctx_->GetCatalog()->GetTable(plan_->table_oid_);
-  auto indexs = exec_ctx_->GetCatalog()->GetTableIndexes(table->name_);
-  int cnt = 0;
-
-  while (child_executor_->Next(tuple, rid)) {
-    bool is_insert = table->table_->InsertTuple(*tuple, rid, exec_ctx_->GetTransaction());
-    if (is_insert) {
-      try {
-        bool get_lock = exec_ctx_->GetLockManager()->LockRow(exec_ctx_->GetTransaction(),
-                                                             LockManager::LockMode::EXCLUSIVE, table_info_->oid_, *rid);
-        if (!get_lock) {
-          throw ExecutionException("Insert Executor Get Row Lock Failed");
-        }
-      } catch (TransactionAbortException &e) {
-        throw ExecutionException("Insert Executor Get Row Lock Failed");
-      }
-
-      for (auto index : indexs) {
-        Tuple index_tuple = tuple->KeyFromTuple(child_executor_->GetOutputSchema(), index->key_schema_,
-                                                index->index_->GetMetadata()->GetKeyAttrs());
-        index->index_->InsertEntry(index_tuple, *rid, exec_ctx_->GetTransaction());
-      }
-      cnt++;
-    }
-  }
-
-  std::vector<Value> ans{Value(INTEGER, cnt)};
-  *tuple = Tuple(ans, &plan_->OutputSchema());
-  return true;
-}
-
-}  // namespace bustub
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// insert_executor.cpp
+//
+// Identification: src/execution/insert_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include "common/util/memcomparable_util.h"
+#include "execution/executors/insert_executor.h"
+
+namespace bustub {
+
+InsertExecutor::InsertExecutor(ExecutorContext *exec_ctx, const InsertPlanNode *plan,
+                               std::unique_ptr<AbstractExecutor> &&child_executor)
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {
+  table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->table_oid_);
+}
+
+void InsertExecutor::Init() {
+  child_executor_->Init();
+  try {
+    bool get_lock = exec_ctx_->GetLockManager()->LockTable(
+        exec_ctx_->GetTransaction(), LockManager::LockMode::INTENTION_EXCLUSIVE, table_info_->oid_);
+    if (!get_lock) {
+      throw ExecutionException("Insert Executor Get Table Lock Failed");
+    }
+  } catch (TransactionAbortException &e) {
+    throw ExecutionException("Insert Executor Get Table Lock Failed");
+  }
+}
+
+auto InsertExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool {
+  if (is_insert_) {
+    return false;
+  }
+  is_insert_ = true;
+
+  auto indexs = exec_ctx_->GetCatalog()->GetTableIndexes(table_info_->name_);
+  int cnt = 0;
+  std::vector<Tuple> batch;
+  std::vector<RID> rids;
+  batch.reserve(INSERT_BATCH_SIZE);
+
+  bool child_done = false;
+  while (!child_done) {
+    batch.clear();
+    while (batch.size() < INSERT_BATCH_SIZE) {
+      if (!child_executor_->Next(tuple, rid)) {
+        child_done = true;
+        break;
+      }
+      batch.push_back(*tuple);
+    }
+    if (batch.empty()) {
+      break;
+    }
+
+    // A failed insert aborts the transaction; the tuples inserted up to then are still locked and indexed so that
+    // the abort can undo them.
+    if (!table_info_->table_->InsertTuples(batch, &rids, exec_ctx_->GetTransaction())) {
+      child_done = true;
+    }
+    for (const auto &inserted_rid : rids) {
+      try {
+        bool get_lock = exec_ctx_->GetLockManager()->LockRow(
+            exec_ctx_->GetTransaction(), LockManager::LockMode::EXCLUSIVE, table_info_->oid_, inserted_rid);
+        if (!get_lock) {
+          throw ExecutionException("Insert Executor Get Row Lock Failed");
+        }
+      } catch (TransactionAbortException &e) {
+        throw ExecutionException("Insert Executor Get Row Lock Failed");
+      }
+    }
+    for (auto index : indexs) {
+      InsertIndexEntries(index, batch, rids);
+    }
+    cnt += static_cast<int>(rids.size());
+  }
+
+  std::vector<Value> ans{Value(INTEGER, cnt)};
+  *tuple = Tuple(ans, &plan_->OutputSchema());
+  return true;
+}
+
+void InsertExecutor::InsertIndexEntries(IndexInfo *index, const std::vector<Tuple> &batch,
+                                        const std::vector<RID> &rids) {
+  const auto &key_attrs = index->index_->GetMetadata()->GetKeyAttrs();
+  std::vector<Tuple> keys;
+  keys.reserve(rids.size());
+  for (size_t i = 0; i < rids.size(); i++) {
+    keys.push_back(batch[i].KeyFromTuple(child_executor_->GetOutputSchema(), index->key_schema_, key_attrs));
+  }
+
+  // Ordered indexes take the batch in key order, so that consecutive inserts land on the same leaf. The keys are
+  // compared through their memcomparable encoding, which orders them like the index does.
+  std::vector<size_t> order(rids.size());
+  std::iota(order.begin(), order.end(), 0);
+  if (index->index_type_ != IndexType::HashTableIndex) {
+    std::vector<std::vector<uint8_t>> encoded(keys.size());
+    for (size_t i = 0; i < keys.size(); i++) {
+      MemComparableUtil::EncodeTuple(keys[i], &index->key_schema_, &encoded[i]);
+    }
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return encoded[a] < encoded[b]; });
+  }
+  for (auto i : order) {
+    index->index_->InsertEntry(keys[i], rids[i], exec_ctx_->GetTransaction());
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,148 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// join_hash_table.cpp
+//
+// Identification: src/execution/join_hash_table.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/join_hash_table.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace bustub {
+
+void JoinHashTable::Clear() {
+  values_.clear();
+  next_.clear();
+  slots_.clear();
+  key_slots_ = 0;
+  row_bytes_ = 0;
+}
+
+auto JoinHashTable::HashKey(const std::vector<std::vector<Value>> &key_columns, uint32_t row) -> hash_t {
+  hash_t hash = 0;
+  for (const auto &column : key_columns) {
+    hash = HashUtil::CombineHashes(hash, HashUtil::HashValue(&column[row]));
+  }
+  return MixHash(hash);
+}
+
+auto JoinHashTable::HashKey(const std::vector<Value> &key) -> hash_t {
+  hash_t hash = 0;
+  for (const auto &value : key) {
+    hash = HashUtil::CombineHashes(hash, HashUtil::HashValue(&value));
+  }
+  return MixHash(hash);
+}
+
+auto JoinHashTable::MixHash(hash_t hash) -> hash_t {
+  // The low bits pick the slot, but HashBytes barely changes them between nearby integers; mix all bits into them
+  // (the MurmurHash3 finalizer) so that consecutive keys do not pile up in one run of slots.
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+auto JoinHashTable::HasNull(const std::vector<std::vector<Value>> &key_columns, uint32_t row) -> bool {
+  return std::any_of(key_columns.begin(), key_columns.end(),
+                     [row](const std::vector<Value> &column) { return column[row].IsNull(); });
+}
+
+auto JoinHashTable::KeyEquals(uint32_t stored_row, const std::vector<std::vector<Value>> &key_columns,
+                              uint32_t row) const -> bool {
+  const auto *key = &values_[static_cast<size_t>(stored_row) * (key_count_ + column_count_)];
+  for (uint32_t i = 0; i < key_count_; i++) {
+    if (key[i].CompareEquals(key_columns[i][row]) != CmpBool::CmpTrue) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void JoinHashTable::Grow() {
+  std::vector<Slot> old_slots(slots_.empty() ? 16 : slots_.size() * 2);
+  std::swap(slots_, old_slots);
+  const size_t mask = slots_.size() - 1;
+  for (const auto &slot : old_slots) {
+    if (slot.row_ == NO_ROW) {
+      continue;
+    }
+    size_t pos = slot.hash_ & mask;
+    while (slots_[pos].row_ != NO_ROW) {
+      pos = (pos + 1) & mask;
+    }
+    slots_[pos] = slot;
+  }
+}
+
+void JoinHashTable::Insert(const std::vector<std::vector<Value>> &key_columns, const TupleBatch &batch, uint32_t row) {
+  if (HasNull(key_columns, row)) {
+    return;
+  }
+  if ((key_slots_ + 1) * 2 > slots_.size()) {
+    Grow();
+  }
+  auto stored_row = static_cast<uint32_t>(next_.size());
+  for (const auto &column : key_columns) {
+    values_.push_back(column[row]);
+  }
+  for (uint32_t i = 0; i < column_count_; i++) {
+    values_.push_back(batch.GetValue(row, i));
+  }
+  next_.push_back(NO_ROW);
+  row_bytes_ += (key_count_ + column_count_) * sizeof(Value) + sizeof(uint32_t);
+  for (auto it = values_.end() - key_count_ - column_count_; it != values_.end(); ++it) {
+    if (it->GetTypeId() == TypeId::VARCHAR && !it->IsNull()) {
+      row_bytes_ += it->GetLength();
+    }
+  }
+
+  auto hash = HashKey(key_columns, row);
+  const size_t mask = slots_.size() - 1;
+  for (size_t pos = hash & mask;; pos = (pos + 1) & mask) {
+    auto &slot = slots_[pos];
+    if (slot.row_ == NO_ROW) {
+      slot.hash_ = hash;
+      slot.row_ = stored_row;
+      key_slots_++;
+      return;
+    }
+    if (slot.hash_ == hash && KeyEquals(slot.row_, key_columns, row)) {
+      // Chain the row right after the first row of its key.
+      next_[stored_row] = next_[slot.row_];
+      next_[slot.row_] = stored_row;
+      return;
+    }
+  }
+}
+
+auto JoinHashTable::Find(const std::vector<std::vector<Value>> &key_columns, uint32_t row) const -> uint32_t {
+  if (slots_.empty()) {
+    return NO_ROW;
+  }
+  if (HasNull(key_columns, row)) {
+    return NO_ROW;
+  }
+  auto hash = HashKey(key_columns, row);
+  const size_t mask = slots_.size() - 1;
+  for (size_t pos = hash & mask;; pos = (pos + 1) & mask) {
+    const auto &slot = slots_[pos];
+    if (slot.row_ == NO_ROW) {
+      return NO_ROW;
+    }
+    if (slot.hash_ == hash && KeyEquals(slot.row_, key_columns, row)) {
+      return slot.row_;
+    }
+  }
+}
+
+}  // namespace bustub
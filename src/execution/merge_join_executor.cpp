@@ -0,0 +1,202 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// merge_join_executor.cpp
+//
+// Identification: src/execution/merge_join_executor.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/merge_join_executor.h"
+
+#include <algorithm>
+
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+auto HasNull(const std::vector<Value> &key) -> bool {
+  return std::any_of(key.begin(), key.end(), [](const Value &value) { return value.IsNull(); });
+}
+
+}  // namespace
+
+MergeJoinExecutor::MergeJoinExecutor(ExecutorContext *exec_ctx, const MergeJoinPlanNode *plan,
+                                     std::unique_ptr<AbstractExecutor> &&left_child,
+                                     std::unique_ptr<AbstractExecutor> &&right_child)
+    : AbstractExecutor(exec_ctx),
+      plan_{plan},
+      left_executor_{std::move(left_child)},
+      right_executor_(std::move(right_child)) {
+  if (!(plan->GetJoinType() == JoinType::LEFT || plan->GetJoinType() == JoinType::INNER)) {
+    throw bustub::NotImplementedException(fmt::format("join type {} not supported", plan->GetJoinType()));
+  }
+}
+
+void MergeJoinExecutor::Init() {
+  left_executor_->Init();
+  right_executor_->Init();
+  ResetBatchReader();
+  left_batch_.Reset(0);
+  left_cursor_ = 0;
+  left_done_ = false;
+  probing_ = false;
+  row_done_ = true;
+  right_batch_.Reset(0);
+  right_cursor_ = 0;
+  right_done_ = false;
+  run_rows_.clear();
+  has_run_ = false;
+}
+
+void MergeJoinExecutor::EvaluateKeys(const std::vector<AbstractExpressionRef> &key_exprs, const TupleBatch &batch,
+                                     std::vector<std::vector<Value>> *key_columns) {
+  key_columns->resize(key_exprs.size());
+  for (size_t i = 0; i < key_exprs.size(); i++) {
+    key_exprs[i]->EvaluateBatch(batch, &(*key_columns)[i]);
+  }
+}
+
+auto MergeJoinExecutor::GetKey(const std::vector<std::vector<Value>> &key_columns, uint32_t row)
+    -> std::vector<Value> {
+  std::vector<Value> key;
+  key.reserve(key_columns.size());
+  for (const auto &column : key_columns) {
+    key.push_back(column[row]);
+  }
+  return key;
+}
+
+auto MergeJoinExecutor::CompareKeys(const std::vector<Value> &a, const std::vector<Value> &b) -> int {
+  for (size_t i = 0; i < a.size(); i++) {
+    if (a[i].CompareLessThan(b[i]) == CmpBool::CmpTrue) {
+      return -1;
+    }
+    if (a[i].CompareGreaterThan(b[i]) == CmpBool::CmpTrue) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+auto MergeJoinExecutor::HasRightRow() -> bool {
+  while (!right_done_ && right_cursor_ == right_batch_.NumSelected()) {
+    if (!right_executor_->NextBatch(&right_batch_)) {
+      right_done_ = true;
+      break;
+    }
+    EvaluateKeys(plan_->RightJoinKeyExpressions(), right_batch_, &right_key_columns_);
+    right_cursor_ = 0;
+  }
+  return !right_done_;
+}
+
+void MergeJoinExecutor::SeekRun(const std::vector<Value> &key) {
+  if (has_run_ && CompareKeys(key, run_key_) == 0) {
+    return;
+  }
+  const auto right_column_count = plan_->GetRightPlan()->OutputSchema().GetColumnCount();
+  run_key_ = key;
+  run_rows_.clear();
+  has_run_ = true;
+  // Right rows with a smaller key, or with a NULL, match no left row that is still to come.
+  for (; HasRightRow(); right_cursor_++) {
+    auto row = right_batch_.GetSelection()[right_cursor_];
+    auto right_key = GetKey(right_key_columns_, row);
+    if (HasNull(right_key)) {
+      continue;
+    }
+    auto cmp = CompareKeys(right_key, key);
+    if (cmp > 0) {
+      break;
+    }
+    if (cmp == 0) {
+      std::vector<Value> values;
+      values.reserve(right_column_count);
+      for (uint32_t i = 0; i < right_column_count; i++) {
+        values.push_back(right_batch_.GetValue(row, i));
+      }
+      run_rows_.push_back(std::move(values));
+    }
+  }
+}
+
+auto MergeJoinExecutor::NextLeftRow() -> bool {
+  if (left_done_) {
+    return false;
+  }
+  if (probing_) {
+    left_cursor_++;
+  }
+  while (left_cursor_ == left_batch_.NumSelected()) {
+    if (!left_executor_->NextBatch(&left_batch_)) {
+      left_done_ = true;
+      probing_ = false;
+      return false;
+    }
+    EvaluateKeys(plan_->LeftJoinKeyExpressions(), left_batch_, &left_key_columns_);
+    left_cursor_ = 0;
+  }
+  probing_ = true;
+  auto key = GetKey(left_key_columns_, left_batch_.GetSelection()[left_cursor_]);
+  matches_ = !HasNull(key);
+  if (matches_) {
+    SeekRun(key);
+    matches_ = !run_rows_.empty();
+  }
+  run_pos_ = 0;
+  return true;
+}
+
+auto MergeJoinExecutor::NextBatch(TupleBatch *batch) -> bool {
+  const auto &right_schema = plan_->GetRightPlan()->OutputSchema();
+  const auto left_column_count = plan_->GetLeftPlan()->OutputSchema().GetColumnCount();
+  const auto column_count = GetOutputSchema().GetColumnCount();
+  batch->Reset(column_count);
+
+  auto left_values = [&](uint32_t row) {
+    std::vector<Value> values;
+    values.reserve(column_count);
+    for (uint32_t i = 0; i < left_column_count; i++) {
+      values.push_back(left_batch_.GetValue(row, i));
+    }
+    return values;
+  };
+
+  while (!batch->IsFull()) {
+    if (row_done_) {
+      if (!NextLeftRow()) {
+        break;
+      }
+      row_done_ = false;
+    }
+    auto row = left_batch_.GetSelection()[left_cursor_];
+    if (matches_) {
+      for (; run_pos_ < run_rows_.size() && !batch->IsFull(); run_pos_++) {
+        auto values = left_values(row);
+        values.insert(values.end(), run_rows_[run_pos_].begin(), run_rows_[run_pos_].end());
+        batch->AppendRow(std::move(values));
+      }
+      if (run_pos_ < run_rows_.size()) {
+        break;
+      }
+    } else if (plan_->GetJoinType() == JoinType::LEFT) {
+      auto values = left_values(row);
+      for (uint32_t i = 0; i < right_schema.GetColumnCount(); i++) {
+        values.push_back(ValueFactory::GetNullValueByType(right_schema.GetColumn(i).GetType()));
+      }
+      batch->AppendRow(std::move(values));
+    }
+    row_done_ = true;
+  }
+  return batch->GetSize() > 0;
+}
+
+auto MergeJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool { return NextFromBatch(tuple, rid); }
+
+}  // namespace bustub
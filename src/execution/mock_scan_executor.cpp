@@ -397,16 +397,19 @@ void MockScanExecutor::Init() {
 }
 
 auto MockScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
-  if (cursor_ == size_) {
-    // Scan complete
-    return EXECUTOR_EXHAUSTED;
-  }
-  if (shuffled_idx_.empty()) {
-    *tuple = func_(cursor_);
-  } else {
-    *tuple = func_(shuffled_idx_[cursor_]);
-  }
-  ++cursor_;
+  do {
+    if (cursor_ == size_) {
+      // Scan complete
+      return EXECUTOR_EXHAUSTED;
+    }
+    if (shuffled_idx_.empty()) {
+      *tuple = func_(cursor_);
+    } else {
+      *tuple = func_(shuffled_idx_[cursor_]);
+    }
+    ++cursor_;
+  } while (!runtime_filters_.MayPass(
+      [&](uint32_t column_idx) { return tuple->GetValue(&GetOutputSchema(), column_idx); }));
   *rid = MakeDummyRID();
   return EXECUTOR_ACTIVE;
 }
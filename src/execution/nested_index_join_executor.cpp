@@ -20,8 +20,7 @@ NestIndexJoinExecutor::NestIndexJoinExecutor(ExecutorContext *exec_ctx, const Ne
       plan_(plan),
       child_executor_(std::move(child_executor)),
       index_info_{exec_ctx_->GetCatalog()->GetIndex(plan_->index_oid_)},
-      table_info_{exec_ctx_->GetCatalog()->GetTable(index_info_->table_name_)},
-      tree_{dynamic_cast<BPlusTreeIndexForOneIntegerColumn *>(index_info_->index_.get())} {
+      table_info_{exec_ctx_->GetCatalog()->GetTable(index_info_->table_name_)} {
   if (!(plan->GetJoinType() == JoinType::LEFT || plan->GetJoinType() == JoinType::INNER)) {
     // Note for 2022 Fall: You ONLY need to implement left join and inner join.
     throw bustub::NotImplementedException(fmt::format("join type {} not supported", plan->GetJoinType()));
@@ -50,7 +49,7 @@ auto NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool {
     Value value = plan_->KeyPredicate()->Evaluate(&left_tuple_, child_executor_->GetOutputSchema());
     // std::cout << "left_tuple_:" << value.ToString() << '\n';
     Tuple tuple1 = Tuple({value}, index_info_->index_->GetKeySchema());
-    tree_->ScanKey(tuple1, &rids_, exec_ctx_->GetTransaction());
+    index_info_->index_->ScanKey(tuple1, &rids_, exec_ctx_->GetTransaction());
     reverse(rids_.begin(), rids_.end());
     if (!rids_.empty()) {
       Tuple right_tuple;
@@ -11,11 +11,73 @@
 //===----------------------------------------------------------------------===//
 
 #include "execution/executors/nested_loop_join_executor.h"
+
+#include <algorithm>
+#include <numeric>
+
 #include "binder/table_ref/bound_join_ref.h"
 #include "common/exception.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/logic_expression.h"
 
 namespace bustub {
 
+namespace {
+
+constexpr int LEFT_SIDE = 1;
+constexpr int RIGHT_SIDE = 2;
+
+/** @return which sides of the join an expression reads, as a combination of LEFT_SIDE and RIGHT_SIDE */
+auto SidesOf(const AbstractExpression &expr) -> int {
+  if (const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(&expr); column_expr != nullptr) {
+    return column_expr->GetTupleIdx() == 0 ? LEFT_SIDE : RIGHT_SIDE;
+  }
+  int sides = 0;
+  for (const auto &child : expr.GetChildren()) {
+    sides |= SidesOf(*child);
+  }
+  return sides;
+}
+
+/** @return the comparison that holds for (b, a) whenever type holds for (a, b) */
+auto Flip(ComparisonType type) -> ComparisonType {
+  switch (type) {
+    case ComparisonType::LessThan:
+      return ComparisonType::GreaterThan;
+    case ComparisonType::LessThanOrEqual:
+      return ComparisonType::GreaterThanOrEqual;
+    case ComparisonType::GreaterThan:
+      return ComparisonType::LessThan;
+    case ComparisonType::GreaterThanOrEqual:
+      return ComparisonType::LessThanOrEqual;
+    default:
+      return type;
+  }
+}
+
+auto Compare(ComparisonType type, const Value &lhs, const Value &rhs) -> CmpBool {
+  switch (type) {
+    case ComparisonType::Equal:
+      return lhs.CompareEquals(rhs);
+    case ComparisonType::NotEqual:
+      return lhs.CompareNotEquals(rhs);
+    case ComparisonType::LessThan:
+      return lhs.CompareLessThan(rhs);
+    case ComparisonType::LessThanOrEqual:
+      return lhs.CompareLessThanEquals(rhs);
+    case ComparisonType::GreaterThan:
+      return lhs.CompareGreaterThan(rhs);
+    case ComparisonType::GreaterThanOrEqual:
+      return lhs.CompareGreaterThanEquals(rhs);
+    default:
+      BUSTUB_ASSERT(false, "Unsupported comparison type.");
+  }
+}
+
+auto IsTrue(const Value &value) -> bool { return !value.IsNull() && value.GetAs<bool>(); }
+
+}  // namespace
+
 NestedLoopJoinExecutor::NestedLoopJoinExecutor(ExecutorContext *exec_ctx, const NestedLoopJoinPlanNode *plan,
                                                std::unique_ptr<AbstractExecutor> &&left_executor,
                                                std::unique_ptr<AbstractExecutor> &&right_executor)
@@ -27,71 +89,293 @@ NestedLoopJoinExecutor::NestedLoopJoinExecutor(ExecutorContext *exec_ctx, const
     // Note for 2022 Fall: You ONLY need to implement left join and inner join.
     throw bustub::NotImplementedException(fmt::format("join type {} not supported", plan->GetJoinType()));
   }
+  AnalyzePredicate(plan->predicate_);
+
+  // An equality narrows the range the most; otherwise take the column of the first range comparison.
+  for (const auto &comparison : comparisons_) {
+    if (comparison.type_ == ComparisonType::Equal) {
+      band_column_ = comparison.right_column_;
+      break;
+    }
+    if (comparison.type_ != ComparisonType::NotEqual && !band_column_.has_value()) {
+      band_column_ = comparison.right_column_;
+    }
+  }
+  for (auto &comparison : comparisons_) {
+    comparison.banded_ = comparison.right_column_ == band_column_ && comparison.type_ != ComparisonType::NotEqual;
+  }
+}
+
+void NestedLoopJoinExecutor::AnalyzePredicate(const AbstractExpressionRef &expr) {
+  if (const auto *logic_expr = dynamic_cast<const LogicExpression *>(expr.get());
+      logic_expr != nullptr && logic_expr->logic_type_ == LogicType::And) {
+    AnalyzePredicate(expr->GetChildAt(0));
+    AnalyzePredicate(expr->GetChildAt(1));
+    return;
+  }
+  auto sides = SidesOf(*expr);
+  if ((sides & RIGHT_SIDE) == 0) {
+    left_conjuncts_.push_back(expr);
+    return;
+  }
+  if ((sides & LEFT_SIDE) == 0) {
+    right_conjuncts_.push_back(expr);
+    return;
+  }
+  if (const auto *comparison_expr = dynamic_cast<const ComparisonExpression *>(expr.get());
+      comparison_expr != nullptr) {
+    for (uint32_t i = 0; i < 2; i++) {
+      const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(comparison_expr->GetChildAt(i).get());
+      const auto &other = comparison_expr->GetChildAt(1 - i);
+      if (column_expr != nullptr && column_expr->GetTupleIdx() == 1 && (SidesOf(*other) & RIGHT_SIDE) == 0) {
+        auto type = i == 0 ? comparison_expr->comp_type_ : Flip(comparison_expr->comp_type_);
+        comparisons_.push_back({type, column_expr->GetColIdx(), other});
+        return;
+      }
+    }
+  }
+  residual_conjuncts_.push_back(expr);
 }
 
 void NestedLoopJoinExecutor::Init() {
   left_executor_->Init();
   right_executor_->Init();
-  Tuple tuple{};
-  RID rid{};
-  while (right_executor_->Next(&tuple, &rid)) {
-    right_tuples_.push_back(tuple);
+  ResetBatchReader();
+  CacheInner();
+  has_outer_block_ = false;
+}
+
+void NestedLoopJoinExecutor::CacheInner() {
+  const auto &right_schema = right_executor_->GetOutputSchema();
+  inner_columns_.assign(right_schema.GetColumnCount(), {});
+  inner_tuples_.clear();
+  inner_row_count_ = 0;
+
+  TupleBatch batch;
+  std::vector<std::vector<Value>> results(right_conjuncts_.size());
+  while (right_executor_->NextBatch(&batch)) {
+    for (size_t i = 0; i < right_conjuncts_.size(); i++) {
+      right_conjuncts_[i]->EvaluateBatch(batch, &results[i]);
+    }
+    for (auto row : batch.GetSelection()) {
+      // A NULL never compares true, so a row with a NULL band value matches nothing.
+      if (!std::all_of(results.begin(), results.end(), [row](const auto &result) { return IsTrue(result[row]); }) ||
+          (band_column_.has_value() && batch.GetValue(row, *band_column_).IsNull())) {
+        continue;
+      }
+      for (uint32_t i = 0; i < inner_columns_.size(); i++) {
+        inner_columns_[i].push_back(batch.GetValue(row, i));
+      }
+      inner_row_count_++;
+    }
+  }
+
+  if (band_column_.has_value()) {
+    const auto &band = inner_columns_[*band_column_];
+    std::vector<size_t> order(inner_row_count_);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&band](size_t a, size_t b) { return band[a].CompareLessThan(band[b]) == CmpBool::CmpTrue; });
+    for (auto &column : inner_columns_) {
+      std::vector<Value> sorted;
+      sorted.reserve(inner_row_count_);
+      for (auto row : order) {
+        sorted.push_back(column[row]);
+      }
+      column = std::move(sorted);
+    }
+  }
+
+  if (!residual_conjuncts_.empty()) {
+    inner_tuples_.reserve(inner_row_count_);
+    for (size_t row = 0; row < inner_row_count_; row++) {
+      std::vector<Value> values;
+      values.reserve(inner_columns_.size());
+      for (const auto &column : inner_columns_) {
+        values.push_back(column[row]);
+      }
+      inner_tuples_.emplace_back(values, &right_schema);
+    }
   }
-  right_tuples_size_ = right_tuples_.size();
 }
 
-auto NestedLoopJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool {
-  // std::cout<<"LoopJoin"<<'\n';
-  if (right_tuples_index_ >= 0 && right_tuples_index_ < right_tuples_size_) {
-    for (int i = right_tuples_index_; i < right_tuples_size_; i++) {
-      if (IsMatch(&left_tuple_, &right_tuples_[i])) {
-        std::vector<Value> values;
-        for (uint32_t j = 0; j < left_executor_->GetOutputSchema().GetColumnCount(); j++) {
-          values.push_back(left_tuple_.GetValue(&left_executor_->GetOutputSchema(), j));
-        }
-        for (uint32_t j = 0; j < right_executor_->GetOutputSchema().GetColumnCount(); j++) {
-          values.push_back(right_tuples_[i].GetValue(&right_executor_->GetOutputSchema(), j));
-        }
-        *tuple = Tuple(values, &GetOutputSchema());
-        right_tuples_index_ = i + 1;
-        return true;
+auto NestedLoopJoinExecutor::BandBound(const Value &value, bool upper) const -> size_t {
+  const auto &band = inner_columns_[*band_column_];
+  if (upper) {
+    return std::upper_bound(band.begin(), band.end(), value,
+                            [](const Value &a, const Value &b) { return a.CompareLessThan(b) == CmpBool::CmpTrue; }) -
+           band.begin();
+  }
+  return std::lower_bound(band.begin(), band.end(), value,
+                          [](const Value &a, const Value &b) { return a.CompareLessThan(b) == CmpBool::CmpTrue; }) -
+         band.begin();
+}
+
+auto NestedLoopJoinExecutor::NextOuterBlock() -> bool {
+  if (!left_executor_->NextBatch(&left_batch_)) {
+    return false;
+  }
+  const auto size = left_batch_.GetSize();
+  left_keys_.resize(comparisons_.size());
+  for (size_t i = 0; i < comparisons_.size(); i++) {
+    comparisons_[i].left_expr_->EvaluateBatch(left_batch_, &left_keys_[i]);
+  }
+  std::vector<std::vector<Value>> results(left_conjuncts_.size());
+  for (size_t i = 0; i < left_conjuncts_.size(); i++) {
+    left_conjuncts_[i]->EvaluateBatch(left_batch_, &results[i]);
+  }
+
+  range_begin_.assign(size, 0);
+  range_end_.assign(size, 0);
+  matched_.assign(size, false);
+  left_tuples_.clear();
+  if (!residual_conjuncts_.empty()) {
+    left_tuples_.resize(size);
+  }
+  for (auto row : left_batch_.GetSelection()) {
+    if (!std::all_of(results.begin(), results.end(), [row](const auto &result) { return IsTrue(result[row]); })) {
+      continue;
+    }
+    size_t begin = 0;
+    size_t end = inner_row_count_;
+    for (size_t i = 0; i < comparisons_.size() && begin < end; i++) {
+      if (!comparisons_[i].banded_) {
+        continue;
+      }
+      const auto &value = left_keys_[i][row];
+      if (value.IsNull()) {
+        end = begin;
+        break;
+      }
+      // The comparisons read `<band value> <type> value`.
+      switch (comparisons_[i].type_) {
+        case ComparisonType::Equal:
+          begin = std::max(begin, BandBound(value, false));
+          end = std::min(end, BandBound(value, true));
+          break;
+        case ComparisonType::LessThan:
+          end = std::min(end, BandBound(value, false));
+          break;
+        case ComparisonType::LessThanOrEqual:
+          end = std::min(end, BandBound(value, true));
+          break;
+        case ComparisonType::GreaterThan:
+          begin = std::max(begin, BandBound(value, true));
+          break;
+        case ComparisonType::GreaterThanOrEqual:
+          begin = std::max(begin, BandBound(value, false));
+          break;
+        default:
+          break;
       }
     }
+    range_begin_[row] = begin;
+    range_end_[row] = std::max(begin, end);
+    if (!residual_conjuncts_.empty()) {
+      left_tuples_[row] = left_batch_.ToTuple(row, left_executor_->GetOutputSchema());
+    }
+  }
+  block_begin_ = 0;
+  outer_pos_ = 0;
+  inner_row_ = 0;
+  pad_pos_ = 0;
+  return true;
+}
+
+auto NestedLoopJoinExecutor::IsMatch(uint32_t row, size_t inner_row) const -> bool {
+  for (size_t i = 0; i < comparisons_.size(); i++) {
+    const auto &comparison = comparisons_[i];
+    if (!comparison.banded_ &&
+        Compare(comparison.type_, inner_columns_[comparison.right_column_][inner_row], left_keys_[i][row]) !=
+            CmpBool::CmpTrue) {
+      return false;
+    }
+  }
+  return std::all_of(residual_conjuncts_.begin(), residual_conjuncts_.end(), [&](const AbstractExpressionRef &expr) {
+    return IsTrue(expr->EvaluateJoin(&left_tuples_[row], left_executor_->GetOutputSchema(), &inner_tuples_[inner_row],
+                                     right_executor_->GetOutputSchema()));
+  });
+}
+
+auto NestedLoopJoinExecutor::LeftValues(uint32_t row) const -> std::vector<Value> {
+  const auto left_column_count = left_batch_.GetColumnCount();
+  std::vector<Value> values;
+  values.reserve(left_column_count + inner_columns_.size());
+  for (uint32_t i = 0; i < left_column_count; i++) {
+    values.push_back(left_batch_.GetValue(row, i));
   }
-  while (left_executor_->Next(&left_tuple_, rid)) {
-    for (int i = 0; i < right_tuples_size_; i++) {
-      if (IsMatch(&left_tuple_, &right_tuples_[i])) {
-        std::vector<Value> values;
-        for (uint32_t j = 0; j < left_executor_->GetOutputSchema().GetColumnCount(); j++) {
-          values.push_back(left_tuple_.GetValue(&left_executor_->GetOutputSchema(), j));
+  return values;
+}
+
+auto NestedLoopJoinExecutor::NextBatch(TupleBatch *batch) -> bool {
+  const auto &right_schema = right_executor_->GetOutputSchema();
+  batch->Reset(GetOutputSchema().GetColumnCount());
+  // With a band column, the range of a left row is already narrow; it is walked in one go.
+  const auto block_rows = band_column_.has_value() ? std::max<size_t>(inner_row_count_, 1) : INNER_BLOCK_ROWS;
+
+  while (!batch->IsFull()) {
+    if (!has_outer_block_) {
+      if (!NextOuterBlock()) {
+        break;
+      }
+      has_outer_block_ = true;
+    }
+    const auto &selection = left_batch_.GetSelection();
+
+    // Join the outer block with one inner block after the other; the batch may fill up anywhere in between.
+    while (block_begin_ < inner_row_count_ && !batch->IsFull()) {
+      const auto block_end = std::min(block_begin_ + block_rows, inner_row_count_);
+      while (outer_pos_ < selection.size() && !batch->IsFull()) {
+        auto row = selection[outer_pos_];
+        const auto end = std::min(range_end_[row], block_end);
+        inner_row_ = std::max({inner_row_, range_begin_[row], block_begin_});
+        for (; inner_row_ < end && !batch->IsFull(); inner_row_++) {
+          if (IsMatch(row, inner_row_)) {
+            auto values = LeftValues(row);
+            for (const auto &column : inner_columns_) {
+              values.push_back(column[inner_row_]);
+            }
+            batch->AppendRow(std::move(values));
+            matched_[row] = true;
+          }
         }
-        for (uint32_t j = 0; j < right_executor_->GetOutputSchema().GetColumnCount(); j++) {
-          values.push_back(right_tuples_[i].GetValue(&right_executor_->GetOutputSchema(), j));
+        if (inner_row_ < end) {
+          break;
         }
-        *tuple = Tuple(values, &GetOutputSchema());
-        right_tuples_index_ = i + 1;
-        return true;
+        outer_pos_++;
+        inner_row_ = 0;
+      }
+      if (outer_pos_ < selection.size()) {
+        break;
       }
+      outer_pos_ = 0;
+      block_begin_ = block_end;
     }
+    if (block_begin_ < inner_row_count_) {
+      break;
+    }
+
     if (plan_->GetJoinType() == JoinType::LEFT) {
-      std::vector<Value> values;
-      for (uint32_t j = 0; j < left_executor_->GetOutputSchema().GetColumnCount(); j++) {
-        values.push_back(left_tuple_.GetValue(&left_executor_->GetOutputSchema(), j));
+      for (; pad_pos_ < selection.size() && !batch->IsFull(); pad_pos_++) {
+        auto row = selection[pad_pos_];
+        if (matched_[row]) {
+          continue;
+        }
+        auto values = LeftValues(row);
+        for (uint32_t i = 0; i < right_schema.GetColumnCount(); i++) {
+          values.push_back(ValueFactory::GetNullValueByType(right_schema.GetColumn(i).GetType()));
+        }
+        batch->AppendRow(std::move(values));
       }
-      for (uint32_t j = 0; j < right_executor_->GetOutputSchema().GetColumnCount(); j++) {
-        values.push_back(ValueFactory::GetNullValueByType(right_executor_->GetOutputSchema().GetColumn(j).GetType()));
+      if (pad_pos_ < selection.size()) {
+        break;
       }
-      *tuple = Tuple(values, &GetOutputSchema());
-      right_tuples_index_ = -1;
-      return true;
     }
+    has_outer_block_ = false;
   }
-  return false;
-}
-auto NestedLoopJoinExecutor::IsMatch(Tuple *left_tuple, Tuple *right_tuple) -> bool {
-  auto value = plan_->Predicate().EvaluateJoin(left_tuple, left_executor_->GetOutputSchema(), right_tuple,
-                                               right_executor_->GetOutputSchema());
-  return !value.IsNull() && value.GetAs<bool>();
+  return batch->GetSize() > 0;
 }
 
+auto NestedLoopJoinExecutor::Next(Tuple *tuple, RID *rid) -> bool { return NextFromBatch(tuple, rid); }
+
 }  // namespace bustub
@@ -1,4 +1,5 @@
 #include "execution/executors/projection_executor.h"
+#include "execution/expressions/column_value_expression.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -12,11 +13,22 @@ void ProjectionExecutor::Init() {
   child_executor_->Init();
 }
 
-auto ProjectionExecutor::Next(Tuple *tuple, RID *rid) -> bool {
-  Tuple child_tuple{};
+auto ProjectionExecutor::PushRuntimeFilter(const std::shared_ptr<const RuntimeFilter> &filter,
+                                           const std::vector<uint32_t> &column_idxs) -> bool {
+  std::vector<uint32_t> child_column_idxs;
+  for (auto column_idx : column_idxs) {
+    const auto *column = dynamic_cast<const ColumnValueExpression *>(plan_->GetExpressions()[column_idx].get());
+    if (column == nullptr) {
+      return false;
+    }
+    child_column_idxs.push_back(column->GetColIdx());
+  }
+  return child_executor_->PushRuntimeFilter(filter, child_column_idxs);
+}
 
+auto ProjectionExecutor::Next(Tuple *tuple, RID *rid) -> bool {
   // Get the next tuple
-  const auto status = child_executor_->Next(&child_tuple, rid);
+  const auto status = child_executor_->Next(&child_tuple_, rid);
 
   if (!status) {
     return false;
@@ -26,11 +38,24 @@ auto ProjectionExecutor::Next(Tuple *tuple, RID *rid) -> bool {
   std::vector<Value> values{};
   values.reserve(GetOutputSchema().GetColumnCount());
   for (const auto &expr : plan_->GetExpressions()) {
-    values.push_back(expr->Evaluate(&child_tuple, child_executor_->GetOutputSchema()));
+    values.push_back(expr->Evaluate(&child_tuple_, child_executor_->GetOutputSchema()));
   }
 
   *tuple = Tuple{values, &GetOutputSchema()};
 
   return true;
 }
+
+auto ProjectionExecutor::NextBatch(TupleBatch *batch) -> bool {
+  if (!child_executor_->NextBatch(&child_batch_)) {
+    return false;
+  }
+  const auto &exprs = plan_->GetExpressions();
+  batch->Reset(exprs.size());
+  batch->CopyRowsFrom(child_batch_);
+  for (size_t i = 0; i < exprs.size(); i++) {
+    exprs[i]->EvaluateBatch(child_batch_, &batch->GetColumnMut(i));
+  }
+  return true;
+}
 }  // namespace bustub
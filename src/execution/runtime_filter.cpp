@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// runtime_filter.cpp
+//
+// Identification: src/execution/runtime_filter.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/runtime_filter.h"
+
+#include <algorithm>
+
+#include "common/macros.h"
+#include "execution/join_hash_table.h"
+
+namespace bustub {
+
+namespace {
+
+auto AsInt64(const Value &value) -> int64_t {
+  switch (value.GetTypeId()) {
+    case TypeId::TINYINT:
+      return value.GetAs<int8_t>();
+    case TypeId::SMALLINT:
+      return value.GetAs<int16_t>();
+    case TypeId::INTEGER:
+      return value.GetAs<int32_t>();
+    case TypeId::BIGINT:
+      return value.GetAs<int64_t>();
+    default:
+      UNREACHABLE("not an integer type");
+  }
+}
+
+}  // namespace
+
+void RuntimeFilter::Reset() {
+  bloom_.clear();
+  has_range_ = false;
+}
+
+void RuntimeFilter::EnableBloom(size_t key_count) {
+  // About 8 bits per key, which with 3 probes passes some 3% of the keys that are not there.
+  size_t words = 1;
+  while (words * 64 < key_count * 8) {
+    words *= 2;
+  }
+  bloom_.assign(words, 0);
+}
+
+void RuntimeFilter::AddHash(hash_t hash) {
+  const size_t mask = bloom_.size() * 64 - 1;
+  // Double hashing: the probes step through the filter by the high half of the hash.
+  const hash_t step = (hash >> 32) | 1;
+  for (uint32_t i = 0; i < NUM_PROBES; i++, hash += step) {
+    bloom_[(hash & mask) / 64] |= uint64_t{1} << (hash % 64);
+  }
+}
+
+void RuntimeFilter::EnableRange() {
+  has_range_ = true;
+  min_ = std::numeric_limits<int64_t>::max();
+  max_ = std::numeric_limits<int64_t>::min();
+}
+
+void RuntimeFilter::AddToRange(const Value &key) {
+  auto value = AsInt64(key);
+  min_ = std::min(min_, value);
+  max_ = std::max(max_, value);
+}
+
+auto RuntimeFilter::MayContain(const std::vector<Value> &key) const -> bool {
+  if (bloom_.empty() && !has_range_) {
+    return true;
+  }
+  if (std::any_of(key.begin(), key.end(), [](const Value &value) { return value.IsNull(); })) {
+    return false;
+  }
+  if (has_range_) {
+    auto value = AsInt64(key[0]);
+    if (value < min_ || value > max_) {
+      return false;
+    }
+  }
+  if (!bloom_.empty()) {
+    const size_t mask = bloom_.size() * 64 - 1;
+    auto hash = JoinHashTable::HashKey(key);
+    const hash_t step = (hash >> 32) | 1;
+    for (uint32_t i = 0; i < NUM_PROBES; i++, hash += step) {
+      if ((bloom_[(hash & mask) / 64] & (uint64_t{1} << (hash % 64))) == 0) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace bustub
@@ -1,69 +1,174 @@
-//===----------------------------------------------------------------------===//
-//
-//                         BusTub
-//
-// seq_scan_executor.cpp
-//
-// Identification: src/execution/seq_scan_executor.cpp
-//
-// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
-//
-//===----------------------------------------------------------------------===//
-
-#include "execution/executors/seq_scan_executor.h"
-
-namespace bustub {
-
-SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan)
-    : AbstractExecutor(exec_ctx), plan_(plan) {
-  table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->table_oid_);
-}
-
-void SeqScanExecutor::Init() {
-  if (exec_ctx_->GetTransaction()->GetIsolationLevel() == IsolationLevel::READ_COMMITTED ||
-      exec_ctx_->GetTransaction()->GetIsolationLevel() == IsolationLevel::REPEATABLE_READ) {
-    try {
-      bool get_lock = exec_ctx_->GetLockManager()->LockTable(
-          exec_ctx_->GetTransaction(), LockManager::LockMode::INTENTION_SHARED, table_info_->oid_);
-      if (!get_lock) {
-        throw ExecutionException("SeqScan Executor Get Table Lock Failed");
-      }
-    } catch (TransactionAbortException &e) {
-      throw ExecutionException("SeqScan Executor Get Table Lock Failed" + e.GetInfo());
-    }
-  }
-  table_iter_ = table_info_->table_->Begin(exec_ctx_->GetTransaction());
-}
-
-auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
-  if (table_iter_ == table_info_->table_->End()) {
-    if (exec_ctx_->GetTransaction()->GetIsolationLevel() == IsolationLevel::READ_COMMITTED) {
-      // 释放表的意向读锁和行的读锁
-      auto row_set = exec_ctx_->GetTransaction()->GetSharedRowLockSet()->at(table_info_->oid_);
-      for (auto &row_rid : row_set) {
-        exec_ctx_->GetLockManager()->UnlockRow(exec_ctx_->GetTransaction(), table_info_->oid_, row_rid);
-      }
-      exec_ctx_->GetLockManager()->UnlockTable(exec_ctx_->GetTransaction(), table_info_->oid_);
-    }
-    return false;
-  }
-  *tuple = *table_iter_;
-  *rid = tuple->GetRid();
-
-  if (exec_ctx_->GetTransaction()->GetIsolationLevel() == IsolationLevel::READ_COMMITTED ||
-      exec_ctx_->GetTransaction()->GetIsolationLevel() == IsolationLevel::REPEATABLE_READ) {
-    try {
-      bool get_lock = exec_ctx_->GetLockManager()->LockRow(exec_ctx_->GetTransaction(), LockManager::LockMode::SHARED,
-                                                           table_info_->oid_, *rid);
-      if (!get_lock) {
-        throw ExecutionException("SeqScan Executor Get Row Lock Failed");
-      }
-    } catch (TransactionAbortException &e) {
-      throw ExecutionException("SeqScan Executor Get Row Lock Failed");
-    }
-  }
-  ++table_iter_;
-  return true;
-}
-
-}  // namespace bustub
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// seq_scan_executor.cpp
+//
+// Identification: src/execution/seq_scan_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/seq_scan_executor.h"
+
+#include <numeric>
+
+namespace bustub {
+
+SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan)
+    : AbstractExecutor(exec_ctx), plan_(plan) {
+  table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->table_oid_);
+}
+
+void SeqScanExecutor::Init() {
+  if (exec_ctx_->GetTransaction()->GetIsolationLevel() == IsolationLevel::READ_COMMITTED ||
+      exec_ctx_->GetTransaction()->GetIsolationLevel() == IsolationLevel::REPEATABLE_READ) {
+    try {
+      bool get_lock = exec_ctx_->GetLockManager()->LockTable(
+          exec_ctx_->GetTransaction(), LockManager::LockMode::INTENTION_SHARED, table_info_->oid_);
+      if (!get_lock) {
+        throw ExecutionException("SeqScan Executor Get Table Lock Failed");
+      }
+    } catch (TransactionAbortException &e) {
+      throw ExecutionException("SeqScan Executor Get Table Lock Failed" + e.GetInfo());
+    }
+  }
+  // PAX tables are always read column by column; a scan of whole rows reads all of their columns.
+  pax_table_ = dynamic_cast<PaxTableHeap *>(table_info_->table_.get());
+  BUSTUB_ENSURE(plan_->column_ids_.empty() || pax_table_ != nullptr,
+                "Only PAX tables can be scanned column by column.");
+  if (pax_table_ != nullptr) {
+    scan_column_ids_ = plan_->column_ids_;
+    if (scan_column_ids_.empty()) {
+      scan_column_ids_.resize(table_info_->schema_.GetColumnCount());
+      std::iota(scan_column_ids_.begin(), scan_column_ids_.end(), 0);
+    }
+    rids_.clear();
+    cursor_ = 0;
+  }
+  next_page_id_ = table_info_->table_->GetFirstPageId();
+  next_slot_ = 0;
+  ResetBatchReader();
+}
+
+auto SeqScanExecutor::Passes(const Tuple &row) -> bool {
+  const auto &schema = GetOutputSchema();
+  if (!runtime_filters_.MayPass([&](uint32_t column_idx) { return row.GetValue(&schema, column_idx); })) {
+    return false;
+  }
+  if (plan_->filter_predicate_ == nullptr) {
+    return true;
+  }
+  auto value = plan_->filter_predicate_->Evaluate(&row, schema);
+  return !value.IsNull() && value.GetAs<bool>();
+}
+
+void SeqScanExecutor::LockRow(const RID &rid) {
+  if (exec_ctx_->GetTransaction()->GetIsolationLevel() == IsolationLevel::READ_COMMITTED ||
+      exec_ctx_->GetTransaction()->GetIsolationLevel() == IsolationLevel::REPEATABLE_READ) {
+    try {
+      bool get_lock = exec_ctx_->GetLockManager()->LockRow(exec_ctx_->GetTransaction(), LockManager::LockMode::SHARED,
+                                                           table_info_->oid_, rid);
+      if (!get_lock) {
+        throw ExecutionException("SeqScan Executor Get Row Lock Failed");
+      }
+    } catch (TransactionAbortException &e) {
+      throw ExecutionException("SeqScan Executor Get Row Lock Failed");
+    }
+  }
+}
+
+void SeqScanExecutor::ReleaseLocks() {
+  if (exec_ctx_->GetTransaction()->GetIsolationLevel() == IsolationLevel::READ_COMMITTED) {
+    // 释放表的意向读锁和行的读锁
+    auto row_set = exec_ctx_->GetTransaction()->GetSharedRowLockSet()->at(table_info_->oid_);
+    for (auto &row_rid : row_set) {
+      exec_ctx_->GetLockManager()->UnlockRow(exec_ctx_->GetTransaction(), table_info_->oid_, row_rid);
+    }
+    exec_ctx_->GetLockManager()->UnlockTable(exec_ctx_->GetTransaction(), table_info_->oid_);
+  }
+}
+
+auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
+  if (pax_table_ != nullptr) {
+    return NextFromBatch(tuple, rid);
+  }
+  // Like NextBatch, but the row that passes is copied straight from the page into the buffer of the caller's tuple,
+  // which is reused from row to row, so stepping through a table does not allocate per row.
+  auto *table = table_info_->table_.get();
+  bool found = false;
+  while (!found && next_page_id_ != INVALID_PAGE_ID) {
+    next_page_id_ = table->ScanPage(next_page_id_, &next_slot_, [&](const Tuple &view) {
+      if (found) {
+        return false;
+      }
+      if (!Passes(view)) {
+        return true;
+      }
+      *tuple = view;
+      found = true;
+      return true;
+    });
+  }
+  if (!found) {
+    ReleaseLocks();
+    return false;
+  }
+  *rid = tuple->GetRid();
+  LockRow(*rid);
+  return true;
+}
+
+auto SeqScanExecutor::NextBatch(TupleBatch *batch) -> bool {
+  const auto &schema = GetOutputSchema();
+  batch->Reset(schema.GetColumnCount());
+  if (pax_table_ != nullptr) {
+    // Hand out the rest of the current page, then read the next one; a batch never spans two pages, but pages whose
+    // rows all fail the runtime filters are skipped.
+    while (batch->GetSize() == 0 && (cursor_ < rids_.size() || next_page_id_ != INVALID_PAGE_ID)) {
+      while (cursor_ == rids_.size() && next_page_id_ != INVALID_PAGE_ID) {
+        next_page_id_ = pax_table_->ScanColumns(next_page_id_, scan_column_ids_, &columns_, &rids_);
+        cursor_ = 0;
+      }
+      for (; cursor_ < rids_.size() && !batch->IsFull(); cursor_++) {
+        if (!runtime_filters_.MayPass([&](uint32_t column_idx) { return columns_[column_idx][cursor_]; })) {
+          continue;
+        }
+        LockRow(rids_[cursor_]);
+        std::vector<Value> values;
+        values.reserve(columns_.size());
+        for (auto &column : columns_) {
+          values.push_back(std::move(column[cursor_]));
+        }
+        batch->AppendRow(std::move(values), rids_[cursor_]);
+      }
+    }
+  } else {
+    // The runtime filters and the predicate look at the rows inside the pinned page, and only the rows that pass
+    // them are copied into the batch. Row locks are taken once the page is let go, never under its latch.
+    auto *table = table_info_->table_.get();
+    while (!batch->IsFull() && next_page_id_ != INVALID_PAGE_ID) {
+      next_page_id_ = table->ScanPage(next_page_id_, &next_slot_, [&](const Tuple &view) {
+        if (batch->IsFull()) {
+          return false;
+        }
+        if (!Passes(view)) {
+          return true;
+        }
+        batch->AppendTuple(view, schema, view.GetRid());
+        return true;
+      });
+    }
+    for (uint32_t row = 0; row < batch->GetSize(); row++) {
+      LockRow(batch->GetRid(row));
+    }
+  }
+  if (batch->GetSize() == 0) {
+    ReleaseLocks();
+    return false;
+  }
+  return true;
+}
+
+}  // namespace bustub
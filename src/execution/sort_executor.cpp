@@ -1,54 +1,262 @@
 #include "execution/executors/sort_executor.h"
 
+#include <algorithm>
+#include <iterator>
+#include <thread>  // NOLINT
+
 namespace bustub {
 
+namespace {
+
+/** Run fn(0) to fn(count - 1) at the same time, fn(0) on the calling thread, and wait for all of them. */
+template <class Fn>
+void RunWorkers(size_t count, const Fn &fn) {
+  std::vector<std::thread> workers;
+  workers.reserve(count - 1);
+  for (size_t worker = 1; worker < count; worker++) {
+    workers.emplace_back(fn, worker);
+  }
+  fn(0);
+  for (auto &worker : workers) {
+    worker.join();
+  }
+}
+
+/**
+ * Merge path: @return how many of the first `diagonal` rows of the stable merge of a[0, a_size) and b[0, b_size) are
+ * taken from a, found by binary search along the diagonal. On equal keys, the rows of a come first.
+ */
+template <class Entry>
+auto MergePathSplit(const Entry *a, size_t a_size, const Entry *b, size_t b_size, size_t diagonal) -> size_t {
+  size_t low = diagonal > b_size ? diagonal - b_size : 0;
+  size_t high = std::min(diagonal, a_size);
+  while (low < high) {
+    auto mid = low + (high - low) / 2;
+    if (b[diagonal - mid - 1].key_ < a[mid].key_) {
+      high = mid;
+    } else {
+      low = mid + 1;
+    }
+  }
+  return low;
+}
+
+/** A part of a merge of two sorted ranges that one thread writes: a[a_begin, a_end) and b[b_begin, b_end) to out */
+struct MergeSegment {
+  size_t out_;
+  size_t a_begin_;
+  size_t a_end_;
+  size_t b_begin_;
+  size_t b_end_;
+};
+
+}  // namespace
+
 SortExecutor::SortExecutor(ExecutorContext *exec_ctx, const SortPlanNode *plan,
                            std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      child_executor_(std::move(child_executor)),
+      encoder_(plan->GetOrderBy()) {}
 
 void SortExecutor::Init() {
   child_executor_->Init();
-  Tuple tuple{};
-  RID rid{};
-  while (child_executor_->Next(&tuple, &rid)) {
-    child_tuples_.push_back(tuple);
-  }
-  std::sort(child_tuples_.begin(), child_tuples_.end(), [this](const Tuple &l, const Tuple &r) {
-    auto schema = child_executor_->GetOutputSchema();
-    for (auto &[order_by_type, expr] : plan_->GetOrderBy()) {
-      switch (order_by_type) {
-        case OrderByType::INVALID:
-        case OrderByType::DEFAULT:
-        case OrderByType::ASC:
-          if (static_cast<bool>(expr->Evaluate(&l, schema).CompareLessThan(expr->Evaluate(&r, schema)))) {
-            return true;
-          } else if (static_cast<bool>(expr->Evaluate(&l, schema).CompareGreaterThan(expr->Evaluate(&r, schema)))) {
-            return false;
-          }
-          break;
-        case OrderByType::DESC:
-          if (static_cast<bool>(expr->Evaluate(&l, schema).CompareLessThan(expr->Evaluate(&r, schema)))) {
-            return false;
-          } else if (static_cast<bool>(expr->Evaluate(&l, schema).CompareGreaterThan(expr->Evaluate(&r, schema)))) {
-            return true;
-          }
-          break;
+  ResetBatchReader();
+  entries_.clear();
+  entries_size_ = 0;
+  entries_index_ = 0;
+  runs_.clear();
+  sources_.clear();
+  merge_tree_.reset();
+
+  const auto &schema = child_executor_->GetOutputSchema();
+  const auto memory_budget = exec_ctx_->GetMemoryBudget();
+  TupleBatch batch;
+  std::vector<std::string> keys;
+  while (child_executor_->NextBatch(&batch)) {
+    encoder_.EncodeBatch(batch, &keys);
+    for (auto row : batch.GetSelection()) {
+      auto &entry = entries_.emplace_back(SortEntry{std::move(keys[row]), batch.ToTuple(row, schema)});
+      entries_size_ += sizeof(SortEntry) + entry.key_.size() + entry.tuple_.GetLength();
+      if (memory_budget > 0 && entries_size_ > memory_budget) {
+        SpillRun();
       }
     }
-    return false;
+  }
+
+  if (runs_.empty()) {
+    SortEntries();
+    return;
+  }
+  if (!entries_.empty()) {
+    SpillRun();
+  }
+  // Merge groups of runs, keeping them in the order of the input, until one merge can take them all.
+  const auto fan_in = MergeFanIn();
+  while (runs_.size() > fan_in) {
+    std::vector<std::unique_ptr<TmpTupleFile>> merged_runs;
+    for (size_t begin = 0; begin < runs_.size(); begin += fan_in) {
+      merged_runs.push_back(MergeRuns(begin, std::min(begin + fan_in, runs_.size())));
+    }
+    runs_ = std::move(merged_runs);
+  }
+  sources_.resize(runs_.size());
+  for (size_t i = 0; i < runs_.size(); i++) {
+    OpenSource(runs_[i].get(), &sources_[i]);
+  }
+  merge_tree_ = std::make_unique<LoserTree<SourceLess>>(sources_.size(), SourceLess{&sources_});
+  merge_tree_->Build();
+}
+
+void SortExecutor::SortEntries() {
+  auto threads = std::min(exec_ctx_->GetSortThreads(), entries_.size() / MIN_ROWS_PER_THREAD);
+  if (threads > 1) {
+    ParallelSortEntries(threads);
+    return;
+  }
+  std::stable_sort(entries_.begin(), entries_.end(),
+                   [](const SortEntry &a, const SortEntry &b) { return a.key_ < b.key_; });
+}
+
+void SortExecutor::ParallelSortEntries(size_t threads) {
+  auto less = [](const SortEntry &a, const SortEntry &b) { return a.key_ < b.key_; };
+  const auto size = entries_.size();
+  // Chunk i is entries_[bounds[i], bounds[i + 1]); the chunks are in the order of the input.
+  std::vector<size_t> bounds(threads + 1);
+  for (size_t i = 0; i <= threads; i++) {
+    bounds[i] = i * size / threads;
+  }
+  RunWorkers(threads, [&](size_t worker) {
+    std::stable_sort(entries_.begin() + bounds[worker], entries_.begin() + bounds[worker + 1], less);
   });
-  child_tuples_size_ = child_tuples_.size();
-  child_tuples_index_ = 0;
+
+  std::vector<SortEntry> merged(size);
+  while (bounds.size() > 2) {
+    // Chunks 2k and 2k + 1 are merged into chunk k of the next round; a last chunk without a pair is merged with an
+    // empty one. Merging a chunk before the one after it keeps equal keys in the order of the input.
+    const auto chunks = bounds.size() - 1;
+    std::vector<size_t> merged_bounds;
+    for (size_t i = 0; i < chunks; i += 2) {
+      merged_bounds.push_back(bounds[i]);
+    }
+    merged_bounds.push_back(size);
+
+    // Every thread writes rows [worker * size / threads, (worker + 1) * size / threads) of the round. The segments
+    // are all found before any row is moved, as the searches read the keys of the rows the other threads move.
+    std::vector<std::vector<MergeSegment>> segments(threads);
+    for (size_t k = 0; k + 1 < merged_bounds.size(); k++) {
+      const auto *a = entries_.data() + bounds[2 * k];
+      const auto a_size = bounds[std::min(2 * k + 1, chunks)] - bounds[2 * k];
+      const auto *b = a + a_size;
+      const auto b_size = bounds[std::min(2 * k + 2, chunks)] - bounds[2 * k] - a_size;
+      for (size_t worker = 0; worker < threads; worker++) {
+        auto begin = std::max(worker * size / threads, merged_bounds[k]);
+        auto end = std::min((worker + 1) * size / threads, merged_bounds[k + 1]);
+        if (begin >= end) {
+          continue;
+        }
+        auto a_begin = MergePathSplit(a, a_size, b, b_size, begin - merged_bounds[k]);
+        auto a_end = MergePathSplit(a, a_size, b, b_size, end - merged_bounds[k]);
+        segments[worker].push_back(MergeSegment{begin, bounds[2 * k] + a_begin, bounds[2 * k] + a_end,
+                                                bounds[2 * k] + a_size + (begin - merged_bounds[k] - a_begin),
+                                                bounds[2 * k] + a_size + (end - merged_bounds[k] - a_end)});
+      }
+    }
+    RunWorkers(threads, [&](size_t worker) {
+      for (const auto &segment : segments[worker]) {
+        auto rows = entries_.begin();
+        std::merge(std::make_move_iterator(rows + segment.a_begin_), std::make_move_iterator(rows + segment.a_end_),
+                   std::make_move_iterator(rows + segment.b_begin_), std::make_move_iterator(rows + segment.b_end_),
+                   merged.begin() + segment.out_, less);
+      }
+    });
+    entries_.swap(merged);
+    bounds = std::move(merged_bounds);
+  }
+}
+
+void SortExecutor::SpillRun() {
+  SortEntries();
+  auto run = std::make_unique<TmpTupleFile>(exec_ctx_->GetBufferPoolManager());
+  for (const auto &entry : entries_) {
+    run->Append(entry.tuple_);
+  }
+  run->Finish();
+  runs_.push_back(std::move(run));
+  entries_.clear();
+  entries_size_ = 0;
+}
+
+auto SortExecutor::MergeFanIn() const -> size_t {
+  return std::max<size_t>(2, exec_ctx_->GetMemoryBudget() / BUSTUB_PAGE_SIZE);
 }
 
-auto SortExecutor::Next(Tuple *tuple, RID *rid) -> bool {
-  if (child_tuples_index_ == child_tuples_size_) {
-    return false;
+auto SortExecutor::SourceLess::operator()(size_t a, size_t b) const -> bool {
+  const auto &source_a = (*sources_)[a];
+  const auto &source_b = (*sources_)[b];
+  if (source_a.done_ || source_b.done_) {
+    return !source_a.done_ || (source_b.done_ && a < b);
   }
-  *tuple = child_tuples_[child_tuples_index_];
-  *rid = tuple->GetRid();
-  child_tuples_index_++;
-  return true;
+  auto cmp = source_a.key_.compare(source_b.key_);
+  return cmp < 0 || (cmp == 0 && a < b);
 }
 
+void SortExecutor::OpenSource(const TmpTupleFile *run, MergeSource *source) const {
+  source->reader_ = std::make_unique<TmpTupleFile::Reader>(run);
+  source->done_ = false;
+  AdvanceSource(source);
+}
+
+void SortExecutor::AdvanceSource(MergeSource *source) const {
+  // Spilled runs only hold the rows; the keys are encoded again as the rows are read back.
+  if (source->reader_->Next(&source->tuple_)) {
+    source->key_ = encoder_.Encode(source->tuple_, child_executor_->GetOutputSchema());
+  } else {
+    source->done_ = true;
+    source->reader_.reset();
+  }
+}
+
+auto SortExecutor::MergeRuns(size_t begin, size_t end) -> std::unique_ptr<TmpTupleFile> {
+  std::vector<MergeSource> sources(end - begin);
+  for (size_t i = begin; i < end; i++) {
+    OpenSource(runs_[i].get(), &sources[i - begin]);
+  }
+  LoserTree<SourceLess> tree(sources.size(), SourceLess{&sources});
+  tree.Build();
+  auto run = std::make_unique<TmpTupleFile>(exec_ctx_->GetBufferPoolManager());
+  for (auto top = tree.Top(); !sources[top].done_; top = tree.Top()) {
+    run->Append(sources[top].tuple_);
+    AdvanceSource(&sources[top]);
+    tree.Replay();
+  }
+  run->Finish();
+  // The pages of the runs that were merged go back to the buffer pool right away.
+  for (size_t i = begin; i < end; i++) {
+    runs_[i].reset();
+  }
+  return run;
+}
+
+auto SortExecutor::NextBatch(TupleBatch *batch) -> bool {
+  const auto &schema = GetOutputSchema();
+  batch->Reset(schema.GetColumnCount());
+  if (merge_tree_ == nullptr) {
+    for (; entries_index_ < entries_.size() && !batch->IsFull(); entries_index_++) {
+      const auto &tuple = entries_[entries_index_].tuple_;
+      batch->AppendTuple(tuple, schema, tuple.GetRid());
+    }
+    return batch->GetSize() > 0;
+  }
+  for (auto top = merge_tree_->Top(); !sources_[top].done_ && !batch->IsFull(); top = merge_tree_->Top()) {
+    const auto &tuple = sources_[top].tuple_;
+    batch->AppendTuple(tuple, schema, tuple.GetRid());
+    AdvanceSource(&sources_[top]);
+    merge_tree_->Replay();
+  }
+  return batch->GetSize() > 0;
+}
+
+auto SortExecutor::Next(Tuple *tuple, RID *rid) -> bool { return NextFromBatch(tuple, rid); }
+
 }  // namespace bustub
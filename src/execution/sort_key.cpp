@@ -0,0 +1,54 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_key.cpp
+//
+// Identification: src/execution/sort_key.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/sort_key.h"
+
+#include "common/util/memcomparable_util.h"
+
+namespace bustub {
+
+void SortKeyEncoder::AppendValue(const Value &value, OrderByType order_by_type, std::string *key) {
+  // Integers are widened, so that values of different widths in one ORDER BY column compare by their numbers.
+  switch (value.GetTypeId()) {
+    case TypeId::TINYINT:
+    case TypeId::SMALLINT:
+    case TypeId::INTEGER:
+      MemComparableUtil::EncodeValue(value.CastAs(TypeId::BIGINT), key, order_by_type == OrderByType::DESC);
+      return;
+    default:
+      MemComparableUtil::EncodeValue(value, key, order_by_type == OrderByType::DESC);
+  }
+}
+
+auto SortKeyEncoder::Encode(const Tuple &tuple, const Schema &schema) const -> std::string {
+  std::string key;
+  for (const auto &[order_by_type, expr] : order_bys_) {
+    AppendValue(expr->Evaluate(&tuple, schema), order_by_type, &key);
+  }
+  return key;
+}
+
+void SortKeyEncoder::EncodeBatch(const TupleBatch &batch, std::vector<std::string> *keys) const {
+  keys->resize(batch.GetSize());
+  for (auto row : batch.GetSelection()) {
+    (*keys)[row].clear();
+  }
+  std::vector<Value> values;
+  for (const auto &[order_by_type, expr] : order_bys_) {
+    expr->EvaluateBatch(batch, &values);
+    for (auto row : batch.GetSelection()) {
+      AppendValue(values[row], order_by_type, &(*keys)[row]);
+    }
+  }
+}
+
+}  // namespace bustub
@@ -1,56 +1,64 @@
 #include "execution/executors/topn_executor.h"
 
+#include <algorithm>
+
 namespace bustub {
 
 TopNExecutor::TopNExecutor(ExecutorContext *exec_ctx, const TopNPlanNode *plan,
                            std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      child_executor_(std::move(child_executor)),
+      encoder_(plan->GetOrderBy()) {}
+
+auto TopNExecutor::EntryLess(const TopNEntry &a, const TopNEntry &b) -> bool {
+  auto cmp = a.key_.compare(b.key_);
+  return cmp < 0 || (cmp == 0 && a.position_ < b.position_);
+}
 
 void TopNExecutor::Init() {
   child_executor_->Init();
-  Tuple tuple{};
-  RID rid{};
-  while (child_executor_->Next(&tuple, &rid)) {
-    child_tuples_.push_back(tuple);
-  }
-  std::sort(child_tuples_.begin(), child_tuples_.end(), [this](const Tuple &l, const Tuple &r) {
-    auto schema = child_executor_->GetOutputSchema();
-    for (auto &[order_by_type, expr] : plan_->GetOrderBy()) {
-      switch (order_by_type) {
-        case OrderByType::INVALID:
-        case OrderByType::DEFAULT:
-        case OrderByType::ASC:
-          if (static_cast<bool>(expr->Evaluate(&l, schema).CompareLessThan(expr->Evaluate(&r, schema)))) {
-            return true;
-          } else if (static_cast<bool>(expr->Evaluate(&l, schema).CompareGreaterThan(expr->Evaluate(&r, schema)))) {
-            return false;
-          }
-          break;
-        case OrderByType::DESC:
-          if (static_cast<bool>(expr->Evaluate(&l, schema).CompareLessThan(expr->Evaluate(&r, schema)))) {
-            return false;
-          } else if (static_cast<bool>(expr->Evaluate(&l, schema).CompareGreaterThan(expr->Evaluate(&r, schema)))) {
-            return true;
-          }
-          break;
+  ResetBatchReader();
+  entries_.clear();
+  entries_index_ = 0;
+
+  const auto n = plan_->GetN();
+  const auto &schema = child_executor_->GetOutputSchema();
+  TupleBatch batch;
+  std::vector<std::string> keys;
+  size_t position = 0;
+  while (n > 0 && child_executor_->NextBatch(&batch)) {
+    encoder_.EncodeBatch(batch, &keys);
+    for (auto row : batch.GetSelection()) {
+      if (entries_.size() < n) {
+        entries_.push_back(TopNEntry{std::move(keys[row]), position++, batch.ToTuple(row, schema)});
+        std::push_heap(entries_.begin(), entries_.end(), EntryLess);
+        continue;
+      }
+      // A row that is not better than the worst one kept is dropped before it is copied. Rows come in the order of
+      // their positions, so one with a key equal to the top's loses the tie.
+      if (keys[row] >= entries_.front().key_) {
+        position++;
+        continue;
       }
+      std::pop_heap(entries_.begin(), entries_.end(), EntryLess);
+      entries_.back() = TopNEntry{std::move(keys[row]), position++, batch.ToTuple(row, schema)};
+      std::push_heap(entries_.begin(), entries_.end(), EntryLess);
     }
-    return false;
-  });
-  child_tuples_index_ = 0;
-  cnt_ = 0;
+  }
+  std::sort_heap(entries_.begin(), entries_.end(), EntryLess);
 }
 
-auto TopNExecutor::Next(Tuple *tuple, RID *rid) -> bool {
-  // std::cout<<"topn\n";
-  if (cnt_ >= std::min(plan_->GetN(), child_tuples_.size())) {
-    return false;
+auto TopNExecutor::NextBatch(TupleBatch *batch) -> bool {
+  const auto &schema = GetOutputSchema();
+  batch->Reset(schema.GetColumnCount());
+  for (; entries_index_ < entries_.size() && !batch->IsFull(); entries_index_++) {
+    const auto &tuple = entries_[entries_index_].tuple_;
+    batch->AppendTuple(tuple, schema, tuple.GetRid());
   }
-  *tuple = child_tuples_[child_tuples_index_];
-  *rid = tuple->GetRid();
-  child_tuples_index_++;
-  cnt_++;
-  return true;
+  return batch->GetSize() > 0;
 }
 
+auto TopNExecutor::Next(Tuple *tuple, RID *rid) -> bool { return NextFromBatch(tuple, rid); }
+
 }  // namespace bustub
@@ -0,0 +1,53 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch.cpp
+//
+// Identification: src/execution/tuple_batch.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/tuple_batch.h"
+
+namespace bustub {
+
+void TupleBatch::Reset(uint32_t column_count) {
+  columns_.resize(column_count);
+  for (auto &column : columns_) {
+    column.clear();
+  }
+  rids_.clear();
+  selection_.clear();
+}
+
+void TupleBatch::AppendTuple(const Tuple &tuple, const Schema &schema, RID rid) {
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    columns_[i].push_back(tuple.GetValue(&schema, i));
+  }
+  selection_.push_back(rids_.size());
+  rids_.push_back(rid);
+}
+
+void TupleBatch::AppendRow(std::vector<Value> &&values, RID rid) {
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    columns_[i].push_back(std::move(values[i]));
+  }
+  selection_.push_back(rids_.size());
+  rids_.push_back(rid);
+}
+
+auto TupleBatch::ToTuple(uint32_t row, const Schema &schema) const -> Tuple {
+  std::vector<Value> values;
+  values.reserve(columns_.size());
+  for (const auto &column : columns_) {
+    values.push_back(column[row]);
+  }
+  Tuple tuple(values, &schema);
+  tuple.SetRid(rids_[row]);
+  return tuple;
+}
+
+}  // namespace bustub
@@ -9,7 +9,10 @@
 // Copyright (c) 2015-2021, Carnegie Mellon University Database Group
 //
 //===----------------------------------------------------------------------===//
+#include <cstring>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "execution/executors/update_executor.h"
 
@@ -17,12 +20,112 @@ namespace bustub {
 
 UpdateExecutor::UpdateExecutor(ExecutorContext *exec_ctx, const UpdatePlanNode *plan,
                                std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {
-  // As of Fall 2022, you DON'T need to implement update executor to have perfect score in project 3 / project 4.
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {
+  table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->TableOid());
 }
 
-void UpdateExecutor::Init() { throw NotImplementedException("UpdateExecutor is not implemented"); }
+void UpdateExecutor::Init() {
+  child_executor_->Init();
+  is_update_ = false;
+  try {
+    bool is_locked = exec_ctx_->GetLockManager()->LockTable(
+        exec_ctx_->GetTransaction(), LockManager::LockMode::INTENTION_EXCLUSIVE, table_info_->oid_);
+    if (!is_locked) {
+      throw ExecutionException("Update Executor Get Table Lock Failed");
+    }
+  } catch (TransactionAbortException &e) {
+    throw ExecutionException("Update Executor Get Table Lock Failed");
+  }
+}
+
+auto UpdateExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool {
+  if (is_update_) {
+    return false;
+  }
+  is_update_ = true;
+
+  // Read all the tuples to update first: a tuple that is moved to another page must not be seen by the child scan
+  // and updated again.
+  std::vector<std::pair<Tuple, RID>> targets;
+  while (child_executor_->Next(tuple, rid)) {
+    targets.emplace_back(*tuple, *rid);
+  }
 
-auto UpdateExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool { return false; }
+  int cnt = 0;
+  for (const auto &[old_tuple, old_rid] : targets) {
+    try {
+      bool get_lock = exec_ctx_->GetLockManager()->LockRow(
+          exec_ctx_->GetTransaction(), LockManager::LockMode::EXCLUSIVE, table_info_->oid_, old_rid);
+      if (!get_lock) {
+        throw ExecutionException("Update Executor Get Row Lock Failed");
+      }
+    } catch (TransactionAbortException &e) {
+      throw ExecutionException("Update Executor Get Row Lock Failed" + e.GetInfo());
+    }
+    UpdateTuple(old_tuple, old_rid);
+    cnt++;
+  }
+
+  std::vector<Value> ans{Value(INTEGER, cnt)};
+  *tuple = Tuple(ans, &plan_->OutputSchema());
+  return true;
+}
+
+void UpdateExecutor::UpdateTuple(const Tuple &old_tuple, const RID &old_rid) {
+  const auto &schema = child_executor_->GetOutputSchema();
+  std::vector<Value> values;
+  values.reserve(plan_->target_expressions_.size());
+  for (const auto &expr : plan_->target_expressions_) {
+    values.push_back(expr->Evaluate(&old_tuple, schema));
+  }
+  Tuple new_tuple(values, &table_info_->schema_);
+
+  auto txn = exec_ctx_->GetTransaction();
+  RID new_rid = old_rid;
+  if (!table_info_->table_->UpdateTuple(new_tuple, old_rid, txn)) {
+    if (txn->GetState() == TransactionState::ABORTED) {
+      throw ExecutionException("Update Executor Update Tuple Failed");
+    }
+    // Move the tuple to another page. A tuple that no page can take is rejected before the old one is deleted, and
+    // the old one is put back if the new one cannot be inserted, so a failed move never loses the row.
+    if (new_tuple.GetLength() > TablePage::MaxTupleSize()) {
+      txn->SetState(TransactionState::ABORTED);
+      throw ExecutionException("Update Executor Tuple Too Large");
+    }
+    if (!table_info_->table_->MarkDelete(old_rid, txn)) {
+      txn->SetState(TransactionState::ABORTED);
+      throw ExecutionException("Update Executor Move Tuple Failed");
+    }
+    if (!table_info_->table_->InsertTuple(new_tuple, &new_rid, txn)) {
+      table_info_->table_->RollbackDelete(old_rid, txn);
+      txn->GetWriteSet()->pop_back();
+      txn->SetState(TransactionState::ABORTED);
+      throw ExecutionException("Update Executor Move Tuple Failed");
+    }
+    // The old tuple is already marked deleted, so the transaction cannot go on without the lock on the new one.
+    try {
+      bool get_lock =
+          exec_ctx_->GetLockManager()->LockRow(txn, LockManager::LockMode::EXCLUSIVE, table_info_->oid_, new_rid);
+      if (!get_lock) {
+        txn->SetState(TransactionState::ABORTED);
+        throw ExecutionException("Update Executor Get Row Lock Failed");
+      }
+    } catch (TransactionAbortException &e) {
+      throw ExecutionException("Update Executor Get Row Lock Failed" + e.GetInfo());
+    }
+  }
+
+  for (auto index : exec_ctx_->GetCatalog()->GetTableIndexes(table_info_->name_)) {
+    const auto &key_attrs = index->index_->GetMetadata()->GetKeyAttrs();
+    auto old_key = old_tuple.KeyFromTuple(schema, index->key_schema_, key_attrs);
+    auto new_key = new_tuple.KeyFromTuple(table_info_->schema_, index->key_schema_, key_attrs);
+    if (new_rid == old_rid && old_key.GetLength() == new_key.GetLength() &&
+        memcmp(old_key.GetData(), new_key.GetData(), old_key.GetLength()) == 0) {
+      continue;
+    }
+    index->index_->DeleteEntry(old_key, old_rid, txn);
+    index->index_->InsertEntry(new_key, new_rid, txn);
+  }
+}
 
 }  // namespace bustub
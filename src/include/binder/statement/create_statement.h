@@ -21,10 +21,12 @@ namespace bustub {
 
 class CreateStatement : public BoundStatement {
  public:
-  explicit CreateStatement(std::string table, std::vector<Column> columns);
+  explicit CreateStatement(std::string table, std::vector<Column> columns, std::string format = "row");
 
   std::string table_;
   std::vector<Column> columns_;
+  /** Page format of the table, "row" or "pax" */
+  std::string format_;
 
   auto ToString() const -> std::string override;
 };
@@ -20,6 +20,7 @@
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
 #include "storage/page/page.h"
+#include "storage/page/page_guard.h"
 
 namespace bustub {
 
@@ -84,6 +85,34 @@ class BufferPoolManager {
     GradingCallback(callback, CallbackType::AFTER, INVALID_PAGE_ID);
   }
 
+  /**
+   * Fetch a page and keep it pinned for the lifetime of the returned guard.
+   * @param page_id id of page to be fetched
+   * @return a guard holding the page, empty if the page could not be fetched
+   */
+  auto FetchPageBasic(page_id_t page_id) -> BasicPageGuard { return {this, FetchPage(page_id)}; }
+
+  /**
+   * Fetch a page and hold its read latch and pin for the lifetime of the returned guard.
+   * @param page_id id of page to be fetched
+   * @return a guard holding the page, empty if the page could not be fetched
+   */
+  auto FetchPageRead(page_id_t page_id) -> ReadPageGuard { return FetchPageBasic(page_id).UpgradeRead(); }
+
+  /**
+   * Fetch a page and hold its write latch and pin for the lifetime of the returned guard.
+   * @param page_id id of page to be fetched
+   * @return a guard holding the page, empty if the page could not be fetched
+   */
+  auto FetchPageWrite(page_id_t page_id) -> WritePageGuard { return FetchPageBasic(page_id).UpgradeWrite(); }
+
+  /**
+   * Create a new page and keep it pinned for the lifetime of the returned guard.
+   * @param[out] page_id id of created page
+   * @return a guard holding the page, empty if no new page could be created
+   */
+  auto NewPageGuarded(page_id_t *page_id) -> BasicPageGuard { return {this, NewPage(page_id)}; }
+
   /** @return size of the buffer pool */
   virtual auto GetPoolSize() -> size_t = 0;
 
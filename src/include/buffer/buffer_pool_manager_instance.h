@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <list>
 #include <mutex>  // NOLINT
 #include <unordered_map>
@@ -52,6 +53,12 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   /** @brief Return the pointer to all the pages in the buffer pool. */
   auto GetPages() -> Page * { return pages_; }
 
+  /**
+   * @brief Return the number of pages that were still pinned when an instance was destroyed, summed over all instances
+   * of this process. Anything but zero means some caller forgot to unpin a page; the tests check this after each test.
+   */
+  static auto GetLeakedPinnedPages() -> size_t { return leaked_pinned_pages; }
+
  protected:
   // auto GetPageFrameIdFromFreeListOrPool(frame_id_t *frame_id)->bool;
   auto GetFrameId(frame_id_t *frame_id) -> bool;
@@ -164,6 +171,9 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
   std::mutex latch_;
 
+  /** Pages found pinned on destruction, see GetLeakedPinnedPages() */
+  static std::atomic<size_t> leaked_pinned_pages;
+
   /**
    * @brief Allocate a page on disk. Caller should acquire the latch before calling this function.
    * @return the id of the allocated page
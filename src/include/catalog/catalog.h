@@ -21,9 +21,12 @@
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/schema.h"
 #include "container/hash/hash_function.h"
+#include "storage/index/art_index.h"
+#include "storage/index/b_link_tree_index.h"
 #include "storage/index/b_plus_tree_index.h"
 #include "storage/index/extendible_hash_table_index.h"
 #include "storage/index/index.h"
+#include "storage/table/pax_table_heap.h"
 #include "storage/table/table_heap.h"
 
 namespace bustub {
@@ -35,6 +38,16 @@ using table_oid_t = uint32_t;
 using column_oid_t = uint32_t;
 using index_oid_t = uint32_t;
 
+/**
+ * The data structure backing an index.
+ */
+enum class IndexType { BPlusTreeIndex, BLinkTreeIndex, ArtIndex, HashTableIndex };
+
+/**
+ * How the pages of a table store its rows: whole rows (TableHeap) or column by column (PaxTableHeap).
+ */
+enum class TableFormat { Row, Pax };
+
 /**
  * The TableInfo class maintains metadata about a table.
  */
@@ -45,9 +58,11 @@ struct TableInfo {
    * @param name The table name
    * @param table An owning pointer to the table heap
    * @param oid The unique OID for the table
+   * @param format The page format of the table heap
    */
-  TableInfo(Schema schema, std::string name, std::unique_ptr<TableHeap> &&table, table_oid_t oid)
-      : schema_{std::move(schema)}, name_{std::move(name)}, table_{std::move(table)}, oid_{oid} {}
+  TableInfo(Schema schema, std::string name, std::unique_ptr<TableHeap> &&table, table_oid_t oid,
+            TableFormat format = TableFormat::Row)
+      : schema_{std::move(schema)}, name_{std::move(name)}, table_{std::move(table)}, oid_{oid}, format_{format} {}
   /** The table schema */
   Schema schema_;
   /** The table name */
@@ -56,6 +71,8 @@ struct TableInfo {
   std::unique_ptr<TableHeap> table_;
   /** The table OID */
   const table_oid_t oid_;
+  /** The page format of the table heap; a PAX table's heap is a PaxTableHeap */
+  const TableFormat format_;
 };
 
 /**
@@ -70,15 +87,17 @@ struct IndexInfo {
    * @param index_oid The unique OID for the index
    * @param table_name The name of the table on which the index is created
    * @param key_size The size of the index key, in bytes
+   * @param index_type The data structure backing the index
    */
   IndexInfo(Schema key_schema, std::string name, std::unique_ptr<Index> &&index, index_oid_t index_oid,
-            std::string table_name, size_t key_size)
+            std::string table_name, size_t key_size, IndexType index_type = IndexType::BPlusTreeIndex)
       : key_schema_{std::move(key_schema)},
         name_{std::move(name)},
         index_{std::move(index)},
         index_oid_{index_oid},
         table_name_{std::move(table_name)},
-        key_size_{key_size} {}
+        key_size_{key_size},
+        index_type_{index_type} {}
   /** The schema for the index key */
   Schema key_schema_;
   /** The name of the index */
@@ -91,6 +110,8 @@ struct IndexInfo {
   std::string table_name_;
   /** The size of the index key, in bytes */
   const size_t key_size_;
+  /** The data structure backing the index */
+  const IndexType index_type_;
 };
 
 /**
@@ -121,10 +142,11 @@ class Catalog {
    * @param table_name The name of the new table, note that all tables beginning with `__` are reserved for the system.
    * @param schema The schema of the new table
    * @param create_table_heap whether to create a table heap for the new table
+   * @param format the page format of the new table
    * @return A (non-owning) pointer to the metadata for the table
    */
-  auto CreateTable(Transaction *txn, const std::string &table_name, const Schema &schema, bool create_table_heap = true)
-      -> TableInfo * {
+  auto CreateTable(Transaction *txn, const std::string &table_name, const Schema &schema, bool create_table_heap = true,
+                   TableFormat format = TableFormat::Row) -> TableInfo * {
     if (table_names_.count(table_name) != 0) {
       return NULL_TABLE_INFO;
     }
@@ -136,14 +158,18 @@ class Catalog {
     // When create_table_heap == false, it means that we're running binder tests (where no txn will be provided) or
     // we are running shell without buffer pool. We don't need to create TableHeap in this case.
     if (create_table_heap) {
-      table = std::make_unique<TableHeap>(bpm_, lock_manager_, log_manager_, txn);
+      if (format == TableFormat::Pax) {
+        table = std::make_unique<PaxTableHeap>(bpm_, lock_manager_, log_manager_, schema, txn);
+      } else {
+        table = std::make_unique<TableHeap>(bpm_, lock_manager_, log_manager_, txn);
+      }
     }
 
     // Fetch the table OID for the new table
     const auto table_oid = next_table_oid_.fetch_add(1);
 
     // Construct the table information
-    auto meta = std::make_unique<TableInfo>(schema, table_name, std::move(table), table_oid);
+    auto meta = std::make_unique<TableInfo>(schema, table_name, std::move(table), table_oid, format);
     auto *tmp = meta.get();
 
     // Update the internal tracking mechanisms
@@ -196,12 +222,14 @@ class Catalog {
    * @param key_attrs Key attributes
    * @param keysize Size of the key
    * @param hash_function The hash function for the index
+   * @param index_type The data structure backing the index
    * @return A (non-owning) pointer to the metadata of the new table
    */
   template <class KeyType, class ValueType, class KeyComparator>
   auto CreateIndex(Transaction *txn, const std::string &index_name, const std::string &table_name, const Schema &schema,
                    const Schema &key_schema, const std::vector<uint32_t> &key_attrs, std::size_t keysize,
-                   HashFunction<KeyType> hash_function) -> IndexInfo * {
+                   HashFunction<KeyType> hash_function, IndexType index_type = IndexType::BPlusTreeIndex)
+      -> IndexInfo * {
     // Reject the creation request for nonexistent table
     if (table_names_.find(table_name) == table_names_.end()) {
       return NULL_INDEX_INFO;
@@ -221,12 +249,22 @@ class Catalog {
     auto meta = std::make_unique<IndexMetadata>(index_name, table_name, &schema, key_attrs);
 
     // Construct the index, take ownership of metadata
-    // TODO(Kyle): We should update the API for CreateIndex
-    // to allow specification of the index type itself, not
-    // just the key, value, and comparator types
-
-    // TODO(chi): support both hash index and btree index
-    auto index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_);
+    std::unique_ptr<Index> index;
+    switch (index_type) {
+      case IndexType::BPlusTreeIndex:
+        index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_);
+        break;
+      case IndexType::BLinkTreeIndex:
+        index = std::make_unique<BLinkTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_);
+        break;
+      case IndexType::ArtIndex:
+        index = std::make_unique<ArtIndex>(std::move(meta));
+        break;
+      case IndexType::HashTableIndex:
+        index = std::make_unique<ExtendibleHashTableIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_,
+                                                                                              hash_function);
+        break;
+    }
 
     // Populate the index with all tuples in table heap
     auto *table_meta = GetTable(table_name);
@@ -239,8 +277,8 @@ class Catalog {
     const auto index_oid = next_index_oid_.fetch_add(1);
 
     // Construct index information; IndexInfo takes ownership of the Index itself
-    auto index_info =
-        std::make_unique<IndexInfo>(key_schema, index_name, std::move(index), index_oid, table_name, keysize);
+    auto index_info = std::make_unique<IndexInfo>(key_schema, index_name, std::move(index), index_oid, table_name,
+                                                  keysize, index_type);
     auto *tmp = index_info.get();
 
     // Update internal tracking
@@ -298,7 +336,7 @@ class Catalog {
    * @param index_oid The OID of the index for which to query
    * @return A (non-owning) pointer to the metadata for the index
    */
-  auto GetIndex(index_oid_t index_oid) -> IndexInfo * {
+  auto GetIndex(index_oid_t index_oid) const -> IndexInfo * {
     auto index = indexes_.find(index_oid);
     if (index == indexes_.end()) {
       return NULL_INDEX_INFO;
@@ -12,18 +12,23 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cctype>
 #include <iostream>
 #include <memory>
 #include <optional>
 #include <shared_mutex>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <thread>  // NOLINT
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "catalog/catalog.h"
 #include "common/config.h"
+#include "common/exception.h"
 #include "common/util/string_util.h"
 #include "libfort/lib/fort.hpp"
 #include "type/value.h"
@@ -266,6 +271,43 @@ class BustubInstance {
     return variable == "1" || variable == "true" || variable == "yes";
   }
 
+  /** @return whether a session variable holds a count; those are checked when they are set */
+  static auto IsCountSessionVariable(const std::string &key) -> bool {
+    return key == "memory_budget" || key == "sort_threads";
+  }
+
+  /** @return the count held by a session variable; throws if the value is not a number that fits into a size_t */
+  static auto ParseCountSessionVariable(const std::string &key, const std::string &value) -> size_t {
+    if (value.empty() || !std::all_of(value.begin(), value.end(), [](char c) { return std::isdigit(c) != 0; })) {
+      throw Exception(fmt::format("{} must be a number, not {}", key, value));
+    }
+    try {
+      return std::stoull(value);
+    } catch (std::out_of_range &e) {
+      throw Exception(fmt::format("{} is too large: {}", key, value));
+    }
+  }
+
+  /** @return the value of a session variable that holds a count, or default_value if it is unset */
+  auto GetCountSessionVariable(const std::string &key, size_t default_value) -> size_t {
+    auto variable = GetSessionVariable(key);
+    if (variable.empty()) {
+      return default_value;
+    }
+    return ParseCountSessionVariable(key, variable);
+  }
+
+  /** @return the memory budget of an operator in bytes, from `SET memory_budget=<bytes>`; 0 (no limit) if unset */
+  auto GetMemoryBudget() -> size_t { return GetCountSessionVariable("memory_budget", 0); }
+
+  /** @return how many threads a sort may use, from `SET sort_threads=<count>`; 1 if unset, at most max_sort_threads_ */
+  auto GetSortThreads() -> size_t {
+    return std::clamp<size_t>(GetCountSessionVariable("sort_threads", 1), 1, max_sort_threads_);
+  }
+
+  /** The cap on sort_threads, the number of threads the hardware runs at once */
+  size_t max_sort_threads_{std::max<size_t>(std::thread::hardware_concurrency(), 1)};
+
  private:
   void CmdDisplayTables(ResultWriter &writer);
   void CmdDisplayIndices(ResultWriter &writer);
@@ -0,0 +1,127 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// memcomparable_util.h
+//
+// Identification: src/include/common/util/memcomparable_util.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/exception.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * MemComparableUtil encodes values into byte strings whose unsigned lexicographic order (memcmp) matches the order
+ * of the values themselves. The encoding of a whole key is the concatenation of its columns and no encoding is a
+ * prefix of another one, which is what radix trees and normalized sort keys rely on.
+ *
+ * Each column starts with a null marker (0x00 for NULL, 0x01 otherwise, so NULLs sort first), followed by:
+ * - integers: big-endian two's complement with the sign bit flipped
+ * - decimals: big-endian IEEE-754 bits, all bits flipped for negatives and only the sign bit for positives
+ * - varchars: the bytes with 0x00 escaped as 0x00 0xFF, terminated by 0x00 0x00
+ * A descending column has all the bytes of its encoding flipped, which reverses its order and puts NULLs last.
+ *
+ * Encodings are appended to a std::vector<uint8_t> (index keys) or a std::string (sort keys).
+ */
+class MemComparableUtil {
+ public:
+  /** Append the encoding of value to out, in descending order if descending is set. */
+  template <class Bytes>
+  static inline void EncodeValue(const Value &value, Bytes *out, bool descending = false) {
+    const auto begin = out->size();
+    EncodeAscending(value, out);
+    if (descending) {
+      for (auto i = begin; i < out->size(); i++) {
+        (*out)[i] = static_cast<typename Bytes::value_type>(~static_cast<uint8_t>((*out)[i]));
+      }
+    }
+  }
+
+  /** Append the encoding of every column of tuple, which is laid out according to schema, to out. */
+  static inline void EncodeTuple(const Tuple &tuple, const Schema *schema, std::vector<uint8_t> *out) {
+    for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+      EncodeValue(tuple.GetValue(schema, i), out);
+    }
+  }
+
+ private:
+  template <class Bytes>
+  static inline void EncodeAscending(const Value &value, Bytes *out) {
+    if (value.IsNull()) {
+      Append(0x00, out);
+      return;
+    }
+    Append(0x01, out);
+    switch (value.GetTypeId()) {
+      case TypeId::BOOLEAN:
+        Append(static_cast<uint8_t>(value.GetAs<int8_t>()), out);
+        return;
+      case TypeId::TINYINT:
+        AppendBigEndian(static_cast<uint8_t>(value.GetAs<int8_t>()) ^ 0x80U, 1, out);
+        return;
+      case TypeId::SMALLINT:
+        AppendBigEndian(static_cast<uint16_t>(value.GetAs<int16_t>()) ^ 0x8000U, 2, out);
+        return;
+      case TypeId::INTEGER:
+        AppendBigEndian(static_cast<uint32_t>(value.GetAs<int32_t>()) ^ 0x80000000U, 4, out);
+        return;
+      case TypeId::BIGINT:
+        AppendBigEndian(static_cast<uint64_t>(value.GetAs<int64_t>()) ^ (1ULL << 63), 8, out);
+        return;
+      case TypeId::TIMESTAMP:
+        AppendBigEndian(value.GetAs<uint64_t>(), 8, out);
+        return;
+      case TypeId::DECIMAL: {
+        auto decimal = value.GetAs<double>();
+        uint64_t bits;
+        std::memcpy(&bits, &decimal, sizeof(bits));
+        bits = (bits & (1ULL << 63)) != 0 ? ~bits : bits | (1ULL << 63);
+        AppendBigEndian(bits, 8, out);
+        return;
+      }
+      case TypeId::VARCHAR: {
+        const char *data = value.GetData();
+        uint32_t len = value.GetLength() == 0 ? 0 : value.GetLength() - 1;
+        for (uint32_t i = 0; i < len; i++) {
+          Append(static_cast<uint8_t>(data[i]), out);
+          if (data[i] == '\0') {
+            Append(0xFF, out);
+          }
+        }
+        Append(0x00, out);
+        Append(0x00, out);
+        return;
+      }
+      default:
+        throw NotImplementedException("memcomparable encoding is not supported for this type");
+    }
+  }
+
+  template <class Bytes>
+  static inline void Append(uint8_t byte, Bytes *out) {
+    out->push_back(static_cast<typename Bytes::value_type>(byte));
+  }
+
+  template <class Bytes>
+  static inline void AppendBigEndian(uint64_t bits, int bytes, Bytes *out) {
+    for (int i = bytes - 1; i >= 0; i--) {
+      Append(static_cast<uint8_t>(bits >> (i * 8)), out);
+    }
+  }
+};
+
+}  // namespace bustub
@@ -0,0 +1,228 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// adaptive_radix_tree.h
+//
+// Identification: src/include/container/art/adaptive_radix_tree.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * AdaptiveRadixTree is an in-memory radix tree over byte-string keys (Leis et al., ICDE 2013).
+ *
+ * (1) Inner nodes adapt their layout to their fan-out (Node4, Node16, Node48 and Node256) and compress common key
+ *     prefixes. At most ART_MAX_PREFIX_LEN prefix bytes are stored in a node; longer prefixes are checked
+ *     optimistically and verified against the full key kept in every leaf.
+ * (2) Keys must be prefix-free, i.e. no key is a prefix of another one. Memcomparable encodings satisfy this.
+ * (3) Concurrency follows optimistic lock coupling: every node carries a version word, readers never write to shared
+ *     memory and restart when a version changed under them, writers lock at most the node they modify and its
+ *     parent. Replaced nodes and removed leaves are reclaimed by epochs: every operation announces the global epoch
+ *     it started in, and memory retired in an epoch is only freed once no operation that started in or before that
+ *     epoch is still running, so a reader holding a stale pointer always finds valid memory.
+ * (4) Only unique keys are supported.
+ */
+template <typename ValueType>
+class AdaptiveRadixTree {
+ public:
+  AdaptiveRadixTree();
+  ~AdaptiveRadixTree();
+
+  DISALLOW_COPY_AND_MOVE(AdaptiveRadixTree);
+
+  /**
+   * @brief Insert a key-value pair.
+   * @return false if the key is already present
+   */
+  auto Insert(const std::vector<uint8_t> &key, const ValueType &value) -> bool;
+
+  /**
+   * @brief Remove a key and its value.
+   * @return false if the key is not present
+   */
+  auto Remove(const std::vector<uint8_t> &key) -> bool;
+
+  /**
+   * @brief Look up the value associated with a key.
+   * @param[out] value the value associated with the key
+   * @return true if the key is present
+   */
+  auto GetValue(const std::vector<uint8_t> &key, ValueType *value) -> bool;
+
+  /**
+   * @brief Collect the values of up to limit keys that are not less than low, in key order.
+   * @param[out] result the values, cleared first
+   */
+  void Scan(const std::vector<uint8_t> &low, size_t limit, std::vector<ValueType> *result);
+
+  /** @return the number of retired nodes and leaves that are not freed yet */
+  auto GetNumRetired() -> size_t;
+
+  /** Retired memory is reclaimed whenever this many nodes and leaves are waiting */
+  static constexpr size_t ART_RECLAIM_THRESHOLD = 256;
+
+ private:
+  static constexpr uint32_t ART_MAX_PREFIX_LEN = 8;
+  /** Number of operations that can announce their epoch at the same time; more wait for a free slot */
+  static constexpr size_t ART_EPOCH_SLOTS = 64;
+  /** Marks an epoch slot that no operation holds */
+  static constexpr uint64_t ART_IDLE_EPOCH = UINT64_MAX;
+  /** Marks an unused slot in Node48::child_index_ */
+  static constexpr uint8_t ART_EMPTY_SLOT = 48;
+
+  enum class NodeType : uint8_t { NODE4, NODE16, NODE48, NODE256 };
+
+  /**
+   * Header of every inner node. Bit 0 of the version marks the node obsolete, bit 1 marks it write-locked, and the
+   * remaining bits count modifications.
+   */
+  struct Node {
+    explicit Node(NodeType type) : type_(type) {}
+    std::atomic<uint64_t> version_{0b100};
+    const NodeType type_;
+    uint16_t num_children_{0};
+    uint32_t prefix_len_{0};
+    uint8_t prefix_[ART_MAX_PREFIX_LEN]{};
+  };
+
+  /** Up to 4 children; keys are kept sorted. */
+  struct Node4 : public Node {
+    Node4() : Node(NodeType::NODE4) {}
+    uint8_t keys_[4]{};
+    Node *children_[4]{};
+  };
+
+  /** Up to 16 children; keys are kept sorted. */
+  struct Node16 : public Node {
+    Node16() : Node(NodeType::NODE16) {}
+    uint8_t keys_[16]{};
+    Node *children_[16]{};
+  };
+
+  /** Up to 48 children, found through a 256-entry index of slots. */
+  struct Node48 : public Node {
+    Node48() : Node(NodeType::NODE48) {
+      for (auto &slot : child_index_) {
+        slot = ART_EMPTY_SLOT;
+      }
+    }
+    uint8_t child_index_[256];
+    Node *children_[48]{};
+  };
+
+  /** One child pointer per key byte. */
+  struct Node256 : public Node {
+    Node256() : Node(NodeType::NODE256) {}
+    Node *children_[256]{};
+  };
+
+  /**
+   * Leaves are immutable once published and store the full key. They are referenced from child slots through a
+   * pointer whose lowest bit is set.
+   */
+  struct Leaf {
+    ValueType value_;
+    uint32_t key_len_;
+    uint8_t key_[1];
+  };
+
+  /*****************************************************************************
+   * TAGGED POINTERS AND VERSIONS
+   *****************************************************************************/
+  static auto IsLeaf(const Node *node) -> bool { return (reinterpret_cast<uintptr_t>(node) & 1) == 1; }
+  static auto AsLeaf(Node *node) -> Leaf * {
+    return reinterpret_cast<Leaf *>(reinterpret_cast<uintptr_t>(node) & ~1ULL);
+  }
+  static auto LeafToNode(Leaf *leaf) -> Node * {
+    return reinterpret_cast<Node *>(reinterpret_cast<uintptr_t>(leaf) | 1);
+  }
+
+  static auto ReadLockOrRestart(Node *node, bool *need_restart) -> uint64_t;
+  static void CheckOrRestart(Node *node, uint64_t version, bool *need_restart);
+  static void UpgradeToWriteLockOrRestart(Node *node, uint64_t version, bool *need_restart);
+  static void WriteUnlock(Node *node);
+  static void WriteUnlockObsolete(Node *node);
+
+  /*****************************************************************************
+   * NODE OPERATIONS
+   *****************************************************************************/
+  static auto MakeLeaf(const uint8_t *key, uint32_t key_len, const ValueType &value) -> Leaf *;
+  static auto LeafMatches(const Leaf *leaf, const uint8_t *key, uint32_t key_len) -> bool;
+  static auto FindChild(Node *node, uint8_t byte) -> Node *;
+  static void AddChild(Node *node, uint8_t byte, Node *child);
+  static void ChangeChild(Node *node, uint8_t byte, Node *child);
+  static void RemoveChild(Node *node, uint8_t byte);
+  static auto IsFull(const Node *node) -> bool;
+  // Whether the node should move to a smaller layout once one child is removed.
+  static auto IsUnderfullAfterRemove(const Node *node) -> bool;
+  static auto Grow(Node *node) -> Node *;
+  static auto Shrink(Node *node) -> Node *;
+  // Copy the children of node whose key byte is at least from into bytes/children in key order; returns their number.
+  static auto CollectChildren(Node *node, uint8_t from, uint8_t *bytes, Node **children) -> int;
+  static void CopyPrefix(Node *from, Node *to);
+  static void SetPrefix(Node *node, const uint8_t *prefix, uint32_t len);
+  // Any leaf below node; nullptr if a concurrent writer got in the way.
+  static auto AnyLeaf(Node *node) -> Leaf *;
+  // Number of leading prefix bytes of node that match key at depth; nullptr leaf triggers a restart.
+  static auto PrefixMismatch(Node *node, const uint8_t *key, uint32_t key_len, uint32_t depth, bool *need_restart)
+      -> uint32_t;
+  // The complete prefix of a write-locked node at depth.
+  static auto LoadFullPrefix(Node *node, uint32_t depth) -> std::vector<uint8_t>;
+  static void FreeNode(Node *node);
+  static void FreeLeaf(Leaf *leaf);
+  static void FreeSubtree(Node *node);
+
+  /*****************************************************************************
+   * OPTIMISTIC ATTEMPTS, RETRIED BY THE PUBLIC API UNTIL need_restart STAYS FALSE
+   *****************************************************************************/
+  auto InsertAttempt(const uint8_t *key, uint32_t key_len, const ValueType &value, bool *need_restart) -> bool;
+  auto RemoveAttempt(const uint8_t *key, uint32_t key_len, bool *need_restart) -> bool;
+  auto GetValueAttempt(const uint8_t *key, uint32_t key_len, ValueType *value, bool *need_restart) -> bool;
+  void ScanNode(Node *node, uint32_t depth, const std::vector<uint8_t> &low, bool bounded, size_t limit,
+                std::vector<ValueType> *result, bool *need_restart);
+
+  /*****************************************************************************
+   * EPOCH-BASED RECLAMATION
+   *****************************************************************************/
+  /** Announces the current epoch in a free slot for the lifetime of a public operation. */
+  class EpochGuard {
+   public:
+    explicit EpochGuard(AdaptiveRadixTree *tree);
+    ~EpochGuard() { tree_->epoch_slots_[slot_].store(ART_IDLE_EPOCH); }
+    DISALLOW_COPY_AND_MOVE(EpochGuard);
+
+   private:
+    AdaptiveRadixTree *tree_;
+    size_t slot_;
+  };
+
+  // Retired nodes and leaves may still be read by concurrent operations; they are freed once every operation that
+  // could have seen them has finished.
+  void Retire(Node *node);
+  // Free the retired memory that no running operation can reach. Must hold garbage_latch_.
+  void Reclaim(std::vector<Node *> *reclaimed);
+
+  /** The root is a Node256 without prefix that is never replaced. */
+  Node256 *root_;
+  std::atomic<uint64_t> global_epoch_{0};
+  std::atomic<uint64_t> epoch_slots_[ART_EPOCH_SLOTS];
+  std::mutex garbage_latch_;
+  /** Retired nodes and leaves with the epoch they were retired in, oldest first */
+  std::vector<std::pair<uint64_t, Node *>> garbage_;
+};
+
+}  // namespace bustub
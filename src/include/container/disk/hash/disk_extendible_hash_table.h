@@ -20,6 +20,7 @@
 #include "concurrency/transaction.h"
 #include "container/hash/hash_function.h"
 #include "storage/page/hash_table_bucket_page.h"
+#include "storage/page/hash_table_directory_header_page.h"
 #include "storage/page/hash_table_directory_page.h"
 
 namespace bustub {
@@ -30,6 +31,17 @@ namespace bustub {
  * Implementation of extendible hash table that is backed by a buffer pool
  * manager. Non-unique keys are supported. Supports insert and delete. The
  * table grows/shrinks dynamically as buckets become full/empty.
+ *
+ * The directory has two levels: a header page picks a directory page by the
+ * high bits of the hash, and the directory picks the bucket by the low bits.
+ *
+ * Latches are taken header -> directory -> bucket and released in reverse:
+ * (1) lookups, inserts and removes hold their directory in shared mode and
+ *     latch only the bucket they touch, so they run in parallel on
+ *     different buckets;
+ * (2) splits and merges hold their directory exclusively, which also keeps
+ *     every bucket of that directory to themselves; other directories are
+ *     unaffected.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class DiskExtendibleHashTable {
@@ -40,9 +52,11 @@ class DiskExtendibleHashTable {
    * @param buffer_pool_manager buffer pool manager to be used
    * @param comparator comparator for keys
    * @param hash_fn the hash function
+   * @param header_max_depth number of hash bits that select a directory page
    */
   explicit DiskExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
-                                   const KeyComparator &comparator, HashFunction<KeyType> hash_fn);
+                                   const KeyComparator &comparator, HashFunction<KeyType> hash_fn,
+                                   uint32_t header_max_depth = DIRECTORY_HEADER_MAX_DEPTH);
 
   /**
    * Inserts a key-value pair into the hash table.
@@ -75,12 +89,12 @@ class DiskExtendibleHashTable {
   auto GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool;
 
   /**
-   * Returns the global depth
+   * Returns the largest global depth of any directory page
    */
   auto GetGlobalDepth() -> uint32_t;
 
   /**
-   * Helper function to verify the integrity of the extendible hash table's directory.
+   * Helper function to verify the integrity of the extendible hash table's directories.
    */
   void VerifyIntegrity();
 
@@ -122,29 +136,44 @@ class DiskExtendibleHashTable {
   auto KeyToPageId(KeyType key, HashTableDirectoryPage *dir_page) -> page_id_t;
 
   /**
-   * Fetches the directory page from the buffer pool manager.
+   * Find the directory page responsible for a key through the header page.
    *
-   * @return a pointer to the directory page
+   * @param key the key for lookup
+   * @param create whether to create the directory, and its first bucket, if it does not exist yet
+   * @return the page_id of the directory, INVALID_PAGE_ID if it does not exist and create is false
    */
-  auto FetchDirectoryPage() -> HashTableDirectoryPage *;
+  auto KeyToDirectoryPageId(KeyType key, bool create) -> page_id_t;
+
+  /** Fetch a page; throw OUT_OF_MEMORY if every frame of the buffer pool is pinned. */
+  auto FetchPageOrThrow(page_id_t page_id) -> Page *;
 
   /**
-   * Fetches the a bucket page from the buffer pool manager using the bucket's page_id.
-   *
-   * @param bucket_page_id the page_id to fetch
-   * @return a pointer to a bucket page
+   * Fetch a bucket while its directory, or a directory while the header, is pinned and read-latched. If the buffer
+   * pool is full, let go of that parent and throw OUT_OF_MEMORY.
    */
-  auto FetchBucketPage(page_id_t bucket_page_id) -> HASH_TABLE_BUCKET_TYPE *;
+  auto FetchChildOrThrow(page_id_t page_id, Page *parent) -> Page *;
+
+  /** Reinterpret the data of a pinned directory page. */
+  static auto AsDirectory(Page *page) -> HashTableDirectoryPage * {
+    return reinterpret_cast<HashTableDirectoryPage *>(page->GetData());
+  }
+
+  /** Reinterpret the data of a pinned bucket page. */
+  static auto AsBucket(Page *page) -> HASH_TABLE_BUCKET_TYPE * {
+    return reinterpret_cast<HASH_TABLE_BUCKET_TYPE *>(page->GetData());
+  }
 
   /**
    * Performs insertion with an optional bucket splitting.
    *
    * @param transaction a pointer to the current transaction
+   * @param directory_page_id the directory responsible for the key
    * @param key the key to insert
    * @param value the value to insert
    * @return whether or not the insertion was successful
    */
-  auto SplitInsert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool;
+  auto SplitInsert(Transaction *transaction, page_id_t directory_page_id, const KeyType &key, const ValueType &value)
+      -> bool;
 
   /**
    * Optionally merges an empty bucket into it's pair.  This is called by Remove,
@@ -156,18 +185,15 @@ class DiskExtendibleHashTable {
    * 3. The bucket's local depth doesn't match its split image's local depth.
    *
    * @param transaction a pointer to the current transaction
+   * @param directory_page_id the directory responsible for the key
    * @param key the key that was removed
-   * @param value the value that was removed
    */
-  void Merge(Transaction *transaction, const KeyType &key, const ValueType &value);
+  void Merge(Transaction *transaction, page_id_t directory_page_id, const KeyType &key);
 
   // member variables
-  page_id_t directory_page_id_;
+  page_id_t header_page_id_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
-
-  // Readers includes inserts and removes, writers are splits and merges
-  ReaderWriterLatch table_latch_;
   HashFunction<KeyType> hash_fn_;
 };
 
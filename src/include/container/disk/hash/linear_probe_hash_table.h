@@ -12,8 +12,11 @@
 
 #pragma once
 
+#include <atomic>
+#include <mutex>  // NOLINT
 #include <queue>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "buffer/buffer_pool_manager.h"
@@ -29,7 +32,25 @@ namespace bustub {
 /**
  * Implementation of linear probing hash table that is backed by a buffer pool
  * manager. Non-unique keys are supported. Supports insert and delete. The
- * table dynamically grows once full.
+ * table is rebuilt once half of its slots are occupied: at twice the size if
+ * most of them hold live pairs, at the same size if most of them are
+ * tombstones, which the rebuild drops.
+ *
+ * Rebuilding is incremental: a resize allocates a new table next to the current one, and from then on
+ * every Insert and Remove moves MIGRATE_SLOTS_PER_OPERATION slots of the old table into the new one before doing its
+ * own work. New pairs always go to the new table, lookups check both. The table latch is only taken exclusively to
+ * switch between tables, so no operation waits for a whole rehash.
+ *
+ * Block slots are claimed with compare and swap and never reused after a removal until the next rebuild, which lets
+ * GetValue run without page latches. Inserts, removes and migrations of the same key are serialized by a write latch
+ * on the block holding the key's home slot in the current table.
+ *
+ * A table has a single header page, so it never grows past HEADER_BLOCK_ARRAY_SIZE blocks: 1016 blocks with 4 KB
+ * pages, e.g. about 256K slots for 8-byte keys with RIDs. Once it cannot double, inserts go on filling it past half
+ * load, and fail when every slot is taken.
+ *
+ * If the buffer pool has no frame for a page it needs, an operation releases its pages and latches and throws
+ * Exception with ExceptionType::OUT_OF_MEMORY, leaving the table as it was.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class LinearProbeHashTable {
@@ -73,32 +94,94 @@ class LinearProbeHashTable {
   auto GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool;
 
   /**
-   * Resizes the table to at least twice the initial size provided.
+   * Starts resizing the table to at least twice the initial size provided. Pending migration of an earlier resize is
+   * finished first; the new one is carried out by later inserts and removes.
    * @param initial_size the initial size of the hash table
    */
   void Resize(size_t initial_size);
 
   /**
    * Gets the size of the hash table
-   * @return current size of the hash table
+   * @return current size of the hash table, in slots
    */
   auto GetSize() -> size_t;
 
+  /**
+   * @return whether slots of a previous, smaller table are still waiting to be migrated
+   */
+  auto IsResizing() -> bool;
+
  private:
-  auto GetHeaderPage() -> HashTableHeaderPage *;
-  auto GetBlockPage(page_id_t block_page_id) -> HASH_TABLE_BLOCK_TYPE *;
-  void ResizeInsert(HashTableHeaderPage *header_page, const KeyType &key, const ValueType &value);
-  void DeleteBlockPages(HashTableHeaderPage *old_header_page);
-  void CreateNewBlockPages(HashTableHeaderPage *header_page, size_t num_blocks);
-  auto GetValueLatchFree(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool;
+  /** Number of old slots every Insert and Remove migrates while a resize is in progress. */
+  static constexpr size_t MIGRATE_SLOTS_PER_OPERATION = 16;
+
+  auto Hash(const KeyType &key) -> size_t;
+
+  /** Fetch a page; throw OUT_OF_MEMORY if every frame of the buffer pool is pinned. */
+  auto FetchPageOrThrow(page_id_t page_id) -> BasicPageGuard;
+
+  /** Allocate a header and enough zeroed blocks for num_slots; returns INVALID_PAGE_ID if it does not fit. */
+  auto CreateTable(size_t num_slots) -> page_id_t;
+  /** Delete the pages of a retired table, whose block page ids were read while its header was still pinned. */
+  void DeleteTable(page_id_t header_page_id, const std::vector<page_id_t> &block_page_ids);
+
+  /**
+   * Call visit(block, offset) on the slots of key's probe sequence in the table of header_page until it returns false
+   * or every slot was visited. Visited blocks are unpinned dirty if is_dirty is set.
+   */
+  template <typename Visitor>
+  void Probe(HashTableHeaderPage *header_page, const KeyType &key, bool is_dirty, Visitor &&visit);
+
+  /** The block page holding key's home slot, pinned and write-latched. */
+  auto LatchHomeBlock(HashTableHeaderPage *header_page, const KeyType &key) -> WritePageGuard;
+  auto ScanTable(HashTableHeaderPage *header_page, const KeyType &key, std::vector<ValueType> *result) -> bool;
+  auto ContainsPair(HashTableHeaderPage *header_page, const KeyType &key, const ValueType &value) -> bool;
+  auto RemovePair(HashTableHeaderPage *header_page, const KeyType &key, const ValueType &value) -> bool;
+  /** Claim the first free slot of key's probe sequence; false if the table is full. */
+  auto InsertPair(HashTableHeaderPage *header_page, const KeyType &key, const ValueType &value) -> bool;
+
+  /**
+   * Migrate the next MIGRATE_SLOTS_PER_OPERATION old slots if a resize is in progress, and retire the old table once
+   * all of its slots are migrated.
+   * @return false if there was nothing left to hand out
+   */
+  auto MigrateStep() -> bool;
+  /** Hand out the next old slots to migrate: a range a failed step left unfinished, or the next ones in order. */
+  auto NextMigrateRange(size_t old_size) -> std::pair<size_t, size_t>;
+  /**
+   * Replace the table of expected_header_page_id by one of at least num_slots slots. Does nothing if another thread
+   * replaced the table first.
+   * @return false if the new table would not fit in a header page
+   */
+  auto Rebuild(page_id_t expected_header_page_id, size_t num_slots) -> bool;
+
+  /**
+   * @return the size of the table that replaces the current one of size slots once half of it is occupied: the same
+   * size if most occupied slots are tombstones, twice the size otherwise
+   */
+  auto RebuildSize(size_t size) const -> size_t;
 
   // member variable
   page_id_t header_page_id_;
+  // Header of the table that is being migrated into header_page_id_, INVALID_PAGE_ID if no resize is in progress
+  page_id_t old_header_page_id_{INVALID_PAGE_ID};
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
 
-  // Readers includes inserts and removes, writer is only resize
+  // Readers includes inserts, removes and migration, writers only switch tables
   ReaderWriterLatch table_latch_;
+  // Serializes resizes, so that only one new table is allocated at a time
+  std::mutex resize_latch_;
+
+  // Slots claimed in the current table, tombstones included, and the tombstones among them
+  std::atomic<size_t> num_occupied_{0};
+  std::atomic<size_t> num_tombstones_{0};
+  // The next old slot to hand out for migration, and the number of old slots whose migration is done
+  std::atomic<size_t> migrate_cursor_{0};
+  std::atomic<size_t> migrated_slots_{0};
+  // Old slot ranges that a migration step did not finish because the buffer pool was full
+  std::vector<std::pair<size_t, size_t>> unfinished_ranges_;
+  std::mutex unfinished_ranges_latch_;
 
   // Hash function
   HashFunction<KeyType> hash_fn_;
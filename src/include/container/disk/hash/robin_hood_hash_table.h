@@ -0,0 +1,174 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// robin_hood_hash_table.h
+//
+// Identification: src/include/container/disk/hash/robin_hood_hash_table.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "concurrency/transaction.h"
+#include "container/hash/hash_function.h"
+#include "storage/page/hash_table_header_page.h"
+#include "storage/page/hash_table_robin_hood_block_page.h"
+
+namespace bustub {
+
+#define ROBIN_HOOD_HASH_TABLE_TYPE RobinHoodHashTable<KeyType, ValueType, KeyComparator>
+
+/**
+ * Implementation of Robin Hood hashing backed by a buffer pool manager. Non-unique keys are supported, duplicate
+ * key/value pairs are not.
+ *
+ * (1) Pairs are placed by linear probing, but a pair takes over the slot of any pair that is closer to its own home
+ *     slot. The pairs of a cluster therefore stay ordered by home slot: an insert shifts the rest of the cluster back
+ *     by one slot and a removal shifts it forward again (backward-shift deletion), so there are no tombstones.
+ * (2) A lookup stops at the first pair that is closer to its home slot than the probe, so misses are as short as
+ *     hits.
+ * (3) No pair is further than ROBIN_HOOD_MAX_PROBE_DISTANCE from its home slot. An insert that would exceed that
+ *     distance or the maximum load factor doubles the table first.
+ * (4) Lookups share the table latch, inserts and removes take it exclusively. Growing rebuilds the table while
+ *     holding it.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class RobinHoodHashTable {
+ public:
+  /**
+   * Creates a new RobinHoodHashTable
+   *
+   * @param buffer_pool_manager buffer pool manager to be used
+   * @param comparator comparator for keys
+   * @param num_buckets initial number of buckets contained by this hash table
+   * @param hash_fn the hash function
+   * @param max_load_factor fraction of the buckets that may be used before the table grows, below 1
+   */
+  explicit RobinHoodHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
+                              const KeyComparator &comparator, size_t num_buckets, HashFunction<KeyType> hash_fn,
+                              double max_load_factor = 0.9);
+
+  /**
+   * Inserts a key-value pair into the hash table.
+   * @param transaction the current transaction
+   * @param key the key to create
+   * @param value the value to be associated with the key
+   * @return true if insert succeeded, false if the pair exists or the table cannot grow any further
+   */
+  auto Insert(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool;
+
+  /**
+   * Deletes the associated value for the given key.
+   * @param transaction the current transaction
+   * @param key the key to delete
+   * @param value the value to delete
+   * @return true if remove succeeded, false otherwise
+   */
+  auto Remove(Transaction *transaction, const KeyType &key, const ValueType &value) -> bool;
+
+  /**
+   * Performs a point query on the hash table.
+   * @param transaction the current transaction
+   * @param key the key to look up
+   * @param[out] result the value(s) associated with a given key
+   * @return the value(s) associated with the given key
+   */
+  auto GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) -> bool;
+
+  /**
+   * Gets the size of the hash table
+   * @return current size of the hash table, in slots
+   */
+  auto GetSize() -> size_t;
+
+  /**
+   * Computes how far the stored pairs are from their home slots.
+   * @param[out] average the average probe distance, 0 for an empty table
+   * @param[out] max the largest probe distance
+   */
+  void GetProbeDistances(double *average, uint32_t *max);
+
+ private:
+  /** Walks the slots of one table, keeping only the block of the last accessed slot pinned. */
+  class BlockCursor {
+   public:
+    BlockCursor(BufferPoolManager *buffer_pool_manager, HashTableHeaderPage *header_page, bool is_dirty)
+        : buffer_pool_manager_(buffer_pool_manager), header_page_(header_page), is_dirty_(is_dirty) {}
+    ~BlockCursor() {
+      if (block_ != nullptr) {
+        buffer_pool_manager_->UnpinPage(block_page_id_, is_dirty_);
+      }
+    }
+    DISALLOW_COPY_AND_MOVE(BlockCursor);
+
+    /** The block holding slot. */
+    auto Block(size_t slot) -> HASH_TABLE_ROBIN_HOOD_BLOCK_TYPE * {
+      size_t block_index = slot / ROBIN_HOOD_BLOCK_ARRAY_SIZE;
+      if (block_ == nullptr || block_index != block_index_) {
+        if (block_ != nullptr) {
+          buffer_pool_manager_->UnpinPage(block_page_id_, is_dirty_);
+        }
+        block_index_ = block_index;
+        block_page_id_ = header_page_->GetBlockPageId(block_index);
+        block_ = reinterpret_cast<HASH_TABLE_ROBIN_HOOD_BLOCK_TYPE *>(
+            buffer_pool_manager_->FetchPage(block_page_id_)->GetData());
+      }
+      return block_;
+    }
+
+   private:
+    BufferPoolManager *buffer_pool_manager_;
+    HashTableHeaderPage *header_page_;
+    bool is_dirty_;
+    size_t block_index_{0};
+    page_id_t block_page_id_{INVALID_PAGE_ID};
+    HASH_TABLE_ROBIN_HOOD_BLOCK_TYPE *block_{nullptr};
+  };
+
+  static auto Offset(size_t slot) -> slot_offset_t { return slot % ROBIN_HOOD_BLOCK_ARRAY_SIZE; }
+  auto Hash(const KeyType &key) -> size_t;
+  auto GetHeaderPage(page_id_t header_page_id) -> HashTableHeaderPage *;
+
+  /** Allocate a header and enough zeroed blocks for num_slots; returns INVALID_PAGE_ID if it does not fit. */
+  auto CreateTable(size_t num_slots) -> page_id_t;
+  void DeleteTable(page_id_t header_page_id);
+
+  /**
+   * Find the slot of a pair.
+   * @return false if there is none
+   */
+  auto FindPair(HashTableHeaderPage *header_page, const KeyType &key, const ValueType &value, size_t *slot) -> bool;
+  /**
+   * Insert a pair that is not in the table yet.
+   * @return false, leaving the table unchanged, if a pair would end up too far from its home slot
+   */
+  auto InsertPair(HashTableHeaderPage *header_page, const MappingType &pair) -> bool;
+  /**
+   * Rebuild the table with at least num_slots slots.
+   * @return false if such a table does not fit in a header page
+   */
+  auto Grow(size_t num_slots) -> bool;
+
+  // member variable
+  page_id_t header_page_id_;
+  BufferPoolManager *buffer_pool_manager_;
+  KeyComparator comparator_;
+  double max_load_factor_;
+  // Number of pairs in the table, guarded by the table latch
+  size_t num_entries_{0};
+
+  // Readers are lookups, writers are inserts and removes
+  ReaderWriterLatch table_latch_;
+
+  // Hash function
+  HashFunction<KeyType> hash_fn_;
+};
+
+}  // namespace bustub
@@ -17,9 +17,10 @@
 
 #pragma once
 
-#include <list>
+#include <atomic>
 #include <memory>
 #include <mutex>  // NOLINT
+#include <shared_mutex>
 #include <utility>
 #include <vector>
 
@@ -29,6 +30,12 @@ namespace bustub {
 
 /**
  * ExtendibleHashTable implements a hash table using the extendible hashing algorithm.
+ *
+ * Concurrency: the directory is guarded by a reader-writer latch that lookups, inserts, removes and bucket splits
+ * only take in shared mode; each bucket has its own reader-writer latch. A split rewrites just the directory slots of
+ * the bucket it splits, so only growing the directory takes the directory latch exclusively. Buckets are never
+ * freed before the table, so directory slots hold plain pointers.
+ *
  * @tparam K key type
  * @tparam V value type
  */
@@ -36,9 +43,6 @@ template <typename K, typename V>
 class ExtendibleHashTable : public HashTable<K, V> {
  public:
   /**
-   *
-   * TODO(P1): Add implementation
-   *
    * @brief Create a new ExtendibleHashTable.
    * @param bucket_size: fixed size for each bucket
    */
@@ -64,9 +68,6 @@ class ExtendibleHashTable : public HashTable<K, V> {
   auto GetNumBuckets() const -> int;
 
   /**
-   *
-   * TODO(P1): Add implementation
-   *
    * @brief Find the value associated with the given key.
    *
    * Use IndexOf(key) to find the directory index the key hashes to.
@@ -78,9 +79,6 @@ class ExtendibleHashTable : public HashTable<K, V> {
   auto Find(const K &key, V &value) -> bool override;
 
   /**
-   *
-   * TODO(P1): Add implementation
-   *
    * @brief Insert the given key-value pair into the hash table.
    * If a key already exists, the value should be updated.
    * If the bucket is full and can't be inserted, do the following steps before retrying:
@@ -95,9 +93,6 @@ class ExtendibleHashTable : public HashTable<K, V> {
   void Insert(const K &key, const V &value) override;
 
   /**
-   *
-   * TODO(P1): Add implementation
-   *
    * @brief Given the key, remove the corresponding key-value pair in the hash table.
    * Shrink & Combination is not required for this project
    * @param key The key to be deleted.
@@ -106,14 +101,15 @@ class ExtendibleHashTable : public HashTable<K, V> {
   auto Remove(const K &key) -> bool override;
 
   /**
-   * Bucket class for each hash table bucket that the directory points to.
+   * Bucket class for each hash table bucket that the directory points to. Items live in one flat array of
+   * bucket_size slots. Callers must hold the bucket's latch.
    */
   class Bucket {
    public:
     explicit Bucket(size_t size, int depth = 0);
 
     /** @brief Check if a bucket is full. */
-    inline auto IsFull() const -> bool { return list_.size() == size_; }
+    inline auto IsFull() const -> bool { return items_.size() == size_; }
 
     /** @brief Get the local depth of the bucket. */
     inline auto GetDepth() const -> int { return depth_; }
@@ -121,23 +117,17 @@ class ExtendibleHashTable : public HashTable<K, V> {
     /** @brief Increment the local depth of a bucket. */
     inline void IncrementDepth() { depth_++; }
 
-    inline auto GetItems() -> std::list<std::pair<K, V>> & { return list_; }
+    inline auto GetItems() -> std::vector<std::pair<K, V>> & { return items_; }
 
     /**
-     *
-     * TODO(P1): Add implementation
-     *
      * @brief Find the value associated with the given key in the bucket.
      * @param key The key to be searched.
      * @param[out] value The value associated with the key.
      * @return True if the key is found, false otherwise.
      */
-    auto Find(const K &key, V &value) -> bool;
+    auto Find(const K &key, V &value) const -> bool;
 
     /**
-     *
-     * TODO(P1): Add implementation
-     *
      * @brief Given the key, remove the corresponding key-value pair in the bucket.
      * @param key The key to be deleted.
      * @return True if the key exists, false otherwise.
@@ -145,9 +135,6 @@ class ExtendibleHashTable : public HashTable<K, V> {
     auto Remove(const K &key) -> bool;
 
     /**
-     *
-     * TODO(P1): Add implementation
-     *
      * @brief Insert the given key-value pair into the bucket.
      *      1. If a key already exists, the value should be updated.
      *      2. If the bucket is full, do nothing and return false.
@@ -157,45 +144,55 @@ class ExtendibleHashTable : public HashTable<K, V> {
      */
     auto Insert(const K &key, const V &value) -> bool;
 
+    /** Guards depth_ and items_ */
+    mutable std::shared_mutex latch_;
+
    private:
-    // TODO(student): You may add additional private members and helper functions
     size_t size_;
     int depth_;
-    std::list<std::pair<K, V>> list_;
+    std::vector<std::pair<K, V>> items_;
   };
 
  private:
-  // TODO(student): You may add additional private members and helper functions and remove the ones
-  // you don't need.
-
   int global_depth_;    // The global depth of the directory
   size_t bucket_size_;  // The size of a bucket
-  int num_buckets_;     // The number of buckets in the hash table
-  mutable std::mutex latch_;
-  std::vector<std::shared_ptr<Bucket>> dir_;  // The directory of the hash table
+  std::atomic<int> num_buckets_;  // The number of buckets in the hash table
+  // Guards global_depth_ and the size of dir_; slots are updated atomically by splits holding it shared.
+  mutable std::shared_mutex dir_latch_;
+  std::vector<std::atomic<Bucket *>> dir_;  // The directory of the hash table
 
-  // The following functions are completely optional, you can delete them if you have your own ideas.
+  // Owns every bucket; splits append to it while holding the directory latch shared.
+  std::mutex buckets_latch_;
+  std::vector<std::unique_ptr<Bucket>> buckets_;
+
+  /*********************************************************************************
+   * Must hold dir_latch_ (shared suffices unless noted) before calling the below. *
+   *********************************************************************************/
 
   /**
-   * @brief Redistribute the kv pairs in a full bucket.
-   * @param bucket The bucket to be redistributed.
+   * @brief Split a full bucket whose local depth is below the global depth. The caller holds the bucket's latch
+   * exclusively.
+   * @param bucket The bucket to be split.
+   * @param index A directory index that points to the bucket.
    */
-  auto RedistributeBucket(std::shared_ptr<Bucket> bucket) -> void;
+  void SplitBucket(Bucket *bucket, size_t index);
 
-  /*****************************************************************
-   * Must acquire latch_ first before calling the below functions. *
-   *****************************************************************/
+  /** @brief Double the directory. The caller holds dir_latch_ exclusively. */
+  void GrowDirectory();
 
   /**
    * @brief For the given key, return the entry index in the directory where the key hashes to.
    * @param key The key to be hashed.
    * @return The entry index in the directory.
    */
-  auto IndexOf(const K &key) -> size_t;
+  auto IndexOf(const K &key) const -> size_t;
 
-  auto GetGlobalDepthInternal() const -> int;
-  auto GetLocalDepthInternal(int dir_index) const -> int;
-  auto GetNumBucketsInternal() const -> int;
+  /**
+   * @brief Find the bucket of a key and latch it, retrying if a concurrent split moved the key elsewhere.
+   * @return The bucket, latched with Lock
+   */
+  template <typename Lock>
+  auto LatchBucket(const K &key, Lock *lock) const -> Bucket *;
 };
 
 }  // namespace bustub
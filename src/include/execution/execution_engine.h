@@ -21,6 +21,7 @@
 #include "execution/executor_context.h"
 #include "execution/executor_factory.h"
 #include "execution/plans/abstract_plan.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -78,18 +79,19 @@ class ExecutionEngine {
 
  private:
   /**
-   * Poll the executor until exhausted, or exception escapes.
+   * Poll the executor a batch at a time until exhausted, or exception escapes.
    * @param executor The root executor
    * @param plan The plan to execute
    * @param result_set The tuple result set
    */
   static void PollExecutor(AbstractExecutor *executor, const AbstractPlanNodeRef &plan,
                            std::vector<Tuple> *result_set) {
-    RID rid{};
-    Tuple tuple{};
-    while (executor->Next(&tuple, &rid)) {
+    TupleBatch batch;
+    while (executor->NextBatch(&batch)) {
       if (result_set != nullptr) {
-        result_set->push_back(tuple);
+        for (auto row : batch.GetSelection()) {
+          result_set->push_back(batch.ToTuple(row, executor->GetOutputSchema()));
+        }
       }
     }
   }
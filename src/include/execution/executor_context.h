@@ -60,6 +60,18 @@ class ExecutorContext {
   /** @return the transaction manager */
   auto GetTransactionManager() -> TransactionManager * { return txn_mgr_; }
 
+  /** @return how many bytes an operator may hold in memory before it spills to disk; 0 if there is no limit */
+  auto GetMemoryBudget() const -> size_t { return memory_budget_; }
+
+  /** Set the memory budget of the operators of the query, see GetMemoryBudget(). */
+  void SetMemoryBudget(size_t memory_budget) { memory_budget_ = memory_budget; }
+
+  /** @return how many threads a sort may use to sort and merge its rows; at least 1 */
+  auto GetSortThreads() const -> size_t { return sort_threads_; }
+
+  /** Set the number of threads of the sorts of the query, see GetSortThreads(). */
+  void SetSortThreads(size_t sort_threads) { sort_threads_ = sort_threads; }
+
  private:
   /** The transaction context associated with this executor context */
   Transaction *transaction_;
@@ -71,6 +83,10 @@ class ExecutorContext {
   TransactionManager *txn_mgr_;
   /** The lock manager associated with this executor context */
   LockManager *lock_mgr_;
+  /** The memory an operator may use before it spills, 0 for no limit */
+  size_t memory_budget_{0};
+  /** The threads a sort may use */
+  size_t sort_threads_{1};
 };
 
 }  // namespace bustub
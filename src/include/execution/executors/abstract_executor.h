@@ -12,7 +12,12 @@
 
 #pragma once
 
+#include <memory>
+#include <vector>
+
 #include "execution/executor_context.h"
+#include "execution/runtime_filter.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -20,6 +25,10 @@ namespace bustub {
  * The AbstractExecutor implements the Volcano tuple-at-a-time iterator model.
  * This is the base class from which all executors in the BustTub execution
  * engine inherit, and defines the minimal interface that all executors support.
+ *
+ * Executors may also produce a batch of tuples at a time with NextBatch(). The two interfaces can be mixed: the
+ * default NextBatch() collects rows from Next(), and executors that work on batches natively can implement Next() on
+ * top of NextBatch() with NextFromBatch().
  */
 class AbstractExecutor {
  public:
@@ -46,6 +55,27 @@ class AbstractExecutor {
    */
   virtual auto Next(Tuple *tuple, RID *rid) -> bool = 0;
 
+  /**
+   * Yield the next batch of tuples from this executor. Do not mix calls to Next() and NextBatch() on one executor.
+   * @param[out] batch The next batch, which has at least one selected row
+   * @return `true` if a batch was produced, `false` if there are no more tuples
+   */
+  virtual auto NextBatch(TupleBatch *batch) -> bool;
+
+  /**
+   * Offer a runtime filter on some output columns: the consumer only needs the rows whose values in them may be in
+   * the filter. An executor that accepts applies the filter itself or hands it on to a child, and checks it from its
+   * first row on, also after being initialized again; the filter may change in between. Rows that fail it may still
+   * be produced, so the consumer has to check them anyway.
+   * @param filter the filter, which the consumer keeps up to date before it pulls rows
+   * @param column_idxs the output columns that make up the key of the filter
+   * @return whether the filter was accepted
+   */
+  virtual auto PushRuntimeFilter(const std::shared_ptr<const RuntimeFilter> &filter,
+                                 const std::vector<uint32_t> &column_idxs) -> bool {
+    return false;
+  }
+
   /** @return The schema of the tuples that this executor produces */
   virtual auto GetOutputSchema() const -> const Schema & = 0;
 
@@ -53,7 +83,23 @@ class AbstractExecutor {
   auto GetExecutorContext() -> ExecutorContext * { return exec_ctx_; }
 
  protected:
+  /**
+   * Next() for executors that work on batches: hand out the selected rows of NextBatch() one at a time. Call
+   * ResetBatchReader() in Init().
+   */
+  auto NextFromBatch(Tuple *tuple, RID *rid) -> bool;
+
+  void ResetBatchReader() {
+    reader_batch_.Reset(0);
+    reader_cursor_ = 0;
+  }
+
   /** The executor context in which the executor runs */
   ExecutorContext *exec_ctx_;
+
+ private:
+  /** The batch that NextFromBatch() is handing out */
+  TupleBatch reader_batch_;
+  uint32_t reader_cursor_{0};
 };
 }  // namespace bustub
@@ -121,10 +121,11 @@ class SimpleAggregationHashTable {
    * @param agg_val the value to be inserted
    */
   void InsertCombine(const AggregateKey &agg_key, const AggregateValue &agg_val) {
-    if (ht_.count(agg_key) == 0) {
-      ht_.insert({agg_key, GenerateInitialAggregateValue()});
+    auto it = ht_.find(agg_key);
+    if (it == ht_.end()) {
+      it = ht_.emplace(agg_key, GenerateInitialAggregateValue()).first;
     }
-    CombineAggregateValues(&ht_[agg_key], agg_val);
+    CombineAggregateValues(&it->second, agg_val);
   }
 
   /**
@@ -204,6 +205,13 @@ class AggregationExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield the next batch of groups from the aggregation.
+   * @param[out] batch The rows produced by the aggregation
+   * @return `true` if any row was produced, `false` if there are no more rows
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
   /** @return The output schema for the aggregation */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); };
 
@@ -229,6 +237,9 @@ class AggregationExecutor : public AbstractExecutor {
     return {vals};
   }
 
+  /** Evaluate the group bys and the aggregates on a child batch and combine its selected rows into the table. */
+  void InsertBatch(const TupleBatch &batch);
+
  private:
   /** The aggregation plan node */
   const AggregationPlanNode *plan_;
@@ -241,5 +252,8 @@ class AggregationExecutor : public AbstractExecutor {
   // TODO(Student): Uncomment
   SimpleAggregationHashTable::Iterator aht_iterator_;
   bool is_agg_{false};
+  /** The group by and aggregate values of the current child batch, one vector per expression */
+  std::vector<std::vector<Value>> key_columns_;
+  std::vector<std::vector<Value>> value_columns_;
 };
 }  // namespace bustub
@@ -60,6 +60,8 @@ class DeleteExecutor : public AbstractExecutor {
   const DeletePlanNode *plan_;
   /** The child executor from which RIDs for deleted tuples are pulled */
   std::unique_ptr<AbstractExecutor> child_executor_;
+  /** The table the tuples are written to */
+  TableInfo *table_info_;
   bool is_delete_{false};
 };
 }  // namespace bustub
@@ -48,6 +48,20 @@ class FilterExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield the next batch from the filter. The rows of a child batch that fail the predicate are dropped from its
+   * selection vector; batches without any row left are skipped.
+   * @param[out] batch The rows produced by the filter
+   * @return `true` if any row was produced, `false` if there are no more rows
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
+  /** The filter passes on the columns of its child unchanged, so runtime filters go to the child. */
+  auto PushRuntimeFilter(const std::shared_ptr<const RuntimeFilter> &filter, const std::vector<uint32_t> &column_idxs)
+      -> bool override {
+    return child_executor_->PushRuntimeFilter(filter, column_idxs);
+  }
+
   /** @return The output schema for the filter plan */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
@@ -57,5 +71,8 @@ class FilterExecutor : public AbstractExecutor {
 
   /** The child executor from which tuples are obtained */
   std::unique_ptr<AbstractExecutor> child_executor_;
+
+  /** The value of the predicate for each row of the current batch */
+  std::vector<Value> predicate_values_;
 };
 }  // namespace bustub
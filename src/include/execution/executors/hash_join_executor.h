@@ -13,20 +13,31 @@
 #pragma once
 
 #include <memory>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "common/util/hash_util.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/join_hash_table.h"
 #include "execution/plans/hash_join_plan.h"
+#include "storage/table/tmp_tuple_file.h"
 #include "storage/table/tuple.h"
 #include "type/value_factory.h"
 namespace bustub {
 
 /**
- * HashJoinExecutor executes a nested-loop JOIN on two tables.
+ * HashJoinExecutor executes a hash JOIN on two tables: it builds a hash table from the right child and probes it with
+ * the rows of the left child, streaming the output.
+ *
+ * When the hash table outgrows the memory budget of the query (ExecutorContext::GetMemoryBudget), the join becomes a
+ * hybrid hash join. The rows already in the table stay there; the remaining right rows are partitioned by the hash
+ * of their key into temp files. A left row probes the table as usual and is then also written to the file of its
+ * partition, with a flag saying whether it already matched. Once the left child is exhausted, each pair of partition
+ * files is joined the same way, one pair after another, so pairs that still do not fit are partitioned again.
+ *
+ * An inner join pushes a RuntimeFilter on the build keys down its left side, towards the scan that produces them. The
+ * right side is therefore built before the left child is initialized.
  */
 class HashJoinExecutor : public AbstractExecutor {
  public:
@@ -51,19 +62,119 @@ class HashJoinExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield the next batch from the join. The left side is probed only as far as needed to fill the batch, so the
+   * join streams, and a LIMIT above it stops the probe early.
+   * @param[out] batch The rows produced by the join.
+   * @return `true` if any row was produced, `false` if there are no more rows.
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
+  /**
+   * Hand a runtime filter on to the child that produces all columns of its key. Filters on right columns are only
+   * handed on by an inner join; a LEFT join would pad the left rows whose matches the filter dropped.
+   * @return whether the child accepted the filter
+   */
+  auto PushRuntimeFilter(const std::shared_ptr<const RuntimeFilter> &filter, const std::vector<uint32_t> &column_idxs)
+      -> bool override;
+
   /** @return The output schema for the join */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); };
 
  private:
+  /** The number of partitions a pass spills to, as a number of hash bits */
+  static constexpr uint32_t SPILL_FANOUT_BITS = 3;
+  /** Partitions of this level are joined in memory whatever their size, e.g. when most rows share one key */
+  static constexpr uint32_t MAX_SPILL_LEVEL = 5;
+
+  /** A pair of partitions spilled by a pass, the rows of both sides whose key hashes to the partition */
+  struct SpillPartition {
+    std::unique_ptr<TmpTupleFile> left_;
+    std::unique_ptr<TmpTupleFile> right_;
+    /** The level of the pass that spilled the partition */
+    uint32_t level_;
+  };
+
+  /**
+   * Start a pass: build the hash table from the right child, or from the right file of a partition, spilling the
+   * rows that do not fit.
+   * @param right_file the right rows of the partition, nullptr for the right child
+   * @param level 0 for the right child, one more than the level of the partition otherwise
+   */
+  void Build(TmpTupleFile *right_file, uint32_t level);
+
+  /** Fill left_batch_ from the left child, or from the left file of the partition being joined. */
+  auto NextProbeBatch() -> bool;
+
+  /**
+   * Start the next pass, on a partition spilled by this pass or an earlier one.
+   * @return `false` when no partition is left
+   */
+  auto NextPass() -> bool;
+
+  /**
+   * Move the probe on to the next left row, pulling the next left batch when the current one is used up.
+   * @return `false` when the left side is exhausted
+   */
+  auto NextLeftRow() -> bool;
+
+  /**
+   * Write the left row being probed to the file of its partition, if the right side of that partition has any row.
+   * @return whether the row was written; it is then joined with the partition later
+   */
+  auto SpillLeftRow(uint32_t row) -> bool;
+
+  /** @return the partition of a join key in the current pass */
+  auto GetPartition(const std::vector<std::vector<Value>> &key_columns, uint32_t row) const -> size_t {
+    return (JoinHashTable::HashKey(key_columns, row) >> (64 - SPILL_FANOUT_BITS * (level_ + 1))) &
+           ((1 << SPILL_FANOUT_BITS) - 1);
+  }
+
+  /**
+   * Evaluate the join key expressions of one side on a batch, into one vector of values per expression. Keys are cast
+   * to key_types_, so that equal keys of different types hash alike.
+   */
+  void EvaluateKeys(const std::vector<AbstractExpressionRef> &key_exprs, const TupleBatch &batch,
+                    std::vector<std::vector<Value>> *key_columns) const;
+
   /** The NestedLoopJoin plan node to be executed. */
   const HashJoinPlanNode *plan_;
   std::unique_ptr<AbstractExecutor> left_executor_;
   std::unique_ptr<AbstractExecutor> right_executor_;
+  /** The schema of spilled left rows: the left columns and whether the row has matched */
+  Schema left_spill_schema_;
+
+  /** The type both sides of each join key are compared as; INVALID where the values are taken as they are */
+  std::vector<TypeId> key_types_;
+
+  /** The filter on the build keys pushed down the left side, nullptr if no child accepted it */
+  std::shared_ptr<RuntimeFilter> runtime_filter_;
 
-  std::unordered_map<hash_t, std::vector<Tuple>> hash_join_table_;
+  /** The right rows of the current pass that fit into memory, by join key */
+  JoinHashTable hash_table_;
+  /** The level of the current pass */
+  uint32_t level_{0};
+  /** The partitions the current pass spills to, none while everything fits */
+  std::vector<SpillPartition> partitions_;
+  /** The partitions that are still to be joined */
+  std::vector<SpillPartition> pending_partitions_;
+  /** The partition whose left rows are being probed, and a reader of them; no file while reading the left child */
+  SpillPartition probe_partition_;
+  std::unique_ptr<TmpTupleFile::Reader> probe_reader_;
 
-  std::vector<Tuple> output_tuples_;
-  std::vector<Tuple>::const_iterator output_tuples_iter_;
+  /** The left batch being probed, and the join keys of its rows */
+  TupleBatch left_batch_;
+  std::vector<std::vector<Value>> left_key_columns_;
+  /** The position in the selection of left_batch_ of the row being probed */
+  uint32_t left_cursor_{0};
+  /** Set once all passes are over, so that the left child is not asked again */
+  bool left_done_{false};
+  /** Whether a left row is being probed; a batch can fill up in the middle of its matches */
+  bool probing_{false};
+  /** The next right row that matches the row being probed, NO_ROW when there are no more */
+  uint32_t match_{JoinHashTable::NO_ROW};
+  /** Whether the row being probed has matched any right row yet, in this pass or an earlier one */
+  bool matched_{false};
 };
 
 }  // namespace bustub
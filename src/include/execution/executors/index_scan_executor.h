@@ -47,7 +47,12 @@ class IndexScanExecutor : public AbstractExecutor {
   IndexInfo *index_info_;
   TableInfo *table_info_;
 
+  /** Only set for full scans, which need an ordered index. */
   BPlusTreeIndexForOneIntegerColumn *tree_;
   BPlusTreeIndexIteratorForOneIntegerColumn iter_;
+
+  /** Matches of a point lookup and the next one to emit. */
+  std::vector<RID> rids_;
+  size_t cursor_{0};
 };
 }  // namespace bustub
@@ -14,6 +14,7 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
@@ -24,7 +25,7 @@ namespace bustub {
 
 /**
  * InsertExecutor executes an insert on a table.
- * Inserted values are always pulled from a child executor.
+ * Inserted values are always pulled from a child executor, and written to the table and its indexes in batches.
  */
 class InsertExecutor : public AbstractExecutor {
  public:
@@ -55,9 +56,17 @@ class InsertExecutor : public AbstractExecutor {
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); };
 
  private:
+  /** Number of child tuples inserted into the table at once */
+  static constexpr size_t INSERT_BATCH_SIZE = 1024;
+
+  /** Insert the index entries of the inserted prefix of a batch, in key order unless the index is unordered. */
+  void InsertIndexEntries(IndexInfo *index, const std::vector<Tuple> &batch, const std::vector<RID> &rids);
+
   /** The insert plan node to be executed*/
   const InsertPlanNode *plan_;
   std::unique_ptr<AbstractExecutor> child_executor_;
+  /** The table the tuples are written to */
+  TableInfo *table_info_;
   bool is_insert_{false};
 };
 
@@ -0,0 +1,125 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// merge_join_executor.h
+//
+// Identification: src/include/execution/executors/merge_join_executor.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/merge_join_plan.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * MergeJoinExecutor joins two inputs sorted on their join keys by reading both of them once, side by side. Only the
+ * run of right rows that share the key of the current left row is kept in memory, so that following left rows with
+ * the same key can be joined with it as well.
+ */
+class MergeJoinExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new MergeJoinExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The MergeJoin join plan to be executed
+   * @param left_child The child executor that produces tuples for the left side of join
+   * @param right_child The child executor that produces tuples for the right side of join
+   */
+  MergeJoinExecutor(ExecutorContext *exec_ctx, const MergeJoinPlanNode *plan,
+                    std::unique_ptr<AbstractExecutor> &&left_child, std::unique_ptr<AbstractExecutor> &&right_child);
+
+  /** Initialize the join */
+  void Init() override;
+
+  /**
+   * Yield the next tuple from the join.
+   * @param[out] tuple The next tuple produced by the join.
+   * @param[out] rid The next tuple RID, not used by merge join.
+   * @return `true` if a tuple was produced, `false` if there are no more tuples.
+   */
+  auto Next(Tuple *tuple, RID *rid) -> bool override;
+
+  /**
+   * Yield the next batch from the join, in the order of the left input.
+   * @param[out] batch The rows produced by the join.
+   * @return `true` if any row was produced, `false` if there are no more rows.
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
+  /** @return The output schema for the join */
+  auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); };
+
+ private:
+  /**
+   * Move on to the next left row, pulling the next left batch when the current one is used up, and find the right
+   * rows with its key.
+   * @return `false` when the left side is exhausted
+   */
+  auto NextLeftRow() -> bool;
+
+  /** Make the run hold the right rows with the given key, reading the right side up to the first greater key. */
+  void SeekRun(const std::vector<Value> &key);
+
+  /**
+   * Point right_cursor_ at a right row, pulling the next right batch when the current one is used up.
+   * @return `false` when the right side is exhausted
+   */
+  auto HasRightRow() -> bool;
+
+  /** Evaluate the join key expressions of one side on a batch, into one vector of values per expression. */
+  static void EvaluateKeys(const std::vector<AbstractExpressionRef> &key_exprs, const TupleBatch &batch,
+                           std::vector<std::vector<Value>> *key_columns);
+
+  /** @return the key of a row of key_columns */
+  static auto GetKey(const std::vector<std::vector<Value>> &key_columns, uint32_t row) -> std::vector<Value>;
+
+  /** @return a negative number, zero or a positive number as key a is less than, equal to or greater than b */
+  static auto CompareKeys(const std::vector<Value> &a, const std::vector<Value> &b) -> int;
+
+  /** The MergeJoin plan node to be executed. */
+  const MergeJoinPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> left_executor_;
+  std::unique_ptr<AbstractExecutor> right_executor_;
+
+  /** The left batch being joined, and the join keys of its rows */
+  TupleBatch left_batch_;
+  std::vector<std::vector<Value>> left_key_columns_;
+  /** The position in the selection of left_batch_ of the current left row */
+  uint32_t left_cursor_{0};
+  /** Set once the left side is exhausted, so that the left child is not asked again */
+  bool left_done_{false};
+  /** Whether left_cursor_ points at a left row that has been taken */
+  bool probing_{false};
+  /** Whether the output of the current left row is complete; a batch can fill up in the middle of its matches */
+  bool row_done_{true};
+  /** Whether the current left row matches the run */
+  bool matches_{false};
+  /** The next row of the run to join with the current left row */
+  size_t run_pos_{0};
+
+  /** The right batch being read, and the join keys of its rows */
+  TupleBatch right_batch_;
+  std::vector<std::vector<Value>> right_key_columns_;
+  /** The position in the selection of right_batch_ of the first right row not read yet */
+  uint32_t right_cursor_{0};
+  bool right_done_{false};
+
+  /** The key of the run, and the values of the right rows with that key; valid once a left row has looked for it */
+  std::vector<Value> run_key_;
+  std::vector<std::vector<Value>> run_rows_;
+  bool has_run_{false};
+};
+
+}  // namespace bustub
@@ -13,6 +13,7 @@
 #pragma once
 
 #include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -50,6 +51,12 @@ class MockScanExecutor : public AbstractExecutor {
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
   /** @return The output schema for the sequential scan */
+  auto PushRuntimeFilter(const std::shared_ptr<const RuntimeFilter> &filter, const std::vector<uint32_t> &column_idxs)
+      -> bool override {
+    runtime_filters_.Add(filter, column_idxs);
+    return true;
+  }
+
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
  private:
@@ -79,6 +86,8 @@ class MockScanExecutor : public AbstractExecutor {
 
   /** The shuffled output */
   std::vector<size_t> shuffled_idx_;
+
+  RuntimeFilterSet runtime_filters_;
 };
 
 }  // namespace bustub
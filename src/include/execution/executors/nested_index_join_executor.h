@@ -54,7 +54,6 @@ class NestIndexJoinExecutor : public AbstractExecutor {
   std::unique_ptr<AbstractExecutor> child_executor_;
   IndexInfo *index_info_;
   TableInfo *table_info_;
-  BPlusTreeIndexForOneIntegerColumn *tree_;
   Tuple left_tuple_{};
   std::vector<RID> rids_{};
 };
@@ -13,11 +13,13 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <utility>
 #include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/expressions/comparison_expression.h"
 #include "execution/plans/nested_loop_join_plan.h"
 #include "storage/table/tuple.h"
 #include "type/value_factory.h"
@@ -25,10 +27,28 @@
 namespace bustub {
 
 /**
- * NestedLoopJoinExecutor executes a nested-loop JOIN on two tables.
+ * NestedLoopJoinExecutor executes a nested-loop JOIN on two tables, a block at a time.
+ *
+ * The right (inner) side is read once and cached column by column. The left (outer) side is read a batch at a time,
+ * and every batch is joined with one block of inner rows after the other, so that a block is reused for a whole batch
+ * while it is hot. Output rows are only built for the pairs that match.
+ *
+ * The predicate is split into its conjuncts, and each of them is evaluated as early as it can be:
+ * - a conjunct on the left columns only is evaluated once per left row, on the whole batch;
+ * - a conjunct on the right columns only drops inner rows while the inner side is cached;
+ * - a comparison between a right column and an expression on the left columns compares the cached column with the
+ *   value of the expression, evaluated once per left row;
+ * - everything else is evaluated on the pair of tuples.
+ *
+ * If some comparisons are on the same right column and are not `<>` (a band join such as `a.x <= b.y AND b.y < a.x +
+ * 10`, or a plain equality), the cached inner rows are sorted on that column, and each left row only visits the range
+ * of rows those comparisons allow, found by binary search.
  */
 class NestedLoopJoinExecutor : public AbstractExecutor {
  public:
+  /** The number of inner rows in a block, when the inner rows are not sorted on a band column */
+  static constexpr size_t INNER_BLOCK_ROWS = TupleBatch::BATCH_SIZE;
+
   /**
    * Construct a new NestedLoopJoinExecutor instance.
    * @param exec_ctx The executor context
@@ -51,20 +71,79 @@ class NestedLoopJoinExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield the next batch from the join.
+   * @param[out] batch The rows produced by the join.
+   * @return `true` if any row was produced, `false` if there are no more rows.
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
   /** @return The output schema for the insert */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); };
 
-  auto IsMatch(Tuple *left_tuple, Tuple *right_tuple) -> bool;
-
  private:
+  /** A conjunct `<right column> <type> <expression on the left columns>` of the predicate */
+  struct KeyComparison {
+    ComparisonType type_;
+    uint32_t right_column_;
+    AbstractExpressionRef left_expr_;
+    /** Whether it is on the band column, so that the range of inner rows a left row visits already satisfies it */
+    bool banded_{false};
+  };
+
+  /** Sort the conjuncts of expr into the kinds above. */
+  void AnalyzePredicate(const AbstractExpressionRef &expr);
+
+  /** Read the right side into inner_columns_, dropping the rows that can never match, and sort it if banded. */
+  void CacheInner();
+
+  /** Pull the next left batch and evaluate what only depends on its rows. @return `false` at the end */
+  auto NextOuterBlock() -> bool;
+
+  /** @return the first cached inner row whose band value is not less (upper: not less or equal) than value */
+  auto BandBound(const Value &value, bool upper) const -> size_t;
+
+  /** @return whether the left row row of the outer block and the inner row inner_row satisfy the predicate */
+  auto IsMatch(uint32_t row, size_t inner_row) const -> bool;
+
+  /** @return the left columns of a row of the outer block, with room for the right ones */
+  auto LeftValues(uint32_t row) const -> std::vector<Value>;
+
   /** The NestedLoopJoin plan node to be executed. */
   const NestedLoopJoinPlanNode *plan_;
   std::unique_ptr<AbstractExecutor> left_executor_;
   std::unique_ptr<AbstractExecutor> right_executor_;
-  std::vector<Tuple> right_tuples_;
-  int right_tuples_index_{-1};
-  int right_tuples_size_{0};
-  Tuple left_tuple_{};
+
+  /** The conjuncts of the predicate, by kind */
+  std::vector<AbstractExpressionRef> left_conjuncts_;
+  std::vector<AbstractExpressionRef> right_conjuncts_;
+  std::vector<KeyComparison> comparisons_;
+  std::vector<AbstractExpressionRef> residual_conjuncts_;
+  /** The right column the inner rows are sorted on, if any */
+  std::optional<uint32_t> band_column_;
+
+  /** The cached inner rows, one vector per right column; and as tuples, only if there are residual conjuncts */
+  std::vector<std::vector<Value>> inner_columns_;
+  std::vector<Tuple> inner_tuples_;
+  size_t inner_row_count_{0};
+
+  /** The outer block: a left batch, the value of the left expression of every comparison and the tuples */
+  TupleBatch left_batch_;
+  std::vector<std::vector<Value>> left_keys_;
+  std::vector<Tuple> left_tuples_;
+  /** For every row of the outer block, the range of inner rows it may match; empty if it matches none */
+  std::vector<size_t> range_begin_;
+  std::vector<size_t> range_end_;
+  /** For every row of the outer block, whether it matched, for LEFT joins */
+  std::vector<bool> matched_;
+  bool has_outer_block_{false};
+
+  /** Where the join of the outer block stopped: the inner block, the left row in it, and its next inner row */
+  size_t block_begin_{0};
+  uint32_t outer_pos_{0};
+  size_t inner_row_{0};
+  /** The next row of the outer block to pad, once all inner blocks are done */
+  uint32_t pad_pos_{0};
 };
 
 }  // namespace bustub
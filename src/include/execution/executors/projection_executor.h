@@ -47,6 +47,20 @@ class ProjectionExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield the next batch from the projection, which has the rows of the next child batch.
+   * @param[out] batch The rows produced by the projection
+   * @return `true` if any row was produced, `false` if there are no more rows
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
+  /**
+   * Hand a runtime filter on to the child, if every column of its key is a plain child column.
+   * @return whether the child accepted the filter
+   */
+  auto PushRuntimeFilter(const std::shared_ptr<const RuntimeFilter> &filter, const std::vector<uint32_t> &column_idxs)
+      -> bool override;
+
   /** @return The output schema for the projection plan */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
@@ -56,5 +70,11 @@ class ProjectionExecutor : public AbstractExecutor {
 
   /** The child executor from which tuples are obtained */
   std::unique_ptr<AbstractExecutor> child_executor_;
+
+  /** The current child tuple, kept across calls so that its buffer is reused */
+  Tuple child_tuple_;
+
+  /** The current child batch, kept across calls so that its columns are reused */
+  TupleBatch child_batch_;
 };
 }  // namespace bustub
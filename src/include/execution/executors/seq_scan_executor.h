@@ -12,11 +12,13 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/seq_scan_plan.h"
+#include "storage/table/pax_table_heap.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -37,20 +39,63 @@ class SeqScanExecutor : public AbstractExecutor {
   void Init() override;
 
   /**
-   * Yield the next tuple from the sequential scan.
+   * Yield the next tuple from the sequential scan. A row of a table of TablePages is copied from its page into the
+   * buffer of tuple, which is reused if it is large enough.
    * @param[out] tuple The next tuple produced by the scan
    * @param[out] rid The next tuple RID produced by the scan
    * @return `true` if a tuple was produced, `false` if there are no more tuples
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield the next batch of the scan, up to TupleBatch::BATCH_SIZE rows. Rows of a table of TablePages are filtered
+   * in place in its pages and only the survivors are copied; a PAX table hands its columns over without building
+   * tuples.
+   * @param[out] batch The rows produced by the scan
+   * @return `true` if any row was produced, `false` at the end of the table
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
+  /**
+   * Accept a runtime filter: rows that fail it are skipped before they are locked and put into a batch.
+   * @return `true`
+   */
+  auto PushRuntimeFilter(const std::shared_ptr<const RuntimeFilter> &filter, const std::vector<uint32_t> &column_idxs)
+      -> bool override {
+    runtime_filters_.Add(filter, column_idxs);
+    return true;
+  }
+
   /** @return The output schema for the sequential scan */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
  private:
+  /** @return whether a row, typically a view into its page, passes the runtime filters and the scan predicate */
+  auto Passes(const Tuple &row) -> bool;
+
+  /** Take the shared lock on a row that is handed out, under READ_COMMITTED and REPEATABLE_READ. */
+  void LockRow(const RID &rid);
+
+  /** At the end of the scan, give back the locks that READ_COMMITTED does not keep until commit. */
+  void ReleaseLocks();
+
   /** The sequential scan plan node to be executed */
   const SeqScanPlanNode *plan_;
-  TableIterator table_iter_ = {nullptr, RID(), nullptr};
   TableInfo *table_info_;
+
+  /** The page to read next, and for tables of TablePages the slot in it to resume at */
+  page_id_t next_page_id_{INVALID_PAGE_ID};
+  uint32_t next_slot_{0};
+
+  /** Set when the table is a PAX table, and the columns read from it */
+  PaxTableHeap *pax_table_{nullptr};
+  std::vector<uint32_t> scan_column_ids_;
+  /** The values of the scanned columns of the current page, and the rids of its rows */
+  std::vector<std::vector<Value>> columns_;
+  std::vector<RID> rids_;
+  size_t cursor_{0};
+
+  /** The runtime filters pushed down by the joins above */
+  RuntimeFilterSet runtime_filters_;
 };
 }  // namespace bustub
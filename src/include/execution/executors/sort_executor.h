@@ -13,21 +13,39 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/loser_tree.h"
 #include "execution/plans/seq_scan_plan.h"
 #include "execution/plans/sort_plan.h"
+#include "execution/sort_key.h"
+#include "storage/table/tmp_tuple_file.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 /**
  * The SortExecutor executor executes a sort.
+ *
+ * Rows are sorted on their normalized keys (see SortKeyEncoder), which are computed once per row, so that comparing
+ * two rows is a memcmp. As long as the rows fit into the memory budget of the query, they are sorted in memory.
+ * Otherwise the sort is external: every time the buffered rows reach the budget they are sorted into a run, which is
+ * spilled to a TmpTupleFile, and the runs are merged with a loser tree. When there are more runs than the budget has
+ * room for a page of each, groups of them are merged into longer runs first.
+ *
+ * With `SET sort_threads=<count>` (ExecutorContext::GetSortThreads), the buffered rows are split into one chunk per
+ * thread, and the chunks are sorted concurrently. They are then merged in rounds of pairs, where every thread writes
+ * an equal share of the output of the round: the share is cut out of the merges with merge path, a binary search on
+ * the diagonals of the merge grid, so the merge scales with the threads as well.
  */
 class SortExecutor : public AbstractExecutor {
  public:
+  /** The fewest rows a sort thread is given; smaller inputs are sorted with fewer threads */
+  static constexpr size_t MIN_ROWS_PER_THREAD = TupleBatch::BATCH_SIZE;
+
   /**
    * Construct a new SortExecutor instance.
    * @param exec_ctx The executor context
@@ -46,15 +64,73 @@ class SortExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield the next batch of sorted rows.
+   * @param[out] batch The next rows produced by the sort
+   * @return `true` if any row was produced, `false` if there are no more rows
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
   /** @return The output schema for the sort */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
  private:
+  /** A buffered row and its key */
+  struct SortEntry {
+    std::string key_;
+    Tuple tuple_;
+  };
+
+  /** A spilled run being merged, and its current head */
+  struct MergeSource {
+    std::unique_ptr<TmpTupleFile::Reader> reader_;
+    std::string key_;
+    Tuple tuple_;
+    bool done_{false};
+  };
+
+  /** Orders the sources of a merge by their heads, exhausted sources last and ties by position, for a LoserTree */
+  struct SourceLess {
+    const std::vector<MergeSource> *sources_;
+    auto operator()(size_t a, size_t b) const -> bool;
+  };
+
+  /** Sort the buffered rows on their keys; rows with equal keys keep the order of the input. */
+  void SortEntries();
+
+  /** Sort the buffered rows with several threads, see SortEntries(). */
+  void ParallelSortEntries(size_t threads);
+
+  /** Sort the buffered rows and append them to a new run. */
+  void SpillRun();
+
+  /** @return the number of runs that are merged at once: one page of each must fit into the budget */
+  auto MergeFanIn() const -> size_t;
+
+  /** Open a source on a run and read its first row. */
+  void OpenSource(const TmpTupleFile *run, MergeSource *source) const;
+
+  /** Move a source on to its next row. */
+  void AdvanceSource(MergeSource *source) const;
+
+  /** Merge runs_[begin, end) into one run. */
+  auto MergeRuns(size_t begin, size_t end) -> std::unique_ptr<TmpTupleFile>;
+
   /** The sort plan node to be executed */
   const SortPlanNode *plan_;
   std::unique_ptr<AbstractExecutor> child_executor_;
-  std::vector<Tuple> child_tuples_{};
-  int child_tuples_size_{0};
-  int child_tuples_index_{0};
+  SortKeyEncoder encoder_;
+
+  /** The buffered rows, and the memory they take */
+  std::vector<SortEntry> entries_;
+  size_t entries_size_{0};
+  /** The next buffered row to emit, when everything fit into memory */
+  size_t entries_index_{0};
+
+  /** The spilled runs, in the order of the input */
+  std::vector<std::unique_ptr<TmpTupleFile>> runs_;
+  /** The final merge, if there are runs */
+  std::vector<MergeSource> sources_;
+  std::unique_ptr<LoserTree<SourceLess>> merge_tree_;
 };
 }  // namespace bustub
@@ -13,18 +13,24 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/seq_scan_plan.h"
 #include "execution/plans/topn_plan.h"
+#include "execution/sort_key.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 /**
  * The TopNExecutor executor executes a topn.
+ *
+ * Only the best N rows seen so far are kept, in a max-heap on their normalized keys (see SortKeyEncoder), whose top is
+ * the worst of them. A row is checked against the top on its key alone, and only copied out of the batch when it
+ * makes it into the heap, so the topn takes O(M log N) time and O(N) memory over M input rows.
  */
 class TopNExecutor : public AbstractExecutor {
  public:
@@ -46,16 +52,34 @@ class TopNExecutor : public AbstractExecutor {
    */
   auto Next(Tuple *tuple, RID *rid) -> bool override;
 
+  /**
+   * Yield the next batch of the top rows.
+   * @param[out] batch The next rows produced by the topn
+   * @return `true` if any row was produced, `false` if there are no more rows
+   */
+  auto NextBatch(TupleBatch *batch) -> bool override;
+
   /** @return The output schema for the topn */
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
  private:
+  /** A row in the heap, with its key and its position in the input, which breaks ties between equal keys */
+  struct TopNEntry {
+    std::string key_;
+    size_t position_;
+    Tuple tuple_;
+  };
+
+  /** Orders the entries of the heap, so that the top of a max-heap is the row to drop first */
+  static auto EntryLess(const TopNEntry &a, const TopNEntry &b) -> bool;
+
   /** The topn plan node to be executed */
   const TopNPlanNode *plan_;
   std::unique_ptr<AbstractExecutor> child_executor_;
-  std::vector<Tuple> child_tuples_{};
-  int child_tuples_index_{0};
-  size_t cnt_{0};
-  // std::priority_queue <>
+  SortKeyEncoder encoder_;
+  /** A max-heap of the best rows while reading the input, then those rows in order */
+  std::vector<TopNEntry> entries_;
+  /** The next row to emit */
+  size_t entries_index_{0};
 };
 }  // namespace bustub
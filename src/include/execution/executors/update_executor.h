@@ -58,11 +58,19 @@ class UpdateExecutor : public AbstractExecutor {
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); }
 
  private:
+  /**
+   * Update one tuple and its index entries. A tuple that no longer fits into its page is moved: the old one is
+   * deleted and the new one inserted elsewhere; if that fails, the old one is left in place. Throws
+   * ExecutionException, with the transaction aborted, if the update fails.
+   */
+  void UpdateTuple(const Tuple &old_tuple, const RID &old_rid);
+
   /** The update plan node to be executed */
   const UpdatePlanNode *plan_;
   /** Metadata identifying the table that should be updated */
   const TableInfo *table_info_;
   /** The child executor to obtain value from */
   std::unique_ptr<AbstractExecutor> child_executor_;
+  bool is_update_{false};
 };
 }  // namespace bustub
@@ -18,6 +18,7 @@
 #include <vector>
 
 #include "catalog/schema.h"
+#include "execution/tuple_batch.h"
 #include "fmt/format.h"
 #include "storage/table/tuple.h"
 
@@ -65,6 +66,13 @@ class AbstractExpression {
   virtual auto EvaluateJoin(const Tuple *left_tuple, const Schema &left_schema, const Tuple *right_tuple,
                             const Schema &right_schema) const -> Value = 0;
 
+  /**
+   * Evaluate the expression on the selected rows of a batch.
+   * @param batch The rows, whose columns are those of the schema Evaluate() would be called with
+   * @param[out] result One value per row of the batch; the values of the rows that are not selected are unspecified
+   */
+  virtual void EvaluateBatch(const TupleBatch &batch, std::vector<Value> *result) const = 0;
+
   /** @return the child_idx'th child of this expression */
   auto GetChildAt(uint32_t child_idx) const -> const AbstractExpressionRef & { return children_[child_idx]; }
 
@@ -65,6 +65,19 @@ class ArithmeticExpression : public AbstractExpression {
     return ValueFactory::GetIntegerValue(*res);
   }
 
+  void EvaluateBatch(const TupleBatch &batch, std::vector<Value> *result) const override {
+    std::vector<Value> lhs;
+    std::vector<Value> rhs;
+    GetChildAt(0)->EvaluateBatch(batch, &lhs);
+    GetChildAt(1)->EvaluateBatch(batch, &rhs);
+    result->resize(batch.GetSize());
+    for (auto row : batch.GetSelection()) {
+      auto res = PerformComputation(lhs[row], rhs[row]);
+      (*result)[row] = res == std::nullopt ? ValueFactory::GetNullValueByType(TypeId::INTEGER)
+                                           : ValueFactory::GetIntegerValue(*res);
+    }
+  }
+
   /** @return the string representation of the expression node and its children */
   auto ToString() const -> std::string override {
     return fmt::format("({}{}{})", *GetChildAt(0), compute_type_, *GetChildAt(1));
@@ -0,0 +1,129 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// join_hash_table.h
+//
+// Identification: src/include/execution/join_hash_table.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <limits>
+#include <vector>
+
+#include "common/util/hash_util.h"
+#include "execution/tuple_batch.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * JoinHashTable holds the build side of a hash join, keyed on the full join key (one or more values).
+ *
+ * The rows live in one flat arena of values, the key of a row first and then its columns. The table itself is an
+ * open-addressing array of (hash, row) slots with linear probing, one slot per distinct key; the rows that share a
+ * key are chained from the row in its slot. A probe compares the stored hash and then the stored key, so nothing is
+ * copied or evaluated again, and every row of the chain it finds is a match.
+ *
+ * Rows with a NULL in their key are not stored, since they never join.
+ */
+class JoinHashTable {
+ public:
+  /** Marks the end of a chain, and an empty slot */
+  static constexpr uint32_t NO_ROW = std::numeric_limits<uint32_t>::max();
+
+  /**
+   * @param key_count the number of values in a join key
+   * @param column_count the number of columns of a stored row
+   */
+  JoinHashTable(uint32_t key_count, uint32_t column_count) : key_count_(key_count), column_count_(column_count) {}
+
+  /** Remove all rows. */
+  void Clear();
+
+  /**
+   * Add a row of a batch.
+   * @param key_columns the values of the join key, one vector per key value, indexed like the rows of batch
+   * @param batch the batch holding the row
+   * @param row the row of batch to add
+   */
+  void Insert(const std::vector<std::vector<Value>> &key_columns, const TupleBatch &batch, uint32_t row);
+
+  /**
+   * Look up a join key.
+   * @param key_columns the values of the join key, one vector per key value
+   * @param row the row of key_columns to look up
+   * @return the first stored row with that key, NO_ROW if there is none; NextMatch gives the others
+   */
+  auto Find(const std::vector<std::vector<Value>> &key_columns, uint32_t row) const -> uint32_t;
+
+  /** @return the next stored row with the same key as stored_row, NO_ROW at the end */
+  auto NextMatch(uint32_t stored_row) const -> uint32_t { return next_[stored_row]; }
+
+  /** @return the column_idx-th column of a stored row */
+  auto GetValue(uint32_t stored_row, uint32_t column_idx) const -> const Value & {
+    return values_[static_cast<size_t>(stored_row) * (key_count_ + column_count_) + key_count_ + column_idx];
+  }
+
+  /** @return the number of stored rows */
+  auto GetRowCount() const -> size_t { return next_.size(); }
+
+  /** @return the number of distinct keys */
+  auto GetKeyCount() const -> size_t { return key_slots_; }
+
+  /** Call f with the hash of every distinct key. */
+  template <class F>
+  void ForEachKeyHash(F &&f) const {
+    for (const auto &slot : slots_) {
+      if (slot.row_ != NO_ROW) {
+        f(slot.hash_);
+      }
+    }
+  }
+
+  /** @return roughly how many bytes the stored rows and the slots take */
+  auto GetMemoryUsage() const -> size_t { return row_bytes_ + slots_.size() * sizeof(Slot); }
+
+  /** @return the hash of the join key of a row of key_columns, with all of its bits well mixed */
+  static auto HashKey(const std::vector<std::vector<Value>> &key_columns, uint32_t row) -> hash_t;
+
+  /** @return the hash of a join key given as one value per key expression, the same as HashKey above */
+  static auto HashKey(const std::vector<Value> &key) -> hash_t;
+
+  /** @return whether the join key of a row of key_columns has a NULL, so that it never joins */
+  static auto HasNull(const std::vector<std::vector<Value>> &key_columns, uint32_t row) -> bool;
+
+ private:
+  struct Slot {
+    hash_t hash_{0};
+    uint32_t row_{NO_ROW};
+  };
+
+  /** @return whether the key of a stored row equals a row of key_columns */
+  auto KeyEquals(uint32_t stored_row, const std::vector<std::vector<Value>> &key_columns, uint32_t row) const -> bool;
+
+  /** Mix all bits of a combined key hash into its low bits. */
+  static auto MixHash(hash_t hash) -> hash_t;
+
+  /** Double the slot array and put the keys back. */
+  void Grow();
+
+  uint32_t key_count_;
+  uint32_t column_count_;
+  /** The arena: the key and then the columns of every stored row */
+  std::vector<Value> values_;
+  /** The next row with the same key, for every stored row */
+  std::vector<uint32_t> next_;
+  /** The slots, a power of two of them, or none before the first insert */
+  std::vector<Slot> slots_;
+  /** The number of used slots, i.e. of distinct keys */
+  size_t key_slots_{0};
+  /** The bytes taken by the stored rows, including the data of variable-length values */
+  size_t row_bytes_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// loser_tree.h
+//
+// Identification: src/include/execution/loser_tree.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace bustub {
+
+/**
+ * LoserTree picks the smallest head among k sorted sources for a k-way merge (a tournament tree of losers).
+ *
+ * Every inner node keeps the source that lost the match played there, and the root keeps the overall winner. Once
+ * the winner has moved on to its next head, only the matches on the path from its leaf to the root are replayed,
+ * which takes log2(k) comparisons, against about twice as many for a binary heap.
+ *
+ * Less is called as less(a, b) on two source indexes and tells whether the head of a comes before the head of b. A
+ * source that is exhausted must come after every other one; to keep a merge stable, equal heads must be ordered by
+ * their source index.
+ */
+template <class Less>
+class LoserTree {
+ public:
+  LoserTree(size_t source_count, Less less) : source_count_(source_count), less_(std::move(less)) {}
+
+  /** Play all matches; the sources must all be at their first head. */
+  void Build() {
+    nodes_.assign(std::max<size_t>(source_count_, 1), 0);
+    if (source_count_ > 1) {
+      nodes_[0] = Play(1);
+    }
+  }
+
+  /** @return the source with the smallest head */
+  auto Top() const -> size_t { return nodes_[0]; }
+
+  /** Replay the matches of the winner, after its head has changed. */
+  void Replay() {
+    auto winner = nodes_[0];
+    for (auto node = (winner + source_count_) / 2; node > 0; node /= 2) {
+      if (less_(nodes_[node], winner)) {
+        std::swap(nodes_[node], winner);
+      }
+    }
+    nodes_[0] = winner;
+  }
+
+ private:
+  /** Play the matches of the subtree under node; the leaves are the nodes source_count_ to 2 * source_count_ - 1. */
+  auto Play(size_t node) -> size_t {
+    if (node >= source_count_) {
+      return node - source_count_;
+    }
+    auto left = Play(2 * node);
+    auto right = Play(2 * node + 1);
+    if (less_(right, left)) {
+      nodes_[node] = left;
+      return right;
+    }
+    nodes_[node] = right;
+    return left;
+  }
+
+  size_t source_count_;
+  Less less_;
+  /** The winner at index 0, and the loser of the match at every inner node 1 to source_count_ - 1 */
+  std::vector<size_t> nodes_;
+};
+
+}  // namespace bustub
@@ -19,6 +19,7 @@
 #include "binder/table_ref/bound_join_ref.h"
 #include "execution/expressions/abstract_expression.h"
 #include "execution/plans/abstract_plan.h"
+#include "fmt/ranges.h"
 
 namespace bustub {
 
@@ -31,25 +32,27 @@ class HashJoinPlanNode : public AbstractPlanNode {
    * Construct a new HashJoinPlanNode instance.
    * @param output_schema The output schema for the JOIN
    * @param children The child plans from which tuples are obtained
-   * @param left_key_expression The expression for the left JOIN key
-   * @param right_key_expression The expression for the right JOIN key
+   * @param left_key_expressions The expressions for the left JOIN key, one per value of a multi-column key
+   * @param right_key_expressions The expressions for the right JOIN key, in the same order
    */
   HashJoinPlanNode(SchemaRef output_schema, AbstractPlanNodeRef left, AbstractPlanNodeRef right,
-                   AbstractExpressionRef left_key_expression, AbstractExpressionRef right_key_expression,
-                   JoinType join_type)
+                   std::vector<AbstractExpressionRef> left_key_expressions,
+                   std::vector<AbstractExpressionRef> right_key_expressions, JoinType join_type)
       : AbstractPlanNode(std::move(output_schema), {std::move(left), std::move(right)}),
-        left_key_expression_{std::move(left_key_expression)},
-        right_key_expression_{std::move(right_key_expression)},
+        left_key_expressions_{std::move(left_key_expressions)},
+        right_key_expressions_{std::move(right_key_expressions)},
         join_type_(join_type) {}
 
   /** @return The type of the plan node */
   auto GetType() const -> PlanType override { return PlanType::HashJoin; }
 
-  /** @return The expression to compute the left join key */
-  auto LeftJoinKeyExpression() const -> const AbstractExpression & { return *left_key_expression_; }
+  /** @return The expressions to compute the left join key */
+  auto LeftJoinKeyExpressions() const -> const std::vector<AbstractExpressionRef> & { return left_key_expressions_; }
 
-  /** @return The expression to compute the right join key */
-  auto RightJoinKeyExpression() const -> const AbstractExpression & { return *right_key_expression_; }
+  /** @return The expressions to compute the right join key */
+  auto RightJoinKeyExpressions() const -> const std::vector<AbstractExpressionRef> & {
+    return right_key_expressions_;
+  }
 
   /** @return The left plan node of the hash join */
   auto GetLeftPlan() const -> AbstractPlanNodeRef {
@@ -68,18 +71,18 @@ class HashJoinPlanNode : public AbstractPlanNode {
 
   BUSTUB_PLAN_NODE_CLONE_WITH_CHILDREN(HashJoinPlanNode);
 
-  /** The expression to compute the left JOIN key */
-  AbstractExpressionRef left_key_expression_;
-  /** The expression to compute the right JOIN key */
-  AbstractExpressionRef right_key_expression_;
+  /** The expressions to compute the left JOIN key */
+  std::vector<AbstractExpressionRef> left_key_expressions_;
+  /** The expressions to compute the right JOIN key */
+  std::vector<AbstractExpressionRef> right_key_expressions_;
 
   /** The join type */
   JoinType join_type_;
 
  protected:
   auto PlanNodeToString() const -> std::string override {
-    return fmt::format("HashJoin {{ type={}, left_key={}, right_key={} }}", join_type_, left_key_expression_,
-                       right_key_expression_);
+    return fmt::format("HashJoin {{ type={}, left_key={}, right_key={} }}", join_type_, left_key_expressions_,
+                       right_key_expressions_);
   }
 };
 
@@ -17,6 +17,7 @@
 
 #include "catalog/catalog.h"
 #include "execution/expressions/abstract_expression.h"
+#include "execution/expressions/constant_value_expression.h"
 #include "execution/plans/abstract_plan.h"
 
 namespace bustub {
@@ -28,10 +29,13 @@ class IndexScanPlanNode : public AbstractPlanNode {
   /**
    * Creates a new index scan plan node.
    * @param output the output format of this scan plan node
-   * @param table_oid the identifier of table to be scanned
+   * @param index_oid the identifier of the index to be scanned
+   * @param pred_key if set, only the tuples whose key equals this constant are emitted; otherwise the whole index is
+   * scanned in key order
    */
-  IndexScanPlanNode(SchemaRef output, index_oid_t index_oid)
-      : AbstractPlanNode(std::move(output), {}), index_oid_(index_oid) {}
+  IndexScanPlanNode(SchemaRef output, index_oid_t index_oid,
+                    std::shared_ptr<const ConstantValueExpression> pred_key = nullptr)
+      : AbstractPlanNode(std::move(output), {}), index_oid_(index_oid), pred_key_(std::move(pred_key)) {}
 
   auto GetType() const -> PlanType override { return PlanType::IndexScan; }
 
@@ -43,10 +47,14 @@ class IndexScanPlanNode : public AbstractPlanNode {
   /** The table whose tuples should be scanned. */
   index_oid_t index_oid_;
 
-  // Add anything you want here for index lookup
+  /** The key to look up, or nullptr for a full scan. */
+  std::shared_ptr<const ConstantValueExpression> pred_key_;
 
  protected:
   auto PlanNodeToString() const -> std::string override {
+    if (pred_key_ != nullptr) {
+      return fmt::format("IndexScan {{ index_oid={}, pred_key={} }}", index_oid_, *pred_key_);
+    }
     return fmt::format("IndexScan {{ index_oid={} }}", index_oid_);
   }
 };
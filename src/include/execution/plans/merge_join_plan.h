@@ -0,0 +1,92 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// merge_join_plan.h
+//
+// Identification: src/include/execution/plans/merge_join_plan.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "binder/table_ref/bound_join_ref.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "fmt/ranges.h"
+
+namespace bustub {
+
+/**
+ * Merge join performs a JOIN operation on two inputs that both come sorted in ascending order on their join keys, by
+ * walking through them side by side. Rows with a NULL in their key never match, wherever they are in the input.
+ */
+class MergeJoinPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Construct a new MergeJoinPlanNode instance.
+   * @param output_schema The output schema for the JOIN
+   * @param children The child plans from which tuples are obtained
+   * @param left_key_expressions The expressions for the left JOIN key, one per value of a multi-column key; the left
+   * input is sorted on them in this order
+   * @param right_key_expressions The expressions for the right JOIN key, in the same order, which the right input is
+   * sorted on
+   */
+  MergeJoinPlanNode(SchemaRef output_schema, AbstractPlanNodeRef left, AbstractPlanNodeRef right,
+                    std::vector<AbstractExpressionRef> left_key_expressions,
+                    std::vector<AbstractExpressionRef> right_key_expressions, JoinType join_type)
+      : AbstractPlanNode(std::move(output_schema), {std::move(left), std::move(right)}),
+        left_key_expressions_{std::move(left_key_expressions)},
+        right_key_expressions_{std::move(right_key_expressions)},
+        join_type_(join_type) {}
+
+  /** @return The type of the plan node */
+  auto GetType() const -> PlanType override { return PlanType::MergeJoin; }
+
+  /** @return The expressions to compute the left join key */
+  auto LeftJoinKeyExpressions() const -> const std::vector<AbstractExpressionRef> & { return left_key_expressions_; }
+
+  /** @return The expressions to compute the right join key */
+  auto RightJoinKeyExpressions() const -> const std::vector<AbstractExpressionRef> & {
+    return right_key_expressions_;
+  }
+
+  /** @return The left plan node of the merge join */
+  auto GetLeftPlan() const -> AbstractPlanNodeRef {
+    BUSTUB_ASSERT(GetChildren().size() == 2, "Merge joins should have exactly two children plans.");
+    return GetChildAt(0);
+  }
+
+  /** @return The right plan node of the merge join */
+  auto GetRightPlan() const -> AbstractPlanNodeRef {
+    BUSTUB_ASSERT(GetChildren().size() == 2, "Merge joins should have exactly two children plans.");
+    return GetChildAt(1);
+  }
+
+  /** @return The join type used in the merge join */
+  auto GetJoinType() const -> JoinType { return join_type_; };
+
+  BUSTUB_PLAN_NODE_CLONE_WITH_CHILDREN(MergeJoinPlanNode);
+
+  /** The expressions to compute the left JOIN key */
+  std::vector<AbstractExpressionRef> left_key_expressions_;
+  /** The expressions to compute the right JOIN key */
+  std::vector<AbstractExpressionRef> right_key_expressions_;
+
+  /** The join type */
+  JoinType join_type_;
+
+ protected:
+  auto PlanNodeToString() const -> std::string override {
+    return fmt::format("MergeJoin {{ type={}, left_key={}, right_key={} }}", join_type_, left_key_expressions_,
+                       right_key_expressions_);
+  }
+};
+
+}  // namespace bustub
@@ -0,0 +1,106 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// runtime_filter.h
+//
+// Identification: src/include/execution/runtime_filter.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "common/util/hash_util.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * RuntimeFilter is a summary of the join keys of the build side of a hash join, which the join hands down to the scan
+ * of its probe side (see AbstractExecutor::PushRuntimeFilter) so that rows that cannot match are dropped before they
+ * are copied into batches and carried up the plan.
+ *
+ * It holds a Bloom filter on the key hashes and, for a single integer key, the range of the keys; each part is only
+ * checked once it has been enabled. A filter may pass rows that do not match, never the other way around.
+ */
+class RuntimeFilter {
+ public:
+  /** Disable both parts, so that every row passes. */
+  void Reset();
+
+  /** Enable the Bloom filter, sized for key_count distinct keys; no row passes it until their hashes are added. */
+  void EnableBloom(size_t key_count);
+
+  /** Add the hash of a key, as computed by JoinHashTable::HashKey, to the Bloom filter. */
+  void AddHash(hash_t hash);
+
+  /** Enable the range check; no row passes it until keys are added. */
+  void EnableRange();
+
+  /** Extend the range by a key, a non-NULL integer value. */
+  void AddToRange(const Value &key);
+
+  /** @return whether a key may be among the build keys; a key with a NULL never is */
+  auto MayContain(const std::vector<Value> &key) const -> bool;
+
+  /** @return whether the key type can be checked against a range */
+  static auto SupportsRange(TypeId type) -> bool {
+    return type == TypeId::TINYINT || type == TypeId::SMALLINT || type == TypeId::INTEGER || type == TypeId::BIGINT;
+  }
+
+ private:
+  /** The number of bits set per key */
+  static constexpr uint32_t NUM_PROBES = 3;
+
+  /** The bits of the Bloom filter, a power of two of them; none while it is disabled */
+  std::vector<uint64_t> bloom_;
+  bool has_range_{false};
+  int64_t min_{std::numeric_limits<int64_t>::max()};
+  int64_t max_{std::numeric_limits<int64_t>::min()};
+};
+
+/** The runtime filters an executor applies to its output rows, each on some of its columns. */
+class RuntimeFilterSet {
+ public:
+  void Add(std::shared_ptr<const RuntimeFilter> filter, std::vector<uint32_t> column_idxs) {
+    filters_.push_back({std::move(filter), std::move(column_idxs)});
+  }
+
+  /**
+   * @param get_value gives the value of an output column of the row
+   * @return whether a row may pass every filter
+   */
+  template <class GetValue>
+  auto MayPass(GetValue &&get_value) -> bool {
+    for (const auto &filter : filters_) {
+      key_.clear();
+      for (auto column_idx : filter.column_idxs_) {
+        key_.push_back(get_value(column_idx));
+      }
+      if (!filter.filter_->MayContain(key_)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+ private:
+  struct Entry {
+    std::shared_ptr<const RuntimeFilter> filter_;
+    std::vector<uint32_t> column_idxs_;
+  };
+
+  std::vector<Entry> filters_;
+  /** The key of the row being checked, kept across calls so that its buffer is reused */
+  std::vector<Value> key_;
+};
+
+}  // namespace bustub
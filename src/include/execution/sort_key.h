@@ -0,0 +1,56 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_key.h
+//
+// Identification: src/include/execution/sort_key.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "binder/bound_order_by.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/tuple_batch.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * SortKeyEncoder turns the ORDER BY values of a row into one normalized, memcomparable byte string: comparing the
+ * strings of two rows with memcmp (shorter first on a common prefix, as std::string does) orders them the way the
+ * ORDER BY does. Sorting and merging then compare keys without evaluating expressions or building Values.
+ *
+ * The values are encoded with MemComparableUtil, integers widened to BIGINT, and DESC values in descending order,
+ * which puts their NULLs last.
+ */
+class SortKeyEncoder {
+ public:
+  explicit SortKeyEncoder(const std::vector<std::pair<OrderByType, AbstractExpressionRef>> &order_bys)
+      : order_bys_(order_bys) {}
+
+  /** @return the key of a tuple of the given schema */
+  auto Encode(const Tuple &tuple, const Schema &schema) const -> std::string;
+
+  /**
+   * Encode the keys of the selected rows of a batch, evaluating every ORDER BY expression once for the whole batch.
+   * @param[out] keys one key per row of the batch; the keys of the rows that are not selected are unspecified
+   */
+  void EncodeBatch(const TupleBatch &batch, std::vector<std::string> *keys) const;
+
+  /** Append the encoding of a value to key. */
+  static void AppendValue(const Value &value, OrderByType order_by_type, std::string *key);
+
+ private:
+  const std::vector<std::pair<OrderByType, AbstractExpressionRef>> &order_bys_;
+};
+
+}  // namespace bustub
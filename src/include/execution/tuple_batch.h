@@ -0,0 +1,88 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch.h
+//
+// Identification: src/include/execution/tuple_batch.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/rid.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * TupleBatch holds up to BATCH_SIZE rows, column by column, for executors that process a batch at a time (see
+ * AbstractExecutor::NextBatch). Row i of the batch is the i-th value of every column.
+ *
+ * The selection vector lists the rows that are actually part of the batch, in ascending order. A filter drops rows by
+ * shrinking it rather than by moving values around; every consumer must only look at the selected rows.
+ */
+class TupleBatch {
+ public:
+  /** The number of rows an executor puts into a batch */
+  static constexpr uint32_t BATCH_SIZE = 1024;
+
+  /** Empty the batch and give it column_count columns. */
+  void Reset(uint32_t column_count);
+
+  auto GetColumnCount() const -> uint32_t { return columns_.size(); }
+
+  /** @return the number of rows, selected or not */
+  auto GetSize() const -> uint32_t { return rids_.size(); }
+
+  auto IsFull() const -> bool { return GetSize() >= BATCH_SIZE; }
+
+  /** Append a row, which is selected. */
+  void AppendTuple(const Tuple &tuple, const Schema &schema, RID rid);
+
+  /** Append a row, which is selected; values holds one value per column. */
+  void AppendRow(std::vector<Value> &&values, RID rid = RID{});
+
+  auto GetColumn(uint32_t column_idx) const -> const std::vector<Value> & { return columns_[column_idx]; }
+
+  /**
+   * @return a column for writing. To fill a column of a batch whose rows come from another batch (see
+   * CopyRowsFrom), resize it to GetSize() and set the selected rows.
+   */
+  auto GetColumnMut(uint32_t column_idx) -> std::vector<Value> & { return columns_[column_idx]; }
+
+  auto GetValue(uint32_t row, uint32_t column_idx) const -> const Value & { return columns_[column_idx][row]; }
+
+  auto GetRid(uint32_t row) const -> RID { return rids_[row]; }
+
+  /** @return the selected rows, in ascending order */
+  auto GetSelection() const -> const std::vector<uint32_t> & { return selection_; }
+
+  /** @return the selection vector for writing; it must stay in ascending order */
+  auto GetSelectionMut() -> std::vector<uint32_t> & { return selection_; }
+
+  auto NumSelected() const -> uint32_t { return selection_.size(); }
+
+  /** Take the rids and the selection of other, so that this batch has the same rows; the columns are not touched. */
+  void CopyRowsFrom(const TupleBatch &other) {
+    rids_ = other.rids_;
+    selection_ = other.selection_;
+  }
+
+  /** @return a row of the batch as a tuple of the given schema */
+  auto ToTuple(uint32_t row, const Schema &schema) const -> Tuple;
+
+ private:
+  std::vector<std::vector<Value>> columns_;
+  std::vector<RID> rids_;
+  std::vector<uint32_t> selection_;
+};
+
+}  // namespace bustub
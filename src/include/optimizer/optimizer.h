@@ -45,11 +45,25 @@ class Optimizer {
 
   /**
    * @brief optimize nested loop join into hash join.
-   * In the starter code, we will check NLJs with exactly one equal condition. You can further support optimizing joins
-   * with multiple eq conditions.
+   * The NLJ predicate must be one equal condition, or a conjunction of them, each between a column of the left table
+   * and a column of the right table; they make up a multi-column join key.
    */
   auto OptimizeNLJAsHashJoin(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
+  /**
+   * @brief optimize hash join into merge join, when both inputs already come sorted on the join key (e.g. from an
+   * index scan of a B+ tree); a sort on the join key right above the join is then dropped as well. Inputs are never
+   * sorted just for a merge join. Runs after OptimizeNLJAsHashJoin: a join becomes an index join if its right side is
+   * an indexed table, a merge join if its inputs come sorted, and a hash join otherwise.
+   */
+  auto OptimizeHashJoinAsMergeJoin(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
+  /**
+   * @brief get the columns that the output of a plan is known to be sorted on, in ascending order
+   * @return the output columns, most significant first; empty if the order is not known
+   */
+  auto GetOrderedColumns(const AbstractPlanNode &plan) -> std::vector<uint32_t>;
+
   /**
    * @brief optimize nested loop join into index join.
    */
@@ -85,6 +99,11 @@ class Optimizer {
    */
   auto OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
+  /**
+   * @brief rewrite an equality filter on a hash-indexed column over a seq scan as an index point lookup
+   */
+  auto OptimizeSeqScanAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
   /** @brief check if the index can be matched */
   auto MatchIndex(const std::string &table_name, uint32_t index_key_idx)
       -> std::optional<std::tuple<index_oid_t, std::string>>;
@@ -94,6 +113,12 @@ class Optimizer {
    */
   auto OptimizeSortLimitAsTopN(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
 
+  /**
+   * @brief make a seq scan of a PAX table below a projection or aggregation (and maybe a filter) read only the columns
+   * that are used
+   */
+  auto OptimizeColumnPruning(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef;
+
   /**
    * @brief get the estimated cardinality for a table based on the table name. Useful when join reordering. BusTub
    * doesn't support statistics for now, so it's the only way for you to get the table size :(
@@ -12,174 +12,223 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <stdexcept>
 #include <string>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "common/exception.h"
-#include "common/rwlatch.h"
 
 namespace bustub {
 
 /**
  * TrieNode is a generic container for any node in Trie.
+ *
+ * Nodes are shared between versions of a trie and must not change once they are reachable from a published root;
+ * writers modify copies made with Clone(). Children are kept in a small array sorted by key char, and in a 256-way
+ * array indexed by key char once a node has more than DENSE_THRESHOLD of them.
  */
 class TrieNode {
  public:
+  /** Number of children above which a node switches to the 256-way child array. */
+  static constexpr size_t DENSE_THRESHOLD = 16;
+
   /**
-   * TODO(P0): Add implementation
-   *
    * @brief Construct a new Trie Node object with the given key char.
-   * is_end_ flag should be initialized to false in this constructor.
+   * is_end_ flag is initialized to false.
    *
    * @param key_char Key character of this trie node
    */
-  explicit TrieNode(char key_char) {
-    key_char_ = key_char;
-    is_end_ = false;
-  }
+  explicit TrieNode(char key_char) : key_char_(key_char) {}
 
   /**
-   * TODO(P0): Add implementation
+   * @brief Copy constructor for trie node object. The copy shares the children of other_trie_node.
    *
-   * @brief Move constructor for trie node object. The unique pointers stored
-   * in children_ should be moved from other_trie_node to new trie node.
-   *
-   * @param other_trie_node Old trie node.
+   * @param other_trie_node Node to copy.
    */
-  TrieNode(TrieNode &&other_trie_node) noexcept {
-    key_char_ = other_trie_node.key_char_;
-    is_end_ = other_trie_node.is_end_;
-    children_ = std::move(other_trie_node.children_);
-    // other_trie_node=nullptr;
+  TrieNode(const TrieNode &other_trie_node)
+      : key_char_(other_trie_node.key_char_),
+        is_end_(other_trie_node.is_end_),
+        children_(other_trie_node.children_),
+        num_dense_children_(other_trie_node.num_dense_children_) {
+    if (other_trie_node.dense_children_ != nullptr) {
+      dense_children_ = std::make_unique<DenseChildren>(*other_trie_node.dense_children_);
+    }
   }
 
+  auto operator=(const TrieNode &) -> TrieNode & = delete;
+
   /**
    * @brief Destroy the TrieNode object.
    */
   virtual ~TrieNode() = default;
 
   /**
-   * TODO(P0): Add implementation
+   * @brief Copy this node, including its value if it holds one.
    *
+   * @return A modifiable copy that shares the children of this node.
+   */
+  virtual auto Clone() const -> std::unique_ptr<TrieNode> { return std::make_unique<TrieNode>(*this); }
+
+  /**
    * @brief Whether this trie node has a child node with specified key char.
    *
    * @param key_char Key char of child node.
    * @return True if this trie node has a child with given key, false otherwise.
    */
-  bool HasChild(char key_char) const { return children_.find(key_char) != children_.end(); }
+  auto HasChild(char key_char) const -> bool { return GetChildNode(key_char) != nullptr; }
 
   /**
-   * TODO(P0): Add implementation
-   *
-   * @brief Whether this trie node has any children at all. This is useful
-   * when implementing 'Remove' functionality.
+   * @brief Whether this trie node has any children at all.
    *
    * @return True if this trie node has any child node, false if it has no child node.
    */
-  bool HasChildren() const { return !children_.empty(); }
+  auto HasChildren() const -> bool { return ChildrenSize() != 0; }
 
   /**
-   * TODO(P0): Add implementation
-   *
    * @brief Whether this trie node is the ending character of a key string.
    *
    * @return True if is_end_ flag is true, false if is_end_ is false.
    */
-  bool IsEndNode() const { return is_end_; }
+  auto IsEndNode() const -> bool { return is_end_; }
 
   /**
-   * TODO(P0): Add implementation
-   *
    * @brief Return key char of this trie node.
    *
    * @return key_char_ of this trie node.
    */
-  char GetKeyChar() const { return key_char_; }
+  auto GetKeyChar() const -> char { return key_char_; }
 
   /**
-   * TODO(P0): Add implementation
-   *
-   * @brief Insert a child node for this trie node into children_ map, given the key char and
-   * unique_ptr of the child node. If specified key_char already exists in children_,
-   * return nullptr. If parameter `child`'s key char is different than parameter
-   * `key_char`, return nullptr.
+   * @brief Insert a child node for this trie node, given the key char and the child node. If specified key_char
+   * already exists, or if parameter `child`'s key char is different than parameter `key_char`, return nullptr.
    *
-   * Note that parameter `child` is rvalue and should be moved when it is
-   * inserted into children_map.
-   *
-   * The return value is a pointer to unique_ptr because pointer to unique_ptr can access the
-   * underlying data without taking ownership of the unique_ptr. Further, we can set the return
-   * value to nullptr when error occurs.
-   *
-   * @param key Key of child node
-   * @param child Unique pointer created for the child node. This should be added to children_ map.
-   * @return Pointer to unique_ptr of the inserted child node. If insertion fails, return nullptr.
+   * @param key_char Key of child node
+   * @param child Child node to add.
+   * @return Pointer to the inserted child node. If insertion fails, return nullptr.
    */
-  std::unique_ptr<TrieNode> *InsertChildNode(char key_char, std::unique_ptr<TrieNode> &&child) {
-    if (HasChild(key_char)) {
-      return nullptr;
-    }
-    if (child->GetKeyChar() != key_char) {
+  auto InsertChildNode(char key_char, std::shared_ptr<const TrieNode> child) -> const TrieNode * {
+    if (HasChild(key_char) || child->GetKeyChar() != key_char) {
       return nullptr;
     }
-    children_[key_char] = std::move(child);
-    return &(children_[key_char]);
+    const TrieNode *inserted = child.get();
+    SetChildNode(key_char, std::move(child));
+    return inserted;
   }
 
   /**
-   * TODO(P0): Add implementation
+   * @brief Add a child node, or replace the child node with the same key char.
    *
+   * @param key_char Key char of child node
+   * @param child Child node to store.
+   */
+  void SetChildNode(char key_char, std::shared_ptr<const TrieNode> child) {
+    if (dense_children_ != nullptr) {
+      auto &slot = (*dense_children_)[static_cast<unsigned char>(key_char)];
+      if (slot == nullptr) {
+        num_dense_children_++;
+      }
+      slot = std::move(child);
+      return;
+    }
+    auto it = LowerBound(key_char);
+    if (it != children_.end() && it->first == key_char) {
+      it->second = std::move(child);
+      return;
+    }
+    children_.emplace(it, key_char, std::move(child));
+    if (children_.size() > DENSE_THRESHOLD) {
+      dense_children_ = std::make_unique<DenseChildren>();
+      for (auto &[child_key, child_node] : children_) {
+        (*dense_children_)[static_cast<unsigned char>(child_key)] = std::move(child_node);
+      }
+      num_dense_children_ = children_.size();
+      children_.clear();
+    }
+  }
+
+  /**
    * @brief Get the child node given its key char. If child node for given key char does
    * not exist, return nullptr.
    *
-   * @param key Key of child node
-   * @return Pointer to unique_ptr of the child node, nullptr if child
-   *         node does not exist.
+   * @param key_char Key of child node
+   * @return Pointer to the child node, nullptr if child node does not exist.
    */
-  std::unique_ptr<TrieNode> *GetChildNode(char key_char) {
-    if (HasChild(key_char)) {
-      return &(children_[key_char]);
+  auto GetChildNode(char key_char) const -> const TrieNode * {
+    if (dense_children_ != nullptr) {
+      return (*dense_children_)[static_cast<unsigned char>(key_char)].get();
     }
-    return nullptr;
+    auto it = LowerBound(key_char);
+    return it != children_.end() && it->first == key_char ? it->second.get() : nullptr;
   }
 
   /**
-   * TODO(P0): Add implementation
-   *
-   * @brief Remove child node from children_ map.
-   * If key_char does not exist in children_, return immediately.
+   * @brief Remove child node. If key_char does not exist, return immediately.
    *
    * @param key_char Key char of child node to be removed
    */
   void RemoveChildNode(char key_char) {
-    if (HasChild(key_char)) {
-      children_.erase(key_char);
+    if (dense_children_ != nullptr) {
+      auto &slot = (*dense_children_)[static_cast<unsigned char>(key_char)];
+      if (slot != nullptr) {
+        slot.reset();
+        num_dense_children_--;
+      }
+      // Go back to the sorted array well below the threshold, so that nodes do not flip back and forth.
+      if (num_dense_children_ <= DENSE_THRESHOLD / 2) {
+        for (size_t c = 0; c < dense_children_->size(); c++) {
+          if ((*dense_children_)[c] != nullptr) {
+            children_.emplace_back(static_cast<char>(c), std::move((*dense_children_)[c]));
+          }
+        }
+        std::sort(children_.begin(), children_.end(),
+                  [](const auto &left, const auto &right) { return left.first < right.first; });
+        dense_children_.reset();
+        num_dense_children_ = 0;
+      }
+      return;
+    }
+    auto it = LowerBound(key_char);
+    if (it != children_.end() && it->first == key_char) {
+      children_.erase(it);
     }
   }
 
   /**
-   * TODO(P0): Add implementation
-   *
    * @brief Set the is_end_ flag to true or false.
    *
    * @param is_end Whether this trie node is ending char of a key string
    */
   void SetEndNode(bool is_end) { is_end_ = is_end; }
 
-  int ChildrenSize() { return children_.size(); }
+  auto ChildrenSize() const -> size_t { return dense_children_ != nullptr ? num_dense_children_ : children_.size(); }
 
  protected:
+  using Child = std::pair<char, std::shared_ptr<const TrieNode>>;
+  using DenseChildren = std::array<std::shared_ptr<const TrieNode>, 256>;
+
+  auto LowerBound(char key_char) const -> std::vector<Child>::const_iterator {
+    return std::lower_bound(children_.begin(), children_.end(), key_char,
+                            [](const Child &child, char key) { return child.first < key; });
+  }
+  auto LowerBound(char key_char) -> std::vector<Child>::iterator {
+    return std::lower_bound(children_.begin(), children_.end(), key_char,
+                            [](const Child &child, char key) { return child.first < key; });
+  }
+
   /** Key character of this trie node */
   char key_char_;
   /** whether this node marks the end of a key */
   bool is_end_{false};
-  /** A map of all child nodes of this trie node, which can be accessed by each
-   * child node's key char. */
-  std::unordered_map<char, std::unique_ptr<TrieNode>> children_;
+  /** Child nodes sorted by key char, empty while dense_children_ is in use */
+  std::vector<Child> children_;
+  /** Child nodes indexed by key char, for nodes with many children */
+  std::unique_ptr<DenseChildren> dense_children_;
+  size_t num_dense_children_{0};
 };
 
 /**
@@ -194,76 +243,63 @@ class TrieNodeWithValue : public TrieNode {
 
  public:
   /**
-   * TODO(P0): Add implementation
-   *
    * @brief Construct a new TrieNodeWithValue object from a TrieNode object and specify its value.
-   * This is used when a non-terminal TrieNode is converted to terminal TrieNodeWithValue.
-   *
-   * The children_ map of TrieNode should be moved to the new TrieNodeWithValue object.
-   * Since it contains unique pointers, the first parameter is a rvalue reference.
+   * This is used when a non-terminal TrieNode is converted to terminal TrieNodeWithValue. The new node shares the
+   * children of trieNode.
    *
-   * You should:
-   * 1) invoke TrieNode's move constructor to move data from TrieNode to
-   * TrieNodeWithValue.
-   * 2) set value_ member variable of this node to parameter `value`.
-   * 3) set is_end_ to true
-   *
-   * @param trieNode TrieNode whose data is to be moved to TrieNodeWithValue
+   * @param trieNode TrieNode whose key char and children are copied
    * @param value
    */
-  TrieNodeWithValue(TrieNode &&trieNode, T value) : TrieNode(std::move(trieNode)), value_(value) { SetEndNode(true); }
+  TrieNodeWithValue(const TrieNode &trieNode, T value) : TrieNode(trieNode), value_(std::move(value)) {
+    SetEndNode(true);
+  }
 
   /**
-   * TODO(P0): Add implementation
-   *
    * @brief Construct a new TrieNodeWithValue. This is used when a new terminal node is constructed.
    *
-   * You should:
-   * 1) Invoke the constructor for TrieNode with the given key_char.
-   * 2) Set value_ for this node.
-   * 3) set is_end_ to true.
-   *
    * @param key_char Key char of this node
    * @param value Value of this node
    */
-  TrieNodeWithValue(char key_char, T value) : TrieNode(key_char), value_(value) { SetEndNode(true); }
+  TrieNodeWithValue(char key_char, T value) : TrieNode(key_char), value_(std::move(value)) { SetEndNode(true); }
 
   /**
    * @brief Destroy the Trie Node With Value object
    */
   ~TrieNodeWithValue() override = default;
 
+  auto Clone() const -> std::unique_ptr<TrieNode> override { return std::make_unique<TrieNodeWithValue>(*this); }
+
   /**
    * @brief Get the stored value_.
    *
    * @return Value of type T stored in this node
    */
-  T GetValue() const { return value_; }
+  auto GetValue() const -> T { return value_; }
 };
 
 /**
  * Trie is a concurrent key-value store. Each key is a string and its corresponding
  * value can be any type.
+ *
+ * The trie is persistent: a write copies the nodes on the path to its key and publishes a new root, while every
+ * version stays immutable. Readers take an atomic snapshot of the root and walk it without any latch; a version is
+ * freed when the last reader holding it is done. Writers are serialized by write_latch_.
  */
 class Trie {
  private:
-  /* Root node of the trie */
-  std::unique_ptr<TrieNode> root_;
-  /* Read-write lock for the trie */
-  ReaderWriterLatch latch_;
+  /* Root node of the current version of the trie, accessed with std::atomic_load and std::atomic_store */
+  std::shared_ptr<const TrieNode> root_;
+  /* Serializes writers */
+  std::mutex write_latch_;
 
  public:
   /**
-   * TODO(P0): Add implementation
-   *
    * @brief Construct a new Trie object. Initialize the root node with '\0'
    * character.
    */
-  Trie() : root_(std::make_unique<TrieNode>('\0')) {}
+  Trie() : root_(std::make_shared<const TrieNode>('\0')) {}
 
   /**
-   * TODO(P0): Add implementation
-   *
    * @brief Insert key-value pair into the trie.
    *
    * If the key is an empty string, return false immediately.
@@ -271,104 +307,95 @@ class Trie {
    * If the key already exists, return false. Duplicated keys are not allowed and
    * you should never overwrite value of an existing key.
    *
-   * When you reach the ending character of a key:
-   * 1. If TrieNode with this ending character does not exist, create new TrieNodeWithValue
-   * and add it to parent node's children_ map.
-   * 2. If the terminal node is a TrieNode, then convert it into TrieNodeWithValue by
-   * invoking the appropriate constructor.
-   * 3. If it is already a TrieNodeWithValue,
-   * then insertion fails and returns false. Do not overwrite existing data with new data.
-   *
-   * You can quickly check whether a TrieNode pointer holds TrieNode or TrieNodeWithValue
-   * by checking the is_end_ flag. If is_end_ == false, then it points to TrieNode. If
-   * is_end_ == true, it points to TrieNodeWithValue.
-   *
    * @param key Key used to traverse the trie and find the correct node
    * @param value Value to be inserted
    * @return True if insertion succeeds, false if the key already exists
    */
   template <typename T>
-  bool Insert(const std::string &key, T value) {
-    latch_.WLock();
+  auto Insert(const std::string &key, T value) -> bool {
     if (key.empty()) {
-      latch_.WUnlock();
       return false;
     }
-    std::unique_ptr<TrieNode> *p = &root_;
-    int len = key.length();
-    for (int i = 0; i < len; i++) {
-      if ((*p)->HasChild(key[i])) {
-        p = (*p)->GetChildNode(key[i]);
-      } else {
-        p = (*p)->InsertChildNode(key[i], std::make_unique<TrieNode>(key[i]));
-      }
+    std::lock_guard<std::mutex> guard(write_latch_);
+    std::shared_ptr<const TrieNode> root = std::atomic_load(&root_);
+
+    // old_path[i] is the node for the first i chars of the key, or nullptr where the key leaves the trie.
+    std::vector<const TrieNode *> old_path{root.get()};
+    for (char key_char : key) {
+      old_path.push_back(old_path.back() == nullptr ? nullptr : old_path.back()->GetChildNode(key_char));
     }
-    if ((*p)->IsEndNode()) {
-      latch_.WUnlock();
+    if (old_path.back() != nullptr && old_path.back()->IsEndNode()) {
       return false;
     }
-    auto newnode = new TrieNodeWithValue<T>(std::move(**p), value);
-    p->reset(newnode);
-    latch_.WUnlock();
+
+    std::shared_ptr<const TrieNode> child;
+    if (old_path.back() != nullptr) {
+      child = std::make_shared<const TrieNodeWithValue<T>>(*old_path.back(), std::move(value));
+    } else {
+      child = std::make_shared<const TrieNodeWithValue<T>>(key.back(), std::move(value));
+    }
+    for (size_t i = key.size(); i-- > 0;) {
+      std::unique_ptr<TrieNode> node =
+          old_path[i] != nullptr ? old_path[i]->Clone() : std::make_unique<TrieNode>(key[i - 1]);
+      node->SetChildNode(key[i], std::move(child));
+      child = std::move(node);
+    }
+    std::atomic_store(&root_, std::move(child));
     return true;
   }
 
   /**
-   * TODO(P0): Add implementation
-   *
    * @brief Remove key value pair from the trie.
-   * This function should also remove nodes that are no longer part of another
+   * This function also removes nodes that are no longer part of another
    * key. If key is empty or not found, return false.
    *
-   * You should:
-   * 1) Find the terminal node for the given key.
-   * 2) If this terminal node does not have any children, remove it from its
-   * parent's children_ map.
-   * 3) Recursively remove nodes that have no children and are not terminal node
-   * of another key.
-   *
    * @param key Key used to traverse the trie and find the correct node
    * @return True if the key exists and is removed, false otherwise
    */
+  auto Remove(const std::string &key) -> bool {
+    if (key.empty()) {
+      return false;
+    }
+    std::lock_guard<std::mutex> guard(write_latch_);
+    std::shared_ptr<const TrieNode> root = std::atomic_load(&root_);
 
-  bool Remove(const std::string &key) {
-    latch_.WLock();
-    int len = key.length();
-    std::unique_ptr<TrieNode> *p = &root_;
-    std::unique_ptr<TrieNode> *fa = nullptr;
-    std::vector<std::unique_ptr<TrieNode> *> ve;
-    for (int i = 0; i < len; i++) {
-      fa = p;
-      ve.push_back(fa);
-      if ((*p)->HasChild(key[i])) {
-        p = (*p)->GetChildNode(key[i]);
-      } else {
-        latch_.WUnlock();
+    std::vector<const TrieNode *> old_path{root.get()};
+    for (char key_char : key) {
+      const TrieNode *next = old_path.back()->GetChildNode(key_char);
+      if (next == nullptr) {
         return false;
       }
+      old_path.push_back(next);
     }
-    if (!(*p)->IsEndNode()) {
-      latch_.WUnlock();
+    if (!old_path.back()->IsEndNode()) {
       return false;
     }
-    (*p)->SetEndNode(false);
-    while (!ve.empty()) {
-      fa = ve.back();
-      ve.pop_back();
-      if ((*p)->HasChildren() || (*p)->IsEndNode()) {
-        latch_.WUnlock();
-        return true;
+
+    // The terminal node loses its value; nodes that end up without children and value are dropped from their parent.
+    std::shared_ptr<const TrieNode> child;
+    if (old_path.back()->HasChildren()) {
+      auto node = std::make_shared<TrieNode>(*old_path.back());
+      node->SetEndNode(false);
+      child = std::move(node);
+    }
+    for (size_t i = key.size(); i-- > 0;) {
+      std::unique_ptr<TrieNode> node = old_path[i]->Clone();
+      if (child != nullptr) {
+        node->SetChildNode(key[i], std::move(child));
+      } else {
+        node->RemoveChildNode(key[i]);
+      }
+      if (i > 0 && !node->HasChildren() && !node->IsEndNode()) {
+        child.reset();
+      } else {
+        child = std::move(node);
       }
-      (*fa)->RemoveChildNode((*p)->GetKeyChar());
-      p = fa;
     }
-    latch_.WUnlock();
+    std::atomic_store(&root_, std::move(child));
     return true;
   }
 
   /**
-   * TODO(P0): Add implementation
-   *
    * @brief Get the corresponding value of type T given its key.
    * If key is empty, set success to false.
    * If key does not exist in trie, set success to false.
@@ -376,46 +403,31 @@ class Trie {
    * (ie. GetValue<int> is called but terminal node holds std::string),
    * set success to false.
    *
-   * To check whether the two types are the same, dynamic_cast
-   * the terminal TrieNode to TrieNodeWithValue<T>. If the casted result
-   * is not nullptr, then type T is the correct type.
-   *
    * @param key Key used to traverse the trie and find the correct node
    * @param success Whether GetValue is successful or not
    * @return Value of type T if type matches
    */
   template <typename T>
-  T GetValue(const std::string &key, bool *success) {
-    latch_.RLock();
+  auto GetValue(const std::string &key, bool *success) -> T {
+    *success = false;
     if (key.empty()) {
-      *success = false;
-      latch_.RUnlock();
       return {};
     }
-    std::unique_ptr<TrieNode> *p = &root_;
-    for (auto it : key) {
-      if ((*p)->HasChild(it)) {
-        p = (*p)->GetChildNode(it);
-      } else {
-        *success = false;
-        latch_.RUnlock();
+    // The snapshot keeps every node of this version alive until the lookup is done.
+    std::shared_ptr<const TrieNode> root = std::atomic_load(&root_);
+    const TrieNode *node = root.get();
+    for (char key_char : key) {
+      node = node->GetChildNode(key_char);
+      if (node == nullptr) {
         return {};
       }
     }
-    if (!(*p)->IsEndNode()) {
-      *success = false;
-      latch_.RUnlock();
-      return {};
-    }
-    auto *rt = dynamic_cast<TrieNodeWithValue<T> *>(p->get());
-    if (rt == nullptr) {
-      *success = false;
-      latch_.RUnlock();
+    auto *terminal = dynamic_cast<const TrieNodeWithValue<T> *>(node);
+    if (terminal == nullptr || !terminal->IsEndNode()) {
       return {};
     }
     *success = true;
-    latch_.RUnlock();
-    return rt->GetValue();
+    return terminal->GetValue();
   }
 };
 }  // namespace bustub
@@ -0,0 +1,47 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// art_index.h
+//
+// Identification: src/include/storage/index/art_index.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "container/art/adaptive_radix_tree.h"
+#include "storage/index/index.h"
+
+namespace bustub {
+
+/**
+ * ArtIndex keeps its entries in an in-memory adaptive radix tree instead of buffer pool pages. Keys are stored in
+ * their memcomparable encoding, so the index works for any key schema and key order is byte order.
+ */
+class ArtIndex : public Index {
+ public:
+  explicit ArtIndex(std::unique_ptr<IndexMetadata> &&metadata);
+
+  void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
+
+  /** Collect the RIDs of up to limit entries whose key is not less than key, in key order. */
+  void ScanFrom(const Tuple &key, size_t limit, std::vector<RID> *result);
+
+ private:
+  auto EncodeKey(const Tuple &key) const -> std::vector<uint8_t>;
+
+  // container
+  AdaptiveRadixTree<RID> container_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,104 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_link_tree.h
+//
+// Identification: src/include/storage/index/b_link_tree.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "concurrency/transaction.h"
+#include "storage/page/b_link_tree_page.h"
+
+namespace bustub {
+
+#define BLINKTREE_TYPE BLinkTree<KeyType, ValueType, KeyComparator>
+
+/**
+ * Lehman-Yao B-link tree backed by the buffer pool.
+ *
+ * Every node carries a high key and a link to its right sibling, which makes a
+ * split visible to concurrent searches before the separator reaches the parent:
+ * a search that arrives at a node whose high key is not greater than the search
+ * key just follows the right link.
+ *
+ * (1) Readers latch one node at a time and never block on a split in progress.
+ * (2) Writers descend like readers and write-latch only the leaf. A split
+ *     child stays latched until the node that takes its separator is latched,
+ *     so a writer holds at most three latches: the child, a parent, and that
+ *     parent's right sibling while moving right. Latches are only ever taken
+ *     upwards or to the right, so writers cannot deadlock.
+ * (3) Only unique keys are supported.
+ * (4) Removal deletes the entry from its leaf but never merges nodes, as in the
+ *     original protocol. Pages are therefore never freed while the tree lives,
+ *     which is what allows searches to drop a latch before following a pointer.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class BLinkTree {
+  using LeafPage = BLinkTreePage<KeyType, ValueType, KeyComparator>;
+  using InternalPage = BLinkTreePage<KeyType, page_id_t, KeyComparator>;
+
+ public:
+  explicit BLinkTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
+                     int leaf_max_size = B_LINK_TREE_PAGE_SIZE(KeyType, ValueType),
+                     int internal_max_size = B_LINK_TREE_PAGE_SIZE(KeyType, page_id_t));
+
+  // Returns true if this tree has never stored a key.
+  auto IsEmpty() const -> bool;
+
+  // Insert a key-value pair into this tree.
+  auto Insert(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr) -> bool;
+
+  // Remove a key and its value from this tree.
+  void Remove(const KeyType &key, Transaction *transaction = nullptr);
+
+  // return the value associated with a given key
+  auto GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction = nullptr) -> bool;
+
+  // return the page id of the root node
+  auto GetRootPageId() -> page_id_t;
+
+ private:
+  auto FetchNode(page_id_t page_id) -> Page *;
+
+  // Create the first leaf if the tree is still empty.
+  void StartNewTree();
+
+  // Descend to the leaf covering key and return it write-latched. Internal nodes visited on the way are pushed to
+  // path, from the root down.
+  auto FindLeafForWrite(const KeyType &key, std::vector<page_id_t> *path) -> Page *;
+
+  // Follow right links from a write-latched page until it covers key; a page stays latched until its sibling is.
+  auto MoveRightForWrite(Page *page, const KeyType &key) -> Page *;
+
+  // Post the separator of a split to the parent level. child is write-latched and is released by this call.
+  void InsertIntoParent(Page *child, const KeyType &key, page_id_t new_page_id, std::vector<page_id_t> *path);
+
+  // Find a node at level that covers key, starting from the current root.
+  auto FindNodeAtLevel(const KeyType &key, int level) -> page_id_t;
+
+  void UpdateRootPageId(int insert_record = 0);
+
+  // member variable
+  std::string index_name_;
+  std::atomic<page_id_t> root_page_id_;
+  BufferPoolManager *buffer_pool_manager_;
+  KeyComparator comparator_;
+  int leaf_max_size_;
+  int internal_max_size_;
+  // Serializes the creation of a new root; never held while a page latch is being waited on.
+  std::mutex root_latch_;
+};
+
+}  // namespace bustub
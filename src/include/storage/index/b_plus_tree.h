@@ -81,6 +81,12 @@ class BPlusTree {
   void ReleaseLatch(Transaction *transaction);
   auto OptimisticPessimisticLock(const KeyType &key, int type, Transaction *transaction) -> Page *;
   auto GetLeafPageByKey(const KeyType &key, int type, Transaction *transaction) -> Page *;
+  /**
+   * Crab down to a leaf with read latches, holding at most two pages at a time. Must be called with root_latch_
+   * read-locked on a non-empty tree; releases it once the root page is latched.
+   * @param key the leaf that may contain key, or the leftmost/rightmost leaf if nullptr
+   */
+  auto FindLeafRead(const KeyType *key, bool rightmost = false) -> ReadPageGuard;
   auto GetNewRootPage() -> InternalPage *;
   auto GetNewInternalPage(page_id_t parent_id) -> InternalPage *;
   auto GetNewLeafPage(page_id_t parent_id) -> LeafPage *;
@@ -14,6 +14,7 @@
  */
 #pragma once
 #include "storage/page/b_plus_tree_leaf_page.h"
+#include "storage/page/page_guard.h"
 
 namespace bustub {
 
@@ -24,9 +25,10 @@ class IndexIterator {
  public:
   using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
 
-  // you may define your own constructor based on your member variables
-  IndexIterator(BufferPoolManager *bpm, Page *page, LeafPage *leaf_, int index = 0);
-  ~IndexIterator();
+  /** An iterator over an empty tree, which points to no leaf. */
+  IndexIterator() = default;
+  /** An iterator at the index-th entry of the leaf held by guard. The leaf stays pinned and read-latched. */
+  IndexIterator(BufferPoolManager *bpm, ReadPageGuard guard, int index = 0);
 
   auto IsEnd() -> bool;
 
@@ -35,6 +37,10 @@ class IndexIterator {
   auto operator++() -> IndexIterator &;
 
   auto operator==(const IndexIterator &itr) const -> bool {
+    // Iterators over an empty tree do not point to any leaf.
+    if (leafnode_ == nullptr || itr.leafnode_ == nullptr) {
+      return leafnode_ == itr.leafnode_;
+    }
     return (leafnode_->GetPageId() == itr.leafnode_->GetPageId() && index_ == itr.index_);
   }
 
@@ -42,10 +48,10 @@ class IndexIterator {
 
  private:
   // add your own private member variables here
-  BufferPoolManager *buffer_pool_manager_;
-  Page *page_;
-  LeafPage *leafnode_;
-  int index_;
+  BufferPoolManager *buffer_pool_manager_{nullptr};
+  ReadPageGuard guard_;
+  LeafPage *leafnode_{nullptr};
+  int index_{0};
 };
 
 }  // namespace bustub
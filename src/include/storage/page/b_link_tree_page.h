@@ -0,0 +1,107 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_link_tree_page.h
+//
+// Identification: src/include/storage/page/b_link_tree_page.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+
+#include "storage/page/b_plus_tree_page.h"
+
+namespace bustub {
+
+#define B_LINK_TREE_PAGE_TYPE BLinkTreePage<KeyType, ValueType, KeyComparator>
+#define B_LINK_TREE_PAGE_HEADER_SIZE 32
+#define B_LINK_TREE_PAGE_SIZE(KeyType, ValueType) \
+  ((BUSTUB_PAGE_SIZE - B_LINK_TREE_PAGE_HEADER_SIZE - sizeof(KeyType)) / sizeof(std::pair<KeyType, ValueType>))
+
+/**
+ * A node of a Lehman-Yao B-link tree. Leaf and internal nodes share the same
+ * layout; leaves store <key, rid> pairs and internal nodes store <key, child
+ * page id> pairs where the first key is unused.
+ *
+ * Every node covers the half-open key range [low key, high key). The low key
+ * is implied by the parent, the high key is stored in the node and equals the
+ * smallest key of the right sibling. When a node splits, the upper half moves
+ * into a fresh right sibling before the parent learns about it, so a search
+ * that lands on the left half simply follows the right link.
+ *
+ * Page format:
+ *  ----------------------------------------------------------------------
+ * | HEADER | HIGH KEY | KEY(1) + VALUE(1) | ... | KEY(n) + VALUE(n)
+ *  ----------------------------------------------------------------------
+ *
+ * Header format (size in byte, 32 bytes in total):
+ *  ---------------------------------------------------------------------
+ * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) | Level (4) |
+ *  ---------------------------------------------------------------------
+ *  ----------------------------------------------------
+ * | PageId (4) | RightPageId (4) | HasHighKey (4) |
+ *  ----------------------------------------------------
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class BLinkTreePage {
+ public:
+  // After creating a new page from buffer pool, must call initialize method to set default values
+  void Init(page_id_t page_id, int level, int max_size);
+
+  auto IsLeafPage() const -> bool { return page_type_ == IndexPageType::LEAF_PAGE; }
+  auto GetLevel() const -> int { return level_; }
+  auto GetSize() const -> int { return size_; }
+  void SetSize(int size) { size_ = size; }
+  auto GetMaxSize() const -> int { return max_size_; }
+  auto GetPageId() const -> page_id_t { return page_id_; }
+  auto GetRightPageId() const -> page_id_t { return right_page_id_; }
+  void SetRightPageId(page_id_t right_page_id) { right_page_id_ = right_page_id; }
+
+  auto HasHighKey() const -> bool { return has_high_key_ != 0; }
+  auto GetHighKey() const -> const KeyType & { return high_key_; }
+  void SetHighKey(const KeyType &key);
+
+  /** @return true if key is beyond the range of this node, i.e. the search has to follow the right link */
+  auto NeedMoveRight(const KeyType &key, const KeyComparator &comparator) const -> bool;
+
+  auto KeyAt(int index) const -> KeyType { return array_[index].first; }
+  auto ValueAt(int index) const -> ValueType { return array_[index].second; }
+
+  /** @return index of the first key that is not less than key (leaf only) */
+  auto LowerBound(const KeyType &key, const KeyComparator &comparator) const -> int;
+
+  /** @return the child covering key (internal only) */
+  auto LookupChild(const KeyType &key, const KeyComparator &comparator) const -> ValueType;
+
+  /** @return the index of value, or -1 if it is not stored in this node */
+  auto ValueIndex(const ValueType &value) const -> int;
+
+  void InsertAt(int index, const KeyType &key, const ValueType &value);
+  void RemoveAt(int index);
+
+  /**
+   * Move the upper half of this node into recipient and link recipient in as the right sibling. The high key of
+   * this node becomes the first key of recipient.
+   */
+  void MoveHalfTo(BLinkTreePage *recipient);
+
+ private:
+  IndexPageType page_type_;
+  lsn_t lsn_;
+  int size_;
+  int max_size_;
+  int level_;
+  page_id_t page_id_;
+  page_id_t right_page_id_;
+  int has_high_key_;
+  KeyType high_key_;
+  // Flexible array member for page data.
+  MappingType array_[1];
+};
+
+}  // namespace bustub
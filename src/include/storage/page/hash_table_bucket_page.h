@@ -33,10 +33,21 @@ namespace bustub {
  *  The above format omits the space required for the occupied_ and
  *  readable_ arrays. More information is in storage/page/hash_table_page_defs.h.
  *
+ *  Every slot also keeps a one-byte fingerprint of its key. Lookups compare
+ *  the fingerprints of BUCKET_GROUP_SIZE slots at once with SIMD, mask the
+ *  result with the readable_ bits, and only compare the keys of the slots
+ *  that survive.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class HashTableBucketPage {
  public:
+  /** Number of (key, value) slots in a bucket */
+  static constexpr uint32_t ARRAY_SIZE = BUCKET_ARRAY_SIZE;
+  /** Number of slots probed at once; the per-slot arrays are padded to a multiple of it */
+  static constexpr uint32_t BUCKET_GROUP_SIZE = 32;
+  static constexpr uint32_t PADDED_ARRAY_SIZE =
+      (ARRAY_SIZE + BUCKET_GROUP_SIZE - 1) / BUCKET_GROUP_SIZE * BUCKET_GROUP_SIZE;
+
   // Delete all constructor / destructor to ensure memory safety
   HashTableBucketPage() = delete;
 
@@ -138,10 +149,20 @@ class HashTableBucketPage {
   void PrintBucket();
 
  private:
+  /** One byte of a hash of the key, computed from its bytes like HashFunction does. */
+  static auto Fingerprint(const KeyType &key) -> uint8_t;
+
+  /** Bits of the group starting at group_start from one of the bitmaps, slot i of the group in bit i. */
+  static auto LoadGroupBits(const char *bitmap, uint32_t group_start) -> uint32_t;
+
+  /** Bits of the slots of a group whose fingerprint equals fingerprint, whether readable or not. */
+  auto MatchFingerprint(uint32_t group_start, uint8_t fingerprint) const -> uint32_t;
+
   //  For more on BUCKET_ARRAY_SIZE see storage/page/hash_table_page_defs.h
-  char occupied_[(BUCKET_ARRAY_SIZE - 1) / 8 + 1];
+  char occupied_[PADDED_ARRAY_SIZE / 8];
   // 0 if tombstone/brand new (never occupied), 1 otherwise.
-  char readable_[(BUCKET_ARRAY_SIZE - 1) / 8 + 1];
+  char readable_[PADDED_ARRAY_SIZE / 8];
+  uint8_t fingerprints_[PADDED_ARRAY_SIZE];
   // Flexible array member for page data.
   MappingType array_[1];
 };
@@ -0,0 +1,100 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_directory_header_page.h
+//
+// Identification: src/include/storage/page/hash_table_directory_header_page.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cassert>
+#include <cstdlib>
+
+#include "common/config.h"
+#include "storage/page/hash_table_page_defs.h"
+
+namespace bustub {
+
+/**
+ *
+ * Header Page for extendible hash table, the first level of a two-level directory.
+ *
+ * The top max_depth bits of a key's hash select one of up to 2^max_depth directory pages, which are created on
+ * first use. Each directory page then maps the low bits of the hash to buckets as usual, so the table grows to
+ * 2^max_depth full directories instead of one.
+ *
+ * Header format (size in byte):
+ * ---------------------------------------------------------------------------
+ * | LSN (4) | PageId(4) | MaxDepth(4) | DirectoryPageIds(2048) | Free(2036)
+ * ---------------------------------------------------------------------------
+ */
+class HashTableDirectoryHeaderPage {
+ public:
+  /**
+   * Initialize a freshly allocated header page; no directory exists yet.
+   *
+   * @param page_id the page ID of this page
+   * @param max_depth number of hash bits used to select a directory, at most DIRECTORY_HEADER_MAX_DEPTH
+   */
+  void Init(page_id_t page_id, uint32_t max_depth);
+
+  /**
+   * @return the page ID of this page
+   */
+  auto GetPageId() const -> page_id_t;
+
+  /**
+   * @return the lsn of this page
+   */
+  auto GetLSN() const -> lsn_t;
+
+  /**
+   * Sets the LSN of this page
+   *
+   * @param lsn the log sequence number to which to set the lsn field
+   */
+  void SetLSN(lsn_t lsn);
+
+  /**
+   * @return number of hash bits used to select a directory
+   */
+  auto GetMaxDepth() const -> uint32_t;
+
+  /**
+   * @return number of directory slots
+   */
+  auto Size() const -> uint32_t;
+
+  /**
+   * Maps a hash to the index of its directory, using the most significant max_depth bits
+   *
+   * @param hash the 32-bit hash of a key
+   * @return the directory index
+   */
+  auto HashToDirectoryIndex(uint32_t hash) const -> uint32_t;
+
+  /**
+   * @param directory_idx the index to lookup
+   * @return the page ID of the directory, or INVALID_PAGE_ID if it has not been created yet
+   */
+  auto GetDirectoryPageId(uint32_t directory_idx) const -> page_id_t;
+
+  /**
+   * @param directory_idx the index to update
+   * @param directory_page_id the page ID of the directory
+   */
+  void SetDirectoryPageId(uint32_t directory_idx, page_id_t directory_page_id);
+
+ private:
+  page_id_t page_id_;
+  lsn_t lsn_;
+  uint32_t max_depth_;
+  page_id_t directory_page_ids_[DIRECTORY_HEADER_ARRAY_SIZE];
+};
+
+}  // namespace bustub
@@ -28,6 +28,30 @@
  */
 #define BLOCK_ARRAY_SIZE (4 * BUSTUB_PAGE_SIZE / (4 * sizeof(MappingType) + 1))
 
+/**
+ * HEADER_BLOCK_ARRAY_SIZE is the number of block page_ids that fit in a linear probe hash header page after its 32
+ * bytes of fields, which bounds the number of slots of a linear probe hash table to HEADER_BLOCK_ARRAY_SIZE *
+ * BLOCK_ARRAY_SIZE.
+ */
+#define HEADER_BLOCK_ARRAY_SIZE ((BUSTUB_PAGE_SIZE - 32) / sizeof(page_id_t))
+
+/**
+ * Robin Hood Hashing Definitions
+ */
+#define HASH_TABLE_ROBIN_HOOD_BLOCK_TYPE HashTableRobinHoodBlockPage<KeyType, ValueType, KeyComparator>
+
+/**
+ * ROBIN_HOOD_BLOCK_ARRAY_SIZE is the number of (key, value) pairs that can be stored in a Robin Hood hash block page.
+ * Each pair comes with a one-byte probe distance; 8 bytes are set aside for aligning the pairs after the distances.
+ */
+#define ROBIN_HOOD_BLOCK_ARRAY_SIZE ((BUSTUB_PAGE_SIZE - 8) / (sizeof(MappingType) + 1))
+
+/**
+ * ROBIN_HOOD_MAX_PROBE_DISTANCE is the largest distance of a pair from its home slot in a Robin Hood hash table, the
+ * most a probe distance byte can hold.
+ */
+#define ROBIN_HOOD_MAX_PROBE_DISTANCE 254
+
 /**
  * Extendible Hashing Definitions
  */
@@ -35,16 +59,24 @@
 
 /**
  * BUCKET_ARRAY_SIZE is the number of (key, value) pairs that can be stored in an extendible hash index bucket page.
- * The computation is the same as the above BLOCK_ARRAY_SIZE, but blocks and buckets have different implementations
- * of search, insertion, removal, and helper methods.
+ * Besides the occupied_ and readable_ bits, every pair of a bucket also has a one-byte fingerprint, so each slot
+ * takes sizeof(MappingType) + 1.25 bytes. The three per-slot arrays are padded to whole probe groups, for which 64
+ * bytes of the page are set aside.
  */
-#define BUCKET_ARRAY_SIZE (4 * BUSTUB_PAGE_SIZE / (4 * sizeof(MappingType) + 1))
+#define BUCKET_ARRAY_SIZE (4 * (BUSTUB_PAGE_SIZE - 64) / (4 * sizeof(MappingType) + 5))
 
 /**
  * DIRECTORY_ARRAY_SIZE is the number of page_ids that can fit in the directory page of an extendible hash index.
  * This is 512 because the directory array must grow in powers of 2, and 1024 page_ids leaves zero room for
  * storage of the other member variables: page_id_, lsn_, global_depth_, and the array local_depths_.
- * Extending the directory implementation to span multiple pages would be a meaningful improvement to the
- * implementation.
+ * Tables that outgrow one directory page spread over several directories through a header page.
  */
 #define DIRECTORY_ARRAY_SIZE 512
+
+/**
+ * DIRECTORY_HEADER_MAX_DEPTH is the largest number of hash bits the extendible hash table header page may use to
+ * select a directory page; the header then holds DIRECTORY_HEADER_ARRAY_SIZE directory page_ids. Together with the
+ * 9 bits of a full directory this addresses 2^18 buckets.
+ */
+#define DIRECTORY_HEADER_MAX_DEPTH 9
+#define DIRECTORY_HEADER_ARRAY_SIZE (1 << DIRECTORY_HEADER_MAX_DEPTH)
@@ -0,0 +1,73 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_robin_hood_block_page.h
+//
+// Identification: src/include/storage/page/hash_table_robin_hood_block_page.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+
+#include "common/config.h"
+#include "storage/index/int_comparator.h"
+#include "storage/page/hash_table_page_defs.h"
+
+namespace bustub {
+/**
+ * Block page of a Robin Hood hash table. Next to every key/value pair it stores how far the pair sits from its home
+ * slot, which is all the table needs to keep probe sequences short and to delete without tombstones.
+ *
+ * Block page format:
+ *  ------------------------------------------------------------------------------------
+ * | DISTANCE(1) | ... | DISTANCE(n) | KEY(1) + VALUE(1) | ... | KEY(n) + VALUE(n)
+ *  ------------------------------------------------------------------------------------
+ *
+ *  A distance byte holds the probe distance plus one, 0 marks an empty slot.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class HashTableRobinHoodBlockPage {
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  HashTableRobinHoodBlockPage() = delete;
+
+  /** @return the key at an occupied index of the block */
+  auto KeyAt(slot_offset_t bucket_ind) const -> KeyType;
+
+  /** @return the value at an occupied index of the block */
+  auto ValueAt(slot_offset_t bucket_ind) const -> ValueType;
+
+  /** @return whether the index holds a pair */
+  auto IsOccupied(slot_offset_t bucket_ind) const -> bool;
+
+  /** @return the distance of the pair at an occupied index from its home slot */
+  auto ProbeDistanceAt(slot_offset_t bucket_ind) const -> uint32_t;
+
+  /**
+   * Stores a pair at an index, replacing whatever was there.
+   *
+   * @param bucket_ind index to write the pair to
+   * @param pair the key and value
+   * @param probe_distance distance of the index from the pair's home slot, at most ROBIN_HOOD_MAX_PROBE_DISTANCE
+   */
+  void SetPair(slot_offset_t bucket_ind, const MappingType &pair, uint32_t probe_distance);
+
+  /** @return the pair at an occupied index */
+  auto PairAt(slot_offset_t bucket_ind) const -> const MappingType & { return array_[bucket_ind]; }
+
+  /** Marks an index empty. */
+  void Clear(slot_offset_t bucket_ind);
+
+ private:
+  uint8_t distances_[ROBIN_HOOD_BLOCK_ARRAY_SIZE];
+  // Flexible array member for page data.
+  MappingType array_[1];
+};
+
+}  // namespace bustub
@@ -0,0 +1,174 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_guard.h
+//
+// Identification: src/include/storage/page/page_guard.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <type_traits>
+
+#include "common/macros.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+class BufferPoolManager;
+class ReadPageGuard;
+class WritePageGuard;
+
+/**
+ * BasicPageGuard keeps a page pinned for as long as it lives and unpins it on destruction, marking it dirty if the
+ * page was modified through the guard. Guards are move-only; a moved-from or dropped guard holds nothing.
+ * Obtain guards from BufferPoolManager::FetchPageBasic/FetchPageRead/FetchPageWrite/NewPageGuarded.
+ */
+class BasicPageGuard {
+ public:
+  BasicPageGuard() = default;
+  BasicPageGuard(BufferPoolManager *bpm, Page *page) : bpm_(bpm), page_(page) {}
+  ~BasicPageGuard() { Drop(); }
+
+  DISALLOW_COPY(BasicPageGuard);
+  BasicPageGuard(BasicPageGuard &&that) noexcept;
+  auto operator=(BasicPageGuard &&that) noexcept -> BasicPageGuard &;
+
+  /** Unpin the page now rather than on destruction. */
+  void Drop();
+
+  /** Take the read latch, keeping the pin. This guard is empty afterwards. */
+  auto UpgradeRead() -> ReadPageGuard;
+
+  /** Take the write latch, keeping the pin. This guard is empty afterwards. */
+  auto UpgradeWrite() -> WritePageGuard;
+
+  /** @return false if the guard holds no page, e.g. because the fetch failed */
+  auto IsValid() const -> bool { return page_ != nullptr; }
+
+  auto PageId() -> page_id_t { return page_->GetPageId(); }
+
+  auto GetData() -> const char * { return page_->GetData(); }
+
+  /** @return the page data for writing, which marks the page dirty */
+  auto GetDataMut() -> char * {
+    is_dirty_ = true;
+    return page_->GetData();
+  }
+
+  /**
+   * @return the page as T: the frame itself for subclasses of Page such as TablePage, the page data for overlay
+   * types such as BPlusTreePage. Does not mark the page dirty.
+   */
+  template <class T>
+  auto As() -> T * {
+    if constexpr (std::is_base_of_v<Page, T>) {
+      return static_cast<T *>(page_);
+    } else {
+      return reinterpret_cast<T *>(page_->GetData());
+    }
+  }
+
+  /** @return the page as T, see As(), and mark the page dirty */
+  template <class T>
+  auto AsMut() -> T * {
+    is_dirty_ = true;
+    return As<T>();
+  }
+
+  /** Mark the page dirty, for changes made through As(). */
+  void SetDirty() { is_dirty_ = true; }
+
+ private:
+  friend class ReadPageGuard;
+  friend class WritePageGuard;
+
+  BufferPoolManager *bpm_{nullptr};
+  Page *page_{nullptr};
+  bool is_dirty_{false};
+};
+
+/** ReadPageGuard holds a pin and the read latch of a page, and releases both on destruction. */
+class ReadPageGuard {
+ public:
+  ReadPageGuard() = default;
+  /** Take over the pin of guard; the caller must already hold the read latch of its page. */
+  explicit ReadPageGuard(BasicPageGuard &&guard) : guard_(std::move(guard)) {}
+  ~ReadPageGuard() { Drop(); }
+
+  DISALLOW_COPY(ReadPageGuard);
+  ReadPageGuard(ReadPageGuard &&that) noexcept = default;
+  auto operator=(ReadPageGuard &&that) noexcept -> ReadPageGuard &;
+
+  /** Release the latch and unpin the page now rather than on destruction. */
+  void Drop();
+
+  /** Release the read latch but keep the pin. This guard is empty afterwards. */
+  auto Downgrade() -> BasicPageGuard;
+
+  auto IsValid() const -> bool { return guard_.IsValid(); }
+
+  auto PageId() -> page_id_t { return guard_.PageId(); }
+
+  auto GetData() -> const char * { return guard_.GetData(); }
+
+  /** @return the page as T, see BasicPageGuard::As(); it must not be modified */
+  template <class T>
+  auto As() -> T * {
+    return guard_.As<T>();
+  }
+
+ private:
+  BasicPageGuard guard_;
+};
+
+/** WritePageGuard holds a pin and the write latch of a page, and releases both on destruction. */
+class WritePageGuard {
+ public:
+  WritePageGuard() = default;
+  /** Take over the pin of guard; the caller must already hold the write latch of its page. */
+  explicit WritePageGuard(BasicPageGuard &&guard) : guard_(std::move(guard)) {}
+  ~WritePageGuard() { Drop(); }
+
+  DISALLOW_COPY(WritePageGuard);
+  WritePageGuard(WritePageGuard &&that) noexcept = default;
+  auto operator=(WritePageGuard &&that) noexcept -> WritePageGuard &;
+
+  /** Release the latch and unpin the page now rather than on destruction. */
+  void Drop();
+
+  /**
+   * Release the write latch but keep the pin. This guard is empty afterwards. There is no atomic downgrade to a read
+   * latch: call UpgradeRead() on the result and expect that other writers may have run in between.
+   */
+  auto Downgrade() -> BasicPageGuard;
+
+  auto IsValid() const -> bool { return guard_.IsValid(); }
+
+  auto PageId() -> page_id_t { return guard_.PageId(); }
+
+  auto GetData() -> const char * { return guard_.GetData(); }
+
+  auto GetDataMut() -> char * { return guard_.GetDataMut(); }
+
+  template <class T>
+  auto As() -> T * {
+    return guard_.As<T>();
+  }
+
+  template <class T>
+  auto AsMut() -> T * {
+    return guard_.AsMut<T>();
+  }
+
+  void SetDirty() { guard_.SetDirty(); }
+
+ private:
+  BasicPageGuard guard_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,179 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pax_page.h
+//
+// Identification: src/include/storage/page/pax_page.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstring>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/rid.h"
+#include "storage/page/page.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * PaxLayout tells where the minipage of each column starts in a PaxPage. It only depends on the schema, so all pages
+ * of a table share one layout.
+ */
+class PaxLayout {
+ public:
+  explicit PaxLayout(const Schema &schema);
+
+  /** @return the schema of the rows */
+  auto GetSchema() const -> const Schema & { return schema_; }
+
+  /** @return the number of rows that fit into a page, if their variable-length data does */
+  auto GetCapacity() const -> uint32_t { return capacity_; }
+
+  /** @return the offset of the minipage of a column in the page */
+  auto GetColumnOffset(uint32_t column_idx) const -> uint32_t { return column_offsets_[column_idx]; }
+
+  /** @return the end of the last minipage; variable-length data grows down from the end of the page to here */
+  auto GetMinipagesEnd() const -> uint32_t { return minipages_end_; }
+
+ private:
+  /** Space reserved for the variable-length data of each VARCHAR value when sizing the minipages */
+  static constexpr uint32_t VARLEN_ESTIMATE = 32;
+
+  Schema schema_;
+  uint32_t capacity_;
+  std::vector<uint32_t> column_offsets_;
+  uint32_t minipages_end_;
+};
+
+/**
+ * PAX page format: the values of each column are stored together in a minipage, so that a scan of a few columns only
+ * reads those. Row i of the page has slot i in every minipage. A minipage entry is the inlined part of the value, as
+ * in a tuple; for VARCHAR columns it is the offset of the length-prefixed data in the page.
+ *  -----------------------------------------------------------------------------------------------
+ *  | HEADER | ROW STATES | COLUMN 0 MINIPAGE | COLUMN 1 MINIPAGE | ... | FREE SPACE | VARLEN DATA |
+ *  -----------------------------------------------------------------------------------------------
+ *
+ *  Header format (size in bytes); the page ids are at the same offsets as in a TablePage:
+ *  ------------------------------------------------------------------------------------------------
+ *  | PageId (4)| LSN (4)| PrevPageId (4)| NextPageId (4)| RowCount (4)| VarlenPointer (4)|
+ *  ------------------------------------------------------------------------------------------------
+ *
+ * Rows are appended; a deleted row leaves its slot empty until the page is dropped.
+ */
+class PaxPage : public Page {
+ public:
+  /**
+   * Initialize the PaxPage header.
+   * @param page_id the page ID of this page
+   * @param prev_page_id the previous page ID
+   */
+  void Init(page_id_t page_id, page_id_t prev_page_id);
+
+  /** @return the page ID of this page */
+  auto GetTablePageId() -> page_id_t { return *reinterpret_cast<page_id_t *>(GetData()); }
+
+  /** @return the page ID of the previous page */
+  auto GetPrevPageId() -> page_id_t { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_PREV_PAGE_ID); }
+
+  /** @return the page ID of the next page */
+  auto GetNextPageId() -> page_id_t { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_NEXT_PAGE_ID); }
+
+  /** Set the page id of the previous page in the table. */
+  void SetPrevPageId(page_id_t prev_page_id) {
+    memcpy(GetData() + OFFSET_PREV_PAGE_ID, &prev_page_id, sizeof(page_id_t));
+  }
+
+  /** Set the page id of the next page in the table. */
+  void SetNextPageId(page_id_t next_page_id) {
+    memcpy(GetData() + OFFSET_NEXT_PAGE_ID, &next_page_id, sizeof(page_id_t));
+  }
+
+  /** @return the number of slots in use, including those of deleted rows */
+  auto GetRowCount() -> uint32_t { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_ROW_COUNT); }
+
+  /**
+   * Append a row to the page.
+   * @param tuple the row, in the format of layout's schema
+   * @param layout the layout of the page
+   * @param[out] rid rid of the inserted row
+   * @return false if the page is full
+   */
+  auto InsertTuple(const Tuple &tuple, const PaxLayout &layout, RID *rid) -> bool;
+
+  /** Mark a row as deleted. @return false if it does not exist */
+  auto MarkDelete(const RID &rid) -> bool;
+
+  /** To be called on commit or abort. Actually delete the row. */
+  void ApplyDelete(const RID &rid);
+
+  /** To be called on abort. Rollback a delete, i.e. this reverses a MarkDelete. */
+  void RollbackDelete(const RID &rid);
+
+  /**
+   * Put a row back together.
+   * @param rid rid of the row
+   * @param layout the layout of the page
+   * @param[out] tuple the row
+   * @return true if the row exists and is not deleted
+   */
+  auto GetTuple(const RID &rid, const PaxLayout &layout, Tuple *tuple) -> bool;
+
+  /** @return the value of one column of the row in slot slot_num, which must exist */
+  auto GetValue(uint32_t slot_num, const PaxLayout &layout, uint32_t column_idx) -> Value;
+
+  /** @return true if the row in slot slot_num exists and is not deleted */
+  auto IsLive(uint32_t slot_num) -> bool {
+    return slot_num < GetRowCount() && GetData()[OFFSET_ROW_STATES + slot_num] == ROW_LIVE;
+  }
+
+  /**
+   * @param[out] first_rid the RID of the first row in this page
+   * @return true if the first row exists, false otherwise
+   */
+  auto GetFirstTupleRid(RID *first_rid) -> bool;
+
+  /**
+   * @param cur_rid the RID of the current row
+   * @param[out] next_rid the RID of the row following the current one
+   * @return true if the next row exists, false otherwise
+   */
+  auto GetNextTupleRid(const RID &cur_rid, RID *next_rid) -> bool;
+
+ private:
+  static_assert(sizeof(page_id_t) == 4);
+
+  static constexpr size_t OFFSET_PREV_PAGE_ID = 8;
+  static constexpr size_t OFFSET_NEXT_PAGE_ID = 12;
+  static constexpr size_t OFFSET_ROW_COUNT = 16;
+  static constexpr size_t OFFSET_VARLEN_POINTER = 20;
+  static constexpr size_t OFFSET_ROW_STATES = 24;
+
+  static constexpr char ROW_EMPTY = 0;
+  static constexpr char ROW_LIVE = 1;
+  static constexpr char ROW_DELETED = 2;
+
+  friend class PaxLayout;
+
+  void SetRowCount(uint32_t row_count) { memcpy(GetData() + OFFSET_ROW_COUNT, &row_count, sizeof(uint32_t)); }
+
+  /** @return the start of the variable-length data */
+  auto GetVarlenPointer() -> uint32_t { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_VARLEN_POINTER); }
+
+  void SetVarlenPointer(uint32_t pointer) { memcpy(GetData() + OFFSET_VARLEN_POINTER, &pointer, sizeof(uint32_t)); }
+
+  /** @return the size of a length-prefixed VARCHAR value, as stored in a tuple or in the page */
+  static auto VarlenSize(const char *data) -> uint32_t {
+    auto len = *reinterpret_cast<const uint32_t *>(data);
+    return sizeof(uint32_t) + (len == BUSTUB_VALUE_NULL ? 0 : len);
+  }
+};
+
+}  // namespace bustub
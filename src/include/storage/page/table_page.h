@@ -13,6 +13,7 @@
 #pragma once
 
 #include <cstring>
+#include <vector>
 
 #include "common/rid.h"
 #include "concurrency/lock_manager.h"
@@ -36,10 +37,13 @@ namespace bustub {
  *  ----------------------------------------------------------------------------
  *  | PageId (4)| LSN (4)| PrevPageId (4)| NextPageId (4)| FreeSpacePointer(4) |
  *  ----------------------------------------------------------------------------
- *  ----------------------------------------------------------------
- *  | TupleCount (4) | Tuple_1 offset (4) | Tuple_1 size (4) | ... |
- *  ----------------------------------------------------------------
+ *  -------------------------------------------------------------------------------------
+ *  | TupleCount (4) | FreedSpace (4) | Tuple_1 offset (4) | Tuple_1 size (4) | ... |
+ *  -------------------------------------------------------------------------------------
  *
+ * Deleting or shrinking a tuple leaves a hole among the inserted tuples rather than shifting the others; FreedSpace
+ * counts the bytes in such holes. A page is only compacted, closing all holes in one pass, once an insert or a
+ * growing update does not fit into the free space otherwise. Empty slots are reused by inserts.
  */
 class TablePage : public Page {
  public:
@@ -84,6 +88,20 @@ class TablePage : public Page {
   auto InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn, LockManager *lock_manager, LogManager *log_manager)
       -> bool;
 
+  /**
+   * Insert as many of the given tuples as fit into the table, in order. Free slots are found in a single pass over
+   * the slot array, rather than once per tuple.
+   * @param tuples the tuples to insert
+   * @param begin index of the first tuple to insert
+   * @param[out] rids the rids of the inserted tuples are appended here
+   * @param txn transaction performing the insert
+   * @param lock_manager the lock manager
+   * @param log_manager the log manager
+   * @return the number of tuples inserted, starting at begin
+   */
+  auto InsertTuples(const std::vector<Tuple> &tuples, size_t begin, std::vector<RID> *rids, Transaction *txn,
+                    LockManager *lock_manager, LogManager *log_manager) -> size_t;
+
   /**
    * Mark a tuple as deleted. This does not actually delete the tuple.
    * @param rid rid of the tuple to mark as deleted
@@ -95,14 +113,14 @@ class TablePage : public Page {
   auto MarkDelete(const RID &rid, Transaction *txn, LockManager *lock_manager, LogManager *log_manager) -> bool;
 
   /**
-   * Update a tuple.
+   * Update a tuple in place. A tuple that grows moves to the free space, which is compacted first if needed.
    * @param new_tuple new value of the tuple
    * @param[out] old_tuple old value of the tuple
    * @param rid rid of the tuple
    * @param txn transaction performing the update
    * @param lock_manager the lock manager
    * @param log_manager the log manager
-   * @return true if updating the tuple succeeded
+   * @return true if updating the tuple succeeded, false if it does not exist or the new value does not fit
    */
   auto UpdateTuple(const Tuple &new_tuple, Tuple *old_tuple, const RID &rid, Transaction *txn,
                    LockManager *lock_manager, LogManager *log_manager) -> bool;
@@ -123,6 +141,15 @@ class TablePage : public Page {
    */
   auto GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockManager *lock_manager) -> bool;
 
+  /**
+   * Point a tuple at the data of a live tuple in this page, without copying it and without taking row locks.
+   * The tuple is only valid while the caller keeps this page pinned and latched; copy it to keep it longer.
+   * @param rid rid of the tuple to read
+   * @param[out] tuple the tuple that borrows the page memory
+   * @return true if the tuple exists and is not deleted
+   */
+  auto GetTupleView(const RID &rid, Tuple *tuple) -> bool;
+
   /** @return the rid of the first tuple in this page */
 
   /**
@@ -138,17 +165,30 @@ class TablePage : public Page {
    */
   auto GetNextTupleRid(const RID &cur_rid, RID *next_rid) -> bool;
 
+  /** @return the size of the largest tuple that fits into an empty page; no page takes a larger one */
+  static constexpr auto MaxTupleSize() -> uint32_t { return BUSTUB_PAGE_SIZE - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE; }
+
+  /** @return the size of the largest tuple that InsertTuple can still fit into this page, compacting it if needed */
+  auto GetMaxInsertSize() -> uint32_t {
+    auto free_space = GetFreeSpaceRemaining() + GetFreedSpace();
+    return free_space > SIZE_TUPLE ? free_space - SIZE_TUPLE : 0;
+  }
+
+  /** Move all tuples to the end of the page, so that the free space is contiguous again. Keeps every rid valid. */
+  void Compact();
+
  private:
   static_assert(sizeof(page_id_t) == 4);
 
-  static constexpr size_t SIZE_TABLE_PAGE_HEADER = 24;
+  static constexpr size_t SIZE_TABLE_PAGE_HEADER = 28;
   static constexpr size_t SIZE_TUPLE = 8;
   static constexpr size_t OFFSET_PREV_PAGE_ID = 8;
   static constexpr size_t OFFSET_NEXT_PAGE_ID = 12;
   static constexpr size_t OFFSET_FREE_SPACE = 16;
   static constexpr size_t OFFSET_TUPLE_COUNT = 20;
-  static constexpr size_t OFFSET_TUPLE_OFFSET = 24;  // Naming things is hard.
-  static constexpr size_t OFFSET_TUPLE_SIZE = 28;
+  static constexpr size_t OFFSET_FREED_SPACE = 24;
+  static constexpr size_t OFFSET_TUPLE_OFFSET = 28;  // Naming things is hard.
+  static constexpr size_t OFFSET_TUPLE_SIZE = 32;
 
   /** @return pointer to the end of the current free space, see header comment */
   auto GetFreeSpacePointer() -> uint32_t { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SPACE); }
@@ -167,6 +207,13 @@ class TablePage : public Page {
   /** Set the number of tuples in this page. */
   void SetTupleCount(uint32_t tuple_count) { memcpy(GetData() + OFFSET_TUPLE_COUNT, &tuple_count, sizeof(uint32_t)); }
 
+  /** @return the number of bytes in holes between the free space pointer and the end of the page */
+  auto GetFreedSpace() -> uint32_t { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREED_SPACE); }
+
+  /** Set the number of bytes in holes between the free space pointer and the end of the page. */
+  void SetFreedSpace(uint32_t freed_space) { memcpy(GetData() + OFFSET_FREED_SPACE, &freed_space, sizeof(uint32_t)); }
+
+  /** @return the size of the contiguous free space between the slot array and the free space pointer */
   auto GetFreeSpaceRemaining() -> uint32_t {
     return GetFreeSpacePointer() - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE * GetTupleCount();
   }
@@ -191,6 +238,19 @@ class TablePage : public Page {
     memcpy(GetData() + OFFSET_TUPLE_SIZE + SIZE_TUPLE * slot_num, &size, sizeof(uint32_t));
   }
 
+  /**
+   * Make room for a tuple of the given size, plus a new slot if needed, compacting the page if that is what it takes.
+   * @return false if the tuple does not fit even then
+   */
+  auto ReserveSpace(uint32_t tuple_size, bool new_slot) -> bool;
+
+  /**
+   * Give up the space of a tuple that is no longer referenced by its slot.
+   * @param tuple_offset where the tuple starts
+   * @param tuple_size how many bytes it takes
+   */
+  void FreeSpace(uint32_t tuple_offset, uint32_t tuple_size);
+
   /** @return true if the tuple is deleted or empty */
   static auto IsDeleted(uint32_t tuple_size) -> bool {
     return static_cast<bool>(tuple_size & DELETE_MASK) || tuple_size == 0;
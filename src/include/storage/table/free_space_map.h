@@ -0,0 +1,79 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map.h
+//
+// Identification: src/include/storage/table/free_space_map.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * FreeSpaceMap remembers how large a tuple each page of a table heap can still take, so that an insert can go
+ * straight to a page that fits instead of walking the page chain.
+ *
+ * The sizes are a max-tree over the pages in chain order: every inner node holds the largest size below it, so the
+ * first page that fits is found in O(log pages) without touching any page. On top of that the map caches the page
+ * that took the last insert, which is where the next insert almost always goes.
+ *
+ * The recorded sizes are only hints. They are reported by the table heap after each change to a page, so a
+ * concurrent writer may have used up the space by the time the page is latched; callers must re-check under the page
+ * latch and report the actual size back.
+ */
+class FreeSpaceMap {
+ public:
+  FreeSpaceMap() = default;
+
+  /**
+   * Register a page at the end of the table.
+   * @param page_id the page appended to the page chain
+   * @param max_insert_size the largest tuple the page can take
+   */
+  void AppendPage(page_id_t page_id, uint32_t max_insert_size);
+
+  /**
+   * Record how large a tuple a page can take now. Pages that were never appended are ignored.
+   * @param page_id the page
+   * @param max_insert_size the largest tuple the page can take
+   */
+  void UpdatePage(page_id_t page_id, uint32_t max_insert_size);
+
+  /**
+   * @param tuple_size the size of the tuple to insert
+   * @return a page that should fit the tuple, the last used page if possible; INVALID_PAGE_ID if there is none
+   */
+  auto FindPage(uint32_t tuple_size) -> page_id_t;
+
+  /** @return the page at the end of the page chain, INVALID_PAGE_ID if no page was appended */
+  auto GetLastPageId() -> page_id_t;
+
+  /** @return the number of pages in the map */
+  auto GetNumPages() -> size_t;
+
+ private:
+  void SetSize(size_t index, uint32_t max_insert_size);
+
+  std::mutex latch_;
+  /** The pages in chain order */
+  std::vector<page_id_t> page_ids_;
+  std::unordered_map<page_id_t, size_t> page_index_;
+  /** Max-tree over the page sizes; the leaf of page i is at capacity + i, the root at 1 */
+  std::vector<uint32_t> tree_{0, 0};
+  size_t capacity_{1};
+  /** Index of the page that took the last insert */
+  size_t hint_{0};
+};
+
+}  // namespace bustub
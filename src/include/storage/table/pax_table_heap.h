@@ -0,0 +1,87 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pax_table_heap.h
+//
+// Identification: src/include/storage/table/pax_table_heap.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "storage/page/pax_page.h"
+#include "storage/table/table_heap.h"
+
+namespace bustub {
+
+/**
+ * PaxTableHeap is a table heap whose pages store the rows column by column (see PaxPage). Rows are appended to the
+ * last page. Point reads and the table iterator put whole rows back together; ScanColumns reads only the columns a
+ * query needs, which is what makes the format pay off for scans of a few columns of a wide table.
+ *
+ * Rows are never updated in place: UpdateTuple always fails, and the update executor deletes and re-inserts instead.
+ */
+class PaxTableHeap : public TableHeap {
+ public:
+  /**
+   * Create a PAX table heap with a transaction. (create table)
+   * @param buffer_pool_manager the buffer pool manager
+   * @param lock_manager the lock manager
+   * @param log_manager the log manager
+   * @param schema the schema of the rows
+   * @param txn the creating transaction
+   */
+  PaxTableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
+               const Schema &schema, Transaction *txn);
+
+  auto InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> bool override;
+
+  auto InsertTuples(const std::vector<Tuple> &tuples, std::vector<RID> *rids, Transaction *txn) -> bool override;
+
+  auto MarkDelete(const RID &rid, Transaction *txn) -> bool override;
+
+  /** Always false, rows are not updated in place. */
+  auto UpdateTuple(const Tuple &tuple, const RID &rid, Transaction *txn) -> bool override;
+
+  void ApplyDelete(const RID &rid, Transaction *txn) override;
+
+  void RollbackDelete(const RID &rid, Transaction *txn) override;
+
+  auto GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool acquire_read_lock = true) -> bool override;
+
+  auto Begin(Transaction *txn) -> TableIterator override;
+
+  /**
+   * Read some columns of the live rows of one page.
+   * @param page_id the page to read, GetFirstPageId() to start a scan
+   * @param column_ids the columns to read
+   * @param[out] columns one vector of values per column in column_ids, in the order of the rows
+   * @param[out] rids the rids of the rows
+   * @return the id of the next page, INVALID_PAGE_ID at the end of the table
+   */
+  auto ScanColumns(page_id_t page_id, const std::vector<uint32_t> &column_ids,
+                   std::vector<std::vector<Value>> *columns, std::vector<RID> *rids) -> page_id_t;
+
+  /** @return the layout of the pages */
+  auto GetLayout() const -> const PaxLayout & { return layout_; }
+
+ protected:
+  void NextTuple(Tuple *tuple) override;
+
+ private:
+  /** Append a row to the last page, linking a new page if it is full. The caller holds insert_latch_. */
+  auto AppendTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> bool;
+
+  PaxLayout layout_;
+  /** Protects last_page_id_ and the page list; inserts only ever go to the last page */
+  std::mutex insert_latch_;
+  page_id_t last_page_id_;
+};
+
+}  // namespace bustub
@@ -12,9 +12,14 @@
 
 #pragma once
 
+#include <atomic>
+#include <mutex>  // NOLINT
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
 #include "recovery/log_manager.h"
 #include "storage/page/table_page.h"
+#include "storage/table/free_space_map.h"
 #include "storage/table/table_iterator.h"
 #include "storage/table/tuple.h"
 
@@ -22,13 +27,15 @@ namespace bustub {
 
 /**
  * TableHeap represents a physical table on disk.
- * This is just a doubly-linked list of pages.
+ * This is just a doubly-linked list of pages. A free-space map over the pages sends each insert straight to a page
+ * that fits; new pages are only ever appended at the end of the list.
+ * Pages store whole rows (see TablePage); subclasses such as PaxTableHeap store them in other formats.
  */
 class TableHeap {
   friend class TableIterator;
 
  public:
-  ~TableHeap() = default;
+  virtual ~TableHeap() = default;
 
   /**
    * Create a table heap without a transaction. (open table)
@@ -57,7 +64,17 @@ class TableHeap {
    * @param txn the transaction performing the insert
    * @return true iff the insert is successful
    */
-  auto InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> bool;
+  virtual auto InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> bool;
+
+  /**
+   * Insert a batch of tuples into the table. Each page is filled with as many tuples as fit while it is pinned and
+   * latched once. If any tuple is too large (>= page_size), nothing is inserted and false is returned.
+   * @param tuples tuples to insert
+   * @param[out] rids the rids of the inserted tuples, in the order of tuples
+   * @param txn the transaction performing the insert
+   * @return true iff all the tuples were inserted
+   */
+  virtual auto InsertTuples(const std::vector<Tuple> &tuples, std::vector<RID> *rids, Transaction *txn) -> bool;
 
   /**
    * Mark the tuple as deleted. The actual delete will occur when ApplyDelete is called.
@@ -65,7 +82,7 @@ class TableHeap {
    * @param txn transaction performing the delete
    * @return true iff the delete is successful (i.e the tuple exists)
    */
-  auto MarkDelete(const RID &rid, Transaction *txn) -> bool;  // for delete
+  virtual auto MarkDelete(const RID &rid, Transaction *txn) -> bool;  // for delete
 
   /**
    * if the new tuple is too large to fit in the old page, return false (will delete and insert)
@@ -74,21 +91,21 @@ class TableHeap {
    * @param txn transaction performing the update
    * @return true is update is successful.
    */
-  auto UpdateTuple(const Tuple &tuple, const RID &rid, Transaction *txn) -> bool;
+  virtual auto UpdateTuple(const Tuple &tuple, const RID &rid, Transaction *txn) -> bool;
 
   /**
    * Called on Commit/Abort to actually delete a tuple or rollback an insert.
    * @param rid rid of the tuple to delete
    * @param txn transaction performing the delete.
    */
-  void ApplyDelete(const RID &rid, Transaction *txn);
+  virtual void ApplyDelete(const RID &rid, Transaction *txn);
 
   /**
    * Called on abort to rollback a delete.
    * @param rid rid of the deleted tuple.
    * @param txn transaction performing the rollback
    */
-  void RollbackDelete(const RID &rid, Transaction *txn);
+  virtual void RollbackDelete(const RID &rid, Transaction *txn);
 
   /**
    * Read a tuple from the table.
@@ -97,10 +114,10 @@ class TableHeap {
    * @param txn transaction performing the read
    * @return true if the read was successful (i.e. the tuple exists)
    */
-  auto GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool acquire_read_lock = true) -> bool;
+  virtual auto GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool acquire_read_lock = true) -> bool;
 
   /** @return the begin iterator of this table */
-  auto Begin(Transaction *txn) -> TableIterator;
+  virtual auto Begin(Transaction *txn) -> TableIterator;
 
   /** @return the end iterator of this table */
   auto End() -> TableIterator;
@@ -108,11 +125,66 @@ class TableHeap {
   /** @return the id of the first page of this table */
   inline auto GetFirstPageId() const -> page_id_t { return first_page_id_; }
 
- private:
+  /**
+   * Hand the live tuples of a page, from slot *slot on, to visit(view) as tuples that borrow the page (see
+   * TablePage::GetTupleView), so a scan can look at rows without copying them. The page stays pinned and read-latched
+   * during the calls; visit must not keep the view nor take locks. Only for tables of TablePages, not PaxTableHeap.
+   * @param page_id the page to read
+   * @param[in,out] slot the first slot to visit; on return, the slot to resume at
+   * @param visit returns false to stop before the tuple it is given, which is then visited again on resumption
+   * @return page_id if visit stopped early, otherwise the next page of the table (slot is then 0), INVALID_PAGE_ID
+   * after the last one
+   */
+  template <class Visitor>
+  auto ScanPage(page_id_t page_id, uint32_t *slot, Visitor &&visit) -> page_id_t {
+    auto guard = buffer_pool_manager_->FetchPageRead(page_id);
+    BUSTUB_ENSURE(guard.IsValid(), "BPM full");
+    auto page = guard.As<TablePage>();
+    RID rid;
+    Tuple view;
+    bool has_tuple =
+        *slot == 0 ? page->GetFirstTupleRid(&rid) : page->GetNextTupleRid(RID(page_id, *slot - 1), &rid);
+    for (; has_tuple; has_tuple = page->GetNextTupleRid(rid, &rid)) {
+      page->GetTupleView(rid, &view);
+      if (!visit(static_cast<const Tuple &>(view))) {
+        *slot = rid.GetSlotNum();
+        return page_id;
+      }
+    }
+    *slot = 0;
+    return page->GetNextPageId();
+  }
+
+ protected:
+  /** For subclasses, which create their first page themselves. */
+  TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager)
+      : buffer_pool_manager_(buffer_pool_manager), lock_manager_(lock_manager), log_manager_(log_manager) {}
+
+  /**
+   * Advance an iterator: read the live tuple after tuple->rid_ into tuple, or set its rid to INVALID_PAGE_ID at the
+   * end of the table.
+   */
+  virtual void NextTuple(Tuple *tuple);
+
   BufferPoolManager *buffer_pool_manager_;
   LockManager *lock_manager_;
   LogManager *log_manager_;
   page_id_t first_page_id_{};
+
+ private:
+  /** Build the free-space map by walking the page chain once, if this heap was opened rather than created. */
+  void LoadFreeSpaceMap();
+
+  /**
+   * Append an empty page to the end of the page chain. Must hold append_latch_.
+   * @return false if no page could be allocated
+   */
+  auto AppendPage(Transaction *txn) -> bool;
+
+  FreeSpaceMap free_space_map_;
+  std::atomic<bool> free_space_map_loaded_{false};
+  /** Serializes appending pages and loading the free-space map */
+  std::mutex append_latch_;
 };
 
 }  // namespace bustub
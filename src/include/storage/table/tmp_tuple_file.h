@@ -0,0 +1,77 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tmp_tuple_file.h
+//
+// Identification: src/include/storage/table/tmp_tuple_file.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "storage/page/page_guard.h"
+#include "storage/page/tmp_tuple_page.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * TmpTupleFile is an append-only sequence of tuples on TmpTuplePages, for operators that spill their input to disk
+ * when it does not fit into their memory budget. Only the page being written is pinned; the buffer pool writes the
+ * others out when it needs the frames. The pages are deleted with the file.
+ *
+ * A file is written first and then read, any number of times, with a Reader.
+ */
+class TmpTupleFile {
+ public:
+  explicit TmpTupleFile(BufferPoolManager *bpm) : bpm_(bpm) {}
+
+  ~TmpTupleFile();
+
+  DISALLOW_COPY_AND_MOVE(TmpTupleFile);
+
+  /** Append a tuple; throws an ExecutionException if the buffer pool has no page for it. */
+  void Append(const Tuple &tuple);
+
+  /** Unpin the page being written. Appending afterwards starts a new page. */
+  void Finish() { write_guard_.Drop(); }
+
+  /** @return the number of tuples appended */
+  auto GetTupleCount() const -> size_t { return tuple_count_; }
+
+  /** @return the number of bytes taken by the tuples appended */
+  auto GetSize() const -> size_t { return size_; }
+
+  /** Reads the tuples of a file in the order they were appended, a page at a time. */
+  class Reader {
+   public:
+    explicit Reader(const TmpTupleFile *file) : file_(file) {}
+
+    /** @return false after the last tuple */
+    auto Next(Tuple *tuple) -> bool;
+
+   private:
+    const TmpTupleFile *file_;
+    /** The next page of the file to read */
+    size_t page_idx_{0};
+    /** The tuples of the current page, last appended first, so that the next one is at the back */
+    std::vector<Tuple> tuples_;
+  };
+
+ private:
+  BufferPoolManager *bpm_;
+  std::vector<page_id_t> page_ids_;
+  /** Guards the last page while it is written */
+  BasicPageGuard write_guard_;
+  size_t tuple_count_{0};
+  size_t size_{0};
+};
+
+}  // namespace bustub
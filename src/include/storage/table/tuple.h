@@ -26,9 +26,15 @@ namespace bustub {
  * ---------------------------------------------------------------------
  * | FIXED-SIZE or VARIED-SIZED OFFSET | PAYLOAD OF VARIED-SIZED FIELD |
  * ---------------------------------------------------------------------
+ *
+ * A tuple either owns its data or borrows it from a table page (see TablePage::GetTupleView). A borrowed tuple is
+ * only valid while that page stays pinned and latched; copying it yields a tuple that owns a copy of the data. An
+ * owning tuple keeps its buffer when it is assigned a tuple that fits, so a tuple that is reused across Next() calls
+ * does not allocate per row.
  */
 class Tuple {
   friend class TablePage;
+  friend class PaxPage;
   friend class TableHeap;
   friend class TableIterator;
 
@@ -45,9 +51,15 @@ class Tuple {
   // copy constructor, deep copy
   Tuple(const Tuple &other);
 
-  // assign operator, deep copy
+  // move constructor, takes over the data of other
+  Tuple(Tuple &&other) noexcept;
+
+  // assign operator, deep copy into the current buffer if it is large enough
   auto operator=(const Tuple &other) -> Tuple &;
 
+  // move assign operator, takes over the data of other
+  auto operator=(Tuple &&other) noexcept -> Tuple &;
+
   ~Tuple() {
     if (allocated_) {
       delete[] data_;
@@ -64,6 +76,9 @@ class Tuple {
   // return RID of current tuple
   inline auto GetRid() const -> RID { return rid_; }
 
+  // set RID of current tuple, e.g. of a tuple built from values read out of the table
+  inline void SetRid(const RID &rid) { rid_ = rid; }
+
   // Get the address of this tuple in the table's backing store
   inline auto GetData() const -> char * { return data_; }
 
@@ -75,7 +90,8 @@ class Tuple {
   auto GetValue(const Schema *schema, uint32_t column_idx) const -> Value;
 
   // Generates a key tuple given schemas and attributes
-  auto KeyFromTuple(const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs) -> Tuple;
+  auto KeyFromTuple(const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs) const
+      -> Tuple;
 
   // Is the column value null ?
   inline auto IsNull(const Schema *schema, uint32_t column_idx) const -> bool {
@@ -84,15 +100,28 @@ class Tuple {
   }
   inline auto IsAllocated() -> bool { return allocated_; }
 
+  // Does the tuple point into memory it does not own, i.e. a table page?
+  inline auto IsBorrowed() const -> bool { return !allocated_ && data_ != nullptr; }
+
   auto ToString(const Schema *schema) const -> std::string;
 
  private:
   // Get the starting storage address of specific column
   auto GetDataPtr(const Schema *schema, uint32_t column_idx) const -> const char *;
 
+  // Copy size bytes of data into an owned buffer, reusing the current one if it is large enough
+  void CopyData(const char *data, uint32_t size);
+
+  // Make the tuple own a buffer of size bytes for the caller to fill, reusing the current one if it is large enough
+  void Reserve(uint32_t size);
+
+  // Point at size bytes of data owned by someone else
+  void Borrow(char *data, uint32_t size);
+
   bool allocated_{false};  // is allocated?
   RID rid_{};              // if pointing to the table heap, the rid is valid
   uint32_t size_{0};
+  uint32_t capacity_{0};  // size of the allocated buffer
   char *data_{nullptr};
 };
 
@@ -64,6 +64,8 @@ class Value {
 
   Value() : Value(TypeId::INVALID) {}
   Value(const Value &other);
+  // Takes over the data of other, which is left INVALID
+  Value(Value &&other) noexcept : Value(TypeId::INVALID) { Swap(*this, other); }
   auto operator=(Value other) -> Value &;
   ~Value();
   // NOLINTNEXTLINE
@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <vector>
+#include "catalog/catalog.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/aggregation_plan.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+namespace {
+
+void CollectColumns(const AbstractExpressionRef &expr, std::map<uint32_t, uint32_t> *columns) {
+  if (const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(expr.get()); column_expr != nullptr) {
+    columns->emplace(column_expr->GetColIdx(), 0);
+  }
+  for (const auto &child : expr->GetChildren()) {
+    CollectColumns(child, columns);
+  }
+}
+
+auto RewriteColumns(const AbstractExpressionRef &expr, const std::map<uint32_t, uint32_t> &columns)
+    -> AbstractExpressionRef {
+  if (const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(expr.get()); column_expr != nullptr) {
+    return std::make_shared<ColumnValueExpression>(column_expr->GetTupleIdx(), columns.at(column_expr->GetColIdx()),
+                                                   column_expr->GetReturnType());
+  }
+  std::vector<AbstractExpressionRef> children;
+  for (const auto &child : expr->GetChildren()) {
+    children.emplace_back(RewriteColumns(child, columns));
+  }
+  return expr->CloneWithChildren(std::move(children));
+}
+
+auto RewriteColumns(const std::vector<AbstractExpressionRef> &exprs, const std::map<uint32_t, uint32_t> &columns)
+    -> std::vector<AbstractExpressionRef> {
+  std::vector<AbstractExpressionRef> rewritten;
+  for (const auto &expr : exprs) {
+    rewritten.emplace_back(RewriteColumns(expr, columns));
+  }
+  return rewritten;
+}
+
+}  // namespace
+
+auto Optimizer::OptimizeColumnPruning(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeColumnPruning(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  if (optimized_plan->GetType() != PlanType::Projection && optimized_plan->GetType() != PlanType::Aggregation) {
+    return optimized_plan;
+  }
+  // Projection / Aggregation, optionally over a Filter, over a SeqScan of a PAX table
+  const FilterPlanNode *filter_plan = nullptr;
+  const AbstractPlanNode *child = optimized_plan->GetChildAt(0).get();
+  if (child->GetType() == PlanType::Filter) {
+    filter_plan = dynamic_cast<const FilterPlanNode *>(child);
+    child = filter_plan->GetChildPlan().get();
+  }
+  if (child->GetType() != PlanType::SeqScan) {
+    return optimized_plan;
+  }
+  const auto &seq_scan = dynamic_cast<const SeqScanPlanNode &>(*child);
+  if (seq_scan.filter_predicate_ != nullptr || !seq_scan.column_ids_.empty() ||
+      catalog_.GetTable(seq_scan.GetTableOid())->format_ != TableFormat::Pax) {
+    return optimized_plan;
+  }
+
+  // Find the columns that are used, and number them in table order.
+  std::map<uint32_t, uint32_t> columns;
+  std::vector<AbstractExpressionRef> exprs;
+  if (optimized_plan->GetType() == PlanType::Projection) {
+    exprs = dynamic_cast<const ProjectionPlanNode &>(*optimized_plan).GetExpressions();
+  } else {
+    const auto &agg_plan = dynamic_cast<const AggregationPlanNode &>(*optimized_plan);
+    exprs = agg_plan.GetGroupBys();
+    exprs.insert(exprs.end(), agg_plan.GetAggregates().begin(), agg_plan.GetAggregates().end());
+  }
+  if (filter_plan != nullptr) {
+    exprs.push_back(filter_plan->GetPredicate());
+  }
+  for (const auto &expr : exprs) {
+    CollectColumns(expr, &columns);
+  }
+  const auto &scan_schema = seq_scan.OutputSchema();
+  if (columns.size() == scan_schema.GetColumnCount()) {
+    return optimized_plan;
+  }
+  if (columns.empty()) {
+    // e.g. `SELECT count(*)`, which still needs one row per row of the table
+    columns.emplace(0, 0);
+  }
+
+  std::vector<uint32_t> column_ids;
+  std::vector<Column> scan_columns;
+  for (auto &[column_id, new_idx] : columns) {
+    new_idx = column_ids.size();
+    column_ids.push_back(column_id);
+    scan_columns.push_back(scan_schema.GetColumn(column_id));
+  }
+  auto pruned_schema = std::make_shared<const Schema>(scan_columns);
+  AbstractPlanNodeRef new_child = std::make_shared<SeqScanPlanNode>(pruned_schema, seq_scan.table_oid_,
+                                                                    seq_scan.table_name_, nullptr, column_ids);
+  if (filter_plan != nullptr) {
+    new_child = std::make_shared<FilterPlanNode>(pruned_schema, RewriteColumns(filter_plan->GetPredicate(), columns),
+                                                 std::move(new_child));
+  }
+
+  if (optimized_plan->GetType() == PlanType::Projection) {
+    const auto &projection_plan = dynamic_cast<const ProjectionPlanNode &>(*optimized_plan);
+    return std::make_shared<ProjectionPlanNode>(projection_plan.output_schema_,
+                                                RewriteColumns(projection_plan.GetExpressions(), columns),
+                                                std::move(new_child));
+  }
+  const auto &agg_plan = dynamic_cast<const AggregationPlanNode &>(*optimized_plan);
+  return std::make_shared<AggregationPlanNode>(agg_plan.output_schema_, std::move(new_child),
+                                               RewriteColumns(agg_plan.GetGroupBys(), columns),
+                                               RewriteColumns(agg_plan.GetAggregates(), columns),
+                                               agg_plan.GetAggregateTypes());
+}
+
+}  // namespace bustub
@@ -0,0 +1,213 @@
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+#include "binder/bound_order_by.h"
+#include "catalog/catalog.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/hash_join_plan.h"
+#include "execution/plans/index_scan_plan.h"
+#include "execution/plans/merge_join_plan.h"
+#include "execution/plans/projection_plan.h"
+#include "execution/plans/sort_plan.h"
+#include "execution/plans/topn_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return the columns that the leading ascending order-by expressions take straight from the input */
+auto OrderByColumns(const std::vector<std::pair<OrderByType, AbstractExpressionRef>> &order_bys)
+    -> std::vector<uint32_t> {
+  std::vector<uint32_t> columns;
+  for (const auto &[order_by_type, expr] : order_bys) {
+    const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(expr.get());
+    if (order_by_type == OrderByType::DESC || column_expr == nullptr) {
+      break;
+    }
+    columns.push_back(column_expr->GetColIdx());
+  }
+  return columns;
+}
+
+/** @return the columns of key expressions that are all plain columns, std::nullopt otherwise */
+auto KeyColumns(const std::vector<AbstractExpressionRef> &key_exprs) -> std::optional<std::vector<uint32_t>> {
+  std::vector<uint32_t> columns;
+  for (const auto &key_expr : key_exprs) {
+    const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(key_expr.get());
+    if (column_expr == nullptr) {
+      return std::nullopt;
+    }
+    columns.push_back(column_expr->GetColIdx());
+  }
+  return columns;
+}
+
+/**
+ * Match the leading columns of an order with the key columns of a join.
+ * @return for each of the first keys.size() columns of order, the position of that column in keys; std::nullopt if
+ * they are not the key columns in some order
+ */
+auto MatchOrder(const std::vector<uint32_t> &order, const std::vector<uint32_t> &keys)
+    -> std::optional<std::vector<size_t>> {
+  if (order.size() < keys.size()) {
+    return std::nullopt;
+  }
+  std::vector<size_t> positions;
+  std::vector<bool> used(keys.size(), false);
+  for (size_t i = 0; i < keys.size(); i++) {
+    size_t pos = 0;
+    while (pos < keys.size() && (used[pos] || keys[pos] != order[i])) {
+      pos++;
+    }
+    if (pos == keys.size()) {
+      return std::nullopt;
+    }
+    used[pos] = true;
+    positions.push_back(pos);
+  }
+  return positions;
+}
+
+/** @return the key expressions in the order given by positions */
+auto Permute(const std::vector<AbstractExpressionRef> &key_exprs, const std::vector<size_t> &positions)
+    -> std::vector<AbstractExpressionRef> {
+  std::vector<AbstractExpressionRef> permuted;
+  for (auto pos : positions) {
+    permuted.push_back(key_exprs[pos]);
+  }
+  return permuted;
+}
+
+}  // namespace
+
+auto Optimizer::GetOrderedColumns(const AbstractPlanNode &plan) -> std::vector<uint32_t> {
+  switch (plan.GetType()) {
+    case PlanType::IndexScan: {
+      // A full scan of a B+ tree comes out in key order, and a point lookup only has one key.
+      const auto *index_info = catalog_.GetIndex(dynamic_cast<const IndexScanPlanNode &>(plan).GetIndexOid());
+      if (index_info->index_type_ == IndexType::BPlusTreeIndex) {
+        return index_info->index_->GetKeyAttrs();
+      }
+      return {};
+    }
+    case PlanType::Sort:
+      return OrderByColumns(dynamic_cast<const SortPlanNode &>(plan).GetOrderBy());
+    case PlanType::TopN:
+      return OrderByColumns(dynamic_cast<const TopNPlanNode &>(plan).GetOrderBy());
+    case PlanType::Filter:
+    case PlanType::Limit:
+      return GetOrderedColumns(*plan.GetChildAt(0));
+    case PlanType::Projection: {
+      const auto &exprs = dynamic_cast<const ProjectionPlanNode &>(plan).GetExpressions();
+      std::vector<uint32_t> columns;
+      for (auto child_column : GetOrderedColumns(*plan.GetChildAt(0))) {
+        auto it = std::find_if(exprs.begin(), exprs.end(), [child_column](const AbstractExpressionRef &expr) {
+          const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(expr.get());
+          return column_expr != nullptr && column_expr->GetColIdx() == child_column;
+        });
+        if (it == exprs.end()) {
+          break;
+        }
+        columns.push_back(it - exprs.begin());
+      }
+      return columns;
+    }
+    case PlanType::MergeJoin: {
+      const auto &merge_join_plan = dynamic_cast<const MergeJoinPlanNode &>(plan);
+      return KeyColumns(merge_join_plan.LeftJoinKeyExpressions()).value_or(std::vector<uint32_t>{});
+    }
+    default:
+      return {};
+  }
+}
+
+auto Optimizer::OptimizeHashJoinAsMergeJoin(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeHashJoinAsMergeJoin(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  // Either the join itself, whose inputs may come sorted on the key, or a sort on the key right above it (and above
+  // the projection of the select list, if there is one).
+  const auto *sort_plan = dynamic_cast<const SortPlanNode *>(optimized_plan.get());
+  const ProjectionPlanNode *projection_plan = nullptr;
+  const auto *join_node = optimized_plan.get();
+  if (sort_plan != nullptr) {
+    join_node = sort_plan->GetChildPlan().get();
+    if (join_node->GetType() == PlanType::Projection) {
+      projection_plan = dynamic_cast<const ProjectionPlanNode *>(join_node);
+      join_node = projection_plan->GetChildPlan().get();
+    }
+  }
+  if (join_node->GetType() != PlanType::HashJoin) {
+    return optimized_plan;
+  }
+  const auto &join_plan = dynamic_cast<const HashJoinPlanNode &>(*join_node);
+  auto left_keys = KeyColumns(join_plan.LeftJoinKeyExpressions());
+  auto right_keys = KeyColumns(join_plan.RightJoinKeyExpressions());
+  if (!left_keys.has_value() || !right_keys.has_value()) {
+    return optimized_plan;
+  }
+  auto left_order = GetOrderedColumns(*join_plan.GetLeftPlan());
+  auto right_order = GetOrderedColumns(*join_plan.GetRightPlan());
+
+  std::optional<std::vector<size_t>> positions;
+  if (sort_plan == nullptr) {
+    // Both inputs must be sorted on the key columns, in the same order.
+    positions = MatchOrder(left_order, *left_keys);
+    if (!positions.has_value() || MatchOrder(right_order, *right_keys) != positions) {
+      return optimized_plan;
+    }
+  } else {
+    // The output of a merge join is in the order of the left key, which equals the right key wherever it is not
+    // NULL. The sort can go away if it is on exactly the key columns of one side; left rows padded by a LEFT join
+    // have NULL right keys, though.
+    auto order = OrderByColumns(sort_plan->GetOrderBy());
+    if (order.size() != sort_plan->GetOrderBy().size() || order.size() != left_keys->size()) {
+      return optimized_plan;
+    }
+    if (projection_plan != nullptr) {
+      for (auto &column : order) {
+        const auto *column_expr =
+            dynamic_cast<const ColumnValueExpression *>(projection_plan->GetExpressions()[column].get());
+        if (column_expr == nullptr) {
+          return optimized_plan;
+        }
+        column = column_expr->GetColIdx();
+      }
+    }
+    const auto left_column_count = join_plan.GetLeftPlan()->OutputSchema().GetColumnCount();
+    if (std::all_of(order.begin(), order.end(), [&](uint32_t column) { return column < left_column_count; })) {
+      positions = MatchOrder(order, *left_keys);
+    } else if (join_plan.GetJoinType() == JoinType::INNER &&
+               std::all_of(order.begin(), order.end(), [&](uint32_t column) { return column >= left_column_count; })) {
+      for (auto &column : order) {
+        column -= left_column_count;
+      }
+      positions = MatchOrder(order, *right_keys);
+    }
+    // Sorting both inputs costs as much as sorting the output of the hash join, so the sort only goes away if the
+    // inputs already come sorted on the key, in the order of the sort.
+    if (!positions.has_value() || MatchOrder(left_order, *left_keys) != positions ||
+        MatchOrder(right_order, *right_keys) != positions) {
+      return optimized_plan;
+    }
+  }
+
+  // The order of the keys is the one of the inputs, which is also the one of the sort.
+  AbstractPlanNodeRef merge_join_plan = std::make_shared<MergeJoinPlanNode>(
+      join_plan.output_schema_, join_plan.GetLeftPlan(), join_plan.GetRightPlan(),
+      Permute(join_plan.LeftJoinKeyExpressions(), *positions), Permute(join_plan.RightJoinKeyExpressions(), *positions),
+      join_plan.GetJoinType());
+  if (projection_plan != nullptr) {
+    return projection_plan->CloneWithChildren({std::move(merge_join_plan)});
+  }
+  return merge_join_plan;
+}
+
+}  // namespace bustub
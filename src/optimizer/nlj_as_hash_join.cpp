@@ -1,5 +1,7 @@
 #include <algorithm>
 #include <memory>
+#include <utility>
+#include <vector>
 #include "catalog/column.h"
 #include "catalog/schema.h"
 #include "common/exception.h"
@@ -7,6 +9,7 @@
 #include "execution/expressions/column_value_expression.h"
 #include "execution/expressions/comparison_expression.h"
 #include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
 #include "execution/plans/abstract_plan.h"
 #include "execution/plans/filter_plan.h"
 #include "execution/plans/hash_join_plan.h"
@@ -17,6 +20,42 @@
 
 namespace bustub {
 
+namespace {
+
+/**
+ * Split a join predicate of the form `<column> = <column> AND <column> = <column> ...`, where each equality has one
+ * column from each side, into the key expressions of the two sides.
+ * @return false if the predicate has any other form
+ */
+auto ExtractJoinKeys(const AbstractExpression &expr, std::vector<AbstractExpressionRef> *left_keys,
+                     std::vector<AbstractExpressionRef> *right_keys) -> bool {
+  if (const auto *logic_expr = dynamic_cast<const LogicExpression *>(&expr); logic_expr != nullptr) {
+    return logic_expr->logic_type_ == LogicType::And &&
+           ExtractJoinKeys(*logic_expr->GetChildAt(0), left_keys, right_keys) &&
+           ExtractJoinKeys(*logic_expr->GetChildAt(1), left_keys, right_keys);
+  }
+  const auto *comp_expr = dynamic_cast<const ComparisonExpression *>(&expr);
+  if (comp_expr == nullptr || comp_expr->comp_type_ != ComparisonType::Equal) {
+    return false;
+  }
+  const auto *left_expr = dynamic_cast<const ColumnValueExpression *>(comp_expr->GetChildAt(0).get());
+  const auto *right_expr = dynamic_cast<const ColumnValueExpression *>(comp_expr->GetChildAt(1).get());
+  if (left_expr == nullptr || right_expr == nullptr || left_expr->GetTupleIdx() == right_expr->GetTupleIdx()) {
+    return false;
+  }
+  if (left_expr->GetTupleIdx() == 1) {
+    std::swap(left_expr, right_expr);
+  }
+  // Both key expressions are evaluated on a single row, so they have tuple_id == 0.
+  left_keys->push_back(
+      std::make_shared<ColumnValueExpression>(0, left_expr->GetColIdx(), left_expr->GetReturnType()));
+  right_keys->push_back(
+      std::make_shared<ColumnValueExpression>(0, right_expr->GetColIdx(), right_expr->GetReturnType()));
+  return true;
+}
+
+}  // namespace
+
 auto Optimizer::OptimizeNLJAsHashJoin(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
   std::vector<AbstractPlanNodeRef> children;
   for (const auto &child : plan->GetChildren()) {
@@ -29,33 +68,14 @@ auto Optimizer::OptimizeNLJAsHashJoin(const AbstractPlanNodeRef &plan) -> Abstra
     // Has exactly two children
     BUSTUB_ENSURE(nlj_plan.children_.size() == 2, "NLJ should have exactly 2 children.");
 
-    // Check if expr is equal condition where one is for the left table, and one is for the right table.
-    if (const auto *expr = dynamic_cast<const ComparisonExpression *>(&nlj_plan.Predicate()); expr != nullptr) {
-      if (expr->comp_type_ == ComparisonType::Equal) {
-        if (const auto *left_expr = dynamic_cast<const ColumnValueExpression *>(expr->children_[0].get());
-            left_expr != nullptr) {
-          if (const auto *right_expr = dynamic_cast<const ColumnValueExpression *>(expr->children_[1].get());
-              right_expr != nullptr) {
-            // Ensure both exprs have tuple_id == 0
-            auto left_expr_tuple_0 =
-                std::make_shared<ColumnValueExpression>(0, left_expr->GetColIdx(), left_expr->GetReturnType());
-            auto right_expr_tuple_0 =
-                std::make_shared<ColumnValueExpression>(0, right_expr->GetColIdx(), right_expr->GetReturnType());
-            // Now it's in form of <column_expr> = <column_expr>. Let's check if one of them is from the left table, and
-            // the other is from the right table.
-            if (left_expr->GetTupleIdx() == 0 && right_expr->GetTupleIdx() == 1) {
-              return std::make_shared<HashJoinPlanNode>(nlj_plan.output_schema_, nlj_plan.GetLeftPlan(),
-                                                        nlj_plan.GetRightPlan(), std::move(left_expr_tuple_0),
-                                                        std::move(right_expr_tuple_0), nlj_plan.GetJoinType());
-            }
-            if (left_expr->GetTupleIdx() == 1 && right_expr->GetTupleIdx() == 0) {
-              return std::make_shared<HashJoinPlanNode>(nlj_plan.output_schema_, nlj_plan.GetLeftPlan(),
-                                                        nlj_plan.GetRightPlan(), std::move(right_expr_tuple_0),
-                                                        std::move(left_expr_tuple_0), nlj_plan.GetJoinType());
-            }
-          }
-        }
-      }
+    // Check if the predicate is a conjunction of equal conditions, each between a column of the left table and a
+    // column of the right table.
+    std::vector<AbstractExpressionRef> left_keys;
+    std::vector<AbstractExpressionRef> right_keys;
+    if (ExtractJoinKeys(nlj_plan.Predicate(), &left_keys, &right_keys)) {
+      return std::make_shared<HashJoinPlanNode>(nlj_plan.output_schema_, nlj_plan.GetLeftPlan(),
+                                                nlj_plan.GetRightPlan(), std::move(left_keys), std::move(right_keys),
+                                                nlj_plan.GetJoinType());
     }
   }
 
@@ -12,8 +12,10 @@ auto Optimizer::Optimize(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef
     p = OptimizeMergeProjection(p);
     p = OptimizeMergeFilterNLJ(p);
     p = OptimizeNLJAsIndexJoin(p);
+    p = OptimizeSeqScanAsIndexScan(p);
     p = OptimizeOrderByAsIndexScan(p);
     p = OptimizeSortLimitAsTopN(p);
+    p = OptimizeColumnPruning(p);
     return p;
   }
   // By default, use user-defined rules.
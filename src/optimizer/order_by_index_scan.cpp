@@ -61,6 +61,10 @@ auto Optimizer::OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> A
       const auto indices = catalog_.GetTableIndexes(table_info->name_);
 
       for (const auto *index : indices) {
+        // Only the B+ tree can be scanned in key order.
+        if (index->index_type_ != IndexType::BPlusTreeIndex) {
+          continue;
+        }
         const auto &columns = index->key_schema_.GetColumns();
         if (columns.size() == 1 &&
             columns[0].GetName() == table_info->schema_.GetColumn(order_by_column_id).GetName()) {
@@ -0,0 +1,71 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// seqscan_as_indexscan.cpp
+//
+// Identification: src/optimizer/seqscan_as_indexscan.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <vector>
+#include "catalog/catalog.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/filter_plan.h"
+#include "execution/plans/index_scan_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "optimizer/optimizer.h"
+
+namespace bustub {
+
+auto Optimizer::OptimizeSeqScanAsIndexScan(const AbstractPlanNodeRef &plan) -> AbstractPlanNodeRef {
+  std::vector<AbstractPlanNodeRef> children;
+  for (const auto &child : plan->GetChildren()) {
+    children.emplace_back(OptimizeSeqScanAsIndexScan(child));
+  }
+  auto optimized_plan = plan->CloneWithChildren(std::move(children));
+
+  if (optimized_plan->GetType() != PlanType::Filter) {
+    return optimized_plan;
+  }
+  const auto &filter_plan = dynamic_cast<const FilterPlanNode &>(*optimized_plan);
+  BUSTUB_ENSURE(filter_plan.children_.size() == 1, "Filter should have exactly 1 child.");
+  if (filter_plan.GetChildPlan()->GetType() != PlanType::SeqScan) {
+    return optimized_plan;
+  }
+  const auto &seq_scan = dynamic_cast<const SeqScanPlanNode &>(*filter_plan.GetChildPlan());
+
+  // Predicate is `column = constant` in either order
+  const auto *expr = dynamic_cast<const ComparisonExpression *>(filter_plan.GetPredicate().get());
+  if (expr == nullptr || expr->comp_type_ != ComparisonType::Equal) {
+    return optimized_plan;
+  }
+  const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(expr->children_[0].get());
+  auto constant_expr = std::dynamic_pointer_cast<const ConstantValueExpression>(expr->children_[1]);
+  if (column_expr == nullptr || constant_expr == nullptr) {
+    column_expr = dynamic_cast<const ColumnValueExpression *>(expr->children_[1].get());
+    constant_expr = std::dynamic_pointer_cast<const ConstantValueExpression>(expr->children_[0]);
+  }
+  if (column_expr == nullptr || constant_expr == nullptr) {
+    return optimized_plan;
+  }
+
+  // Only hash indexes are used here: they cannot serve anything but point lookups, while an equality filter over a
+  // small table is usually cheaper as a sequential scan than as a walk down a B+ tree.
+  const auto key_attrs = std::vector{column_expr->GetColIdx()};
+  for (const auto *index_info : catalog_.GetTableIndexes(seq_scan.table_name_)) {
+    if (index_info->index_type_ == IndexType::HashTableIndex && key_attrs == index_info->index_->GetKeyAttrs()) {
+      return std::make_shared<IndexScanPlanNode>(filter_plan.output_schema_, index_info->index_oid_,
+                                                 std::move(constant_expr));
+    }
+  }
+  return optimized_plan;
+}
+
+}  // namespace bustub
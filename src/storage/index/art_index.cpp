@@ -0,0 +1,44 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// art_index.cpp
+//
+// Identification: src/storage/index/art_index.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/art_index.h"
+
+#include "common/util/memcomparable_util.h"
+
+namespace bustub {
+
+ArtIndex::ArtIndex(std::unique_ptr<IndexMetadata> &&metadata) : Index(std::move(metadata)) {}
+
+void ArtIndex::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  container_.Insert(EncodeKey(key), rid);
+}
+
+void ArtIndex::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) { container_.Remove(EncodeKey(key)); }
+
+void ArtIndex::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
+  RID rid;
+  if (container_.GetValue(EncodeKey(key), &rid)) {
+    result->push_back(rid);
+  }
+}
+
+void ArtIndex::ScanFrom(const Tuple &key, size_t limit, std::vector<RID> *result) {
+  container_.Scan(EncodeKey(key), limit, result);
+}
+
+auto ArtIndex::EncodeKey(const Tuple &key) const -> std::vector<uint8_t> {
+  std::vector<uint8_t> encoded;
+  MemComparableUtil::EncodeTuple(key, GetKeySchema(), &encoded);
+  return encoded;
+}
+
+}  // namespace bustub
@@ -0,0 +1,363 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_link_tree.cpp
+//
+// Identification: src/storage/index/b_link_tree.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <string>
+
+#include "common/exception.h"
+#include "common/macros.h"
+#include "common/rid.h"
+#include "storage/index/b_link_tree.h"
+#include "storage/page/header_page.h"
+
+namespace bustub {
+
+INDEX_TEMPLATE_ARGUMENTS
+BLINKTREE_TYPE::BLinkTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
+                          int leaf_max_size, int internal_max_size)
+    : index_name_(std::move(name)),
+      root_page_id_(INVALID_PAGE_ID),
+      buffer_pool_manager_(buffer_pool_manager),
+      comparator_(comparator),
+      leaf_max_size_(leaf_max_size),
+      internal_max_size_(internal_max_size) {
+  BUSTUB_ASSERT(leaf_max_size_ >= 2 && internal_max_size_ >= 3, "b-link tree nodes are too small to split");
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BLINKTREE_TYPE::IsEmpty() const -> bool { return root_page_id_.load() == INVALID_PAGE_ID; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BLINKTREE_TYPE::FetchNode(page_id_t page_id) -> Page * {
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch b-link tree page");
+  }
+  return page;
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+/*
+ * Readers hold a single read latch at a time. A child pointer read from a
+ * parent may be stale by the time the child is latched, in which case the key
+ * has moved to a right sibling and is reached through the right link.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BLINKTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction) -> bool {
+  if (IsEmpty()) {
+    return false;
+  }
+  Page *page = FetchNode(root_page_id_.load());
+  page->RLatch();
+  while (true) {
+    // Leaf and internal nodes share the header and high key layout.
+    auto *node = reinterpret_cast<InternalPage *>(page->GetData());
+    page_id_t next_page_id;
+    if (node->NeedMoveRight(key, comparator_)) {
+      next_page_id = node->GetRightPageId();
+    } else if (node->IsLeafPage()) {
+      break;
+    } else {
+      next_page_id = node->LookupChild(key, comparator_);
+    }
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    page = FetchNode(next_page_id);
+    page->RLatch();
+  }
+
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  int index = leaf->LowerBound(key, comparator_);
+  bool found = index < leaf->GetSize() && comparator_(leaf->KeyAt(index), key) == 0;
+  if (found) {
+    result->push_back(leaf->ValueAt(index));
+  }
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  return found;
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+void BLINKTREE_TYPE::StartNewTree() {
+  std::scoped_lock lock(root_latch_);
+  if (!IsEmpty()) {
+    return;
+  }
+  page_id_t root_page_id;
+  Page *page = buffer_pool_manager_->NewPage(&root_page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate new page");
+  }
+  reinterpret_cast<LeafPage *>(page->GetData())->Init(root_page_id, 0, leaf_max_size_);
+  buffer_pool_manager_->UnpinPage(root_page_id, true);
+  root_page_id_.store(root_page_id);
+  UpdateRootPageId(1);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BLINKTREE_TYPE::MoveRightForWrite(Page *page, const KeyType &key) -> Page * {
+  auto *node = reinterpret_cast<InternalPage *>(page->GetData());
+  while (node->NeedMoveRight(key, comparator_)) {
+    Page *right_page = FetchNode(node->GetRightPageId());
+    right_page->WLatch();
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    page = right_page;
+    node = reinterpret_cast<InternalPage *>(page->GetData());
+  }
+  return page;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BLINKTREE_TYPE::FindLeafForWrite(const KeyType &key, std::vector<page_id_t> *path) -> Page * {
+  // The type and level of a page never change once it is part of the tree, so they may be read before latching.
+  Page *page = FetchNode(root_page_id_.load());
+  if (reinterpret_cast<InternalPage *>(page->GetData())->IsLeafPage()) {
+    page->WLatch();
+    return MoveRightForWrite(page, key);
+  }
+  page->RLatch();
+  while (true) {
+    auto *node = reinterpret_cast<InternalPage *>(page->GetData());
+    page_id_t next_page_id;
+    bool next_is_leaf = false;
+    if (node->NeedMoveRight(key, comparator_)) {
+      next_page_id = node->GetRightPageId();
+    } else {
+      path->push_back(node->GetPageId());
+      next_page_id = node->LookupChild(key, comparator_);
+      next_is_leaf = node->GetLevel() == 1;
+    }
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    page = FetchNode(next_page_id);
+    if (next_is_leaf) {
+      page->WLatch();
+      return MoveRightForWrite(page, key);
+    }
+    page->RLatch();
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BLINKTREE_TYPE::FindNodeAtLevel(const KeyType &key, int level) -> page_id_t {
+  Page *page = FetchNode(root_page_id_.load());
+  page->RLatch();
+  while (true) {
+    auto *node = reinterpret_cast<InternalPage *>(page->GetData());
+    BUSTUB_ASSERT(node->GetLevel() >= level, "root is below the requested level");
+    page_id_t next_page_id;
+    if (node->NeedMoveRight(key, comparator_)) {
+      next_page_id = node->GetRightPageId();
+    } else if (node->GetLevel() == level) {
+      break;
+    } else {
+      next_page_id = node->LookupChild(key, comparator_);
+    }
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    page = FetchNode(next_page_id);
+    page->RLatch();
+  }
+  page_id_t page_id = page->GetPageId();
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  return page_id;
+}
+
+/*
+ * Insert constant key & value pair into the tree. A full leaf is split before
+ * the parent is touched: the upper half moves to a new right sibling, the
+ * leaf's high key and right link are redirected to it, and only then is the
+ * separator posted one level up.
+ * @return: since we only support unique key, if user try to insert duplicate
+ * keys return false, otherwise return true.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BLINKTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) -> bool {
+  if (IsEmpty()) {
+    StartNewTree();
+  }
+  std::vector<page_id_t> path;
+  Page *page = FindLeafForWrite(key, &path);
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+
+  int index = leaf->LowerBound(key, comparator_);
+  if (index < leaf->GetSize() && comparator_(leaf->KeyAt(index), key) == 0) {
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    return false;
+  }
+  if (leaf->GetSize() < leaf->GetMaxSize()) {
+    leaf->InsertAt(index, key, value);
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+    return true;
+  }
+
+  // The new sibling is unreachable until the latch on the leaf is released, so it needs no latch of its own.
+  page_id_t new_page_id;
+  Page *new_page = buffer_pool_manager_->NewPage(&new_page_id);
+  if (new_page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate new page");
+  }
+  auto *new_leaf = reinterpret_cast<LeafPage *>(new_page->GetData());
+  new_leaf->Init(new_page_id, 0, leaf_max_size_);
+  leaf->MoveHalfTo(new_leaf);
+  KeyType separator = new_leaf->KeyAt(0);
+  if (comparator_(key, separator) >= 0) {
+    new_leaf->InsertAt(new_leaf->LowerBound(key, comparator_), key, value);
+  } else {
+    leaf->InsertAt(index, key, value);
+  }
+  buffer_pool_manager_->UnpinPage(new_page_id, true);
+
+  InsertIntoParent(page, separator, new_page_id, &path);
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BLINKTREE_TYPE::InsertIntoParent(Page *child, const KeyType &key, page_id_t new_page_id,
+                                      std::vector<page_id_t> *path) {
+  KeyType separator = key;
+  while (true) {
+    auto *child_node = reinterpret_cast<InternalPage *>(child->GetData());
+    page_id_t child_page_id = child_node->GetPageId();
+    int level = child_node->GetLevel() + 1;
+
+    page_id_t parent_page_id;
+    if (path->empty()) {
+      std::unique_lock lock(root_latch_);
+      if (root_page_id_.load() == child_page_id) {
+        page_id_t root_page_id;
+        Page *root_page = buffer_pool_manager_->NewPage(&root_page_id);
+        if (root_page == nullptr) {
+          throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate new page");
+        }
+        auto *root = reinterpret_cast<InternalPage *>(root_page->GetData());
+        root->Init(root_page_id, level, internal_max_size_);
+        root->InsertAt(0, separator, child_page_id);
+        root->InsertAt(1, separator, new_page_id);
+        buffer_pool_manager_->UnpinPage(root_page_id, true);
+        root_page_id_.store(root_page_id);
+        UpdateRootPageId(0);
+        lock.unlock();
+
+        child->WUnlatch();
+        buffer_pool_manager_->UnpinPage(child_page_id, true);
+        return;
+      }
+      // Somebody else grew the tree above the level we started from.
+      lock.unlock();
+      parent_page_id = FindNodeAtLevel(separator, level);
+    } else {
+      parent_page_id = path->back();
+      path->pop_back();
+    }
+
+    // The child is let go only once the parent that takes its separator is latched, so another split of the child
+    // cannot post a separator between the child and ours. Moving right on the parent holds a third latch meanwhile.
+    Page *parent_page = FetchNode(parent_page_id);
+    parent_page->WLatch();
+    parent_page = MoveRightForWrite(parent_page, separator);
+    child->WUnlatch();
+    buffer_pool_manager_->UnpinPage(child_page_id, true);
+
+    auto *parent = reinterpret_cast<InternalPage *>(parent_page->GetData());
+    int index = parent->ValueIndex(child_page_id);
+    BUSTUB_ASSERT(index != -1, "split child is not referenced by its parent");
+    if (parent->GetSize() < parent->GetMaxSize()) {
+      parent->InsertAt(index + 1, separator, new_page_id);
+      parent_page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(parent->GetPageId(), true);
+      return;
+    }
+
+    page_id_t new_parent_page_id;
+    Page *new_parent_page = buffer_pool_manager_->NewPage(&new_parent_page_id);
+    if (new_parent_page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate new page");
+    }
+    auto *new_parent = reinterpret_cast<InternalPage *>(new_parent_page->GetData());
+    new_parent->Init(new_parent_page_id, level, internal_max_size_);
+    parent->MoveHalfTo(new_parent);
+    KeyType parent_separator = new_parent->KeyAt(0);
+    if (comparator_(separator, parent_separator) >= 0) {
+      new_parent->InsertAt(new_parent->ValueIndex(child_page_id) + 1, separator, new_page_id);
+    } else {
+      parent->InsertAt(index + 1, separator, new_page_id);
+    }
+    buffer_pool_manager_->UnpinPage(new_parent_page_id, true);
+
+    child = parent_page;
+    separator = parent_separator;
+    new_page_id = new_parent_page_id;
+  }
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+/*
+ * Delete key & value pair associated with input key. Underfull leaves are
+ * left in place; the tree never shrinks.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BLINKTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
+  if (IsEmpty()) {
+    return;
+  }
+  std::vector<page_id_t> path;
+  Page *page = FindLeafForWrite(key, &path);
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  int index = leaf->LowerBound(key, comparator_);
+  bool found = index < leaf->GetSize() && comparator_(leaf->KeyAt(index), key) == 0;
+  if (found) {
+    leaf->RemoveAt(index);
+  }
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), found);
+}
+
+/**
+ * @return Page id of the root of this tree
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BLINKTREE_TYPE::GetRootPageId() -> page_id_t { return root_page_id_.load(); }
+
+/*
+ * Update/Insert root page id in header page(where page_id = 0, header_page is
+ * defined under include/page/header_page.h)
+ * Call this method everytime root page id is changed.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BLINKTREE_TYPE::UpdateRootPageId(int insert_record) {
+  auto *header_page = static_cast<HeaderPage *>(buffer_pool_manager_->FetchPage(HEADER_PAGE_ID));
+  if (insert_record != 0) {
+    header_page->InsertRecord(index_name_, root_page_id_.load());
+  } else {
+    header_page->UpdateRecord(index_name_, root_page_id_.load());
+  }
+  buffer_pool_manager_->UnpinPage(HEADER_PAGE_ID, true);
+}
+
+template class BLinkTree<GenericKey<4>, RID, GenericComparator<4>>;
+template class BLinkTree<GenericKey<8>, RID, GenericComparator<8>>;
+template class BLinkTree<GenericKey<16>, RID, GenericComparator<16>>;
+template class BLinkTree<GenericKey<32>, RID, GenericComparator<32>>;
+template class BLinkTree<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
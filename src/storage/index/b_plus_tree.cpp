@@ -1,4 +1,5 @@
 #include <string>
+#include <utility>
 
 #include "common/exception.h"
 #include "common/logger.h"
@@ -162,6 +163,38 @@ auto BPLUSTREE_TYPE::GetLeafPageByKey(const KeyType &key, int type, Transaction
   // node=static_cast<LeafPage*>(node);
   // return leaf_page;
 }
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeafRead(const KeyType *key, bool rightmost) -> ReadPageGuard {
+  auto guard = buffer_pool_manager_->FetchPageRead(root_page_id_);
+  root_latch_.RUnlock();
+  if (!guard.IsValid()) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate root_page_id_ page");
+  }
+  auto node = guard.As<BPlusTreePage>();
+  while (!node->IsLeafPage()) {
+    auto node_internal = static_cast<InternalPage *>(node);
+    page_id_t value;
+    if (key == nullptr) {
+      value = node_internal->ValueAt(rightmost ? node_internal->GetSize() - 1 : 0);
+    } else {
+      value = node_internal->ValueAt(0);
+      for (int i = 1; i < node_internal->GetSize(); i++) {
+        if (comparator_(*key, node_internal->KeyAt(i)) < 0) {
+          break;
+        }
+        value = node_internal->ValueAt(i);
+      }
+    }
+    auto child_guard = buffer_pool_manager_->FetchPageRead(value);
+    if (!child_guard.IsValid()) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate next page");
+    }
+    guard = std::move(child_guard);
+    node = guard.As<BPlusTreePage>();
+  }
+  return guard;
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction) -> bool {
   root_latch_.RLock();
@@ -169,13 +202,9 @@ auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
     root_latch_.RUnlock();
     return false;
   }
-  Page *page = GetLeafPageByKey(key, SEARCH, transaction);
-  auto node = reinterpret_cast<LeafPage *>(page->GetData());
+  ReadPageGuard guard = FindLeafRead(&key);
   ValueType value;
-  bool is_find = node->GetValueByKey(key, value, comparator_);
-  buffer_pool_manager_->UnpinPage(node->GetPageId(), false);
-  page->RUnlatch();
-  if (is_find) {
+  if (guard.As<LeafPage>()->GetValueByKey(key, value, comparator_)) {
     result->push_back(value);
     return true;
   }
@@ -613,26 +642,9 @@ auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
   root_latch_.RLock();
   if (root_page_id_ == INVALID_PAGE_ID) {
     root_latch_.RUnlock();
-    return INDEXITERATOR_TYPE(nullptr, nullptr, nullptr, 0);
-  }
-  auto page = buffer_pool_manager_->FetchPage(root_page_id_);
-  auto node = reinterpret_cast<BPlusTreePage *>(page->GetData());
-  root_latch_.RUnlock();
-  page->RLatch();
-  while (!node->IsLeafPage()) {
-    auto node_internal = static_cast<InternalPage *>(node);
-    page_id_t value = node_internal->ValueAt(0);
-    auto new_page = buffer_pool_manager_->FetchPage(value);
-    auto new_node = reinterpret_cast<BPlusTreePage *>(new_page->GetData());
-    new_page->RLatch();
-    page->RUnlatch();
-    buffer_pool_manager_->UnpinPage(node_internal->GetPageId(), false);
-    node = new_node;
-    page = new_page;
+    return INDEXITERATOR_TYPE();
   }
-  auto leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
-  // node=static_cast<LeafPage*>(node);
-  return INDEXITERATOR_TYPE(buffer_pool_manager_, page, leaf_page, 0);
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, FindLeafRead(nullptr), 0);
 }
 
 /*
@@ -645,15 +657,14 @@ auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
   root_latch_.RLock();
   if (root_page_id_ == INVALID_PAGE_ID) {
     root_latch_.RUnlock();
-    return INDEXITERATOR_TYPE(nullptr, nullptr, nullptr, 0);
+    return INDEXITERATOR_TYPE();
   }
-  Page *page = GetLeafPageByKey(key, SEARCH, nullptr);
-  auto node = reinterpret_cast<LeafPage *>(page->GetData());
-  int index = node->GetIndexByKey(key, comparator_);
+  ReadPageGuard guard = FindLeafRead(&key);
+  int index = guard.As<LeafPage>()->GetIndexByKey(key, comparator_);
   if (index == -1) {
-    return INDEXITERATOR_TYPE(nullptr, nullptr, nullptr, 0);
+    return INDEXITERATOR_TYPE();
   }
-  return INDEXITERATOR_TYPE(buffer_pool_manager_, page, node, index);
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, std::move(guard), index);
 }
 
 /*
@@ -666,26 +677,11 @@ auto BPLUSTREE_TYPE::End() -> INDEXITERATOR_TYPE {
   root_latch_.RLock();
   if (root_page_id_ == INVALID_PAGE_ID) {
     root_latch_.RUnlock();
-    return INDEXITERATOR_TYPE(nullptr, nullptr, nullptr, 0);
+    return INDEXITERATOR_TYPE();
   }
-  auto page = buffer_pool_manager_->FetchPage(root_page_id_);
-  auto node = reinterpret_cast<BPlusTreePage *>(page->GetData());
-  root_latch_.RUnlock();
-  page->RLatch();
-  while (!node->IsLeafPage()) {
-    auto node_internal = static_cast<InternalPage *>(node);
-    page_id_t value = node_internal->ValueAt(node_internal->GetSize() - 1);
-    auto new_page = buffer_pool_manager_->FetchPage(value);
-    auto new_node = reinterpret_cast<BPlusTreePage *>(new_page->GetData());
-    new_page->RLatch();
-    page->RUnlatch();
-    buffer_pool_manager_->UnpinPage(node_internal->GetPageId(), false);
-    node = new_node;
-    page = new_page;
-  }
-  auto leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
-  // node=static_cast<LeafPage*>(node);
-  return INDEXITERATOR_TYPE(buffer_pool_manager_, page, leaf_page, leaf_page->GetSize());
+  ReadPageGuard guard = FindLeafRead(nullptr, true);
+  int size = guard.As<LeafPage>()->GetSize();
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, std::move(guard), size);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -2,25 +2,15 @@
  * index_iterator.cpp
  */
 #include <cassert>
+#include <utility>
 
 #include "storage/index/index_iterator.h"
 
 namespace bustub {
 
-/*
- * NOTE: you can change the destructor/constructor method here
- * set your own input parameters
- */
-
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE::IndexIterator(BufferPoolManager *bpm, Page *page, LeafPage *leaf, int index)
-    : buffer_pool_manager_(bpm), page_(page), leafnode_(leaf), index_(index) {}
-
-INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE::~IndexIterator() {
-  page_->RUnlatch();
-  buffer_pool_manager_->UnpinPage(page_->GetPageId(), false);
-}
+INDEXITERATOR_TYPE::IndexIterator(BufferPoolManager *bpm, ReadPageGuard guard, int index)
+    : buffer_pool_manager_(bpm), guard_(std::move(guard)), leafnode_(guard_.As<LeafPage>()), index_(index) {}
 
 INDEX_TEMPLATE_ARGUMENTS
 auto INDEXITERATOR_TYPE::IsEnd() -> bool {
@@ -36,14 +26,11 @@ auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & {
     index_++;
   } else {
     if (leafnode_->GetNextPageId() != INVALID_PAGE_ID) {
-      Page *page = buffer_pool_manager_->FetchPage(leafnode_->GetNextPageId());
-      auto leaf_next_node = reinterpret_cast<LeafPage *>(page->GetData());
-      page->RLatch();
-      page_->RUnlatch();
-      buffer_pool_manager_->UnpinPage(leafnode_->GetPageId(), false);
-      leafnode_ = leaf_next_node;
+      // Latch the next leaf before letting go of the current one.
+      auto next_guard = buffer_pool_manager_->FetchPageRead(leafnode_->GetNextPageId());
+      guard_ = std::move(next_guard);
+      leafnode_ = guard_.As<LeafPage>();
       index_ = 0;
-      page_ = page;
     } else {
       index_++;
     }
@@ -0,0 +1,135 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_link_tree_page.cpp
+//
+// Identification: src/storage/page/b_link_tree_page.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstring>
+
+#include "common/rid.h"
+#include "storage/page/b_link_tree_page.h"
+
+namespace bustub {
+
+/*
+ * Init method after creating a new page. A node of level 0 is a leaf.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_LINK_TREE_PAGE_TYPE::Init(page_id_t page_id, int level, int max_size) {
+  page_type_ = level == 0 ? IndexPageType::LEAF_PAGE : IndexPageType::INTERNAL_PAGE;
+  lsn_ = INVALID_LSN;
+  size_ = 0;
+  max_size_ = max_size;
+  level_ = level;
+  page_id_ = page_id;
+  right_page_id_ = INVALID_PAGE_ID;
+  has_high_key_ = 0;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_LINK_TREE_PAGE_TYPE::SetHighKey(const KeyType &key) {
+  high_key_ = key;
+  has_high_key_ = 1;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_LINK_TREE_PAGE_TYPE::NeedMoveRight(const KeyType &key, const KeyComparator &comparator) const -> bool {
+  return has_high_key_ != 0 && right_page_id_ != INVALID_PAGE_ID && comparator(key, high_key_) >= 0;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_LINK_TREE_PAGE_TYPE::LowerBound(const KeyType &key, const KeyComparator &comparator) const -> int {
+  int lo = 0;
+  int hi = size_;
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (comparator(array_[mid].first, key) < 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+/*
+ * The first key of an internal node is unused, so the search looks for the
+ * last key in [1, size) that is not greater than key.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto B_LINK_TREE_PAGE_TYPE::LookupChild(const KeyType &key, const KeyComparator &comparator) const -> ValueType {
+  int lo = 1;
+  int hi = size_;
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (comparator(array_[mid].first, key) <= 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return array_[lo - 1].second;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_LINK_TREE_PAGE_TYPE::ValueIndex(const ValueType &value) const -> int {
+  for (int i = 0; i < size_; i++) {
+    if (array_[i].second == value) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_LINK_TREE_PAGE_TYPE::InsertAt(int index, const KeyType &key, const ValueType &value) {
+  std::memmove(static_cast<void *>(array_ + index + 1), static_cast<void *>(array_ + index),
+               (size_ - index) * sizeof(MappingType));
+  array_[index] = MappingType(key, value);
+  size_++;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_LINK_TREE_PAGE_TYPE::RemoveAt(int index) {
+  std::memmove(static_cast<void *>(array_ + index), static_cast<void *>(array_ + index + 1),
+               (size_ - index - 1) * sizeof(MappingType));
+  size_--;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_LINK_TREE_PAGE_TYPE::MoveHalfTo(BLinkTreePage *recipient) {
+  int left_size = size_ / 2;
+  int right_size = size_ - left_size;
+  std::memcpy(static_cast<void *>(recipient->array_), static_cast<void *>(array_ + left_size),
+              right_size * sizeof(MappingType));
+  recipient->size_ = right_size;
+  size_ = left_size;
+
+  // The recipient inherits the old upper bound and right link of this node.
+  if (has_high_key_ != 0) {
+    recipient->SetHighKey(high_key_);
+  }
+  recipient->right_page_id_ = right_page_id_;
+  SetHighKey(recipient->array_[0].first);
+  right_page_id_ = recipient->page_id_;
+}
+
+template class BLinkTreePage<GenericKey<4>, RID, GenericComparator<4>>;
+template class BLinkTreePage<GenericKey<8>, RID, GenericComparator<8>>;
+template class BLinkTreePage<GenericKey<16>, RID, GenericComparator<16>>;
+template class BLinkTreePage<GenericKey<32>, RID, GenericComparator<32>>;
+template class BLinkTreePage<GenericKey<64>, RID, GenericComparator<64>>;
+
+template class BLinkTreePage<GenericKey<4>, page_id_t, GenericComparator<4>>;
+template class BLinkTreePage<GenericKey<8>, page_id_t, GenericComparator<8>>;
+template class BLinkTreePage<GenericKey<16>, page_id_t, GenericComparator<16>>;
+template class BLinkTreePage<GenericKey<32>, page_id_t, GenericComparator<32>>;
+template class BLinkTreePage<GenericKey<64>, page_id_t, GenericComparator<64>>;
+
+}  // namespace bustub
@@ -110,7 +110,7 @@ auto B_PLUS_TREE_LEAF_PAGE_TYPE::Insert(KeyType key, ValueType value, KeyCompara
     return true;
   }
   int u = GetKeyAtIndex(key, comparator_);
-  if (comparator_(key, array_[u].first) == 0) {
+  if (u < GetSize() && comparator_(key, array_[u].first) == 0) {
     IsSplit = false;
     return false;
   }
@@ -11,6 +11,16 @@
 //===----------------------------------------------------------------------===//
 
 #include "storage/page/hash_table_bucket_page.h"
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include "common/logger.h"
 #include "common/util/hash_util.h"
 #include "storage/index/generic_key.h"
@@ -21,61 +31,174 @@ namespace bustub {
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::GetValue(KeyType key, KeyComparator cmp, std::vector<ValueType> *result) -> bool {
-  return false;
+  static_assert(sizeof(HashTableBucketPage) + (ARRAY_SIZE - 1) * sizeof(MappingType) <= BUSTUB_PAGE_SIZE,
+                "bucket does not fit in a page");
+  uint8_t fingerprint = Fingerprint(key);
+  bool found = false;
+  for (uint32_t group_start = 0; group_start < ARRAY_SIZE; group_start += BUCKET_GROUP_SIZE) {
+    uint32_t candidates = MatchFingerprint(group_start, fingerprint) & LoadGroupBits(readable_, group_start);
+    while (candidates != 0) {
+      uint32_t bucket_idx = group_start + __builtin_ctz(candidates);
+      candidates &= candidates - 1;
+      if (cmp(key, array_[bucket_idx].first) == 0) {
+        result->push_back(array_[bucket_idx].second);
+        found = true;
+      }
+    }
+    if (LoadGroupBits(occupied_, group_start) != UINT32_MAX) {
+      // Slots are filled from the front, so nothing was ever stored past the first never-occupied slot.
+      break;
+    }
+  }
+  return found;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::Insert(KeyType key, ValueType value, KeyComparator cmp) -> bool {
+  uint8_t fingerprint = Fingerprint(key);
+  uint32_t free_idx = ARRAY_SIZE;
+  for (uint32_t group_start = 0; group_start < ARRAY_SIZE; group_start += BUCKET_GROUP_SIZE) {
+    uint32_t readable = LoadGroupBits(readable_, group_start);
+    uint32_t candidates = MatchFingerprint(group_start, fingerprint) & readable;
+    while (candidates != 0) {
+      uint32_t bucket_idx = group_start + __builtin_ctz(candidates);
+      candidates &= candidates - 1;
+      if (cmp(key, array_[bucket_idx].first) == 0 && value == array_[bucket_idx].second) {
+        return false;
+      }
+    }
+    if (free_idx == ARRAY_SIZE && readable != UINT32_MAX) {
+      // The first tombstone or never-occupied slot; in the last group this may be padding.
+      free_idx = group_start + __builtin_ctz(~readable);
+    }
+    if (LoadGroupBits(occupied_, group_start) != UINT32_MAX) {
+      break;
+    }
+  }
+  if (free_idx >= ARRAY_SIZE) {
+    return false;
+  }
+  array_[free_idx] = MappingType(key, value);
+  fingerprints_[free_idx] = fingerprint;
+  SetOccupied(free_idx);
+  SetReadable(free_idx);
   return true;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::Remove(KeyType key, ValueType value, KeyComparator cmp) -> bool {
+  uint8_t fingerprint = Fingerprint(key);
+  for (uint32_t group_start = 0; group_start < ARRAY_SIZE; group_start += BUCKET_GROUP_SIZE) {
+    uint32_t candidates = MatchFingerprint(group_start, fingerprint) & LoadGroupBits(readable_, group_start);
+    while (candidates != 0) {
+      uint32_t bucket_idx = group_start + __builtin_ctz(candidates);
+      candidates &= candidates - 1;
+      if (cmp(key, array_[bucket_idx].first) == 0 && value == array_[bucket_idx].second) {
+        RemoveAt(bucket_idx);
+        return true;
+      }
+    }
+    if (LoadGroupBits(occupied_, group_start) != UINT32_MAX) {
+      break;
+    }
+  }
   return false;
 }
 
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_BUCKET_TYPE::Fingerprint(const KeyType &key) -> uint8_t {
+  uint64_t hash = HashUtil::HashBytes(reinterpret_cast<const char *>(&key), sizeof(KeyType));
+  // HashBytes barely mixes its low byte; a multiplicative step folds every bit into the top byte.
+  return static_cast<uint8_t>((hash * 0x9E3779B97F4A7C15ULL) >> 56);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_BUCKET_TYPE::LoadGroupBits(const char *bitmap, uint32_t group_start) -> uint32_t {
+  uint32_t bits;
+  std::memcpy(&bits, bitmap + group_start / 8, sizeof(bits));
+  return bits;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_BUCKET_TYPE::MatchFingerprint(uint32_t group_start, uint8_t fingerprint) const -> uint32_t {
+  const uint8_t *group = fingerprints_ + group_start;
+#if defined(__AVX2__)
+  __m256i cmp = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(group)),
+                                  _mm256_set1_epi8(static_cast<char>(fingerprint)));
+  return static_cast<uint32_t>(_mm256_movemask_epi8(cmp));
+#elif defined(__SSE2__)
+  __m128i needle = _mm_set1_epi8(static_cast<char>(fingerprint));
+  auto low = static_cast<uint32_t>(
+      _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(group)), needle)));
+  auto high = static_cast<uint32_t>(
+      _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(group + 16)), needle)));
+  return low | (high << 16);
+#else
+  uint32_t bits = 0;
+  for (uint32_t i = 0; i < BUCKET_GROUP_SIZE; i++) {
+    bits |= static_cast<uint32_t>(group[i] == fingerprint) << i;
+  }
+  return bits;
+#endif
+}
+
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::KeyAt(uint32_t bucket_idx) const -> KeyType {
-  return {};
+  return array_[bucket_idx].first;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::ValueAt(uint32_t bucket_idx) const -> ValueType {
-  return {};
+  return array_[bucket_idx].second;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_BUCKET_TYPE::RemoveAt(uint32_t bucket_idx) {}
+void HASH_TABLE_BUCKET_TYPE::RemoveAt(uint32_t bucket_idx) {
+  readable_[bucket_idx / 8] &= static_cast<char>(~(1 << (bucket_idx % 8)));
+}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::IsOccupied(uint32_t bucket_idx) const -> bool {
-  return false;
+  return (occupied_[bucket_idx / 8] & (1 << (bucket_idx % 8))) != 0;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_BUCKET_TYPE::SetOccupied(uint32_t bucket_idx) {}
+void HASH_TABLE_BUCKET_TYPE::SetOccupied(uint32_t bucket_idx) {
+  occupied_[bucket_idx / 8] |= static_cast<char>(1 << (bucket_idx % 8));
+}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::IsReadable(uint32_t bucket_idx) const -> bool {
-  return false;
+  return (readable_[bucket_idx / 8] & (1 << (bucket_idx % 8))) != 0;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_BUCKET_TYPE::SetReadable(uint32_t bucket_idx) {}
+void HASH_TABLE_BUCKET_TYPE::SetReadable(uint32_t bucket_idx) {
+  readable_[bucket_idx / 8] |= static_cast<char>(1 << (bucket_idx % 8));
+}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::IsFull() -> bool {
-  return false;
+  return NumReadable() == BUCKET_ARRAY_SIZE;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::NumReadable() -> uint32_t {
-  return 0;
+  uint32_t num_readable = 0;
+  for (uint32_t group_start = 0; group_start < ARRAY_SIZE; group_start += BUCKET_GROUP_SIZE) {
+    num_readable += __builtin_popcount(LoadGroupBits(readable_, group_start));
+  }
+  return num_readable;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 auto HASH_TABLE_BUCKET_TYPE::IsEmpty() -> bool {
-  return false;
+  for (uint32_t group_start = 0; group_start < ARRAY_SIZE; group_start += BUCKET_GROUP_SIZE) {
+    if (LoadGroupBits(readable_, group_start) != 0) {
+      return false;
+    }
+  }
+  return true;
 }
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
@@ -0,0 +1,60 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_robin_hood_block_page.cpp
+//
+// Identification: src/storage/page/hash_table_robin_hood_block_page.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/hash_table_robin_hood_block_page.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_ROBIN_HOOD_BLOCK_TYPE::KeyAt(slot_offset_t bucket_ind) const -> KeyType {
+  return array_[bucket_ind].first;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_ROBIN_HOOD_BLOCK_TYPE::ValueAt(slot_offset_t bucket_ind) const -> ValueType {
+  return array_[bucket_ind].second;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_ROBIN_HOOD_BLOCK_TYPE::IsOccupied(slot_offset_t bucket_ind) const -> bool {
+  return distances_[bucket_ind] != 0;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+auto HASH_TABLE_ROBIN_HOOD_BLOCK_TYPE::ProbeDistanceAt(slot_offset_t bucket_ind) const -> uint32_t {
+  return distances_[bucket_ind] - 1;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_ROBIN_HOOD_BLOCK_TYPE::SetPair(slot_offset_t bucket_ind, const MappingType &pair,
+                                               uint32_t probe_distance) {
+  static_assert(sizeof(HashTableRobinHoodBlockPage) + (ROBIN_HOOD_BLOCK_ARRAY_SIZE - 1) * sizeof(MappingType) <=
+                    BUSTUB_PAGE_SIZE,
+                "block does not fit in a page");
+  array_[bucket_ind] = pair;
+  distances_[bucket_ind] = static_cast<uint8_t>(probe_distance + 1);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_ROBIN_HOOD_BLOCK_TYPE::Clear(slot_offset_t bucket_ind) {
+  distances_[bucket_ind] = 0;
+}
+
+template class HashTableRobinHoodBlockPage<int, int, IntComparator>;
+template class HashTableRobinHoodBlockPage<GenericKey<4>, RID, GenericComparator<4>>;
+template class HashTableRobinHoodBlockPage<GenericKey<8>, RID, GenericComparator<8>>;
+template class HashTableRobinHoodBlockPage<GenericKey<16>, RID, GenericComparator<16>>;
+template class HashTableRobinHoodBlockPage<GenericKey<32>, RID, GenericComparator<32>>;
+template class HashTableRobinHoodBlockPage<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
@@ -0,0 +1,167 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pax_page.cpp
+//
+// Identification: src/storage/page/pax_page.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/pax_page.h"
+
+namespace bustub {
+
+PaxLayout::PaxLayout(const Schema &schema) : schema_(schema) {
+  // Size the minipages so that a page of rows with typical VARCHAR values is about full.
+  uint32_t row_size = 1;  // the row state
+  for (const auto &column : schema_.GetColumns()) {
+    row_size += column.GetFixedLength();
+    if (!column.IsInlined()) {
+      row_size += VARLEN_ESTIMATE;
+    }
+  }
+  capacity_ = (BUSTUB_PAGE_SIZE - PaxPage::OFFSET_ROW_STATES) / row_size;
+  BUSTUB_ENSURE(capacity_ > 0, "A row of this schema does not fit into a page.");
+
+  uint32_t offset = PaxPage::OFFSET_ROW_STATES + capacity_;
+  for (const auto &column : schema_.GetColumns()) {
+    column_offsets_.push_back(offset);
+    offset += capacity_ * column.GetFixedLength();
+  }
+  minipages_end_ = offset;
+}
+
+void PaxPage::Init(page_id_t page_id, page_id_t prev_page_id) {
+  memcpy(GetData(), &page_id, sizeof(page_id));
+  SetPrevPageId(prev_page_id);
+  SetNextPageId(INVALID_PAGE_ID);
+  SetRowCount(0);
+  SetVarlenPointer(BUSTUB_PAGE_SIZE);
+}
+
+auto PaxPage::InsertTuple(const Tuple &tuple, const PaxLayout &layout, RID *rid) -> bool {
+  const auto &schema = layout.GetSchema();
+  uint32_t slot_num = GetRowCount();
+  if (slot_num == layout.GetCapacity()) {
+    return false;
+  }
+  uint32_t varlen_size = 0;
+  for (auto column_idx : schema.GetUnlinedColumns()) {
+    const auto &column = schema.GetColumn(column_idx);
+    varlen_size += VarlenSize(tuple.data_ + *reinterpret_cast<const uint32_t *>(tuple.data_ + column.GetOffset()));
+  }
+  if (GetVarlenPointer() - layout.GetMinipagesEnd() < varlen_size) {
+    return false;
+  }
+
+  uint32_t varlen_pointer = GetVarlenPointer();
+  for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+    const auto &column = schema.GetColumn(i);
+    char *entry = GetData() + layout.GetColumnOffset(i) + slot_num * column.GetFixedLength();
+    if (column.IsInlined()) {
+      memcpy(entry, tuple.data_ + column.GetOffset(), column.GetFixedLength());
+    } else {
+      const char *value = tuple.data_ + *reinterpret_cast<const uint32_t *>(tuple.data_ + column.GetOffset());
+      uint32_t size = VarlenSize(value);
+      varlen_pointer -= size;
+      memcpy(GetData() + varlen_pointer, value, size);
+      memcpy(entry, &varlen_pointer, sizeof(uint32_t));
+    }
+  }
+  SetVarlenPointer(varlen_pointer);
+  GetData()[OFFSET_ROW_STATES + slot_num] = ROW_LIVE;
+  SetRowCount(slot_num + 1);
+  rid->Set(GetTablePageId(), slot_num);
+  return true;
+}
+
+auto PaxPage::MarkDelete(const RID &rid) -> bool {
+  if (!IsLive(rid.GetSlotNum())) {
+    return false;
+  }
+  GetData()[OFFSET_ROW_STATES + rid.GetSlotNum()] = ROW_DELETED;
+  return true;
+}
+
+void PaxPage::ApplyDelete(const RID &rid) {
+  BUSTUB_ASSERT(rid.GetSlotNum() < GetRowCount(), "Cannot have more slots than rows.");
+  GetData()[OFFSET_ROW_STATES + rid.GetSlotNum()] = ROW_EMPTY;
+}
+
+void PaxPage::RollbackDelete(const RID &rid) {
+  BUSTUB_ASSERT(rid.GetSlotNum() < GetRowCount(), "Cannot have more slots than rows.");
+  if (GetData()[OFFSET_ROW_STATES + rid.GetSlotNum()] == ROW_DELETED) {
+    GetData()[OFFSET_ROW_STATES + rid.GetSlotNum()] = ROW_LIVE;
+  }
+}
+
+auto PaxPage::GetTuple(const RID &rid, const PaxLayout &layout, Tuple *tuple) -> bool {
+  uint32_t slot_num = rid.GetSlotNum();
+  if (!IsLive(slot_num)) {
+    return false;
+  }
+  const auto &schema = layout.GetSchema();
+  uint32_t size = schema.GetLength();
+  for (auto column_idx : schema.GetUnlinedColumns()) {
+    const auto &column = schema.GetColumn(column_idx);
+    auto varlen_offset = *reinterpret_cast<uint32_t *>(GetData() + layout.GetColumnOffset(column_idx) +
+                                                       slot_num * column.GetFixedLength());
+    size += VarlenSize(GetData() + varlen_offset);
+  }
+
+  // Same format as the Tuple constructor: the inlined values first, then the VARCHAR data in column order.
+  tuple->Reserve(size);
+  uint32_t varlen_offset_in_tuple = schema.GetLength();
+  for (uint32_t i = 0; i < schema.GetColumnCount(); i++) {
+    const auto &column = schema.GetColumn(i);
+    const char *entry = GetData() + layout.GetColumnOffset(i) + slot_num * column.GetFixedLength();
+    if (column.IsInlined()) {
+      memcpy(tuple->data_ + column.GetOffset(), entry, column.GetFixedLength());
+    } else {
+      const char *value = GetData() + *reinterpret_cast<const uint32_t *>(entry);
+      uint32_t value_size = VarlenSize(value);
+      memcpy(tuple->data_ + column.GetOffset(), &varlen_offset_in_tuple, sizeof(uint32_t));
+      memcpy(tuple->data_ + varlen_offset_in_tuple, value, value_size);
+      varlen_offset_in_tuple += value_size;
+    }
+  }
+  tuple->rid_ = rid;
+  return true;
+}
+
+auto PaxPage::GetValue(uint32_t slot_num, const PaxLayout &layout, uint32_t column_idx) -> Value {
+  const auto &column = layout.GetSchema().GetColumn(column_idx);
+  const char *entry = GetData() + layout.GetColumnOffset(column_idx) + slot_num * column.GetFixedLength();
+  if (column.IsInlined()) {
+    return Value::DeserializeFrom(entry, column.GetType());
+  }
+  return Value::DeserializeFrom(GetData() + *reinterpret_cast<const uint32_t *>(entry), column.GetType());
+}
+
+auto PaxPage::GetFirstTupleRid(RID *first_rid) -> bool {
+  for (uint32_t i = 0; i < GetRowCount(); i++) {
+    if (IsLive(i)) {
+      first_rid->Set(GetTablePageId(), i);
+      return true;
+    }
+  }
+  first_rid->Set(INVALID_PAGE_ID, 0);
+  return false;
+}
+
+auto PaxPage::GetNextTupleRid(const RID &cur_rid, RID *next_rid) -> bool {
+  BUSTUB_ASSERT(cur_rid.GetPageId() == GetTablePageId(), "Wrong table!");
+  for (auto i = cur_rid.GetSlotNum() + 1; i < GetRowCount(); i++) {
+    if (IsLive(i)) {
+      next_rid->Set(GetTablePageId(), i);
+      return true;
+    }
+  }
+  next_rid->Set(INVALID_PAGE_ID, 0);
+  return false;
+}
+
+}  // namespace bustub
@@ -12,7 +12,11 @@
 
 #include "storage/page/table_page.h"
 
+#include <algorithm>
 #include <cassert>
+#include <functional>
+#include <utility>
+#include <vector>
 
 namespace bustub {
 
@@ -33,16 +37,12 @@ void TablePage::Init(page_id_t page_id, uint32_t page_size, page_id_t prev_page_
   SetNextPageId(INVALID_PAGE_ID);
   SetFreeSpacePointer(page_size);
   SetTupleCount(0);
+  SetFreedSpace(0);
 }
 
 auto TablePage::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn, LockManager *lock_manager,
                             LogManager *log_manager) -> bool {
   BUSTUB_ASSERT(tuple.size_ > 0, "Cannot have empty tuples.");
-  // If there is not enough space, then return false.
-  if (GetFreeSpaceRemaining() < tuple.size_ + SIZE_TUPLE) {
-    return false;
-  }
-
   // Try to find a free slot to reuse.
   uint32_t i;
   for (i = 0; i < GetTupleCount(); i++) {
@@ -53,8 +53,8 @@ auto TablePage::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn, Lock
     }
   }
 
-  // If there was no free slot left, and we cannot claim it from the free space, then we give up.
-  if (i == GetTupleCount() && GetFreeSpaceRemaining() < tuple.size_ + SIZE_TUPLE) {
+  // If we cannot claim the space for the tuple, and a new slot if there was no free one left, then we give up.
+  if (!ReserveSpace(tuple.size_, i == GetTupleCount())) {
     return false;
   }
 
@@ -89,6 +89,34 @@ auto TablePage::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn, Lock
   return true;
 }
 
+auto TablePage::InsertTuples(const std::vector<Tuple> &tuples, size_t begin, std::vector<RID> *rids,
+                             Transaction *txn, LockManager *lock_manager, LogManager *log_manager) -> size_t {
+  // Every tuple may take the next free slot; slots past the last one are claimed from the free space.
+  uint32_t slot = 0;
+  size_t end = begin;
+  for (; end < tuples.size(); end++) {
+    const auto &tuple = tuples[end];
+    BUSTUB_ASSERT(tuple.size_ > 0, "Cannot have empty tuples.");
+    while (slot < GetTupleCount() && GetTupleSize(slot) != 0) {
+      slot++;
+    }
+    if (!ReserveSpace(tuple.size_, slot == GetTupleCount())) {
+      break;
+    }
+
+    SetFreeSpacePointer(GetFreeSpacePointer() - tuple.size_);
+    memcpy(GetData() + GetFreeSpacePointer(), tuple.data_, tuple.size_);
+    SetTupleOffsetAtSlot(slot, GetFreeSpacePointer());
+    SetTupleSize(slot, tuple.size_);
+    if (slot == GetTupleCount()) {
+      SetTupleCount(GetTupleCount() + 1);
+    }
+    rids->emplace_back(GetTablePageId(), slot);
+  }
+  // As in InsertTuple, inserts are not logged.
+  return end - begin;
+}
+
 auto TablePage::MarkDelete(const RID &rid, Transaction *txn, LockManager *lock_manager, LogManager *log_manager)
     -> bool {
   uint32_t slot_num = rid.GetSlotNum();
@@ -155,21 +183,15 @@ auto TablePage::UpdateTuple(const Tuple &new_tuple, Tuple *old_tuple, const RID
     }
     return false;
   }
-  // If there is not enuogh space to update, we need to update via delete followed by an insert (not enough space).
-  if (GetFreeSpaceRemaining() + tuple_size < new_tuple.size_) {
+  // If there is not enough space to update, we need to update via delete followed by an insert (not enough space).
+  if (GetFreeSpaceRemaining() + GetFreedSpace() + tuple_size < new_tuple.size_) {
     return false;
   }
 
   // Copy out the old value.
   uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
-  old_tuple->size_ = tuple_size;
-  if (old_tuple->allocated_) {
-    delete[] old_tuple->data_;
-  }
-  old_tuple->data_ = new char[old_tuple->size_];
-  memcpy(old_tuple->data_, GetData() + tuple_offset, old_tuple->size_);
+  old_tuple->CopyData(GetData() + tuple_offset, tuple_size);
   old_tuple->rid_ = rid;
-  old_tuple->allocated_ = true;
 
   /**
    * Removed to support new lock manager API for p4 (multilevel locking); Big hack energy
@@ -188,23 +210,25 @@ auto TablePage::UpdateTuple(const Tuple &new_tuple, Tuple *old_tuple, const RID
   //    new_tuple); lsn_t lsn = log_manager->AppendLogRecord(&log_record); SetLSN(lsn); txn->SetPrevLSN(lsn);
   //  }
 
-  // Perform the update.
-  uint32_t free_space_pointer = GetFreeSpacePointer();
-  BUSTUB_ASSERT(tuple_offset >= free_space_pointer, "Offset should appear after current free space position.");
-
-  memmove(GetData() + free_space_pointer + tuple_size - new_tuple.size_, GetData() + free_space_pointer,
-          tuple_offset - free_space_pointer);
-  SetFreeSpacePointer(free_space_pointer + tuple_size - new_tuple.size_);
-  memcpy(GetData() + tuple_offset + tuple_size - new_tuple.size_, new_tuple.data_, new_tuple.size_);
-  SetTupleSize(slot_num, new_tuple.size_);
-
-  // Update all tuple offsets.
-  for (uint32_t i = 0; i < GetTupleCount(); ++i) {
-    uint32_t tuple_offset_i = GetTupleOffsetAtSlot(i);
-    if (GetTupleSize(i) > 0 && tuple_offset_i < tuple_offset + tuple_size) {
-      SetTupleOffsetAtSlot(i, tuple_offset_i + tuple_size - new_tuple.size_);
-    }
+  // Perform the update. A tuple that does not grow stays where it is and leaves its unused head as a hole; one that
+  // grows moves to the free space, leaving its old place as a hole.
+  if (new_tuple.size_ <= tuple_size) {
+    uint32_t new_offset = tuple_offset + tuple_size - new_tuple.size_;
+    memcpy(GetData() + new_offset, new_tuple.data_, new_tuple.size_);
+    SetTupleOffsetAtSlot(slot_num, new_offset);
+    SetTupleSize(slot_num, new_tuple.size_);
+    FreeSpace(tuple_offset, tuple_size - new_tuple.size_);
+    return true;
   }
+  // The old value is copied out already, so its space may be reclaimed if the page needs compacting.
+  SetTupleSize(slot_num, 0);
+  SetTupleOffsetAtSlot(slot_num, 0);
+  FreeSpace(tuple_offset, tuple_size);
+  BUSTUB_ENSURE(ReserveSpace(new_tuple.size_, false), "The new tuple should fit after freeing the old one.");
+  SetFreeSpacePointer(GetFreeSpacePointer() - new_tuple.size_);
+  memcpy(GetData() + GetFreeSpacePointer(), new_tuple.data_, new_tuple.size_);
+  SetTupleOffsetAtSlot(slot_num, GetFreeSpacePointer());
+  SetTupleSize(slot_num, new_tuple.size_);
   return true;
 }
 
@@ -241,22 +265,9 @@ void TablePage::ApplyDelete(const RID &rid, Transaction *txn, LogManager *log_ma
   //    txn->SetPrevLSN(lsn);
   //  }
 
-  uint32_t free_space_pointer = GetFreeSpacePointer();
-  BUSTUB_ASSERT(tuple_offset >= free_space_pointer, "Free space appears before tuples.");
-
-  memmove(GetData() + free_space_pointer + tuple_size, GetData() + free_space_pointer,
-          tuple_offset - free_space_pointer);
-  SetFreeSpacePointer(free_space_pointer + tuple_size);
   SetTupleSize(slot_num, 0);
   SetTupleOffsetAtSlot(slot_num, 0);
-
-  // Update all tuple offsets.
-  for (uint32_t i = 0; i < GetTupleCount(); ++i) {
-    uint32_t tuple_offset_i = GetTupleOffsetAtSlot(i);
-    if (GetTupleSize(i) != 0 && tuple_offset_i < tuple_offset) {
-      SetTupleOffsetAtSlot(i, tuple_offset_i + tuple_size);
-    }
-  }
+  FreeSpace(tuple_offset, tuple_size);
 }
 
 void TablePage::RollbackDelete(const RID &rid, Transaction *txn, LogManager *log_manager) {
@@ -314,18 +325,82 @@ auto TablePage::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockMan
   //  }
 
   // At this point, we have at least a shared lock on the RID. Copy the tuple data into our result.
-  uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
-  tuple->size_ = tuple_size;
-  if (tuple->allocated_) {
-    delete[] tuple->data_;
+  tuple->CopyData(GetData() + GetTupleOffsetAtSlot(slot_num), tuple_size);
+  tuple->rid_ = rid;
+  return true;
+}
+
+auto TablePage::GetTupleView(const RID &rid, Tuple *tuple) -> bool {
+  uint32_t slot_num = rid.GetSlotNum();
+  if (slot_num >= GetTupleCount()) {
+    return false;
   }
-  tuple->data_ = new char[tuple->size_];
-  memcpy(tuple->data_, GetData() + tuple_offset, tuple->size_);
+  uint32_t tuple_size = GetTupleSize(slot_num);
+  if (IsDeleted(tuple_size)) {
+    return false;
+  }
+  tuple->Borrow(GetData() + GetTupleOffsetAtSlot(slot_num), tuple_size);
   tuple->rid_ = rid;
-  tuple->allocated_ = true;
   return true;
 }
 
+void TablePage::Compact() {
+  // Visit the tuples from the end of the page on, sliding each run of adjacent tuples up with a single memmove.
+  std::vector<std::pair<uint32_t, uint32_t>> tuples;  // (offset, slot)
+  for (uint32_t i = 0; i < GetTupleCount(); i++) {
+    if (GetTupleSize(i) != 0) {
+      tuples.emplace_back(GetTupleOffsetAtSlot(i), i);
+    }
+  }
+  std::sort(tuples.begin(), tuples.end(), std::greater<>());
+
+  uint32_t end = BUSTUB_PAGE_SIZE;
+  size_t run_begin = 0;
+  while (run_begin < tuples.size()) {
+    size_t run_end = run_begin + 1;
+    uint32_t run_offset = tuples[run_begin].first;
+    uint32_t run_size = UnsetDeletedFlag(GetTupleSize(tuples[run_begin].second));
+    while (run_end < tuples.size() &&
+           tuples[run_end].first + UnsetDeletedFlag(GetTupleSize(tuples[run_end].second)) == run_offset) {
+      run_offset = tuples[run_end].first;
+      run_size += UnsetDeletedFlag(GetTupleSize(tuples[run_end].second));
+      run_end++;
+    }
+    uint32_t shift = end - run_offset - run_size;
+    if (shift > 0) {
+      memmove(GetData() + run_offset + shift, GetData() + run_offset, run_size);
+      for (size_t i = run_begin; i < run_end; i++) {
+        SetTupleOffsetAtSlot(tuples[i].second, tuples[i].first + shift);
+      }
+    }
+    end = run_offset + shift;
+    run_begin = run_end;
+  }
+  SetFreeSpacePointer(end);
+  SetFreedSpace(0);
+}
+
+auto TablePage::ReserveSpace(uint32_t tuple_size, bool new_slot) -> bool {
+  uint32_t needed = tuple_size + (new_slot ? SIZE_TUPLE : 0);
+  if (GetFreeSpaceRemaining() >= needed) {
+    return true;
+  }
+  if (GetFreeSpaceRemaining() + GetFreedSpace() < needed) {
+    return false;
+  }
+  Compact();
+  return true;
+}
+
+void TablePage::FreeSpace(uint32_t tuple_offset, uint32_t tuple_size) {
+  // A tuple right at the free space pointer simply becomes part of the free space.
+  if (tuple_offset == GetFreeSpacePointer()) {
+    SetFreeSpacePointer(tuple_offset + tuple_size);
+  } else {
+    SetFreedSpace(GetFreedSpace() + tuple_size);
+  }
+}
+
 auto TablePage::GetFirstTupleRid(RID *first_rid) -> bool {
   // Find and return the first valid tuple.
   for (uint32_t i = 0; i < GetTupleCount(); ++i) {
@@ -0,0 +1,80 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map.cpp
+//
+// Identification: src/storage/table/free_space_map.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/free_space_map.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+void FreeSpaceMap::AppendPage(page_id_t page_id, uint32_t max_insert_size) {
+  std::scoped_lock lock(latch_);
+  if (page_ids_.size() == capacity_) {
+    // Double the tree, keeping the leaves in order.
+    std::vector<uint32_t> tree(4 * capacity_, 0);
+    std::copy(tree_.begin() + capacity_, tree_.end(), tree.begin() + 2 * capacity_);
+    capacity_ *= 2;
+    tree_ = std::move(tree);
+    for (size_t node = capacity_ - 1; node > 0; node--) {
+      tree_[node] = std::max(tree_[2 * node], tree_[2 * node + 1]);
+    }
+  }
+  hint_ = page_ids_.size();
+  page_index_[page_id] = hint_;
+  page_ids_.push_back(page_id);
+  SetSize(hint_, max_insert_size);
+}
+
+void FreeSpaceMap::UpdatePage(page_id_t page_id, uint32_t max_insert_size) {
+  std::scoped_lock lock(latch_);
+  auto it = page_index_.find(page_id);
+  if (it != page_index_.end()) {
+    SetSize(it->second, max_insert_size);
+  }
+}
+
+auto FreeSpaceMap::FindPage(uint32_t tuple_size) -> page_id_t {
+  std::scoped_lock lock(latch_);
+  if (page_ids_.empty() || tree_[1] < tuple_size) {
+    return INVALID_PAGE_ID;
+  }
+  if (tree_[capacity_ + hint_] >= tuple_size) {
+    return page_ids_[hint_];
+  }
+  // Descend towards the leftmost page that fits, so that space freed early in the chain is reused first.
+  size_t node = 1;
+  while (node < capacity_) {
+    node = tree_[2 * node] >= tuple_size ? 2 * node : 2 * node + 1;
+  }
+  hint_ = node - capacity_;
+  return page_ids_[hint_];
+}
+
+auto FreeSpaceMap::GetLastPageId() -> page_id_t {
+  std::scoped_lock lock(latch_);
+  return page_ids_.empty() ? INVALID_PAGE_ID : page_ids_.back();
+}
+
+auto FreeSpaceMap::GetNumPages() -> size_t {
+  std::scoped_lock lock(latch_);
+  return page_ids_.size();
+}
+
+void FreeSpaceMap::SetSize(size_t index, uint32_t max_insert_size) {
+  size_t node = capacity_ + index;
+  tree_[node] = max_insert_size;
+  for (node /= 2; node > 0; node /= 2) {
+    tree_[node] = std::max(tree_[2 * node], tree_[2 * node + 1]);
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,197 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pax_table_heap.cpp
+//
+// Identification: src/storage/table/pax_table_heap.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/pax_table_heap.h"
+
+#include <utility>
+
+#include "common/exception.h"
+#include "concurrency/transaction.h"
+
+namespace bustub {
+
+PaxTableHeap::PaxTableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager,
+                           LogManager *log_manager, const Schema &schema, Transaction *txn)
+    : TableHeap(buffer_pool_manager, lock_manager, log_manager), layout_(schema) {
+  auto guard = buffer_pool_manager_->NewPageGuarded(&first_page_id_);
+  BUSTUB_ASSERT(guard.IsValid(), "Couldn't create a page for the table heap.");
+  guard.AsMut<PaxPage>()->Init(first_page_id_, INVALID_PAGE_ID);
+  last_page_id_ = first_page_id_;
+}
+
+auto PaxTableHeap::AppendTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> bool {
+  auto guard = buffer_pool_manager_->FetchPageWrite(last_page_id_);
+  if (!guard.IsValid()) {
+    txn->SetState(TransactionState::ABORTED);
+    return false;
+  }
+  if (guard.As<PaxPage>()->InsertTuple(tuple, layout_, rid)) {
+    guard.SetDirty();
+    return true;
+  }
+  if (guard.As<PaxPage>()->GetRowCount() == 0) {
+    // The row does not even fit into an empty page.
+    txn->SetState(TransactionState::ABORTED);
+    return false;
+  }
+
+  page_id_t new_page_id;
+  auto new_guard = buffer_pool_manager_->NewPageGuarded(&new_page_id);
+  if (!new_guard.IsValid()) {
+    txn->SetState(TransactionState::ABORTED);
+    return false;
+  }
+  auto new_page = new_guard.AsMut<PaxPage>();
+  new_page->Init(new_page_id, last_page_id_);
+  guard.AsMut<PaxPage>()->SetNextPageId(new_page_id);
+  guard.Drop();
+  last_page_id_ = new_page_id;
+  if (!new_page->InsertTuple(tuple, layout_, rid)) {
+    txn->SetState(TransactionState::ABORTED);
+    return false;
+  }
+  return true;
+}
+
+auto PaxTableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> bool {
+  {
+    std::scoped_lock lock(insert_latch_);
+    if (!AppendTuple(tuple, rid, txn)) {
+      return false;
+    }
+  }
+  txn->GetWriteSet()->emplace_back(*rid, WType::INSERT, Tuple{}, this);
+  return true;
+}
+
+auto PaxTableHeap::InsertTuples(const std::vector<Tuple> &tuples, std::vector<RID> *rids, Transaction *txn) -> bool {
+  rids->clear();
+  rids->reserve(tuples.size());
+  std::scoped_lock lock(insert_latch_);
+  for (const auto &tuple : tuples) {
+    RID rid;
+    if (!AppendTuple(tuple, &rid, txn)) {
+      return false;
+    }
+    rids->push_back(rid);
+    txn->GetWriteSet()->emplace_back(rid, WType::INSERT, Tuple{}, this);
+  }
+  return true;
+}
+
+auto PaxTableHeap::MarkDelete(const RID &rid, Transaction *txn) -> bool {
+  auto guard = buffer_pool_manager_->FetchPageWrite(rid.GetPageId());
+  if (!guard.IsValid()) {
+    txn->SetState(TransactionState::ABORTED);
+    return false;
+  }
+  if (!guard.AsMut<PaxPage>()->MarkDelete(rid)) {
+    return false;
+  }
+  guard.Drop();
+  txn->GetWriteSet()->emplace_back(rid, WType::DELETE, Tuple{}, this);
+  return true;
+}
+
+auto PaxTableHeap::UpdateTuple(const Tuple &tuple, const RID &rid, Transaction *txn) -> bool { return false; }
+
+void PaxTableHeap::ApplyDelete(const RID &rid, Transaction *txn) {
+  auto guard = buffer_pool_manager_->FetchPageWrite(rid.GetPageId());
+  BUSTUB_ASSERT(guard.IsValid(), "Couldn't find a page containing that RID.");
+  guard.AsMut<PaxPage>()->ApplyDelete(rid);
+}
+
+void PaxTableHeap::RollbackDelete(const RID &rid, Transaction *txn) {
+  auto guard = buffer_pool_manager_->FetchPageWrite(rid.GetPageId());
+  BUSTUB_ASSERT(guard.IsValid(), "Couldn't find a page containing that RID.");
+  guard.AsMut<PaxPage>()->RollbackDelete(rid);
+}
+
+auto PaxTableHeap::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool acquire_read_lock) -> bool {
+  auto guard = buffer_pool_manager_->FetchPageBasic(rid.GetPageId());
+  if (!guard.IsValid()) {
+    txn->SetState(TransactionState::ABORTED);
+    return false;
+  }
+  if (!acquire_read_lock) {
+    return guard.As<PaxPage>()->GetTuple(rid, layout_, tuple);
+  }
+  auto read_guard = guard.UpgradeRead();
+  return read_guard.As<PaxPage>()->GetTuple(rid, layout_, tuple);
+}
+
+auto PaxTableHeap::Begin(Transaction *txn) -> TableIterator {
+  RID rid;
+  auto page_id = first_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    auto guard = buffer_pool_manager_->FetchPageRead(page_id);
+    BUSTUB_ENSURE(guard.IsValid(), "BPM full");
+    auto page = guard.As<PaxPage>();
+    if (page->GetFirstTupleRid(&rid)) {
+      break;
+    }
+    page_id = page->GetNextPageId();
+  }
+  return {this, rid, txn};
+}
+
+void PaxTableHeap::NextTuple(Tuple *tuple) {
+  auto guard = buffer_pool_manager_->FetchPageRead(tuple->GetRid().GetPageId());
+  BUSTUB_ENSURE(guard.IsValid(), "BPM full");
+
+  auto cur_page = guard.As<PaxPage>();
+  RID next_rid;
+  if (!cur_page->GetNextTupleRid(tuple->GetRid(), &next_rid)) {
+    while (cur_page->GetNextPageId() != INVALID_PAGE_ID) {
+      auto next_guard = buffer_pool_manager_->FetchPageRead(cur_page->GetNextPageId());
+      guard = std::move(next_guard);
+      cur_page = guard.As<PaxPage>();
+      if (cur_page->GetFirstTupleRid(&next_rid)) {
+        break;
+      }
+    }
+  }
+  if (next_rid.GetPageId() == INVALID_PAGE_ID) {
+    tuple->SetRid(next_rid);
+    return;
+  }
+  if (!cur_page->GetTuple(next_rid, layout_, tuple)) {
+    throw bustub::Exception("read non-existing tuple");
+  }
+}
+
+auto PaxTableHeap::ScanColumns(page_id_t page_id, const std::vector<uint32_t> &column_ids,
+                               std::vector<std::vector<Value>> *columns, std::vector<RID> *rids) -> page_id_t {
+  auto guard = buffer_pool_manager_->FetchPageRead(page_id);
+  BUSTUB_ENSURE(guard.IsValid(), "BPM full");
+  auto page = guard.As<PaxPage>();
+
+  rids->clear();
+  for (uint32_t slot_num = 0; slot_num < page->GetRowCount(); slot_num++) {
+    if (page->IsLive(slot_num)) {
+      rids->emplace_back(page_id, slot_num);
+    }
+  }
+  // Go through the page one minipage at a time.
+  columns->resize(column_ids.size());
+  for (size_t i = 0; i < column_ids.size(); i++) {
+    auto &column = (*columns)[i];
+    column.clear();
+    column.reserve(rids->size());
+    for (const auto &rid : *rids) {
+      column.push_back(page->GetValue(rid.GetSlotNum(), layout_, column_ids[i]));
+    }
+  }
+  return page->GetNextPageId();
+}
+
+}  // namespace bustub
@@ -11,7 +11,9 @@
 //===----------------------------------------------------------------------===//
 
 #include <cassert>
+#include <utility>
 
+#include "common/exception.h"
 #include "common/logger.h"
 #include "fmt/format.h"
 #include "storage/table/table_heap.h"
@@ -29,82 +31,153 @@ TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_m
                      Transaction *txn)
     : buffer_pool_manager_(buffer_pool_manager), lock_manager_(lock_manager), log_manager_(log_manager) {
   // Initialize the first table page.
-  auto first_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(&first_page_id_));
-  BUSTUB_ASSERT(first_page != nullptr,
+  auto guard = buffer_pool_manager_->NewPageGuarded(&first_page_id_);
+  BUSTUB_ASSERT(guard.IsValid(),
                 "Couldn't create a page for the table heap. Have you completed the buffer pool manager project?");
+  auto first_page = guard.AsMut<TablePage>();
   first_page->Init(first_page_id_, BUSTUB_PAGE_SIZE, INVALID_LSN, log_manager_, txn);
-  buffer_pool_manager_->UnpinPage(first_page_id_, true);
+  free_space_map_.AppendPage(first_page_id_, first_page->GetMaxInsertSize());
+  free_space_map_loaded_.store(true);
 }
 
 auto TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> bool {
-  if (tuple.size_ + 32 > BUSTUB_PAGE_SIZE) {  // larger than one page size
+  if (tuple.size_ > TablePage::MaxTupleSize()) {  // larger than an empty page takes
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
+  LoadFreeSpaceMap();
 
-  auto cur_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
-  if (cur_page == nullptr) {
-    txn->SetState(TransactionState::ABORTED);
-    return false;
-  }
-
-  cur_page->WLatch();
-
-  // Insert into the first page with enough space. If no such page exists, create a new page and insert into that.
-  // INVARIANT: cur_page is WLatched if you leave the loop normally.
-  while (!cur_page->InsertTuple(tuple, rid, txn, lock_manager_, log_manager_)) {
-    auto next_page_id = cur_page->GetNextPageId();
-    // If the next page is a valid page,
-    if (next_page_id != INVALID_PAGE_ID) {
-      auto next_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(next_page_id));
-      next_page->WLatch();
-      // Unlatch and unpin the current page.
-      cur_page->WUnlatch();
-      buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), false);
-      cur_page = next_page;
-    } else {
-      // Otherwise we have run out of valid pages. We need to create a new page.
-      auto new_page = static_cast<TablePage *>(buffer_pool_manager_->NewPage(&next_page_id));
-      // If we could not create a new page,
-      if (new_page == nullptr) {
-        // Then life sucks and we abort the transaction.
-        cur_page->WUnlatch();
-        buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), false);
+  // Insert into a page that the free-space map says has enough space. The map is only a hint, so the page may have
+  // filled up in the meantime; report its actual space and ask again. If no page fits, append a new page.
+  while (true) {
+    auto page_id = free_space_map_.FindPage(tuple.size_);
+    if (page_id == INVALID_PAGE_ID) {
+      std::scoped_lock lock(append_latch_);
+      // Another insert may have appended a page while we were waiting.
+      if (free_space_map_.FindPage(tuple.size_) == INVALID_PAGE_ID && !AppendPage(txn)) {
+        // If we could not create a new page, then life sucks and we abort the transaction.
         txn->SetState(TransactionState::ABORTED);
         return false;
       }
-      // Otherwise we were able to create a new page. We initialize it now.
-      new_page->WLatch();
-      cur_page->SetNextPageId(next_page_id);
-      new_page->Init(next_page_id, BUSTUB_PAGE_SIZE, cur_page->GetTablePageId(), log_manager_, txn);
-      cur_page->WUnlatch();
-      buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
-      cur_page = new_page;
+      continue;
+    }
+
+    auto guard = buffer_pool_manager_->FetchPageWrite(page_id);
+    if (!guard.IsValid()) {
+      txn->SetState(TransactionState::ABORTED);
+      return false;
+    }
+    auto cur_page = guard.As<TablePage>();
+    bool is_inserted = cur_page->InsertTuple(tuple, rid, txn, lock_manager_, log_manager_);
+    free_space_map_.UpdatePage(page_id, cur_page->GetMaxInsertSize());
+    if (is_inserted) {
+      guard.SetDirty();
+      break;
     }
   }
-  // This line has caused most of us to double-take and "whoa double unlatch".
-  // We are not, in fact, double unlatching. See the invariant above.
-  cur_page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
   // Update the transaction's write set.
   txn->GetWriteSet()->emplace_back(*rid, WType::INSERT, Tuple{}, this);
   return true;
 }
 
+auto TableHeap::InsertTuples(const std::vector<Tuple> &tuples, std::vector<RID> *rids, Transaction *txn) -> bool {
+  for (const auto &tuple : tuples) {
+    if (tuple.size_ > TablePage::MaxTupleSize()) {  // larger than an empty page takes
+      txn->SetState(TransactionState::ABORTED);
+      return false;
+    }
+  }
+  LoadFreeSpaceMap();
+  rids->clear();
+  rids->reserve(tuples.size());
+
+  // Same as InsertTuple, but every page that fits the next tuple takes as many of the following ones as it can.
+  size_t next = 0;
+  while (next < tuples.size()) {
+    auto page_id = free_space_map_.FindPage(tuples[next].size_);
+    if (page_id == INVALID_PAGE_ID) {
+      std::scoped_lock lock(append_latch_);
+      if (free_space_map_.FindPage(tuples[next].size_) == INVALID_PAGE_ID && !AppendPage(txn)) {
+        txn->SetState(TransactionState::ABORTED);
+        return false;
+      }
+      continue;
+    }
+
+    auto guard = buffer_pool_manager_->FetchPageWrite(page_id);
+    if (!guard.IsValid()) {
+      txn->SetState(TransactionState::ABORTED);
+      return false;
+    }
+    auto cur_page = guard.As<TablePage>();
+    auto num_inserted = cur_page->InsertTuples(tuples, next, rids, txn, lock_manager_, log_manager_);
+    free_space_map_.UpdatePage(page_id, cur_page->GetMaxInsertSize());
+    if (num_inserted > 0) {
+      guard.SetDirty();
+    }
+    guard.Drop();
+    // Update the transaction's write set page by page, so that an abort halfway rolls back what was inserted.
+    for (auto it = rids->end() - num_inserted; it != rids->end(); ++it) {
+      txn->GetWriteSet()->emplace_back(*it, WType::INSERT, Tuple{}, this);
+    }
+    next += num_inserted;
+  }
+  return true;
+}
+
+void TableHeap::LoadFreeSpaceMap() {
+  if (free_space_map_loaded_.load()) {
+    return;
+  }
+  std::scoped_lock lock(append_latch_);
+  if (free_space_map_loaded_.load()) {
+    return;
+  }
+  auto page_id = first_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    auto guard = buffer_pool_manager_->FetchPageRead(page_id);
+    BUSTUB_ASSERT(guard.IsValid(), "Couldn't fetch a page of the table heap.");
+    auto page = guard.As<TablePage>();
+    free_space_map_.AppendPage(page_id, page->GetMaxInsertSize());
+    page_id = page->GetNextPageId();
+  }
+  free_space_map_loaded_.store(true);
+}
+
+auto TableHeap::AppendPage(Transaction *txn) -> bool {
+  auto last_page_id = free_space_map_.GetLastPageId();
+  auto last_guard = buffer_pool_manager_->FetchPageBasic(last_page_id);
+  if (!last_guard.IsValid()) {
+    return false;
+  }
+  page_id_t new_page_id;
+  auto new_guard = buffer_pool_manager_->NewPageGuarded(&new_page_id);
+  if (!new_guard.IsValid()) {
+    return false;
+  }
+  // Link the new page in while holding both latches, so that iterators never see a half-initialized page.
+  auto last_page_guard = last_guard.UpgradeWrite();
+  auto new_page_guard = new_guard.UpgradeWrite();
+  last_page_guard.AsMut<TablePage>()->SetNextPageId(new_page_id);
+  auto new_page = new_page_guard.AsMut<TablePage>();
+  new_page->Init(new_page_id, BUSTUB_PAGE_SIZE, last_page_id, log_manager_, txn);
+  last_page_guard.Drop();
+  free_space_map_.AppendPage(new_page_id, new_page->GetMaxInsertSize());
+  return true;
+}
+
 auto TableHeap::MarkDelete(const RID &rid, Transaction *txn) -> bool {
   // TODO(Amadou): remove empty page
   // Find the page which contains the tuple.
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  auto guard = buffer_pool_manager_->FetchPageWrite(rid.GetPageId());
   // If the page could not be found, then abort the transaction.
-  if (page == nullptr) {
+  if (!guard.IsValid()) {
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
   // Otherwise, mark the tuple as deleted.
-  page->WLatch();
-  page->MarkDelete(rid, txn, lock_manager_, log_manager_);
-  page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+  guard.AsMut<TablePage>()->MarkDelete(rid, txn, lock_manager_, log_manager_);
+  guard.Drop();
   // Update the transaction's write set.
   txn->GetWriteSet()->emplace_back(rid, WType::DELETE, Tuple{}, this);
   return true;
@@ -112,18 +185,21 @@ auto TableHeap::MarkDelete(const RID &rid, Transaction *txn) -> bool {
 
 auto TableHeap::UpdateTuple(const Tuple &tuple, const RID &rid, Transaction *txn) -> bool {
   // Find the page which contains the tuple.
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  auto guard = buffer_pool_manager_->FetchPageWrite(rid.GetPageId());
   // If the page could not be found, then abort the transaction.
-  if (page == nullptr) {
+  if (!guard.IsValid()) {
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
   // Update the tuple; but first save the old value for rollbacks.
   Tuple old_tuple;
-  page->WLatch();
+  auto page = guard.As<TablePage>();
   bool is_updated = page->UpdateTuple(tuple, &old_tuple, rid, txn, lock_manager_, log_manager_);
-  page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), is_updated);
+  free_space_map_.UpdatePage(rid.GetPageId(), page->GetMaxInsertSize());
+  if (is_updated) {
+    guard.SetDirty();
+  }
+  guard.Drop();
   // Update the transaction's write set.
   if (is_updated && txn->GetState() != TransactionState::ABORTED) {
     txn->GetWriteSet()->emplace_back(rid, WType::UPDATE, old_tuple, this);
@@ -133,47 +209,39 @@ auto TableHeap::UpdateTuple(const Tuple &tuple, const RID &rid, Transaction *txn
 
 void TableHeap::ApplyDelete(const RID &rid, Transaction *txn) {
   // Find the page which contains the tuple.
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
-  BUSTUB_ASSERT(page != nullptr, "Couldn't find a page containing that RID.");
+  auto guard = buffer_pool_manager_->FetchPageWrite(rid.GetPageId());
+  BUSTUB_ASSERT(guard.IsValid(), "Couldn't find a page containing that RID.");
   // Delete the tuple from the page.
-  page->WLatch();
+  auto page = guard.AsMut<TablePage>();
   page->ApplyDelete(rid, txn, log_manager_);
+  free_space_map_.UpdatePage(rid.GetPageId(), page->GetMaxInsertSize());
   /** Commented out to make compatible with p4; This is called only on commit or delete, which consequently unlocks the
    * tuple; so should be fine */
   // lock_manager_->Unlock(txn, rid);
-  page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
 }
 
 void TableHeap::RollbackDelete(const RID &rid, Transaction *txn) {
   // Find the page which contains the tuple.
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
-  BUSTUB_ASSERT(page != nullptr, "Couldn't find a page containing that RID.");
+  auto guard = buffer_pool_manager_->FetchPageWrite(rid.GetPageId());
+  BUSTUB_ASSERT(guard.IsValid(), "Couldn't find a page containing that RID.");
   // Rollback the delete.
-  page->WLatch();
-  page->RollbackDelete(rid, txn, log_manager_);
-  page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+  guard.AsMut<TablePage>()->RollbackDelete(rid, txn, log_manager_);
 }
 
 auto TableHeap::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool acquire_read_lock) -> bool {
   // Find the page which contains the tuple.
-  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  auto guard = buffer_pool_manager_->FetchPageBasic(rid.GetPageId());
   // If the page could not be found, then abort the transaction.
-  if (page == nullptr) {
+  if (!guard.IsValid()) {
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
   // Read the tuple from the page.
-  if (acquire_read_lock) {
-    page->RLatch();
-  }
-  bool res = page->GetTuple(rid, tuple, txn, lock_manager_);
-  if (acquire_read_lock) {
-    page->RUnlatch();
+  if (!acquire_read_lock) {
+    return guard.As<TablePage>()->GetTuple(rid, tuple, txn, lock_manager_);
   }
-  buffer_pool_manager_->UnpinPage(rid.GetPageId(), false);
-  return res;
+  auto read_guard = guard.UpgradeRead();
+  return read_guard.As<TablePage>()->GetTuple(rid, tuple, txn, lock_manager_);
 }
 
 auto TableHeap::Begin(Transaction *txn) -> TableIterator {
@@ -182,13 +250,11 @@ auto TableHeap::Begin(Transaction *txn) -> TableIterator {
   RID rid;
   auto page_id = first_page_id_;
   while (page_id != INVALID_PAGE_ID) {
-    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
-    page->RLatch();
+    auto guard = buffer_pool_manager_->FetchPageRead(page_id);
+    BUSTUB_ENSURE(guard.IsValid(), "BPM full");
+    auto page = guard.As<TablePage>();
     // If this fails because there is no tuple, then RID will be the default-constructed value, which means EOF.
-    auto found_tuple = page->GetFirstTupleRid(&rid);
-    page->RUnlatch();
-    buffer_pool_manager_->UnpinPage(page_id, false);
-    if (found_tuple) {
+    if (page->GetFirstTupleRid(&rid)) {
       break;
     }
     page_id = page->GetNextPageId();
@@ -196,6 +262,37 @@ auto TableHeap::Begin(Transaction *txn) -> TableIterator {
   return {this, rid, txn};
 }
 
+void TableHeap::NextTuple(Tuple *tuple) {
+  auto guard = buffer_pool_manager_->FetchPageRead(tuple->rid_.GetPageId());
+  BUSTUB_ENSURE(guard.IsValid(), "BPM full");  // all pages are pinned
+
+  auto cur_page = guard.As<TablePage>();
+  RID next_tuple_rid;
+  if (!cur_page->GetNextTupleRid(tuple->rid_,
+                                 &next_tuple_rid)) {  // end of this page
+    while (cur_page->GetNextPageId() != INVALID_PAGE_ID) {
+      // Latch the next page before letting go of the current one.
+      auto next_guard = buffer_pool_manager_->FetchPageRead(cur_page->GetNextPageId());
+      guard = std::move(next_guard);
+      cur_page = guard.As<TablePage>();
+      if (cur_page->GetFirstTupleRid(&next_tuple_rid)) {
+        break;
+      }
+    }
+  }
+  tuple->rid_ = next_tuple_rid;
+
+  if (next_tuple_rid.GetPageId() != INVALID_PAGE_ID) {
+    // Read the tuple from the page we already hold rather than fetching and latching it again. The view is copied
+    // into the buffer of the current tuple, so stepping through a table does not allocate per row.
+    Tuple view;
+    if (!cur_page->GetTupleView(tuple->rid_, &view)) {
+      throw bustub::Exception("read non-existing tuple");
+    }
+    *tuple = view;
+  }
+}
+
 auto TableHeap::End() -> TableIterator { return {this, RID(INVALID_PAGE_ID, 0), nullptr}; }
 
 }  // namespace bustub
@@ -0,0 +1,69 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tmp_tuple_file.cpp
+//
+// Identification: src/storage/table/tmp_tuple_file.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/tmp_tuple_file.h"
+
+#include <utility>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+TmpTupleFile::~TmpTupleFile() {
+  write_guard_.Drop();
+  for (auto page_id : page_ids_) {
+    bpm_->DeletePage(page_id);
+  }
+}
+
+void TmpTupleFile::Append(const Tuple &tuple) {
+  TmpTuple tmp_tuple(INVALID_PAGE_ID, 0);
+  if (!write_guard_.IsValid() || !write_guard_.AsMut<TmpTuplePage>()->Insert(tuple, &tmp_tuple)) {
+    page_id_t page_id;
+    auto guard = bpm_->NewPageGuarded(&page_id);
+    if (!guard.IsValid()) {
+      throw ExecutionException("no free page in the buffer pool to spill to");
+    }
+    page_ids_.push_back(page_id);
+    write_guard_ = std::move(guard);
+    auto page = write_guard_.AsMut<TmpTuplePage>();
+    page->Init(page_id, BUSTUB_PAGE_SIZE);
+    if (!page->Insert(tuple, &tmp_tuple)) {
+      throw ExecutionException("tuple too large to spill");
+    }
+  }
+  tuple_count_++;
+  size_ += sizeof(uint32_t) + tuple.GetLength();
+}
+
+auto TmpTupleFile::Reader::Next(Tuple *tuple) -> bool {
+  while (tuples_.empty()) {
+    if (page_idx_ == file_->page_ids_.size()) {
+      return false;
+    }
+    auto guard = file_->bpm_->FetchPageRead(file_->page_ids_[page_idx_++]);
+    if (!guard.IsValid()) {
+      throw ExecutionException("no free page in the buffer pool to read spilled tuples");
+    }
+    auto page = guard.As<TmpTuplePage>();
+    // The page is read from the tuple inserted last towards the first one.
+    for (size_t offset = page->GetFreeSpacePointer(); offset < BUSTUB_PAGE_SIZE;
+         offset = page->GetPrevTupleOffset(offset)) {
+      page->Get(offset, &tuples_.emplace_back());
+    }
+  }
+  *tuple = std::move(tuples_.back());
+  tuples_.pop_back();
+  return true;
+}
+
+}  // namespace bustub
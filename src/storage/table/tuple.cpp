@@ -36,6 +36,7 @@ Tuple::Tuple(std::vector<Value> values, const Schema *schema) : allocated_(true)
 
   // 2. Allocate memory.
   size_ = tuple_size;
+  capacity_ = tuple_size;
   data_ = new char[size_];
   std::memset(data_, 0, size_);
 
@@ -61,38 +62,88 @@ Tuple::Tuple(std::vector<Value> values, const Schema *schema) : allocated_(true)
   }
 }
 
-Tuple::Tuple(const Tuple &other) : allocated_(other.allocated_), rid_(other.rid_), size_(other.size_) {
-  if (allocated_) {
-    delete[] data_;
+Tuple::Tuple(const Tuple &other) : rid_(other.rid_) {
+  if (other.data_ != nullptr) {
+    // Deep copy, also of borrowed data, which is only valid as long as its page is latched.
+    CopyData(other.data_, other.size_);
   }
-  if (allocated_) {
-    // Deep copy.
-    data_ = new char[size_];
-    memcpy(data_, other.data_, size_);
+}
+
+Tuple::Tuple(Tuple &&other) noexcept
+    : allocated_(other.allocated_),
+      rid_(other.rid_),
+      size_(other.size_),
+      capacity_(other.capacity_),
+      data_(other.data_) {
+  other.allocated_ = false;
+  other.size_ = 0;
+  other.capacity_ = 0;
+  other.data_ = nullptr;
+}
+
+auto Tuple::operator=(const Tuple &other) -> Tuple & {
+  if (this == &other) {
+    return *this;
+  }
+  rid_ = other.rid_;
+  if (other.data_ != nullptr) {
+    CopyData(other.data_, other.size_);
   } else {
-    // Shallow copy.
-    data_ = other.data_;
+    if (allocated_) {
+      delete[] data_;
+    }
+    allocated_ = false;
+    size_ = 0;
+    capacity_ = 0;
+    data_ = nullptr;
   }
+  return *this;
 }
 
-auto Tuple::operator=(const Tuple &other) -> Tuple & {
+auto Tuple::operator=(Tuple &&other) noexcept -> Tuple & {
+  if (this == &other) {
+    return *this;
+  }
   if (allocated_) {
     delete[] data_;
   }
   allocated_ = other.allocated_;
   rid_ = other.rid_;
   size_ = other.size_;
+  capacity_ = other.capacity_;
+  data_ = other.data_;
+  other.allocated_ = false;
+  other.size_ = 0;
+  other.capacity_ = 0;
+  other.data_ = nullptr;
+  return *this;
+}
 
-  if (allocated_) {
-    // Deep copy.
-    data_ = new char[size_];
-    memcpy(data_, other.data_, size_);
-  } else {
-    // Shallow copy.
-    data_ = other.data_;
+void Tuple::CopyData(const char *data, uint32_t size) {
+  Reserve(size);
+  memcpy(data_, data, size);
+}
+
+void Tuple::Reserve(uint32_t size) {
+  if (!allocated_ || capacity_ < size) {
+    if (allocated_) {
+      delete[] data_;
+    }
+    data_ = new char[size];
+    capacity_ = size;
+    allocated_ = true;
   }
+  size_ = size;
+}
 
-  return *this;
+void Tuple::Borrow(char *data, uint32_t size) {
+  if (allocated_) {
+    delete[] data_;
+  }
+  allocated_ = false;
+  capacity_ = 0;
+  data_ = data;
+  size_ = size;
 }
 
 auto Tuple::GetValue(const Schema *schema, const uint32_t column_idx) const -> Value {
@@ -104,7 +155,7 @@ auto Tuple::GetValue(const Schema *schema, const uint32_t column_idx) const -> V
   return Value::DeserializeFrom(data_ptr, column_type);
 }
 
-auto Tuple::KeyFromTuple(const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs)
+auto Tuple::KeyFromTuple(const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs) const
     -> Tuple {
   std::vector<Value> values;
   values.reserve(key_attrs.size());
@@ -162,13 +213,7 @@ void Tuple::SerializeTo(char *storage) const {
 void Tuple::DeserializeFrom(const char *storage) {
   uint32_t size = *reinterpret_cast<const uint32_t *>(storage);
   // Construct a tuple.
-  this->size_ = size;
-  if (this->allocated_) {
-    delete[] this->data_;
-  }
-  this->data_ = new char[this->size_];
-  memcpy(this->data_, storage + sizeof(int32_t), this->size_);
-  this->allocated_ = true;
+  CopyData(storage + sizeof(int32_t), size);
 }
 
 }  // namespace bustub
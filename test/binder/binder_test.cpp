@@ -13,6 +13,7 @@
 #include "binder/binder.h"
 #include <memory>
 #include "binder/bound_statement.h"
+#include "binder/statement/create_statement.h"
 #include "catalog/catalog.h"
 #include "gtest/gtest.h"
 
@@ -143,6 +144,15 @@ TEST(BinderTest, FailBindUnknownColumn) {
 
 TEST(BinderTest, BindCreateTable) { TryBind("CREATE TABLE tablex (v1 int)"); }
 
+TEST(BinderTest, BindCreateTableWithFormat) {
+  auto statements = TryBind("CREATE TABLE tablex (v1 int) WITH (format = pax)");
+  ASSERT_EQ(dynamic_cast<const CreateStatement &>(*statements[0]).format_, "pax");
+  statements = TryBind("CREATE TABLE tablex (v1 int) WITH (format = 'ROW')");
+  ASSERT_EQ(dynamic_cast<const CreateStatement &>(*statements[0]).format_, "row");
+  EXPECT_THROW(TryBind("CREATE TABLE tablex (v1 int) WITH (format = parquet)"), Exception);
+  EXPECT_THROW(TryBind("CREATE TABLE tablex (v1 int) WITH (fillfactor = 70)"), Exception);
+}
+
 TEST(BinderTest, BindInsert) { TryBind("INSERT INTO y VALUES (1,2,3,4,5), (6,7,8,9,10)"); }
 
 TEST(BinderTest, BindInsertSelect) { TryBind("INSERT INTO y SELECT * FROM y WHERE x < 500"); }
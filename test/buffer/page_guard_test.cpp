@@ -0,0 +1,112 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_guard_test.cpp
+//
+// Identification: test/buffer/page_guard_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/page/page_guard.h"
+#include "storage/page/table_page.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(PageGuardTest, BasicGuardTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(5, disk_manager.get());
+
+  page_id_t page_id;
+  auto *page = bpm->NewPage(&page_id);
+  {
+    auto guard = bpm->FetchPageBasic(page_id);
+    ASSERT_TRUE(guard.IsValid());
+    EXPECT_EQ(guard.PageId(), page_id);
+    EXPECT_EQ(page->GetPinCount(), 2);
+
+    // Moving hands the pin over; the moved-from guard releases nothing.
+    auto moved = std::move(guard);
+    EXPECT_FALSE(guard.IsValid());  // NOLINT(bugprone-use-after-move)
+    EXPECT_EQ(page->GetPinCount(), 2);
+    strcpy(moved.GetDataMut(), "Hello");  // NOLINT
+  }
+  EXPECT_EQ(page->GetPinCount(), 1);
+  EXPECT_TRUE(page->IsDirty());
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  EXPECT_EQ(page->GetPinCount(), 0);
+
+  // Filling the pool evicts the page; the guard marked it dirty, so the data survives.
+  std::vector<BasicPageGuard> guards;
+  for (int i = 0; i < 5; i++) {
+    page_id_t other_id;
+    guards.push_back(bpm->NewPageGuarded(&other_id));
+    ASSERT_TRUE(guards.back().IsValid());
+  }
+  // An empty guard is returned when the pool has no free frame, and dropping it is a no-op.
+  EXPECT_FALSE(bpm->FetchPageRead(page_id).IsValid());
+  guards.clear();
+  auto guard = bpm->FetchPageRead(page_id);
+  ASSERT_TRUE(guard.IsValid());
+  EXPECT_STREQ(guard.GetData(), "Hello");
+  guard.Drop();
+  EXPECT_FALSE(guard.IsValid());
+  guard.Drop();
+}
+
+// NOLINTNEXTLINE
+TEST(PageGuardTest, LatchGuardTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(5, disk_manager.get());
+
+  page_id_t page_id;
+  {
+    auto guard = bpm->NewPageGuarded(&page_id);
+    auto write_guard = guard.UpgradeWrite();
+    EXPECT_FALSE(guard.IsValid());  // NOLINT(bugprone-use-after-move)
+    auto table_page = write_guard.AsMut<TablePage>();
+    table_page->Init(page_id, BUSTUB_PAGE_SIZE, INVALID_PAGE_ID, nullptr, nullptr);
+    EXPECT_EQ(table_page->GetTablePageId(), page_id);
+  }
+  auto *page = bpm->FetchPage(page_id);
+  EXPECT_EQ(page->GetPinCount(), 1);
+  EXPECT_TRUE(page->IsDirty());
+
+  {
+    // Any number of readers may hold the page at once.
+    auto reader1 = bpm->FetchPageRead(page_id);
+    auto reader2 = bpm->FetchPageRead(page_id);
+    EXPECT_EQ(page->GetPinCount(), 3);
+    EXPECT_EQ(reader1.As<TablePage>()->GetNextPageId(), INVALID_PAGE_ID);
+
+    // Downgrading keeps the pin but lets go of the latch.
+    auto basic = reader1.Downgrade();
+    EXPECT_FALSE(reader1.IsValid());  // NOLINT(bugprone-use-after-move)
+    EXPECT_EQ(page->GetPinCount(), 3);
+    reader2.Drop();
+    auto writer = basic.UpgradeWrite();
+    EXPECT_EQ(page->GetPinCount(), 2);
+
+    // Move-assigning releases the latch and pin held by the target.
+    page_id_t other_id;
+    auto other = bpm->NewPageGuarded(&other_id);
+    writer = other.UpgradeWrite();
+    EXPECT_EQ(page->GetPinCount(), 1);
+    EXPECT_EQ(writer.PageId(), other_id);
+  }
+  EXPECT_EQ(page->GetPinCount(), 1);
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+}
+
+}  // namespace bustub
@@ -0,0 +1,205 @@
+/**
+ * adaptive_radix_tree_test.cpp
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/rid.h"
+#include "container/art/adaptive_radix_tree.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// Fixed-length keys are prefix-free. The first prefix_len bytes are shared by every key, the last four hold i
+// big-endian so that byte order is numeric order.
+static auto MakeArtKey(uint32_t i, size_t prefix_len = 0) -> std::vector<uint8_t> {
+  std::vector<uint8_t> key(prefix_len, 0xAB);
+  for (int shift = 24; shift >= 0; shift -= 8) {
+    key.push_back(static_cast<uint8_t>(i >> shift));
+  }
+  return key;
+}
+
+TEST(AdaptiveRadixTreeTest, InsertGetRemove) {
+  // Long shared prefixes exercise the optimistic prefix check beyond the stored bytes.
+  for (size_t prefix_len : {0, 3, 20}) {
+    AdaptiveRadixTree<RID> tree;
+    std::vector<uint32_t> keys;
+    // Sparse and dense key ranges make nodes grow through every layout.
+    for (uint32_t i = 0; i < 2000; i++) {
+      keys.push_back(i);
+      keys.push_back(i * 7919 + 100000);
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+
+    for (auto key : keys) {
+      ASSERT_TRUE(tree.Insert(MakeArtKey(key, prefix_len), RID(0, key)));
+    }
+    ASSERT_FALSE(tree.Insert(MakeArtKey(keys[0], prefix_len), RID(0, 0)));
+
+    RID rid;
+    for (auto key : keys) {
+      ASSERT_TRUE(tree.GetValue(MakeArtKey(key, prefix_len), &rid));
+      ASSERT_EQ(rid.GetSlotNum(), key);
+    }
+    ASSERT_FALSE(tree.GetValue(MakeArtKey(99999, prefix_len), &rid));
+
+    // Removing most keys shrinks nodes and collapses paths again.
+    for (auto key : keys) {
+      if (key % 5 != 0) {
+        ASSERT_TRUE(tree.Remove(MakeArtKey(key, prefix_len)));
+      }
+    }
+    ASSERT_FALSE(tree.Remove(MakeArtKey(1, prefix_len)));
+    for (auto key : keys) {
+      ASSERT_EQ(tree.GetValue(MakeArtKey(key, prefix_len), &rid), key % 5 == 0);
+    }
+    for (auto key : keys) {
+      if (key % 5 != 0) {
+        ASSERT_TRUE(tree.Insert(MakeArtKey(key, prefix_len), RID(0, key)));
+      }
+    }
+    for (auto key : keys) {
+      ASSERT_TRUE(tree.GetValue(MakeArtKey(key, prefix_len), &rid));
+    }
+  }
+}
+
+TEST(AdaptiveRadixTreeTest, Scan) {
+  for (size_t prefix_len : {0, 12}) {
+    AdaptiveRadixTree<RID> tree;
+    std::vector<uint32_t> keys;
+    for (uint32_t i = 0; i < 3000; i++) {
+      keys.push_back(i * 3);
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+    for (auto key : keys) {
+      ASSERT_TRUE(tree.Insert(MakeArtKey(key, prefix_len), RID(0, key)));
+    }
+
+    std::vector<RID> result;
+    tree.Scan(MakeArtKey(0, prefix_len), 10000, &result);
+    ASSERT_EQ(result.size(), keys.size());
+    for (size_t i = 0; i < result.size(); i++) {
+      ASSERT_EQ(result[i].GetSlotNum(), i * 3);
+    }
+
+    // The low key does not need to be present.
+    for (uint32_t low : {1, 299, 300, 4000, 8995}) {
+      tree.Scan(MakeArtKey(low, prefix_len), 5, &result);
+      uint32_t expected = (low + 2) / 3 * 3;
+      for (auto &rid : result) {
+        ASSERT_EQ(rid.GetSlotNum(), expected);
+        expected += 3;
+      }
+      ASSERT_EQ(result.size(), std::min<size_t>(5, (8997 - (low + 2) / 3 * 3) / 3 + 1));
+    }
+    tree.Scan(MakeArtKey(9000, prefix_len), 5, &result);
+    ASSERT_TRUE(result.empty());
+  }
+}
+
+TEST(AdaptiveRadixTreeTest, ConcurrentInsertRemoveAndRead) {
+  AdaptiveRadixTree<RID> tree;
+  const uint32_t stable_keys = 5000;
+  const int num_writers = 4;
+  const uint32_t keys_per_writer = 5000;
+  for (uint32_t key = 0; key < stable_keys; key++) {
+    ASSERT_TRUE(tree.Insert(MakeArtKey(key * 2, 10), RID(0, key * 2)));
+  }
+
+  // Writers insert and remove the odd keys between the stable ones; readers must see every stable key throughout.
+  std::vector<std::thread> threads;
+  std::atomic<int> missed{0};
+  for (int i = 0; i < num_writers; i++) {
+    threads.emplace_back([&tree, i]() {
+      for (uint32_t n = 0; n < keys_per_writer; n++) {
+        uint32_t key = (n * num_writers + i) * 2 + 1;
+        tree.Insert(MakeArtKey(key, 10), RID(0, key));
+      }
+      for (uint32_t n = 0; n < keys_per_writer; n += 2) {
+        uint32_t key = (n * num_writers + i) * 2 + 1;
+        tree.Remove(MakeArtKey(key, 10));
+      }
+    });
+  }
+  for (int i = 0; i < 2; i++) {
+    threads.emplace_back([&tree, &missed]() {
+      RID rid;
+      std::vector<RID> result;
+      for (uint32_t key = 0; key < stable_keys; key++) {
+        if (!tree.GetValue(MakeArtKey(key * 2, 10), &rid) || rid.GetSlotNum() != key * 2) {
+          missed++;
+        }
+        if (key % 100 == 0) {
+          tree.Scan(MakeArtKey(key * 2, 10), 1, &result);
+          if (result.size() != 1 || result[0].GetSlotNum() != key * 2) {
+            missed++;
+          }
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(missed.load(), 0);
+
+  RID rid;
+  for (int i = 0; i < num_writers; i++) {
+    for (uint32_t n = 0; n < keys_per_writer; n++) {
+      uint32_t key = (n * num_writers + i) * 2 + 1;
+      ASSERT_EQ(tree.GetValue(MakeArtKey(key, 10), &rid), n % 2 == 1);
+    }
+  }
+}
+
+TEST(AdaptiveRadixTreeTest, ChurnReclaimsRetiredMemory) {
+  AdaptiveRadixTree<RID> tree;
+  const size_t bound = 2 * AdaptiveRadixTree<RID>::ART_RECLAIM_THRESHOLD;
+  const int num_threads = 4;
+  const uint32_t keys_per_thread = 500;
+
+  // Every round grows nodes through all layouts and shrinks them again, retiring thousands of nodes and leaves.
+  for (int round = 0; round < 20; round++) {
+    for (uint32_t key = 0; key < 2000; key++) {
+      ASSERT_TRUE(tree.Insert(MakeArtKey(key * 13, 3), RID(0, key)));
+    }
+    for (uint32_t key = 0; key < 2000; key++) {
+      ASSERT_TRUE(tree.Remove(MakeArtKey(key * 13, 3)));
+    }
+    ASSERT_LT(tree.GetNumRetired(), bound);
+  }
+
+  // Concurrent churn with readers on the same keys; once the threads are done, the next writes free what they left.
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; i++) {
+    threads.emplace_back([&tree, i]() {
+      RID rid;
+      for (int round = 0; round < 10; round++) {
+        for (uint32_t n = 0; n < keys_per_thread; n++) {
+          uint32_t key = n * num_threads + i;
+          tree.Insert(MakeArtKey(key, 3), RID(0, key));
+          tree.GetValue(MakeArtKey(key ^ 1, 3), &rid);
+        }
+        for (uint32_t n = 0; n < keys_per_thread; n++) {
+          tree.Remove(MakeArtKey(n * num_threads + i, 3));
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (uint32_t key = 0; key < 2000; key++) {
+    ASSERT_TRUE(tree.Insert(MakeArtKey(key, 3), RID(0, key)));
+    ASSERT_TRUE(tree.Remove(MakeArtKey(key, 3)));
+  }
+  ASSERT_LT(tree.GetNumRetired(), bound);
+}
+
+}  // namespace bustub
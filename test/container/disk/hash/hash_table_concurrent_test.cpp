@@ -0,0 +1,125 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_concurrent_test.cpp
+//
+// Identification: test/container/disk/hash/hash_table_concurrent_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <memory>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "container/disk/hash/disk_extendible_hash_table.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+using IntHashTable = DiskExtendibleHashTable<int, int, IntComparator>;
+
+template <typename F>
+static void LaunchParallel(int num_threads, F &&f) {
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; i++) {
+    threads.emplace_back(f, i);
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+// Keys spread over a few directories, each of which splits its buckets many times, inserted concurrently through a
+// buffer pool smaller than the table.
+TEST(HashTableConcurrentTest, InsertLookupRemove) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(64, disk_manager.get());
+  IntHashTable ht("blah", bpm.get(), IntComparator(), HashFunction<int>(), 2);
+  const int num_threads = 4;
+  const int keys_per_thread = 8000;
+
+  std::atomic<int> failures{0};
+  LaunchParallel(num_threads, [&](int tid) {
+    for (int i = 0; i < keys_per_thread; i++) {
+      int key = i * num_threads + tid;
+      if (!ht.Insert(nullptr, key, key)) {
+        failures++;
+      }
+    }
+  });
+  ASSERT_EQ(failures.load(), 0);
+  ht.VerifyIntegrity();
+
+  // Readers run alongside writers that remove the odd keys.
+  LaunchParallel(num_threads * 2, [&](int tid) {
+    std::vector<int> res;
+    if (tid < num_threads) {
+      for (int i = 1; i < keys_per_thread; i += 2) {
+        int key = i * num_threads + tid;
+        if (!ht.Remove(nullptr, key, key)) {
+          failures++;
+        }
+      }
+      return;
+    }
+    for (int i = 0; i < keys_per_thread; i += 2) {
+      int key = i * num_threads + tid - num_threads;
+      res.clear();
+      if (!ht.GetValue(nullptr, key, &res) || res.size() != 1 || res[0] != key) {
+        failures++;
+      }
+    }
+  });
+  ASSERT_EQ(failures.load(), 0);
+  ht.VerifyIntegrity();
+
+  for (int key = 0; key < num_threads * keys_per_thread; key++) {
+    std::vector<int> res;
+    ASSERT_EQ(ht.GetValue(nullptr, key, &res), (key / num_threads) % 2 == 0);
+  }
+}
+
+TEST(HashTableConcurrentTest, DISABLED_MultithreadedBenchmark) {  // NOLINT
+  const int total_keys = 1000000;
+  for (int num_threads : {1, 2, 4, 8}) {
+    auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+    // The table takes a few thousand pages.
+    auto bpm = std::make_unique<BufferPoolManagerInstance>(512, disk_manager.get());
+    IntHashTable ht("blah", bpm.get(), IntComparator(), HashFunction<int>());
+    const int keys_per_thread = total_keys / num_threads;
+
+    auto start = std::chrono::steady_clock::now();
+    LaunchParallel(num_threads, [&](int tid) {
+      for (int i = 0; i < keys_per_thread; i++) {
+        ht.Insert(nullptr, i * num_threads + tid, i);
+      }
+    });
+    auto insert_done = std::chrono::steady_clock::now();
+    LaunchParallel(num_threads, [&](int tid) {
+      std::vector<int> res;
+      for (int i = 0; i < keys_per_thread; i++) {
+        res.clear();
+        ht.GetValue(nullptr, i * num_threads + tid, &res);
+      }
+    });
+    auto lookup_done = std::chrono::steady_clock::now();
+
+    auto insert_ms = std::chrono::duration_cast<std::chrono::milliseconds>(insert_done - start).count();
+    auto lookup_ms = std::chrono::duration_cast<std::chrono::milliseconds>(lookup_done - insert_done).count();
+    std::cout << "<<< BEGIN" << std::endl;
+    std::cout << num_threads << " threads, " << total_keys << " keys, 512 frames" << std::endl;
+    std::cout << "Insert Time: " << insert_ms << " ms" << std::endl;
+    std::cout << "Lookup Time: " << lookup_ms << " ms" << std::endl;
+    std::cout << ">>> END" << std::endl;
+  }
+}
+
+}  // namespace bustub
@@ -10,6 +10,9 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <memory>
 #include <thread>  // NOLINT
 #include <vector>
 
@@ -17,13 +20,16 @@
 #include "common/logger.h"
 #include "gtest/gtest.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/index/generic_key.h"
 #include "storage/page/hash_table_bucket_page.h"
 #include "storage/page/hash_table_directory_page.h"
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
 
 namespace bustub {
 
 // NOLINTNEXTLINE
-TEST(HashTablePageTest, DISABLED_DirectoryPageSampleTest) {
+TEST(HashTablePageTest, DirectoryPageSampleTest) {
   auto *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManagerInstance(5, disk_manager);
 
@@ -57,7 +63,7 @@ TEST(HashTablePageTest, DISABLED_DirectoryPageSampleTest) {
 }
 
 // NOLINTNEXTLINE
-TEST(HashTablePageTest, DISABLED_BucketPageSampleTest) {
+TEST(HashTablePageTest, BucketPageSampleTest) {
   auto *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManagerInstance(5, disk_manager);
 
@@ -114,4 +120,93 @@ TEST(HashTablePageTest, DISABLED_BucketPageSampleTest) {
   delete bpm;
 }
 
+using GenericBucketPage = HashTableBucketPage<GenericKey<8>, RID, GenericComparator<8>>;
+
+static auto MakeGenericKeys(const Schema *schema, int64_t count) -> std::vector<GenericKey<8>> {
+  std::vector<GenericKey<8>> keys(count);
+  for (int64_t i = 0; i < count; i++) {
+    keys[i].SetFromKey(Tuple({ValueFactory::GetBigIntValue(i * 7919)}, schema));
+  }
+  return keys;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTablePageTest, FullBucketPageTest) {
+  auto schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> cmp(schema.get());
+  auto data = std::make_unique<char[]>(BUSTUB_PAGE_SIZE);
+  auto *bucket_page = reinterpret_cast<GenericBucketPage *>(data.get());
+  auto keys = MakeGenericKeys(schema.get(), GenericBucketPage::ARRAY_SIZE);
+
+  for (uint32_t i = 0; i < GenericBucketPage::ARRAY_SIZE; i++) {
+    ASSERT_TRUE(bucket_page->Insert(keys[i], RID(0, i), cmp));
+  }
+  EXPECT_TRUE(bucket_page->IsFull());
+  EXPECT_FALSE(bucket_page->Insert(keys[0], RID(0, 1), cmp));
+
+  // Duplicate keys with different values are allowed; removed slots are reused.
+  ASSERT_TRUE(bucket_page->Remove(keys[3], RID(0, 3), cmp));
+  ASSERT_TRUE(
+      bucket_page->Remove(keys[GenericBucketPage::ARRAY_SIZE - 1], RID(0, GenericBucketPage::ARRAY_SIZE - 1), cmp));
+  EXPECT_FALSE(bucket_page->Insert(keys[5], RID(0, 5), cmp));
+  EXPECT_TRUE(bucket_page->Insert(keys[5], RID(1, 5), cmp));
+  EXPECT_EQ(bucket_page->NumReadable(), GenericBucketPage::ARRAY_SIZE - 1);
+
+  for (uint32_t i = 0; i < GenericBucketPage::ARRAY_SIZE; i++) {
+    std::vector<RID> result;
+    bool found = bucket_page->GetValue(keys[i], cmp, &result);
+    if (i == 3 || i == GenericBucketPage::ARRAY_SIZE - 1) {
+      EXPECT_FALSE(found);
+      continue;
+    }
+    ASSERT_TRUE(found);
+    ASSERT_EQ(result.size(), i == 5 ? 2 : 1);
+    EXPECT_EQ(result[0].GetSlotNum(), i);
+  }
+
+  for (uint32_t i = 0; i < GenericBucketPage::ARRAY_SIZE; i++) {
+    bucket_page->Remove(keys[i], RID(0, i), cmp);
+  }
+  ASSERT_TRUE(bucket_page->Remove(keys[5], RID(1, 5), cmp));
+  EXPECT_TRUE(bucket_page->IsEmpty());
+}
+
+TEST(HashTablePageTest, DISABLED_FullBucketProbeBenchmark) {  // NOLINT
+  const int rounds = 200;
+  auto schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> cmp(schema.get());
+  auto data = std::make_unique<char[]>(BUSTUB_PAGE_SIZE);
+  auto *bucket_page = reinterpret_cast<GenericBucketPage *>(data.get());
+  auto keys = MakeGenericKeys(schema.get(), GenericBucketPage::ARRAY_SIZE);
+  for (uint32_t i = 0; i < GenericBucketPage::ARRAY_SIZE; i++) {
+    bucket_page->Insert(keys[i], RID(0, i), cmp);
+  }
+
+  std::vector<RID> result;
+  auto start = std::chrono::steady_clock::now();
+  for (int round = 0; round < rounds; round++) {
+    for (uint32_t i = 0; i < GenericBucketPage::ARRAY_SIZE; i++) {
+      result.clear();
+      bucket_page->GetValue(keys[i], cmp, &result);
+    }
+  }
+  auto lookup_done = std::chrono::steady_clock::now();
+  // Every insert checks the whole bucket for a duplicate pair before taking the freed slot.
+  for (int round = 0; round < rounds; round++) {
+    for (uint32_t i = 0; i < GenericBucketPage::ARRAY_SIZE; i++) {
+      bucket_page->RemoveAt(i);
+      bucket_page->Insert(keys[i], RID(0, i), cmp);
+    }
+  }
+  auto insert_done = std::chrono::steady_clock::now();
+
+  auto lookup_ms = std::chrono::duration_cast<std::chrono::milliseconds>(lookup_done - start).count();
+  auto insert_ms = std::chrono::duration_cast<std::chrono::milliseconds>(insert_done - lookup_done).count();
+  std::cout << "<<< BEGIN" << std::endl;
+  std::cout << rounds << " x " << GenericBucketPage::ARRAY_SIZE << " operations on a full bucket" << std::endl;
+  std::cout << "Lookup Time: " << lookup_ms << " ms" << std::endl;
+  std::cout << "Insert Time: " << insert_ms << " ms" << std::endl;
+  std::cout << ">>> END" << std::endl;
+}
+
 }  // namespace bustub
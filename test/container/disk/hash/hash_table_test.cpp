@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <memory>
 #include <thread>  // NOLINT
 #include <vector>
 
@@ -18,13 +19,14 @@
 #include "container/disk/hash/disk_extendible_hash_table.h"
 #include "gtest/gtest.h"
 #include "murmur3/MurmurHash3.h"
+#include "storage/disk/disk_manager_memory.h"
 
 namespace bustub {
 
 // NOLINTNEXTLINE
 
 // NOLINTNEXTLINE
-TEST(HashTableTest, DISABLED_SampleTest) {
+TEST(HashTableTest, SampleTest) {
   auto *disk_manager = new DiskManager("test.db");
   auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
   DiskExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
@@ -117,4 +119,78 @@ TEST(HashTableTest, DISABLED_SampleTest) {
   delete bpm;
 }
 
+// NOLINTNEXTLINE
+TEST(HashTableTest, SplitGrowShrinkTest) {
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  // A single directory page, so that every key lands in the same directory.
+  DiskExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>(), 0);
+
+  // Enough keys to split buckets and grow the directory several times.
+  const int num_keys = 20000;
+  for (int i = 0; i < num_keys; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+  }
+  EXPECT_GT(ht.GetGlobalDepth(), 4);
+  ht.VerifyIntegrity();
+
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    ASSERT_EQ(1, res.size());
+    EXPECT_EQ(i, res[0]);
+  }
+
+  // Emptying buckets merges them into their split images and shrinks the directory again.
+  for (int i = 0; i < num_keys; i++) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+  }
+  ht.VerifyIntegrity();
+  EXPECT_LT(ht.GetGlobalDepth(), 4);
+  for (int i = 0; i < num_keys; i += 97) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ(0, res.size());
+  }
+
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, BufferPoolFullTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(4, disk_manager.get());
+  DiskExtendibleHashTable<int, int, IntComparator> ht("blah", bpm.get(), IntComparator(), HashFunction<int>());
+  ASSERT_TRUE(ht.Insert(nullptr, 1, 1));
+
+  std::vector<page_id_t> pinned(4);
+  for (auto &page_id : pinned) {
+    ASSERT_NE(bpm->NewPage(&page_id), nullptr);
+  }
+  std::vector<int> res;
+  EXPECT_THROW(ht.Insert(nullptr, 2, 2), Exception);
+  EXPECT_THROW(ht.GetValue(nullptr, 1, &res), Exception);
+  EXPECT_THROW(ht.Remove(nullptr, 1, 1), Exception);
+  // With a single free frame, the directory is fetched but its bucket is not; the directory must be let go.
+  bpm->UnpinPage(pinned.back(), false);
+  pinned.pop_back();
+  EXPECT_THROW(ht.GetValue(nullptr, 1, &res), Exception);
+
+  for (auto page_id : pinned) {
+    bpm->UnpinPage(page_id, false);
+  }
+  ASSERT_TRUE(ht.GetValue(nullptr, 1, &res));
+  ASSERT_TRUE(ht.Insert(nullptr, 2, 2));
+  ASSERT_TRUE(ht.Remove(nullptr, 1, 1));
+  // No page of the table stays pinned.
+  pinned.resize(4);
+  for (auto &page_id : pinned) {
+    ASSERT_NE(bpm->NewPage(&page_id), nullptr);
+  }
+  for (auto page_id : pinned) {
+    bpm->UnpinPage(page_id, false);
+  }
+}
+
 }  // namespace bustub
@@ -0,0 +1,157 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// robin_hood_hash_table_test.cpp
+//
+// Identification: test/container/disk/hash/robin_hood_hash_table_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "container/disk/hash/robin_hood_hash_table.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+using IntRobinHoodHashTable = RobinHoodHashTable<int, int, IntComparator>;
+
+// NOLINTNEXTLINE
+TEST(RobinHoodHashTableTest, SampleTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(50, disk_manager.get());
+  IntRobinHoodHashTable ht("blah", bpm.get(), IntComparator(), 10, HashFunction<int>());
+  size_t initial_size = ht.GetSize();
+
+  const int num_keys = 5000;
+  for (int i = 0; i < num_keys; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+    if (i % 7 == 0) {
+      EXPECT_TRUE(ht.Insert(nullptr, i, 2 * i + 1));
+    }
+    EXPECT_FALSE(ht.Insert(nullptr, i, i));
+  }
+  EXPECT_GE(ht.GetSize(), initial_size * 8);
+
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    ASSERT_TRUE(ht.GetValue(nullptr, i, &res));
+    std::sort(res.begin(), res.end());
+    ASSERT_EQ(res.size(), i % 7 == 0 ? 2 : 1);
+    EXPECT_EQ(i, res[0]);
+  }
+
+  for (int i = 0; i < num_keys; i += 2) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+    EXPECT_FALSE(ht.Remove(nullptr, i, i));
+  }
+  for (int i = 0; i < num_keys; i++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ(res.size(), (i % 2 == 0 ? 0 : 1) + (i % 7 == 0 ? 1 : 0));
+  }
+}
+
+// Backward-shift deletion leaves no tombstones: emptying a full table restores every probe distance to zero.
+// NOLINTNEXTLINE
+TEST(RobinHoodHashTableTest, HighLoadRemoveTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(50, disk_manager.get());
+  IntRobinHoodHashTable ht("blah", bpm.get(), IntComparator(), 4000, HashFunction<int>(), 0.95);
+  size_t size = ht.GetSize();
+  auto num_keys = static_cast<int>(size * 0.95);
+
+  std::vector<int> keys;
+  for (int i = 0; i < num_keys; i++) {
+    keys.push_back(i * 7919);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+  for (auto key : keys) {
+    ASSERT_TRUE(ht.Insert(nullptr, key, key));
+  }
+  ASSERT_EQ(ht.GetSize(), size);
+  double average;
+  uint32_t max;
+  ht.GetProbeDistances(&average, &max);
+  EXPECT_GT(max, 0);
+
+  std::vector<int> res;
+  for (int round = 0; round < 2; round++) {
+    for (int i = 0; i < num_keys; i++) {
+      if (i % 2 == round) {
+        ASSERT_TRUE(ht.Remove(nullptr, keys[i], keys[i]));
+      }
+    }
+    for (int i = 0; i < num_keys; i++) {
+      res.clear();
+      ASSERT_EQ(ht.GetValue(nullptr, keys[i], &res), round == 0 && i % 2 == 1);
+    }
+  }
+  ht.GetProbeDistances(&average, &max);
+  EXPECT_EQ(max, 0);
+
+  // The freed slots are reusable right away.
+  for (auto key : keys) {
+    ASSERT_TRUE(ht.Insert(nullptr, key, -key));
+  }
+  ASSERT_EQ(ht.GetSize(), size);
+  for (auto key : keys) {
+    res.clear();
+    ASSERT_TRUE(ht.GetValue(nullptr, key, &res));
+    ASSERT_EQ(res, std::vector<int>{-key});
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(RobinHoodHashTableTest, DISABLED_LoadFactorBenchmark) {
+  const size_t num_buckets = 200000;
+  for (double load : {0.5, 0.6, 0.7, 0.8, 0.9, 0.95}) {
+    auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+    auto bpm = std::make_unique<BufferPoolManagerInstance>(1024, disk_manager.get());
+    IntRobinHoodHashTable ht("blah", bpm.get(), IntComparator(), num_buckets, HashFunction<int>(), 0.96);
+    auto num_keys = static_cast<int>(ht.GetSize() * load);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_keys; i++) {
+      ht.Insert(nullptr, i, i);
+    }
+    auto inserted = std::chrono::steady_clock::now();
+    std::vector<int> res;
+    for (int i = 0; i < num_keys; i++) {
+      res.clear();
+      ht.GetValue(nullptr, i, &res);
+    }
+    auto hits = std::chrono::steady_clock::now();
+    for (int i = num_keys; i < 2 * num_keys; i++) {
+      res.clear();
+      ht.GetValue(nullptr, i, &res);
+    }
+    auto misses = std::chrono::steady_clock::now();
+    double average;
+    uint32_t max;
+    ht.GetProbeDistances(&average, &max);
+
+    auto ms = [](auto from, auto to) {
+      return std::chrono::duration_cast<std::chrono::milliseconds>(to - from).count();
+    };
+    std::cout << "<<< BEGIN" << std::endl;
+    std::cout << num_keys << " keys in " << ht.GetSize() << " slots, load " << load << std::endl;
+    std::cout << "Probe Distance: average " << average << ", max " << max << std::endl;
+    std::cout << "Insert Time: " << ms(start, inserted) << " ms" << std::endl;
+    std::cout << "Hit Lookup Time: " << ms(inserted, hits) << " ms" << std::endl;
+    std::cout << "Miss Lookup Time: " << ms(hits, misses) << " ms" << std::endl;
+    std::cout << ">>> END" << std::endl;
+  }
+}
+
+}  // namespace bustub
@@ -2,15 +2,20 @@
  * extendible_hash_test.cpp
  */
 
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <iostream>
 #include <memory>
+#include <string>
 #include <thread>  // NOLINT
+#include <vector>
 
 #include "container/hash/extendible_hash_table.h"
 #include "gtest/gtest.h"
 
 namespace bustub {
 
-TEST(ExtendibleHashTableTest, DISABLED_SampleTest) {
+TEST(ExtendibleHashTableTest, SampleTest) {
   auto table = std::make_unique<ExtendibleHashTable<int, std::string>>(2);
 
   table->Insert(1, "a");
@@ -42,7 +47,7 @@ TEST(ExtendibleHashTableTest, DISABLED_SampleTest) {
   EXPECT_FALSE(table->Remove(20));
 }
 
-TEST(ExtendibleHashTableTest, DISABLED_ConcurrentInsertTest) {
+TEST(ExtendibleHashTableTest, ConcurrentInsertTest) {
   const int num_runs = 50;
   const int num_threads = 3;
 
@@ -68,4 +73,78 @@ TEST(ExtendibleHashTableTest, DISABLED_ConcurrentInsertTest) {
   }
 }
 
+TEST(ExtendibleHashTableTest, ConcurrentInsertFindRemoveTest) {
+  const int num_threads = 8;
+  const int keys_per_thread = 5000;
+  auto table = std::make_unique<ExtendibleHashTable<int, int>>(4);
+  for (int key = 0; key < keys_per_thread; key++) {
+    table->Insert(-key - 1, key);
+  }
+
+  // Writers split buckets and grow the directory while readers look up keys that must stay visible throughout.
+  std::atomic<int> missed{0};
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([tid, &table, &missed]() {
+      int val;
+      for (int i = 0; i < keys_per_thread; i++) {
+        if (tid % 2 == 0) {
+          table->Insert(i * num_threads + tid, tid);
+        } else if (!table->Find(-i - 1, val) || val != i) {
+          missed++;
+        }
+      }
+      for (int i = 0; i < keys_per_thread; i += 2) {
+        if (tid % 2 == 0 && !table->Remove(i * num_threads + tid)) {
+          missed++;
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(missed.load(), 0);
+
+  int val;
+  for (int tid = 0; tid < num_threads; tid += 2) {
+    for (int i = 0; i < keys_per_thread; i++) {
+      ASSERT_EQ(table->Find(i * num_threads + tid, val), i % 2 == 1);
+    }
+  }
+  for (int dir_index = 0; dir_index < (1 << table->GetGlobalDepth()); dir_index++) {
+    EXPECT_LE(table->GetLocalDepth(dir_index), table->GetGlobalDepth());
+  }
+}
+
+TEST(ExtendibleHashTableTest, DISABLED_ConcurrentFindBenchmark) {
+  const int num_keys = 100000;
+  const int lookups_per_thread = 1000000;
+  auto table = std::make_unique<ExtendibleHashTable<int, int>>(16);
+  for (int key = 0; key < num_keys; key++) {
+    table->Insert(key, key);
+  }
+  for (int num_threads : {1, 2, 4, 8}) {
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (int tid = 0; tid < num_threads; tid++) {
+      threads.emplace_back([tid, &table]() {
+        int val;
+        for (int i = 0; i < lookups_per_thread; i++) {
+          table->Find((i * 7919 + tid) % num_keys, val);
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    auto ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "<<< BEGIN" << std::endl;
+    std::cout << num_threads << " threads x " << lookups_per_thread << " lookups" << std::endl;
+    std::cout << "Time: " << ms << " ms" << std::endl;
+    std::cout << ">>> END" << std::endl;
+  }
+}
+
 }  // namespace bustub
@@ -0,0 +1,52 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_join_executor_test.cpp
+//
+// Identification: test/execution/hash_join_executor_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "common/bustub_instance.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(HashJoinExecutorTest, DISABLED_SpillBenchmark) {
+  // Join a table with itself while the memory budget shrinks from unlimited to a small part of the build side, which
+  // takes about 4MB in memory. The result must not change, and the join must get slower gradually.
+  auto bustub = std::make_unique<BustubInstance>();
+  bustub->GenerateMockTable();
+  auto noop_writer = NoopWriter();
+  bustub->ExecuteSql("create table t1(x int, y int);", noop_writer);
+  bustub->ExecuteSql("insert into t1 select * from __mock_t1_50k;", noop_writer);
+
+  std::string expected;
+  std::cout << "<<< BEGIN" << std::endl;
+  for (size_t budget : {0, 8 << 20, 2 << 20, 1 << 20, 256 << 10, 64 << 10}) {
+    bustub->ExecuteSql("set memory_budget=" + std::to_string(budget), noop_writer);
+    std::stringstream result;
+    auto writer = SimpleStreamWriter(result, true);
+    auto start = std::chrono::steady_clock::now();
+    bustub->ExecuteSql("select count(*), sum(a.y - b.y) from t1 a inner join t1 b on a.x = b.x;", writer);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    if (budget == 0) {
+      expected = result.str();
+    }
+    EXPECT_EQ(result.str(), expected);
+    std::cout << "budget " << budget << " bytes: " << elapsed.count() << " ms" << std::endl;
+  }
+  std::cout << ">>> END" << std::endl;
+}
+
+}  // namespace bustub
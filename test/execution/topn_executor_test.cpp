@@ -0,0 +1,93 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// topn_executor_test.cpp
+//
+// Identification: test/execution/topn_executor_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include "common/bustub_instance.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(TopNExecutorTest, HeapMatchesSortLimit) {
+  // The topn must return the same rows as a full sort followed by a limit, ties included, whether N is smaller than a
+  // batch, larger than a batch, or larger than the input.
+  auto bustub = std::make_unique<BustubInstance>();
+  bustub->GenerateMockTable();
+  auto noop_writer = NoopWriter();
+  bustub->ExecuteSql("create table t1(x int, y int, z varchar(8));", noop_writer);
+  std::mt19937 generator(15445);
+  std::stringstream insert;
+  insert << "insert into t1 values ";
+  for (int i = 0; i < 5000; i++) {
+    insert << (i == 0 ? "" : ", ") << "(" << generator() % 100 << ", " << i << ", '"
+           << std::string(generator() % 4, static_cast<char>('a' + generator() % 3)) << "')";
+  }
+  bustub->ExecuteSql(insert.str() + ";", noop_writer);
+
+  for (size_t n : {0, 1, 10, 1500, 5000, 6000}) {
+    // A limit over a filter over the sort is not turned into a topn; the filter keeps every row.
+    std::stringstream expected;
+    auto expected_writer = SimpleStreamWriter(expected, true);
+    bustub->ExecuteSql(
+        "select * from (select x, y, z from t1 order by x desc, z) where x >= 0 limit " + std::to_string(n) + ";",
+        expected_writer);
+    std::stringstream result;
+    auto writer = SimpleStreamWriter(result, true);
+    bustub->ExecuteSql("select x, y, z from t1 order by x desc, z limit " + std::to_string(n) + ";", writer);
+    EXPECT_EQ(result.str(), expected.str()) << "limit " << n;
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(TopNExecutorTest, DISABLED_TopNBenchmark) {
+  // Take the top rows of 1M rows with the topn and with a full sort followed by a limit. The topn keeps N rows only,
+  // and must be faster by about the log of the ratio of the input to N, or more, as the sort copies every row.
+  auto bustub = std::make_unique<BustubInstance>();
+  bustub->GenerateMockTable();
+  auto noop_writer = NoopWriter();
+
+  std::cout << "<<< BEGIN" << std::endl;
+  for (size_t n : {10, 1000, 100000}) {
+    auto limit = std::to_string(n);
+    std::stringstream sort_result;
+    auto sort_writer = SimpleStreamWriter(sort_result, true);
+    auto start = std::chrono::steady_clock::now();
+    bustub->ExecuteSql("select count(*), min(y), max(y) from (select * from (select x, y from __mock_t4_1m order by y "
+                       "desc, x) where x >= 0 limit " +
+                           limit + ");",
+                       sort_writer);
+    auto sort_elapsed =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    std::stringstream topn_result;
+    auto topn_writer = SimpleStreamWriter(topn_result, true);
+    start = std::chrono::steady_clock::now();
+    bustub->ExecuteSql("select count(*), min(y), max(y) from (select x, y from __mock_t4_1m order by y desc, x limit " +
+                           limit + ");",
+                       topn_writer);
+    auto topn_elapsed =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    EXPECT_EQ(topn_result.str(), sort_result.str());
+    std::cout << "limit " << n << ": sort " << sort_elapsed.count() << " ms, topn " << topn_elapsed.count() << " ms"
+              << std::endl;
+  }
+  std::cout << ">>> END" << std::endl;
+}
+
+}  // namespace bustub
@@ -0,0 +1,44 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pin_count_listener.cpp
+//
+// Identification: test/pin_count_listener.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+/**
+ * Fails every test that destroys a buffer pool with pages still pinned, i.e. a test that leaks a pin itself or runs
+ * code that does. Linked into every test binary.
+ */
+class PinCountListener : public testing::EmptyTestEventListener {
+ public:
+  void OnTestStart(const testing::TestInfo & /*test_info*/) override {
+    leaked_at_start_ = BufferPoolManagerInstance::GetLeakedPinnedPages();
+  }
+
+  void OnTestEnd(const testing::TestInfo & /*test_info*/) override {
+    auto leaked = BufferPoolManagerInstance::GetLeakedPinnedPages() - leaked_at_start_;
+    if (leaked > 0) {
+      ADD_FAILURE() << leaked << " page(s) were still pinned when their buffer pool was destroyed";
+    }
+  }
+
+ private:
+  size_t leaked_at_start_{0};
+};
+
+static const bool PIN_COUNT_LISTENER_REGISTERED = []() {
+  testing::UnitTest::GetInstance()->listeners().Append(new PinCountListener);
+  return true;
+}();
+
+}  // namespace bustub
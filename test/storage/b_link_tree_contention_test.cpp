@@ -0,0 +1,117 @@
+/**
+ * b_link_tree_contention_test.cpp
+ */
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <thread>  // NOLINT
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_link_tree.h"
+#include "storage/index/b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+/**
+ * Half of the threads insert disjoint key ranges while the other half look up keys that were loaded beforehand.
+ * Returns the wall time in milliseconds.
+ */
+template <typename Tree>
+auto IndexContentionBenchmarkCall(size_t num_threads, int leaf_node_size, int internal_node_size) -> size_t {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto *disk_manager = new DiskManagerMemory(16 << 10);
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(64, disk_manager);
+  Tree tree("foo_pk", bpm, comparator, leaf_node_size, internal_node_size);
+  page_id_t page_id;
+  auto *header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  const int preload_keys = 10000;
+  const int keys_per_thread = 20000 / num_threads;
+  const int keys_stride = 100000;
+
+  auto *preload_txn = new Transaction(0);
+  GenericKey<8> index_key;
+  RID rid;
+  for (int64_t key = 0; key < preload_keys; key++) {
+    rid.Set(0, key);
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, rid, preload_txn);
+  }
+  delete preload_txn;
+
+  auto clock_start = std::chrono::system_clock::now();
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < num_threads; i++) {
+    threads.emplace_back([&tree, i, keys_per_thread]() {
+      GenericKey<8> index_key;
+      RID rid;
+      std::vector<RID> result;
+      auto *transaction = new Transaction(static_cast<txn_id_t>(i + 1));
+      if (i % 2 == 0) {
+        const auto start_key = keys_stride * (i + 1);
+        for (auto key = start_key; key < start_key + keys_per_thread; key++) {
+          rid.Set(0, key);
+          index_key.SetFromInteger(key);
+          tree.Insert(index_key, rid, transaction);
+        }
+      } else {
+        for (int round = 0; round < 4; round++) {
+          for (int64_t key = 0; key < preload_keys; key += 2) {
+            result.clear();
+            index_key.SetFromInteger(key);
+            tree.GetValue(index_key, &result, transaction);
+          }
+        }
+      }
+      delete transaction;
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  auto clock_end = std::chrono::system_clock::now();
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  return std::chrono::duration_cast<std::chrono::milliseconds>(clock_end - clock_start).count();
+}
+
+TEST(BLinkTreeTest, DISABLED_BLinkTreeContentionBenchmark) {  // NOLINT
+  using BPlusTreeType = BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+  using BLinkTreeType = BLinkTree<GenericKey<8>, RID, GenericComparator<8>>;
+  std::vector<size_t> time_ms_b_plus;
+  std::vector<size_t> time_ms_b_link;
+  for (size_t iter = 0; iter < 10; iter++) {
+    time_ms_b_plus.push_back(IndexContentionBenchmarkCall<BPlusTreeType>(32, 10, 10));
+    time_ms_b_link.push_back(IndexContentionBenchmarkCall<BLinkTreeType>(32, 10, 10));
+  }
+  std::cout << "This test compares latch crabbing in the B+ tree with the B-link tree under mixed contention."
+            << std::endl;
+  std::cout << "<<< BEGIN" << std::endl;
+  double total_b_plus = 0;
+  double total_b_link = 0;
+  std::cout << "B+ Tree Time: ";
+  for (auto x : time_ms_b_plus) {
+    std::cout << x << " ";
+    total_b_plus += x;
+  }
+  std::cout << std::endl;
+  std::cout << "B-link Tree Time: ";
+  for (auto x : time_ms_b_link) {
+    std::cout << x << " ";
+    total_b_link += x;
+  }
+  std::cout << std::endl;
+  std::cout << "Ratio: " << total_b_link / total_b_plus << std::endl;
+  std::cout << ">>> END" << std::endl;
+}
+
+}  // namespace bustub
@@ -0,0 +1,163 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_link_tree_test.cpp
+//
+// Identification: test/storage/b_link_tree_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <random>
+#include <thread>  // NOLINT
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_link_tree.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using BLinkTreeForTest = BLinkTree<GenericKey<8>, RID, GenericComparator<8>>;
+
+void BLinkInsertHelper(BLinkTreeForTest *tree, const std::vector<int64_t> &keys, int total_threads,
+                       uint64_t thread_itr) {
+  GenericKey<8> index_key;
+  RID rid;
+  for (auto key : keys) {
+    if (static_cast<uint64_t>(key) % total_threads == thread_itr) {
+      rid.Set(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF);
+      index_key.SetFromInteger(key);
+      tree->Insert(index_key, rid);
+    }
+  }
+}
+
+TEST(BLinkTreeTest, InsertGetRemove) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManagerMemory(1000);
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  ASSERT_EQ(page_id, HEADER_PAGE_ID);
+  (void)header_page;
+
+  // Tiny nodes force splits at every level.
+  BLinkTreeForTest tree("foo_pk", bpm, comparator, 2, 3);
+  ASSERT_TRUE(tree.IsEmpty());
+
+  std::vector<int64_t> keys;
+  for (int64_t key = 1; key <= 500; key++) {
+    keys.push_back(key);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(15445));
+
+  GenericKey<8> index_key;
+  RID rid;
+  for (auto key : keys) {
+    rid.Set(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF);
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(tree.Insert(index_key, rid));
+  }
+  index_key.SetFromInteger(42);
+  ASSERT_FALSE(tree.Insert(index_key, rid));
+
+  std::vector<RID> rids;
+  for (auto key : keys) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(tree.GetValue(index_key, &rids));
+    ASSERT_EQ(rids.size(), 1);
+    ASSERT_EQ(rids[0].GetSlotNum(), key & 0xFFFFFFFF);
+  }
+
+  for (auto key : keys) {
+    if (key % 2 == 0) {
+      index_key.SetFromInteger(key);
+      tree.Remove(index_key);
+    }
+  }
+  for (auto key : keys) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    ASSERT_EQ(tree.GetValue(index_key, &rids), key % 2 == 1);
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(BLinkTreeTest, ConcurrentInsertAndRead) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto *disk_manager = new DiskManagerMemory(10000);
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  BLinkTreeForTest tree("foo_pk", bpm, comparator, 3, 4);
+
+  // Keys below 1000 are inserted up front and must stay visible while the tree splits around them.
+  std::vector<int64_t> stable_keys;
+  std::vector<int64_t> new_keys;
+  for (int64_t key = 0; key < 1000; key++) {
+    stable_keys.push_back(key);
+  }
+  for (int64_t key = 1000; key < 5000; key++) {
+    new_keys.push_back(key);
+  }
+  BLinkInsertHelper(&tree, stable_keys, 1, 0);
+
+  const int num_writers = 4;
+  std::atomic<bool> done{false};
+  std::atomic<int> missed{0};
+  std::thread reader([&]() {
+    GenericKey<8> index_key;
+    std::vector<RID> rids;
+    while (!done.load()) {
+      for (auto key : stable_keys) {
+        rids.clear();
+        index_key.SetFromInteger(key);
+        if (!tree.GetValue(index_key, &rids)) {
+          missed++;
+        }
+      }
+    }
+  });
+  std::vector<std::thread> writers;
+  for (int i = 0; i < num_writers; i++) {
+    writers.emplace_back(BLinkInsertHelper, &tree, std::cref(new_keys), num_writers, i);
+  }
+  for (auto &writer : writers) {
+    writer.join();
+  }
+  done = true;
+  reader.join();
+  ASSERT_EQ(missed.load(), 0);
+
+  GenericKey<8> index_key;
+  std::vector<RID> rids;
+  for (int64_t key = 0; key < 5000; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    ASSERT_TRUE(tree.GetValue(index_key, &rids));
+    ASSERT_EQ(rids[0].GetSlotNum(), key);
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
@@ -0,0 +1,165 @@
+/**
+ * index_benchmark_test.cpp
+ *
+ * Compares the in-memory and hash index structures with the buffer-pool B+ tree. The benchmarks are disabled by
+ * default; run them with --gtest_also_run_disabled_tests.
+ */
+
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/art_index.h"
+#include "storage/index/b_plus_tree_index.h"
+#include "storage/index/extendible_hash_table_index.h"
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+static const int64_t BENCHMARK_NUM_KEYS = 100000;
+static const int BENCHMARK_SCAN_LENGTH = 100;
+
+class IndexBenchmarkTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    schema_ = ParseCreateStatement("a bigint");
+    disk_manager_ = std::make_unique<DiskManagerMemory>(16 << 10);
+    bpm_ = std::make_unique<BufferPoolManagerInstance>(1024, disk_manager_.get());
+    page_id_t page_id;
+    bpm_->NewPage(&page_id);
+    txn_ = std::make_unique<Transaction>(0);
+
+    b_plus_tree_ = std::make_unique<BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>>>(
+        std::make_unique<IndexMetadata>("b_plus_tree", "t", schema_.get(), std::vector<uint32_t>{0}), bpm_.get());
+    art_ = std::make_unique<ArtIndex>(
+        std::make_unique<IndexMetadata>("art", "t", schema_.get(), std::vector<uint32_t>{0}));
+    hash_ = std::make_unique<ExtendibleHashTableIndex<GenericKey<8>, RID, GenericComparator<8>>>(
+        std::make_unique<IndexMetadata>("hash", "t", schema_.get(), std::vector<uint32_t>{0}), bpm_.get(),
+        HashFunction<GenericKey<8>>());
+
+    for (int64_t key = 0; key < BENCHMARK_NUM_KEYS; key++) {
+      keys_.push_back(key);
+    }
+    std::shuffle(keys_.begin(), keys_.end(), std::mt19937(15445));
+    for (auto key : keys_) {
+      auto tuple = MakeKey(key);
+      RID rid(0, static_cast<uint32_t>(key));
+      b_plus_tree_->InsertEntry(tuple, rid, txn_.get());
+      art_->InsertEntry(tuple, rid, txn_.get());
+      hash_->InsertEntry(tuple, rid, txn_.get());
+    }
+  }
+
+  void TearDown() override {
+    b_plus_tree_.reset();
+    hash_.reset();
+    bpm_->UnpinPage(HEADER_PAGE_ID, true);
+  }
+
+  auto MakeKey(int64_t key) -> Tuple { return Tuple({ValueFactory::GetBigIntValue(key)}, schema_.get()); }
+
+  template <typename F>
+  static auto TimeMs(F &&f) -> int64_t {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  std::unique_ptr<Schema> schema_;
+  std::unique_ptr<DiskManagerMemory> disk_manager_;
+  std::unique_ptr<BufferPoolManagerInstance> bpm_;
+  std::unique_ptr<Transaction> txn_;
+  std::unique_ptr<BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>>> b_plus_tree_;
+  std::unique_ptr<ArtIndex> art_;
+  std::unique_ptr<ExtendibleHashTableIndex<GenericKey<8>, RID, GenericComparator<8>>> hash_;
+  std::vector<int64_t> keys_;
+};
+
+TEST_F(IndexBenchmarkTest, DISABLED_ArtPointLookupBenchmark) {  // NOLINT
+  std::vector<Tuple> probes;
+  for (auto key : keys_) {
+    probes.push_back(MakeKey(key));
+  }
+  std::vector<RID> result;
+  auto b_plus_ms = TimeMs([&]() {
+    for (auto &probe : probes) {
+      result.clear();
+      b_plus_tree_->ScanKey(probe, &result, txn_.get());
+    }
+  });
+  auto art_ms = TimeMs([&]() {
+    for (auto &probe : probes) {
+      result.clear();
+      art_->ScanKey(probe, &result, txn_.get());
+    }
+  });
+  std::cout << "<<< BEGIN" << std::endl;
+  std::cout << BENCHMARK_NUM_KEYS << " point lookups" << std::endl;
+  std::cout << "B+ Tree Time: " << b_plus_ms << " ms" << std::endl;
+  std::cout << "ART Time: " << art_ms << " ms" << std::endl;
+  std::cout << ">>> END" << std::endl;
+}
+
+TEST_F(IndexBenchmarkTest, DISABLED_ArtRangeScanBenchmark) {  // NOLINT
+  const int num_scans = 10000;
+  std::vector<RID> result;
+  auto b_plus_ms = TimeMs([&]() {
+    GenericKey<8> index_key;
+    auto end = b_plus_tree_->GetEndIterator();
+    for (int i = 0; i < num_scans; i++) {
+      result.clear();
+      index_key.SetFromKey(MakeKey(keys_[i]));
+      auto iter = b_plus_tree_->GetBeginIterator(index_key);
+      for (int n = 0; n < BENCHMARK_SCAN_LENGTH && iter != end; n++, ++iter) {
+        result.push_back((*iter).second);
+      }
+    }
+  });
+  auto art_ms = TimeMs([&]() {
+    for (int i = 0; i < num_scans; i++) {
+      art_->ScanFrom(MakeKey(keys_[i]), BENCHMARK_SCAN_LENGTH, &result);
+    }
+  });
+  std::cout << "<<< BEGIN" << std::endl;
+  std::cout << num_scans << " scans of " << BENCHMARK_SCAN_LENGTH << " keys" << std::endl;
+  std::cout << "B+ Tree Time: " << b_plus_ms << " ms" << std::endl;
+  std::cout << "ART Time: " << art_ms << " ms" << std::endl;
+  std::cout << ">>> END" << std::endl;
+}
+
+TEST_F(IndexBenchmarkTest, DISABLED_HashPointLookupBenchmark) {  // NOLINT
+  std::vector<Tuple> probes;
+  for (auto key : keys_) {
+    probes.push_back(MakeKey(key));
+  }
+  std::vector<RID> result;
+  size_t b_plus_hits = 0;
+  size_t hash_hits = 0;
+  auto b_plus_ms = TimeMs([&]() {
+    for (auto &probe : probes) {
+      result.clear();
+      b_plus_tree_->ScanKey(probe, &result, txn_.get());
+      b_plus_hits += result.size();
+    }
+  });
+  auto hash_ms = TimeMs([&]() {
+    for (auto &probe : probes) {
+      result.clear();
+      hash_->ScanKey(probe, &result, txn_.get());
+      hash_hits += result.size();
+    }
+  });
+  std::cout << "<<< BEGIN" << std::endl;
+  std::cout << BENCHMARK_NUM_KEYS << " point lookups" << std::endl;
+  std::cout << "B+ Tree Time: " << b_plus_ms << " ms, " << b_plus_hits << " hits" << std::endl;
+  std::cout << "Hash Index Time: " << hash_ms << " ms, " << hash_hits << " hits" << std::endl;
+  std::cout << ">>> END" << std::endl;
+}
+
+}  // namespace bustub
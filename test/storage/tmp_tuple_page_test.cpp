@@ -10,20 +10,21 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <memory>
+#include <string>
 #include <vector>
 
+#include "buffer/buffer_pool_manager_instance.h"
 #include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
 #include "storage/page/tmp_tuple_page.h"
+#include "storage/table/tmp_tuple_file.h"
 #include "type/value_factory.h"
 
 namespace bustub {
 
 // NOLINTNEXTLINE
-TEST(TmpTuplePageTest, DISABLED_BasicTest) {
-  // There are many ways to do this assignment, and this is only one of them.
-  // If you don't like the TmpTuplePage idea, please feel free to delete this test case entirely.
-  // You will get full credit as long as you are correctly using a linear probe hash table.
-
+TEST(TmpTuplePageTest, BasicTest) {
   TmpTuplePage page{};
   page_id_t page_id = 15445;
   page.Init(page_id, BUSTUB_PAGE_SIZE);
@@ -46,6 +47,59 @@ TEST(TmpTuplePageTest, DISABLED_BasicTest) {
   ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + sizeof(page_id_t) + sizeof(lsn_t)), BUSTUB_PAGE_SIZE - 8);
   ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + BUSTUB_PAGE_SIZE - 8), 4);
   ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + BUSTUB_PAGE_SIZE - 4), 123);
+  ASSERT_EQ(tmp_tuple.GetPageId(), page_id);
+  ASSERT_EQ(tmp_tuple.GetOffset(), BUSTUB_PAGE_SIZE - 8);
+
+  Tuple read_tuple;
+  page.Get(tmp_tuple.GetOffset(), &read_tuple);
+  ASSERT_EQ(read_tuple.GetValue(&schema, 0).GetAs<int32_t>(), 123);
+
+  // Fill the page up.
+  int inserted = 1;
+  while (page.Insert(tuple, &tmp_tuple)) {
+    inserted++;
+  }
+  ASSERT_EQ(inserted, (BUSTUB_PAGE_SIZE - 12) / 8);
+}
+
+// NOLINTNEXTLINE
+TEST(TmpTuplePageTest, TmpTupleFileTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  // Fewer frames than the file has pages, so that pages are written out and read back.
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(4, disk_manager.get());
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 64}});
+
+  const int num_tuples = 5000;
+  {
+    TmpTupleFile file(bpm.get());
+    for (int i = 0; i < num_tuples; i++) {
+      file.Append(Tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::string(i % 50, 'x'))},
+                        &schema));
+    }
+    file.Finish();
+    EXPECT_EQ(file.GetTupleCount(), num_tuples);
+
+    // Read twice; the tuples come back in the order they were appended.
+    for (int pass = 0; pass < 2; pass++) {
+      TmpTupleFile::Reader reader(&file);
+      Tuple tuple;
+      int i = 0;
+      while (reader.Next(&tuple)) {
+        ASSERT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), i);
+        ASSERT_EQ(tuple.GetValue(&schema, 1).ToString(), std::string(i % 50, 'x'));
+        i++;
+      }
+      EXPECT_EQ(i, num_tuples);
+    }
+  }
+  // All pages of the file are gone, so the buffer pool can hand out all of its frames again.
+  std::vector<page_id_t> page_ids(4);
+  for (auto &page_id : page_ids) {
+    ASSERT_NE(bpm->NewPage(&page_id), nullptr);
+  }
+  for (auto page_id : page_ids) {
+    bpm->UnpinPage(page_id, false);
+  }
 }
 
 }  // namespace bustub
@@ -0,0 +1,232 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// pax_table_heap_test.cpp
+//
+// Identification: test/table/pax_table_heap_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "concurrency/transaction.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/table/pax_table_heap.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+static auto MakeRow(const Schema *schema, int32_t key) -> Tuple {
+  std::vector<Value> values{ValueFactory::GetIntegerValue(key),
+                            key % 7 == 0 ? ValueFactory::GetNullValueByType(TypeId::VARCHAR)
+                                         : ValueFactory::GetVarcharValue(std::string(key % 50, 'a' + key % 26)),
+                            ValueFactory::GetIntegerValue(-key)};
+  return {values, schema};
+}
+
+static void CheckRow(const Schema *schema, const Tuple &tuple, int32_t key) {
+  auto expected = MakeRow(schema, key);
+  for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+    auto value = tuple.GetValue(schema, i);
+    auto expected_value = expected.GetValue(schema, i);
+    ASSERT_EQ(value.IsNull(), expected_value.IsNull()) << "key " << key << " column " << i;
+    if (!value.IsNull()) {
+      ASSERT_EQ(value.CompareEquals(expected_value), CmpBool::CmpTrue) << "key " << key << " column " << i;
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(PaxTableHeapTest, InsertGetScanTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(32, disk_manager.get());
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 64}, Column{"c", TypeId::INTEGER}});
+  auto txn = std::make_unique<Transaction>(0);
+  PaxTableHeap table(bpm.get(), nullptr, nullptr, schema, txn.get());
+
+  const int num_rows = 2000;
+  std::vector<RID> rids;
+  std::set<page_id_t> pages;
+  for (int i = 0; i < num_rows; i += 100) {
+    std::vector<Tuple> batch;
+    for (int j = i; j < i + 100; j++) {
+      batch.push_back(MakeRow(&schema, j));
+    }
+    std::vector<RID> batch_rids;
+    ASSERT_TRUE(table.InsertTuples(batch, &batch_rids, txn.get()));
+    rids.insert(rids.end(), batch_rids.begin(), batch_rids.end());
+  }
+  for (const auto &rid : rids) {
+    pages.insert(rid.GetPageId());
+  }
+  EXPECT_GT(pages.size(), 1);
+  EXPECT_EQ(txn->GetWriteSet()->size(), num_rows);
+
+  for (int i = 0; i < num_rows; i++) {
+    Tuple tuple;
+    ASSERT_TRUE(table.GetTuple(rids[i], &tuple, txn.get()));
+    EXPECT_EQ(tuple.GetRid(), rids[i]);
+    CheckRow(&schema, tuple, i);
+  }
+
+  // The iterator puts whole rows back together, in insertion order.
+  int key = 0;
+  for (auto it = table.Begin(txn.get()); it != table.End(); ++it) {
+    CheckRow(&schema, *it, key++);
+  }
+  EXPECT_EQ(key, num_rows);
+
+  // A row is never updated in place.
+  EXPECT_FALSE(table.UpdateTuple(MakeRow(&schema, 1), rids[0], txn.get()));
+}
+
+// NOLINTNEXTLINE
+TEST(PaxTableHeapTest, DeleteTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(32, disk_manager.get());
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 64}, Column{"c", TypeId::INTEGER}});
+  auto txn = std::make_unique<Transaction>(0);
+  PaxTableHeap table(bpm.get(), nullptr, nullptr, schema, txn.get());
+
+  std::vector<RID> rids;
+  for (int i = 0; i < 1000; i++) {
+    RID rid;
+    ASSERT_TRUE(table.InsertTuple(MakeRow(&schema, i), &rid, txn.get()));
+    rids.push_back(rid);
+  }
+  // Delete every other row, and the whole first page.
+  for (int i = 0; i < 1000; i++) {
+    if (i % 2 == 0 || rids[i].GetPageId() == rids[0].GetPageId()) {
+      ASSERT_TRUE(table.MarkDelete(rids[i], txn.get()));
+    }
+  }
+  EXPECT_FALSE(table.MarkDelete(rids[0], txn.get()));
+  Tuple tuple;
+  EXPECT_FALSE(table.GetTuple(rids[0], &tuple, txn.get()));
+
+  // Roll back one delete, apply the others.
+  table.RollbackDelete(rids[998], txn.get());
+  for (int i = 0; i < 998; i++) {
+    if (i % 2 == 0 || rids[i].GetPageId() == rids[0].GetPageId()) {
+      table.ApplyDelete(rids[i], txn.get());
+    }
+  }
+  std::vector<int> keys;
+  for (auto it = table.Begin(txn.get()); it != table.End(); ++it) {
+    keys.push_back(it->GetValue(&schema, 0).GetAs<int32_t>());
+  }
+  std::vector<int> expected;
+  for (int i = 0; i < 1000; i++) {
+    if (i == 998 || (i % 2 == 1 && rids[i].GetPageId() != rids[0].GetPageId())) {
+      expected.push_back(i);
+    }
+  }
+  EXPECT_EQ(keys, expected);
+}
+
+// NOLINTNEXTLINE
+TEST(PaxTableHeapTest, ScanColumnsTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(32, disk_manager.get());
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 64}, Column{"c", TypeId::INTEGER}});
+  auto txn = std::make_unique<Transaction>(0);
+  PaxTableHeap table(bpm.get(), nullptr, nullptr, schema, txn.get());
+
+  const int num_rows = 1500;
+  std::vector<RID> rids;
+  for (int i = 0; i < num_rows; i++) {
+    RID rid;
+    ASSERT_TRUE(table.InsertTuple(MakeRow(&schema, i), &rid, txn.get()));
+    rids.push_back(rid);
+  }
+  ASSERT_TRUE(table.MarkDelete(rids[5], txn.get()));
+
+  // Read the columns out of order, and only two of them.
+  const std::vector<uint32_t> column_ids{2, 1};
+  std::vector<std::vector<Value>> columns;
+  std::vector<RID> page_rids;
+  int key = 0;
+  for (auto page_id = table.GetFirstPageId(); page_id != INVALID_PAGE_ID;) {
+    page_id = table.ScanColumns(page_id, column_ids, &columns, &page_rids);
+    ASSERT_EQ(columns.size(), 2);
+    ASSERT_EQ(columns[0].size(), page_rids.size());
+    ASSERT_EQ(columns[1].size(), page_rids.size());
+    for (size_t i = 0; i < page_rids.size(); i++, key++) {
+      if (key == 5) {
+        key++;
+      }
+      EXPECT_EQ(page_rids[i], rids[key]);
+      EXPECT_EQ(columns[0][i].GetAs<int32_t>(), -key);
+      auto expected = MakeRow(&schema, key).GetValue(&schema, 1);
+      ASSERT_EQ(columns[1][i].IsNull(), expected.IsNull());
+      if (!expected.IsNull()) {
+        EXPECT_EQ(columns[1][i].CompareEquals(expected), CmpBool::CmpTrue);
+      }
+    }
+  }
+  EXPECT_EQ(key, num_rows);
+}
+
+// NOLINTNEXTLINE
+TEST(PaxTableHeapTest, DISABLED_ColumnScanBenchmark) {
+  // Sum one column of a table with 16 columns, stored row by row and column by column.
+  const int num_rows = 500000;
+  const uint32_t num_columns = 16;
+  std::vector<Column> columns;
+  std::vector<Value> values;
+  for (uint32_t i = 0; i < num_columns; i++) {
+    columns.emplace_back("c" + std::to_string(i), TypeId::INTEGER);
+    values.push_back(ValueFactory::GetIntegerValue(i));
+  }
+  Schema schema(columns);
+
+  std::cout << "<<< BEGIN" << std::endl;
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(4096, disk_manager.get());
+  auto txn = std::make_unique<Transaction>(0);
+  TableHeap row_table(bpm.get(), nullptr, nullptr, txn.get());
+  PaxTableHeap pax_table(bpm.get(), nullptr, nullptr, schema, txn.get());
+  for (int i = 0; i < num_rows; i++) {
+    values[3] = ValueFactory::GetIntegerValue(i);
+    Tuple tuple(values, &schema);
+    RID rid;
+    row_table.InsertTuple(tuple, &rid, txn.get());
+    pax_table.InsertTuple(tuple, &rid, txn.get());
+  }
+  txn->GetWriteSet()->clear();
+
+  auto start = std::chrono::steady_clock::now();
+  int64_t sum = 0;
+  for (auto it = row_table.Begin(txn.get()); it != row_table.End(); ++it) {
+    sum += it->GetValue(&schema, 3).GetAs<int32_t>();
+  }
+  auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+  std::cout << "Row: " << ms << " ms, sum " << sum << std::endl;
+
+  start = std::chrono::steady_clock::now();
+  sum = 0;
+  std::vector<std::vector<Value>> column_values;
+  std::vector<RID> rids;
+  for (auto page_id = pax_table.GetFirstPageId(); page_id != INVALID_PAGE_ID;) {
+    page_id = pax_table.ScanColumns(page_id, {3}, &column_values, &rids);
+    for (const auto &value : column_values[0]) {
+      sum += value.GetAs<int32_t>();
+    }
+  }
+  ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+  std::cout << "PAX: " << ms << " ms, sum " << sum << std::endl;
+  std::cout << ">>> END" << std::endl;
+}
+
+}  // namespace bustub
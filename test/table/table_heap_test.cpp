@@ -0,0 +1,392 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_heap_test.cpp
+//
+// Identification: test/table/table_heap_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "concurrency/transaction.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/page/table_page.h"
+#include "storage/table/free_space_map.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+static auto MakeTuple(const Schema *schema, int32_t key, size_t padding) -> Tuple {
+  std::vector<Value> values{ValueFactory::GetIntegerValue(key),
+                            ValueFactory::GetVarcharValue(std::string(padding, 'x'))};
+  return {values, schema};
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, FreeSpaceMapTest) {
+  FreeSpaceMap map;
+  EXPECT_EQ(map.FindPage(1), INVALID_PAGE_ID);
+  for (page_id_t page_id = 0; page_id < 10; page_id++) {
+    map.AppendPage(page_id * 3, 100);
+  }
+  EXPECT_EQ(map.GetNumPages(), 10);
+  EXPECT_EQ(map.GetLastPageId(), 27);
+  // The last appended page is the hint.
+  EXPECT_EQ(map.FindPage(100), 27);
+  EXPECT_EQ(map.FindPage(101), INVALID_PAGE_ID);
+
+  map.UpdatePage(27, 0);
+  map.UpdatePage(12, 500);
+  EXPECT_EQ(map.FindPage(200), 12);
+  // Once the hint is full, the leftmost page that fits wins.
+  map.UpdatePage(12, 10);
+  EXPECT_EQ(map.FindPage(50), 0);
+  map.UpdatePage(42, 1000);
+  EXPECT_EQ(map.FindPage(101), INVALID_PAGE_ID);
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, ReuseFreedSpaceTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(32, disk_manager.get());
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 512}});
+  auto txn = std::make_unique<Transaction>(0);
+  TableHeap table(bpm.get(), nullptr, nullptr, txn.get());
+
+  std::vector<RID> rids;
+  std::set<page_id_t> pages;
+  for (int i = 0; i < 500; i++) {
+    RID rid;
+    ASSERT_TRUE(table.InsertTuple(MakeTuple(&schema, i, 200), &rid, txn.get()));
+    rids.push_back(rid);
+    pages.insert(rid.GetPageId());
+  }
+  size_t num_pages = pages.size();
+  EXPECT_GT(num_pages, 20);
+
+  // Free every other tuple; the next inserts fill those holes instead of growing the table.
+  for (size_t i = 0; i < rids.size(); i += 2) {
+    ASSERT_TRUE(table.MarkDelete(rids[i], txn.get()));
+    table.ApplyDelete(rids[i], txn.get());
+  }
+  for (int i = 0; i < 200; i++) {
+    RID rid;
+    ASSERT_TRUE(table.InsertTuple(MakeTuple(&schema, 1000 + i, 200), &rid, txn.get()));
+    EXPECT_NE(pages.count(rid.GetPageId()), 0);
+  }
+
+  // A heap opened from its first page builds its map from the page chain.
+  TableHeap reopened(bpm.get(), nullptr, nullptr, table.GetFirstPageId());
+  RID rid;
+  ASSERT_TRUE(reopened.InsertTuple(MakeTuple(&schema, 2000, 200), &rid, txn.get()));
+  EXPECT_NE(pages.count(rid.GetPageId()), 0);
+  Tuple tuple;
+  ASSERT_TRUE(reopened.GetTuple(rid, &tuple, txn.get()));
+  EXPECT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), 2000);
+
+  size_t count = 0;
+  for (auto it = reopened.Begin(txn.get()); it != reopened.End(); ++it) {
+    count++;
+  }
+  EXPECT_EQ(count, 500 - 250 + 200 + 1);
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, InsertTuplesTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(32, disk_manager.get());
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 512}});
+  auto txn = std::make_unique<Transaction>(0);
+  TableHeap table(bpm.get(), nullptr, nullptr, txn.get());
+
+  // Leave holes in the first pages for the batch to fill.
+  std::vector<RID> rids;
+  for (int i = 0; i < 100; i++) {
+    RID rid;
+    ASSERT_TRUE(table.InsertTuple(MakeTuple(&schema, i, 300), &rid, txn.get()));
+    rids.push_back(rid);
+  }
+  for (size_t i = 0; i < rids.size(); i += 3) {
+    ASSERT_TRUE(table.MarkDelete(rids[i], txn.get()));
+    table.ApplyDelete(rids[i], txn.get());
+  }
+
+  std::vector<Tuple> batch;
+  for (int i = 0; i < 1000; i++) {
+    batch.push_back(MakeTuple(&schema, 1000 + i, i % 400));
+  }
+  size_t write_set_size = txn->GetWriteSet()->size();
+  ASSERT_TRUE(table.InsertTuples(batch, &rids, txn.get()));
+  ASSERT_EQ(rids.size(), batch.size());
+  EXPECT_EQ(txn->GetWriteSet()->size(), write_set_size + batch.size());
+  std::set<int64_t> distinct_rids;
+  std::set<page_id_t> pages;
+  for (size_t i = 0; i < batch.size(); i++) {
+    distinct_rids.insert(rids[i].Get());
+    pages.insert(rids[i].GetPageId());
+    Tuple tuple;
+    ASSERT_TRUE(table.GetTuple(rids[i], &tuple, txn.get()));
+    ASSERT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), 1000 + static_cast<int>(i));
+    ASSERT_EQ(tuple.GetLength(), batch[i].GetLength());
+  }
+  EXPECT_EQ(distinct_rids.size(), rids.size());
+  EXPECT_EQ(pages.count(table.GetFirstPageId()), 1);
+
+  // One oversized tuple rejects the whole batch.
+  batch.push_back(MakeTuple(&schema, -1, BUSTUB_PAGE_SIZE));
+  EXPECT_FALSE(table.InsertTuples(batch, &rids, txn.get()));
+  EXPECT_EQ(txn->GetState(), TransactionState::ABORTED);
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, MaxTupleSizeTest) {
+  // The largest tuple an empty page takes is inserted; anything larger is rejected right away, as no page could ever
+  // take it.
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(8, disk_manager.get());
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 2 * BUSTUB_PAGE_SIZE}});
+  auto make_tuple_of_size = [&](uint32_t size) {
+    return MakeTuple(&schema, 0, size - MakeTuple(&schema, 0, 0).GetLength());
+  };
+  auto txn = std::make_unique<Transaction>(0);
+  TableHeap table(bpm.get(), nullptr, nullptr, txn.get());
+
+  for (uint32_t size : {TablePage::MaxTupleSize() - 1, TablePage::MaxTupleSize()}) {
+    auto tuple = make_tuple_of_size(size);
+    ASSERT_EQ(tuple.GetLength(), size);
+    RID rid;
+    ASSERT_TRUE(table.InsertTuple(tuple, &rid, txn.get()));
+    std::vector<RID> rids;
+    ASSERT_TRUE(table.InsertTuples({tuple, tuple}, &rids, txn.get()));
+    EXPECT_EQ(rids.size(), 2);
+  }
+  EXPECT_EQ(txn->GetState(), TransactionState::GROWING);
+
+  for (uint32_t size = TablePage::MaxTupleSize() + 1; size <= BUSTUB_PAGE_SIZE; size++) {
+    auto tuple = make_tuple_of_size(size);
+    Transaction insert_txn(1);
+    RID rid;
+    EXPECT_FALSE(table.InsertTuple(tuple, &rid, &insert_txn));
+    EXPECT_EQ(insert_txn.GetState(), TransactionState::ABORTED);
+    Transaction batch_txn(2);
+    std::vector<RID> rids;
+    EXPECT_FALSE(table.InsertTuples({tuple}, &rids, &batch_txn));
+    EXPECT_EQ(batch_txn.GetState(), TransactionState::ABORTED);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, ScanPageTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(32, disk_manager.get());
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 512}});
+  auto txn = std::make_unique<Transaction>(0);
+  TableHeap table(bpm.get(), nullptr, nullptr, txn.get());
+
+  std::vector<RID> rids;
+  for (int i = 0; i < 300; i++) {
+    RID rid;
+    ASSERT_TRUE(table.InsertTuple(MakeTuple(&schema, i, 100), &rid, txn.get()));
+    rids.push_back(rid);
+  }
+  for (size_t i = 0; i < rids.size(); i += 3) {
+    ASSERT_TRUE(table.MarkDelete(rids[i], txn.get()));
+    table.ApplyDelete(rids[i], txn.get());
+  }
+
+  // Stop after every 7th row and resume from where the visitor stopped: every live row is seen once, in table order,
+  // as a view into its page.
+  std::vector<int32_t> keys;
+  page_id_t page_id = table.GetFirstPageId();
+  uint32_t slot = 0;
+  size_t num_pages = 0;
+  while (page_id != INVALID_PAGE_ID) {
+    size_t visited = 0;
+    auto next_page_id = table.ScanPage(page_id, &slot, [&](const Tuple &view) {
+      if (++visited % 7 == 0) {
+        return false;
+      }
+      EXPECT_TRUE(view.IsBorrowed());
+      keys.push_back(view.GetValue(&schema, 0).GetAs<int32_t>());
+      return true;
+    });
+    num_pages += next_page_id != page_id ? 1 : 0;
+    page_id = next_page_id;
+  }
+  EXPECT_GT(num_pages, 5);
+  std::vector<int32_t> expected;
+  for (int i = 0; i < 300; i++) {
+    if (i % 3 != 0) {
+      expected.push_back(i);
+    }
+  }
+  EXPECT_EQ(keys, expected);
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, TablePageCompactionTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(4, disk_manager.get());
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 4096}});
+  auto txn = std::make_unique<Transaction>(0);
+  page_id_t page_id;
+  auto guard = bpm->NewPageGuarded(&page_id);
+  auto page = guard.AsMut<TablePage>();
+  page->Init(page_id, BUSTUB_PAGE_SIZE, INVALID_PAGE_ID, nullptr, txn.get());
+
+  // Fill the page, then free every other tuple.
+  std::vector<RID> rids;
+  RID rid;
+  for (int i = 0; page->InsertTuple(MakeTuple(&schema, i, 100), &rid, txn.get(), nullptr, nullptr); i++) {
+    rids.push_back(rid);
+  }
+  ASSERT_GT(rids.size(), 10);
+  for (size_t i = 0; i < rids.size(); i += 2) {
+    ASSERT_TRUE(page->MarkDelete(rids[i], txn.get(), nullptr, nullptr));
+    page->ApplyDelete(rids[i], txn.get(), nullptr);
+  }
+  auto max_insert_size = page->GetMaxInsertSize();
+  EXPECT_GT(max_insert_size, 100 * (rids.size() / 2));
+
+  // A tuple larger than any hole compacts the page and reuses the first free slot.
+  Tuple big = MakeTuple(&schema, -1, max_insert_size - 200);
+  ASSERT_TRUE(page->InsertTuple(big, &rid, txn.get(), nullptr, nullptr));
+  EXPECT_EQ(rid, rids[0]);
+  Tuple tuple;
+  for (size_t i = 1; i < rids.size(); i += 2) {
+    ASSERT_TRUE(page->GetTuple(rids[i], &tuple, txn.get(), nullptr));
+    EXPECT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), static_cast<int32_t>(i));
+  }
+
+  // Shrinking a tuple frees space in place; growing it moves it, compacting the page if needed.
+  Tuple old_tuple;
+  ASSERT_TRUE(page->UpdateTuple(MakeTuple(&schema, -2, 10), &old_tuple, rid, txn.get(), nullptr, nullptr));
+  EXPECT_EQ(old_tuple.GetLength(), big.GetLength());
+  ASSERT_TRUE(page->UpdateTuple(MakeTuple(&schema, 1, 150), &old_tuple, rids[1], txn.get(), nullptr, nullptr));
+  auto grown = MakeTuple(&schema, -3, page->GetMaxInsertSize() + 18);
+  ASSERT_TRUE(page->UpdateTuple(grown, &old_tuple, rid, txn.get(), nullptr, nullptr));
+  EXPECT_EQ(page->GetMaxInsertSize(), 0);
+  EXPECT_FALSE(page->UpdateTuple(MakeTuple(&schema, 1, 151), &old_tuple, rids[1], txn.get(), nullptr, nullptr));
+  for (size_t i = 1; i < rids.size(); i += 2) {
+    ASSERT_TRUE(page->GetTuple(rids[i], &tuple, txn.get(), nullptr));
+    EXPECT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), static_cast<int32_t>(i));
+    EXPECT_EQ(tuple.GetLength(), MakeTuple(&schema, 0, i == 1 ? 150 : 100).GetLength());
+  }
+  ASSERT_TRUE(page->GetTuple(rid, &tuple, txn.get(), nullptr));
+  EXPECT_EQ(tuple.GetValue(&schema, 0).GetAs<int32_t>(), -3);
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, ConcurrentInsertTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(64, disk_manager.get());
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 128}});
+  auto create_txn = std::make_unique<Transaction>(0);
+  TableHeap table(bpm.get(), nullptr, nullptr, create_txn.get());
+
+  const int num_threads = 4;
+  const int tuples_per_thread = 2000;
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&, tid]() {
+      Transaction txn(tid + 1);
+      for (int i = 0; i < tuples_per_thread; i++) {
+        RID rid;
+        ASSERT_TRUE(table.InsertTuple(MakeTuple(&schema, tid * tuples_per_thread + i, 64), &rid, &txn));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  std::vector<bool> seen(num_threads * tuples_per_thread, false);
+  for (auto it = table.Begin(create_txn.get()); it != table.End(); ++it) {
+    auto key = it->GetValue(&schema, 0).GetAs<int32_t>();
+    ASSERT_FALSE(seen[key]);
+    seen[key] = true;
+  }
+  for (auto found : seen) {
+    ASSERT_TRUE(found);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, DISABLED_InsertThroughputBenchmark) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(256, disk_manager.get());
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 128}});
+  auto txn = std::make_unique<Transaction>(0);
+  TableHeap table(bpm.get(), nullptr, nullptr, txn.get());
+
+  const int batch = 100000;
+  std::cout << "<<< BEGIN" << std::endl;
+  for (int round = 0; round < 10; round++) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < batch; i++) {
+      RID rid;
+      table.InsertTuple(MakeTuple(&schema, round * batch + i, 64), &rid, txn.get());
+    }
+    auto ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Tuples " << round * batch << "-" << (round + 1) * batch << ": " << ms << " ms" << std::endl;
+    // The write set is irrelevant here and would only grow.
+    txn->GetWriteSet()->clear();
+  }
+  std::cout << ">>> END" << std::endl;
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, DISABLED_BatchInsertBenchmark) {
+  const int num_tuples = 1000000;
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 128}});
+  std::vector<Tuple> tuples;
+  tuples.reserve(num_tuples);
+  for (int i = 0; i < num_tuples; i++) {
+    tuples.push_back(MakeTuple(&schema, i, 16));
+  }
+
+  std::cout << "<<< BEGIN" << std::endl;
+  for (size_t batch_size : {1, 16, 256, 4096}) {
+    auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+    auto bpm = std::make_unique<BufferPoolManagerInstance>(256, disk_manager.get());
+    auto txn = std::make_unique<Transaction>(0);
+    TableHeap table(bpm.get(), nullptr, nullptr, txn.get());
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<Tuple> batch;
+    std::vector<RID> rids;
+    for (size_t i = 0; i < tuples.size(); i += batch_size) {
+      if (batch_size == 1) {
+        RID rid;
+        table.InsertTuple(tuples[i], &rid, txn.get());
+      } else {
+        batch.assign(tuples.begin() + i, tuples.begin() + std::min(i + batch_size, tuples.size()));
+        table.InsertTuples(batch, &rids, txn.get());
+      }
+      if (txn->GetWriteSet()->size() > 100000) {
+        txn->GetWriteSet()->clear();
+      }
+    }
+    auto ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Batch Size " << batch_size << ": " << ms << " ms" << std::endl;
+  }
+  std::cout << ">>> END" << std::endl;
+}
+
+}  // namespace bustub
@@ -13,14 +13,17 @@
 #include <algorithm>
 #include <cstdio>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "buffer/buffer_pool_manager_instance.h"
 #include "gtest/gtest.h"
 #include "logging/common.h"
+#include "storage/disk/disk_manager_memory.h"
 #include "storage/table/table_heap.h"
 #include "storage/table/tuple.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 // NOLINTNEXTLINE
@@ -71,4 +74,74 @@ TEST(TupleTest, DISABLED_TableHeapTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+TEST(TupleTest, BorrowedTupleTest) {
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(10, disk_manager.get());
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 32}});
+  auto txn = std::make_unique<Transaction>(0);
+  TableHeap table(bpm.get(), nullptr, nullptr, txn.get());
+  RID rid;
+  ASSERT_TRUE(table.InsertTuple(Tuple({ValueFactory::GetIntegerValue(42), ValueFactory::GetVarcharValue("hello")},
+                                      &schema),
+                                &rid, txn.get()));
+
+  auto page = static_cast<TablePage *>(bpm->FetchPage(rid.GetPageId()));
+  page->RLatch();
+  Tuple view;
+  ASSERT_TRUE(page->GetTupleView(rid, &view));
+  EXPECT_TRUE(view.IsBorrowed());
+  EXPECT_GE(view.GetData(), page->GetData());
+  EXPECT_LT(view.GetData(), page->GetData() + BUSTUB_PAGE_SIZE);
+  EXPECT_EQ(view.GetRid(), rid);
+  EXPECT_EQ(view.GetValue(&schema, 0).GetAs<int32_t>(), 42);
+
+  // Copies own their data, moves keep borrowing.
+  Tuple copy(view);
+  EXPECT_TRUE(copy.IsAllocated());
+  EXPECT_NE(copy.GetData(), view.GetData());
+  Tuple moved(std::move(view));
+  EXPECT_TRUE(moved.IsBorrowed());
+  EXPECT_FALSE(page->GetTupleView(RID(rid.GetPageId(), 1), &view));
+  page->RUnlatch();
+  bpm->UnpinPage(rid.GetPageId(), false);
+  EXPECT_EQ(copy.GetValue(&schema, 1).ToString(), "hello");
+}
+
+// NOLINTNEXTLINE
+TEST(TupleTest, ReuseBufferTest) {
+  Schema schema({Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 128}});
+  Tuple small({ValueFactory::GetIntegerValue(1), ValueFactory::GetVarcharValue("a")}, &schema);
+  Tuple large({ValueFactory::GetIntegerValue(2), ValueFactory::GetVarcharValue(std::string(100, 'b'))}, &schema);
+
+  Tuple tuple(large);
+  const char *buffer = tuple.GetData();
+  tuple = small;
+  EXPECT_EQ(tuple.GetData(), buffer);
+  EXPECT_EQ(tuple.GetLength(), small.GetLength());
+  EXPECT_EQ(tuple.GetValue(&schema, 1).ToString(), "a");
+  tuple = large;
+  EXPECT_EQ(tuple.GetData(), buffer);
+  EXPECT_EQ(tuple.GetValue(&schema, 1).ToString(), std::string(100, 'b'));
+
+  // A scan copies every row into the same buffer once it is large enough.
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(10, disk_manager.get());
+  auto txn = std::make_unique<Transaction>(0);
+  TableHeap table(bpm.get(), nullptr, nullptr, txn.get());
+  RID rid;
+  ASSERT_TRUE(table.InsertTuple(large, &rid, txn.get()));
+  for (int i = 0; i < 1000; i++) {
+    ASSERT_TRUE(table.InsertTuple(i % 2 == 0 ? small : large, &rid, txn.get()));
+  }
+  auto it = table.Begin(txn.get());
+  buffer = it->GetData();
+  int count = 0;
+  for (; it != table.End(); ++it) {
+    EXPECT_EQ(it->GetData(), buffer);
+    count++;
+  }
+  EXPECT_EQ(count, 1001);
+}
+
 }  // namespace bustub
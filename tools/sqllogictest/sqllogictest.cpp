@@ -88,6 +88,27 @@ auto ProcessExtraOptions(const std::string &sql, bustub::BustubInstance &instanc
           fmt::print("NestedIndexJoin not found\n");
           return false;
         }
+      } else if (opt == "ensure:hash_join") {
+        if (!bustub::StringUtil::Contains(result.str(), "HashJoin")) {
+          fmt::print("HashJoin not found\n");
+          return false;
+        }
+      } else if (opt == "ensure:nlj") {
+        if (!bustub::StringUtil::Contains(result.str(), "NestedLoopJoin")) {
+          fmt::print("NestedLoopJoin not found\n");
+          return false;
+        }
+      } else if (opt == "ensure:merge_join") {
+        if (!bustub::StringUtil::Contains(result.str(), "MergeJoin")) {
+          fmt::print("MergeJoin not found\n");
+          return false;
+        }
+      } else if (opt == "ensure:column_scan") {
+        if (!bustub::StringUtil::Contains(result.str(), "SeqScan { table=") ||
+            !bustub::StringUtil::Contains(result.str(), "columns=")) {
+          fmt::print("column scan not found\n");
+          return false;
+        }
       } else {
         throw bustub::NotImplementedException(fmt::format("unsupported extra option: {}", opt));
       }